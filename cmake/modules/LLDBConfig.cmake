@@ -323,6 +323,25 @@ else()
 
 endif()
 
+# Packet compression in the gdb-remote protocol. Darwin uses libcompression,
+# other hosts use zlib for zlib-deflate and liblz4 for lz4 when available.
+if (NOT CMAKE_SYSTEM_NAME MATCHES "Darwin")
+  find_package(ZLIB)
+  if (ZLIB_FOUND)
+    add_definitions( -DHAVE_LIBZ )
+    list(APPEND system_libs ${ZLIB_LIBRARIES})
+    include_directories(${ZLIB_INCLUDE_DIRS})
+  endif()
+
+  find_path(LZ4_INCLUDE_DIR lz4.h)
+  find_library(LZ4_LIBRARY lz4)
+  if (LZ4_INCLUDE_DIR AND LZ4_LIBRARY)
+    add_definitions( -DHAVE_LIBLZ4 )
+    list(APPEND system_libs ${LZ4_LIBRARY})
+    include_directories(${LZ4_INCLUDE_DIR})
+  endif()
+endif()
+
 if (HAVE_LIBPTHREAD)
   list(APPEND system_libs pthread)
 endif(HAVE_LIBPTHREAD)
@@ -257,6 +257,52 @@ public:
                     bool load_event,
                     bool delete_locations = false);
 
+    //------------------------------------------------------------------
+    /// A location found by a search that doesn't add it to the
+    /// breakpoint right away.
+    //------------------------------------------------------------------
+    struct DeferredLocation
+    {
+        DeferredLocation (const Address &location_addr, LazyBool reexported) :
+            addr (location_addr),
+            is_reexported (reexported)
+        {
+        }
+
+        Address addr;
+        LazyBool is_reexported; // eLazyBoolCalculate leaves the location's flag alone
+    };
+
+    //------------------------------------------------------------------
+    /// The first half of ModulesChanged for loaded modules: resolve the
+    /// sites of the existing locations in \a changed_modules, and
+    /// collect the modules that have no locations yet, which need to be
+    /// searched, in \a new_modules.
+    //------------------------------------------------------------------
+    void
+    FindModulesToResolve (ModuleList &changed_modules, ModuleList &new_modules);
+
+    //------------------------------------------------------------------
+    /// Search \a module_sp for new locations without adding them, so
+    /// the searches in different modules can run concurrently.
+    ///
+    /// @return
+    ///     \b false if the resolver doesn't support deferred locations,
+    ///     in which case nothing was searched.
+    //------------------------------------------------------------------
+    bool
+    FindDeferredLocations (const lldb::ModuleSP &module_sp, std::vector<DeferredLocation> &locations);
+
+    //------------------------------------------------------------------
+    /// Add the locations found by FindDeferredLocations, and send a
+    /// locations added event for non-internal breakpoints.
+    //------------------------------------------------------------------
+    void
+    AddDeferredLocations (const std::vector<DeferredLocation> &locations);
+
+    bool
+    SupportsDeferredLocations () const;
+
     //------------------------------------------------------------------
     /// Tells the breakpoint the old module \a old_module_sp has been
     /// replaced by new_module_sp (usually because the underlying file has been
@@ -175,6 +175,14 @@ public:
     //------------------------------------------------------------------
     const char *
     GetConditionText(size_t *hash = nullptr) const;
+
+    //------------------------------------------------------------------
+    /// Let the process update the conditions of this location's
+    /// breakpoint site after the condition changed, for processes that
+    /// evaluate them without stopping.
+    //------------------------------------------------------------------
+    void
+    UpdateBreakpointSiteConditions ();
     
     bool
     ConditionSaysStop (ExecutionContext &exe_ctx, Error &error);
@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/lldb-private.h"
@@ -138,7 +140,39 @@ public:
     virtual lldb::BreakpointResolverSP
     CopyForBreakpoint (Breakpoint &breakpoint) = 0;
 
+    //------------------------------------------------------------------
+    /// Return true if the resolver's searches only read from the modules
+    /// they search, so searches in different modules can run
+    /// concurrently when their locations are deferred.
+    //------------------------------------------------------------------
+    virtual bool
+    SupportsDeferredLocations () const
+    {
+        return false;
+    }
+
+    //------------------------------------------------------------------
+    /// Have the locations the resolver finds appended to \a locations
+    /// instead of being added to the breakpoint, or add them again if
+    /// \a locations is NULL.
+    //------------------------------------------------------------------
+    void
+    SetDeferredLocations (std::vector<Breakpoint::DeferredLocation> *locations)
+    {
+        m_deferred_locations = locations;
+    }
+
 protected:
+    //------------------------------------------------------------------
+    /// Add a location at \a addr to the breakpoint, or defer it if
+    /// SetDeferredLocations() was called.
+    ///
+    /// @return
+    ///     The location, or an empty shared pointer if it was deferred.
+    //------------------------------------------------------------------
+    lldb::BreakpointLocationSP
+    AddLocation (const Address &addr, bool *new_location = nullptr, LazyBool is_reexported = eLazyBoolCalculate);
+
     //------------------------------------------------------------------
     /// SetSCMatchesByLine - Takes a symbol context list of matches which supposedly represent the same file and
     /// line number in a CU, and find the nearest actual line number that matches, and then filter down the
@@ -147,6 +181,7 @@ protected:
     void SetSCMatchesByLine (SearchFilter &filter, SymbolContextList &sc_list, bool skip_prologue, const char *log_ident);
     
     Breakpoint *m_breakpoint;  // This is the breakpoint we add locations to.
+    std::vector<Breakpoint::DeferredLocation> *m_deferred_locations; // Set on the copies that run the deferred searches
 
 private:
     // Subclass identifier (for llvm isa/dyn_cast)
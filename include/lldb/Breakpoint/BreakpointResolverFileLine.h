@@ -61,6 +61,12 @@ public:
     lldb::BreakpointResolverSP
     CopyForBreakpoint (Breakpoint &breakpoint) override;
 
+    bool
+    SupportsDeferredLocations () const override
+    {
+        return true;
+    }
+
 protected:
     friend class Breakpoint;
     FileSpec m_file_spec; // This is the file spec we are looking for.
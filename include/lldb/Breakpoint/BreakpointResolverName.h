@@ -92,6 +92,12 @@ public:
     lldb::BreakpointResolverSP
     CopyForBreakpoint (Breakpoint &breakpoint) override;
 
+    bool
+    SupportsDeferredLocations () const override
+    {
+        return true;
+    }
+
 protected:
     BreakpointResolverName(const BreakpointResolverName &rhs);
 
@@ -482,6 +482,22 @@ public:
     static size_t
     StaticMemorySize ();
 
+    //------------------------------------------------------------------
+    /// Counters for the global string pool, used to measure how often
+    /// strings are found in the per-thread caches and how contended the
+    /// shared pool is.
+    //------------------------------------------------------------------
+    struct PoolStatistics
+    {
+        uint64_t thread_cache_hits;  // Strings found in the calling thread's cache (updated in batches)
+        uint64_t pool_lookups;       // Strings looked up in the shared pool
+        uint64_t pool_insertions;    // Strings added to the shared pool
+        uint64_t contended_lookups;  // Pool lookups that had to wait for another thread
+    };
+
+    static PoolStatistics
+    GetPoolStatistics ();
+
 protected:
     //------------------------------------------------------------------
     // Member variables
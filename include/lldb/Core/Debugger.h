@@ -351,6 +351,9 @@ public:
     bool
     SetTabSize (uint32_t tab_size);
 
+    uint32_t
+    GetTaskPoolThreads () const;
+
     bool
     GetEscapeNonPrintables () const;
     
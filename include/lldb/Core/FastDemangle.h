@@ -10,8 +10,16 @@
 #ifndef liblldb_FastDemangle_h_
 #define liblldb_FastDemangle_h_
 
+#include <stdint.h>
+
 namespace lldb_private
 {
+    //------------------------------------------------------------------
+    // The version of the names produced by FastDemangle(). Demangled
+    // names cached on disk are only reused by the same version, so bump
+    // this whenever the demangled text of any name changes.
+    //------------------------------------------------------------------
+    const uint32_t FastDemangleVersion = 1;
 
     char *
     FastDemangle(const char *mangled_name);
@@ -14,6 +14,7 @@
 // C++ Includes
 #include <atomic>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 // Other libraries and framework includes
@@ -365,6 +366,39 @@ public:
                    bool append, 
                    SymbolContextList& sc_list);
 
+    //------------------------------------------------------------------
+    /// Check if FindFunctions could find anything for \a name.
+    ///
+    /// The names the symbol file and the symbol table can find functions
+    /// by are collected in a set the first time this is called, so
+    /// modules that don't define \a name can be skipped without
+    /// searching them.
+    ///
+    /// @param[in] name
+    ///     A name that was already prepared for lookup with
+    ///     PrepareForFunctionNameLookup().
+    ///
+    /// @return
+    ///     \b false if the module certainly has no function or symbol
+    ///     called \a name, \b true if it might.
+    //------------------------------------------------------------------
+    bool
+    MayContainFunctionName (const ConstString &name);
+
+    //------------------------------------------------------------------
+    /// Check if any compile unit of the module, or any file it includes,
+    /// has the same filename as \a file_spec.
+    ///
+    /// The filenames of the compile units and their support files are
+    /// collected in a set the first time this is called.
+    ///
+    /// @return
+    ///     \b false if no line table of the module can refer to
+    ///     \a file_spec, \b true if one might.
+    //------------------------------------------------------------------
+    bool
+    MayContainSourceFile (const FileSpec &file_spec);
+
     //------------------------------------------------------------------
     /// Find addresses by file/line
     ///
@@ -1122,6 +1156,10 @@ protected:
     TypeSystemMap               m_type_system_map;    ///< A map of any type systems associated with this module
     PathMappingList             m_source_mappings; ///< Module specific source remappings for when you have debug info for a module that doesn't match where the sources currently are
     lldb::SectionListUP         m_sections_ap; ///< Unified section list for module that is used by the ObjectFile and and ObjectFile instances for the debug info
+    std::unordered_set<const char *> m_function_names;     ///< The names FindFunctions can match, see MayContainFunctionName()
+    std::unordered_set<const char *> m_source_file_names;  ///< The filenames of all compile units and support files, see MayContainSourceFile()
+    LazyBool                    m_has_function_names;     ///< eLazyBoolNo if the symbol file can't enumerate its function names
+    LazyBool                    m_has_source_file_names;
 
     std::atomic<bool>           m_did_load_objfile;
     std::atomic<bool>           m_did_load_symbol_vendor;
@@ -13,6 +13,7 @@
 // C Includes
 // C++ Includes
 #include <algorithm>
+#include <iterator>
 #include <vector>
 
 // Other libraries and framework includes
@@ -299,6 +300,21 @@ public:
         std::sort (m_map.begin(), m_map.end());
     }
     
+    //------------------------------------------------------------------
+    // Merge the entries of "other" into this map. Both maps must be
+    // sorted, and this map stays sorted without being sorted again.
+    //------------------------------------------------------------------
+    void
+    Merge (const UniqueCStringMap &other)
+    {
+        if (other.m_map.empty())
+            return;
+        collection merged;
+        merged.reserve (m_map.size() + other.m_map.size());
+        std::merge (m_map.begin(), m_map.end(), other.m_map.begin(), other.m_map.end(), std::back_inserter (merged));
+        m_map.swap (merged);
+    }
+
     //------------------------------------------------------------------
     // Since we are using a vector to contain our items it will always 
     // double its memory consumption as things are added to the vector,
@@ -160,6 +160,10 @@ protected:
     uint32_t
     GetMaxNumChildrenToPrint (bool& print_dotdotdot);
     
+    void
+    PrefetchChildPointees (size_t num_children,
+                           const DumpValueObjectOptions::PointerDepth& curr_ptr_depth);
+    
     void
     PrintChildren (bool value_printed,
                    bool summary_printed,
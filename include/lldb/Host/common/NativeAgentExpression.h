@@ -0,0 +1,119 @@
+//===-- NativeAgentExpression.h ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_NativeAgentExpression_h_
+#define liblldb_NativeAgentExpression_h_
+
+#include <vector>
+
+#include "lldb/lldb-types.h"
+#include "lldb/Core/Error.h"
+
+namespace lldb_private
+{
+    class NativeProcessProtocol;
+    class NativeThreadProtocol;
+    struct NativeCollectSample;
+
+    //----------------------------------------------------------------------
+    /// @class NativeAgentExpression NativeAgentExpression.h "lldb/Host/common/NativeAgentExpression.h"
+    /// @brief A GDB remote protocol agent expression.
+    ///
+    /// Agent expressions are the stack machine bytecode the debugger sends
+    /// along with breakpoint conditions, so the condition can be checked
+    /// in the stub without reporting every hit. Only the integer subset of
+    /// the bytecode is supported: constants, register and memory loads,
+    /// arithmetic, comparisons and jumps, and the trace opcodes used by
+    /// breakpoint commands to collect memory. Multi-byte immediates are big
+    /// endian and jump targets are offsets from the start of the bytecode.
+    //----------------------------------------------------------------------
+    class NativeAgentExpression
+    {
+    public:
+        enum Opcode
+        {
+            eOpAdd          = 0x02,
+            eOpSub          = 0x03,
+            eOpMul          = 0x04,
+            eOpDivSigned    = 0x05,
+            eOpDivUnsigned  = 0x06,
+            eOpRemSigned    = 0x07,
+            eOpRemUnsigned  = 0x08,
+            eOpLsh          = 0x09,
+            eOpRshSigned    = 0x0a,
+            eOpRshUnsigned  = 0x0b,
+            eOpTrace        = 0x0c,
+            eOpTraceQuick   = 0x0d, // 1 byte: number of bytes to collect at the address on top of the stack
+            eOpLogNot       = 0x0e,
+            eOpBitAnd       = 0x0f,
+            eOpBitOr        = 0x10,
+            eOpBitXor       = 0x11,
+            eOpBitNot       = 0x12,
+            eOpEqual        = 0x13,
+            eOpLessSigned   = 0x14,
+            eOpLessUnsigned = 0x15,
+            eOpExt          = 0x16, // 1 byte: bit width of the signed value on top of the stack
+            eOpRef8         = 0x17,
+            eOpRef16        = 0x18,
+            eOpRef32        = 0x19,
+            eOpRef64        = 0x1a,
+            eOpIfGoto       = 0x20, // 2 bytes: jump target if the popped value is non-zero
+            eOpGoto         = 0x21, // 2 bytes: jump target
+            eOpConst8       = 0x22,
+            eOpConst16      = 0x23,
+            eOpConst32      = 0x24,
+            eOpConst64      = 0x25,
+            eOpReg          = 0x26, // 2 bytes: register number
+            eOpEnd          = 0x27,
+            eOpDup          = 0x28,
+            eOpPop          = 0x29,
+            eOpZeroExt      = 0x2a, // 1 byte: bit width of the value on top of the stack
+            eOpSwap         = 0x2b,
+            eOpTrace16      = 0x30, // 2 bytes: number of bytes to collect at the address on top of the stack
+            eOpPick         = 0x32, // 1 byte: depth of the stack entry to copy
+            eOpRot          = 0x33
+        };
+
+        NativeAgentExpression (std::vector<uint8_t> &&bytecode);
+
+        const std::vector<uint8_t> &
+        GetBytecode () const
+        {
+            return m_bytecode;
+        }
+
+        //------------------------------------------------------------------
+        /// Run the expression in the context of a stopped thread.
+        ///
+        /// Register numbers are indexes into the register context of
+        /// \a thread and memory is read from \a process with any software
+        /// breakpoint traps removed.
+        ///
+        /// @param[out] result
+        ///     The value on top of the stack when the expression ends.
+        ///
+        /// @param[in] sample
+        ///     If not NULL, the registers the expression reads and the
+        ///     memory passed to the trace opcodes are recorded in it.
+        ///     Otherwise the trace opcodes only pop their operands.
+        ///
+        /// @return
+        ///     An error if the bytecode is malformed or a register or
+        ///     memory location can't be read.
+        //------------------------------------------------------------------
+        Error
+        Evaluate (NativeProcessProtocol &process, NativeThreadProtocol &thread, uint64_t &result,
+                  NativeCollectSample *sample = nullptr) const;
+
+    private:
+        std::vector<uint8_t> m_bytecode;
+    };
+}
+
+#endif // ifndef liblldb_NativeAgentExpression_h_
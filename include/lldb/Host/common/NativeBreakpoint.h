@@ -10,11 +10,15 @@
 #ifndef liblldb_NativeBreakpoint_h_
 #define liblldb_NativeBreakpoint_h_
 
+#include <vector>
+
 #include "lldb/lldb-types.h"
+#include "lldb/Host/common/NativeAgentExpression.h"
 
 namespace lldb_private
 {
     class NativeBreakpointList;
+    struct NativeCollectSample;
 
     class NativeBreakpoint
     {
@@ -42,6 +46,46 @@ namespace lldb_private
         virtual bool
         IsSoftwareBreakpoint () const = 0;
 
+        //------------------------------------------------------------------
+        /// Replace the conditions sent by the debugger for this breakpoint.
+        //------------------------------------------------------------------
+        void
+        SetConditions (std::vector<NativeAgentExpression> &&conditions);
+
+        bool
+        HasConditions () const { return !m_conditions.empty (); }
+
+        //------------------------------------------------------------------
+        /// Check whether a hit of this breakpoint by \a thread should be
+        /// reported.
+        ///
+        /// @return
+        ///     false only if the breakpoint has conditions and all of them
+        ///     evaluate to zero. A condition that fails to evaluate says
+        ///     stop, so the debugger can evaluate it instead.
+        //------------------------------------------------------------------
+        bool
+        ConditionsSayStop (NativeProcessProtocol &process, NativeThreadProtocol &thread) const;
+
+        //------------------------------------------------------------------
+        /// Replace the commands sent by the debugger for this breakpoint.
+        /// A breakpoint with commands runs them when its conditions say
+        /// stop, and the hit is never reported.
+        //------------------------------------------------------------------
+        void
+        SetCommands (std::vector<NativeAgentExpression> &&commands);
+
+        bool
+        HasCommands () const { return !m_commands.empty (); }
+
+        //------------------------------------------------------------------
+        /// Run the commands for a hit by \a thread, collecting what they
+        /// trace into \a sample. A command that fails doesn't prevent the
+        /// others from running.
+        //------------------------------------------------------------------
+        void
+        RunCommands (NativeProcessProtocol &process, NativeThreadProtocol &thread, NativeCollectSample &sample) const;
+
     protected:
         const lldb::addr_t m_addr;
         int32_t m_ref_count;
@@ -54,6 +98,8 @@ namespace lldb_private
 
     private:
         bool m_enabled;
+        std::vector<NativeAgentExpression> m_conditions;
+        std::vector<NativeAgentExpression> m_commands;
 
         // -----------------------------------------------------------
         // interface for NativeBreakpointList
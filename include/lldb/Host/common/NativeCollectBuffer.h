@@ -0,0 +1,105 @@
+//===-- NativeCollectBuffer.h -----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_NativeCollectBuffer_h_
+#define liblldb_NativeCollectBuffer_h_
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "lldb/lldb-types.h"
+#include "lldb/Host/Mutex.h"
+
+namespace lldb_private
+{
+    //----------------------------------------------------------------------
+    /// @class NativeCollectSample
+    /// @brief The registers and memory collected by the commands of a
+    /// breakpoint for a single hit.
+    //----------------------------------------------------------------------
+    struct NativeCollectSample
+    {
+        struct MemoryBlock
+        {
+            lldb::addr_t addr;
+            std::vector<uint8_t> bytes;
+        };
+
+        NativeCollectSample (uint64_t id, lldb::tid_t tid, lldb::addr_t addr) :
+            id (id),
+            tid (tid),
+            addr (addr),
+            registers (),
+            memory ()
+        {
+        }
+
+        // The size the sample is accounted for in the buffer.
+        size_t
+        GetByteSize () const;
+
+        uint64_t id;        // Increases by one for every hit, gaps are dropped samples
+        lldb::tid_t tid;
+        lldb::addr_t addr;  // Address of the breakpoint
+        std::map<uint32_t, std::vector<uint8_t>> registers; // Keyed by register index
+        std::vector<MemoryBlock> memory;
+    };
+
+    //----------------------------------------------------------------------
+    /// @class NativeCollectBuffer NativeCollectBuffer.h "lldb/Host/common/NativeCollectBuffer.h"
+    /// @brief A bounded buffer of collected samples.
+    ///
+    /// The buffer behaves as a ring: once the total size of the samples
+    /// exceeds the capacity, the oldest ones are discarded. The debugger
+    /// drains it in bulk, so nothing is sent while the breakpoints are
+    /// being hit.
+    //----------------------------------------------------------------------
+    class NativeCollectBuffer
+    {
+    public:
+        NativeCollectBuffer (size_t capacity);
+
+        // Create the sample for the next hit, its id is reserved even if
+        // it is never added.
+        NativeCollectSample
+        CreateSample (lldb::tid_t tid, lldb::addr_t addr);
+
+        void
+        AddSample (NativeCollectSample &&sample);
+
+        //------------------------------------------------------------------
+        /// Remove the oldest samples from the buffer.
+        ///
+        /// @param[in] max_bytes
+        ///     Stop before the accounted size of the removed samples
+        ///     exceeds this, though at least one sample is removed if the
+        ///     buffer is not empty.
+        ///
+        /// @param[out] dropped
+        ///     The number of samples discarded because the buffer was full
+        ///     since the last call.
+        //------------------------------------------------------------------
+        void
+        Drain (size_t max_bytes, std::vector<NativeCollectSample> &samples, uint64_t &dropped);
+
+        void
+        Clear ();
+
+    private:
+        Mutex m_mutex;
+        const size_t m_capacity;
+        size_t m_byte_size;
+        uint64_t m_next_id;
+        uint64_t m_dropped;
+        std::deque<NativeCollectSample> m_samples;
+    };
+}
+
+#endif // ifndef liblldb_NativeCollectBuffer_h_
@@ -10,6 +10,7 @@
 #ifndef liblldb_NativeProcessProtocol_h_
 #define liblldb_NativeProcessProtocol_h_
 
+#include <string>
 #include <vector>
 
 #include "lldb/lldb-private-forward.h"
@@ -19,7 +20,9 @@
 #include "lldb/Host/MainLoop.h"
 #include "llvm/ADT/StringRef.h"
 
+#include "NativeAgentExpression.h"
 #include "NativeBreakpointList.h"
+#include "NativeCollectBuffer.h"
 #include "NativeWatchpointList.h"
 
 namespace lldb_private
@@ -81,6 +84,30 @@ namespace lldb_private
         virtual Error
         Kill () = 0;
 
+        //------------------------------------------------------------------
+        /// Enable or disable non-stop mode.
+        ///
+        /// In non-stop mode a thread that stops for a breakpoint, a step
+        /// or a signal is reported on its own with
+        /// NativeDelegate::ThreadStopped() while the other threads keep
+        /// running, and Resume() only affects the threads that have an
+        /// action. The process is only marked stopped once all of its
+        /// threads are stopped.
+        ///
+        /// The default implementation doesn't support non-stop mode.
+        ///
+        /// @return
+        ///     Returns an error object.
+        //------------------------------------------------------------------
+        virtual Error
+        SetNonStopMode (bool enable);
+
+        bool
+        IsNonStopMode () const
+        {
+            return m_non_stop;
+        }
+
         //----------------------------------------------------------------------
         // Memory and memory region functions
         //----------------------------------------------------------------------
@@ -94,6 +121,37 @@ namespace lldb_private
         virtual Error
         ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read) = 0;
 
+        //------------------------------------------------------------------
+        /// Read several, possibly scattered, memory ranges at once.
+        ///
+        /// Plug-ins should override this when the host can read many
+        /// ranges with fewer system calls than one ReadMemory per range.
+        ///
+        /// @param[in] ranges
+        ///     The address and size of each range to read.
+        ///
+        /// @param[out] buf
+        ///     A buffer at least as large as all ranges together, which
+        ///     receives the bytes of the ranges one after the other.
+        ///
+        /// @param[out] bytes_read
+        ///     The number of bytes read from the start of each range. A
+        ///     range that can't be read completely doesn't fail the others.
+        //------------------------------------------------------------------
+        virtual Error
+        ReadMemoryRanges (const std::vector<std::pair<lldb::addr_t, size_t> > &ranges,
+                          void *buf,
+                          std::vector<size_t> &bytes_read);
+
+        //------------------------------------------------------------------
+        /// Like ReadMemoryRanges, with software breakpoint opcodes replaced
+        /// like ReadMemoryWithoutTrap does.
+        //------------------------------------------------------------------
+        Error
+        ReadMemoryRangesWithoutTrap (const std::vector<std::pair<lldb::addr_t, size_t> > &ranges,
+                                     void *buf,
+                                     std::vector<size_t> &bytes_read);
+
         virtual Error
         WriteMemory(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written) = 0;
 
@@ -106,6 +164,43 @@ namespace lldb_private
         virtual lldb::addr_t
         GetSharedLibraryInfoAddress () = 0;
 
+        //----------------------------------------------------------------------
+        // Shared library functions
+        //----------------------------------------------------------------------
+        struct SVR4LibraryInfo
+        {
+            std::string name;         // l_name of the link_map entry
+            lldb::addr_t link_map;    // Address of the link_map entry
+            lldb::addr_t base_addr;   // l_addr, the load bias of the object
+            lldb::addr_t ld_addr;     // l_ld, the address of its dynamic section
+        };
+
+        //------------------------------------------------------------------
+        /// Walk the link map the dynamic linker keeps in its r_debug
+        /// structure.
+        ///
+        /// @param[in] start_link_map
+        ///     If not LLDB_INVALID_ADDRESS, the walk starts at this link_map
+        ///     entry instead of at the head of the list. This lets clients
+        ///     fetch only the entries appended since they last looked.
+        ///
+        /// @param[in] prev_link_map
+        ///     If not LLDB_INVALID_ADDRESS, the expected l_prev of
+        ///     \a start_link_map. The walk fails if it doesn't match, as
+        ///     the list changed under the client.
+        ///
+        /// @param[out] main_link_map
+        ///     The head of the link map, which is the executable's entry.
+        ///
+        /// @param[out] library_list
+        ///     The link map entries in list order.
+        //------------------------------------------------------------------
+        virtual Error
+        GetLoadedSVR4Libraries (lldb::addr_t start_link_map,
+                                lldb::addr_t prev_link_map,
+                                lldb::addr_t &main_link_map,
+                                std::vector<SVR4LibraryInfo> &library_list);
+
         virtual bool
         IsAlive () const;
 
@@ -130,6 +225,38 @@ namespace lldb_private
         virtual Error
         DisableBreakpoint (lldb::addr_t addr);
 
+        //------------------------------------------------------------------
+        /// Replace the conditions of the breakpoint at \a addr. Processes
+        /// that evaluate breakpoint conditions only report hits for which
+        /// at least one of them is true, others report every hit.
+        //------------------------------------------------------------------
+        Error
+        SetBreakpointConditions (lldb::addr_t addr, std::vector<NativeAgentExpression> &&conditions);
+
+        //------------------------------------------------------------------
+        /// Replace the commands of the breakpoint at \a addr. Hits of a
+        /// breakpoint with commands run them and resume the thread without
+        /// being reported, which only processes that can step a thread off
+        /// a breakpoint by themselves support.
+        //------------------------------------------------------------------
+        Error
+        SetBreakpointCommands (lldb::addr_t addr, std::vector<NativeAgentExpression> &&commands);
+
+        virtual bool
+        SupportsBreakpointCommands () const
+        {
+            return false;
+        }
+
+        //------------------------------------------------------------------
+        /// The samples collected by the commands of breakpoints.
+        //------------------------------------------------------------------
+        NativeCollectBuffer &
+        GetCollectBuffer ()
+        {
+            return m_collect_buffer;
+        }
+
         //----------------------------------------------------------------------
         // Watchpoint functions
         //----------------------------------------------------------------------
@@ -247,6 +374,9 @@ namespace lldb_private
 
             virtual void
             DidExec (NativeProcessProtocol *process) = 0;
+
+            virtual void
+            ThreadStopped (NativeProcessProtocol *process, lldb::tid_t tid) = 0;
         };
 
         //------------------------------------------------------------------
@@ -376,8 +506,10 @@ namespace lldb_private
         std::vector<NativeDelegate*> m_delegates;
         NativeBreakpointList m_breakpoint_list;
         NativeWatchpointList m_watchpoint_list;
+        NativeCollectBuffer m_collect_buffer;
         int m_terminal_fd;
         uint32_t m_stop_id;
+        bool m_non_stop;
 
         // -----------------------------------------------------------
         // Internal interface for state handling
@@ -403,6 +535,11 @@ namespace lldb_private
         virtual Error
         GetSoftwareBreakpointTrapOpcode (size_t trap_opcode_size_hint, size_t &actual_opcode_size, const uint8_t *&trap_opcode_bytes) = 0;
 
+        // Run the commands of a breakpoint hit by a stopped thread and add
+        // what they collect to the collect buffer.
+        void
+        RunBreakpointCommands (NativeBreakpoint &breakpoint, NativeThreadProtocol &thread);
+
         // -----------------------------------------------------------
         /// Notify the delegate that an exec occurred.
         ///
@@ -412,6 +549,13 @@ namespace lldb_private
         void
         NotifyDidExec ();
 
+        // -----------------------------------------------------------
+        /// Notify the delegate that a single thread stopped while in
+        /// non-stop mode.
+        // -----------------------------------------------------------
+        void
+        NotifyThreadStopped (lldb::tid_t tid);
+
         NativeThreadProtocolSP
         GetThreadByIDUnlocked (lldb::tid_t tid);
 
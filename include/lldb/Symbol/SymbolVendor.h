@@ -10,6 +10,7 @@
 #ifndef liblldb_SymbolVendor_h_
 #define liblldb_SymbolVendor_h_
 
+#include <unordered_set>
 #include <vector>
 
 #include "lldb/lldb-private.h"
@@ -123,6 +124,9 @@ public:
                    bool append,
                    SymbolContextList& sc_list);
 
+    virtual bool
+    GetFunctionNames (std::unordered_set<const char *> &names);
+
     virtual size_t
     FindTypes (const SymbolContext& sc, 
                const ConstString &name,
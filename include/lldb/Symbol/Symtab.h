@@ -11,6 +11,8 @@
 #ifndef liblldb_Symtab_h_
 #define liblldb_Symtab_h_
 
+#include <map>
+#include <unordered_set>
 #include <vector>
 
 #include "lldb/lldb-private.h"
@@ -82,6 +84,7 @@ public:
             Symbol *    FindSymbolContainingFileAddress (lldb::addr_t file_addr, const uint32_t* indexes, uint32_t num_indexes);
             Symbol *    FindSymbolContainingFileAddress (lldb::addr_t file_addr);
             size_t      FindFunctionSymbols (const ConstString &name, uint32_t name_type_mask, SymbolContextList& sc_list);
+            void        AppendFunctionSymbolNames (std::unordered_set<const char *> &names);
             void        CalculateSymbolSizes ();
 
             void        SortSymbolIndexesByValue (std::vector<uint32_t>& indexes, bool remove_duplicates) const;
@@ -113,7 +116,35 @@ protected:
     typedef collection::iterator        iterator;
     typedef collection::const_iterator  const_iterator;
     typedef RangeDataVector<lldb::addr_t, lldb::addr_t, uint32_t> FileRangeToIndexMap;
-            void        InitNameIndexes ();
+    enum { kNameIndexChunkSize = 16 * 1024 };
+    //------------------------------------------------------------------
+    // The names found in a contiguous range of symbols while building the
+    // name indexes. Chunks are filled in parallel and then merged in
+    // symbol order by InitNameIndexes().
+    //------------------------------------------------------------------
+    struct NameIndexChunk
+    {
+        struct CxxMethodEntry
+        {
+            NameToIndexMap::Entry entry;
+            const char *context;    // nullptr if "entry" is known to be a method
+        };
+
+        std::vector<NameToIndexMap::Entry> names;
+        std::vector<NameToIndexMap::Entry> selectors;
+        std::vector<NameToIndexMap::Entry> basenames;
+        std::vector<CxxMethodEntry> methods;
+        std::map<const char *, uint32_t> class_contexts;    // Class context to first symbol index
+    };
+
+            //------------------------------------------------------------------
+            // Build the name indexes. The names of each "chunk_size"
+            // consecutive symbols are indexed by a single task.
+            //------------------------------------------------------------------
+            void        InitNameIndexes (size_t chunk_size = kNameIndexChunkSize);
+            void        IndexSymbolNames (uint32_t begin, uint32_t end, NameIndexChunk &chunk);
+            bool        LoadDemangledNameCache ();
+            void        SaveDemangledNameCache ();
             void        InitAddressIndexes ();
 
     ObjectFile *        m_objfile;
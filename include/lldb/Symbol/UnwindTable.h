@@ -11,7 +11,8 @@
 #ifndef liblldb_UnwindTable_h
 #define liblldb_UnwindTable_h
 
-#include <map>
+#include <utility>
+#include <vector>
 
 #include "lldb/lldb-private.h" 
 #include "lldb/Host/Mutex.h"
@@ -58,7 +59,10 @@ private:
     
     void Initialize ();
 
-    typedef std::map<lldb::addr_t, lldb::FuncUnwindersSP> collection;
+    // Sorted by the file address of the functions. Only the functions that
+    // are unwound get an entry, so insertions are rare compared to lookups.
+    typedef std::pair<lldb::addr_t, lldb::FuncUnwindersSP> collection_entry;
+    typedef std::vector<collection_entry> collection;
     typedef collection::iterator iterator;
     typedef collection::const_iterator const_iterator;
 
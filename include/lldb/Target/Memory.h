@@ -48,6 +48,15 @@ namespace lldb_private {
               void *dst, 
               size_t dst_len,
               Error &error);
+
+        //------------------------------------------------------------------
+        // Read the memory of all given (address, size) ranges that isn't
+        // cached yet with as few reads from the process as possible.
+        // Ranges up to the cache line size go into the L2 cache, larger
+        // ones into the L1 cache, just like Read() would cache them.
+        //------------------------------------------------------------------
+        void
+        Prefetch (const std::vector<std::pair<lldb::addr_t, size_t> > &ranges);
         
         uint32_t
         GetMemoryCacheLineSize() const
@@ -59,6 +59,11 @@ class ModuleCache;
         GetModuleCacheDirectory () const;
         bool
         SetModuleCacheDirectory (const FileSpec& dir_spec);
+
+        bool
+        GetUseIndexCache () const;
+        bool
+        SetUseIndexCache (bool use_index_cache);
     };
 
     typedef std::shared_ptr<PlatformProperties> PlatformPropertiesSP;
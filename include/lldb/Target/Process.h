@@ -30,6 +30,7 @@
 #include "lldb/Core/Communication.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Event.h"
+#include "lldb/Core/LoadedModuleInfoList.h"
 #include "lldb/Core/ThreadSafeValue.h"
 #include "lldb/Core/PluginInterface.h"
 #include "lldb/Core/StructuredData.h"
@@ -44,6 +45,7 @@
 #include "lldb/Target/ProcessLaunchInfo.h"
 #include "lldb/Target/QueueList.h"
 #include "lldb/Target/ThreadList.h"
+#include "lldb/Target/UnwindSymbolCache.h"
 #include "lldb/Target/InstrumentationRuntime.h"
 
 namespace lldb_private {
@@ -1152,6 +1154,33 @@ public:
         return 0;
     }
 
+    //------------------------------------------------------------------
+    /// Query the process plug-in for the shared libraries loaded in the
+    /// process, for plug-ins that can get them cheaper than a dynamic
+    /// loader walking the inferior's memory.
+    ///
+    /// @param[out] list
+    ///     The loaded libraries.
+    ///
+    /// @param[in] start_link_map
+    ///     If not LLDB_INVALID_ADDRESS, only list the SVR4 link map
+    ///     entries starting at this one.
+    ///
+    /// @param[in] prev_link_map
+    ///     If not LLDB_INVALID_ADDRESS, the link map entry that is
+    ///     expected to precede \a start_link_map.
+    ///
+    /// @return
+    ///     An error if the plug-in can't report the libraries.
+    //------------------------------------------------------------------
+    virtual Error
+    GetLoadedModuleList (LoadedModuleInfoList &list,
+                         lldb::addr_t start_link_map,
+                         lldb::addr_t prev_link_map)
+    {
+        return Error ("not supported");
+    }
+
 protected:
     virtual JITLoaderList &
     GetJITLoaders ();
@@ -2100,6 +2129,28 @@ public:
                   size_t size,
                   Error &error) = 0;
 
+    typedef std::vector<std::pair<lldb::addr_t, size_t> > MemoryRangeList;
+
+    //------------------------------------------------------------------
+    /// Actually read several, possibly discontiguous, ranges of memory
+    /// from a process.
+    ///
+    /// The default implementation reads the ranges one at a time with
+    /// DoReadMemory. Subclasses that pay a round trip for every read,
+    /// like remote processes, can override this to read them at once.
+    ///
+    /// @param[in] ranges
+    ///     The address and size of each range to read.
+    ///
+    /// @param[out] buffers
+    ///     One buffer per range with the bytes that could be read from
+    ///     the start of the range, which may be fewer than requested.
+    ///     The buffer is empty if nothing could be read.
+    //------------------------------------------------------------------
+    virtual void
+    DoReadMemoryRanges (const MemoryRangeList &ranges,
+                        std::vector<lldb::DataBufferSP> &buffers);
+
     //------------------------------------------------------------------
     /// Read of memory from a process.
     ///
@@ -2196,6 +2247,26 @@ public:
                             void *buf, 
                             size_t size,
                             Error &error);
+
+    //------------------------------------------------------------------
+    /// Read several ranges of memory from the inferior at once, with
+    /// any inserted traps removed.
+    ///
+    /// @see Process::DoReadMemoryRanges
+    //------------------------------------------------------------------
+    void
+    ReadMemoryRangesFromInferior (const MemoryRangeList &ranges,
+                                  std::vector<lldb::DataBufferSP> &buffers);
+
+    //------------------------------------------------------------------
+    /// Populate the memory cache with the given ranges ahead of time.
+    ///
+    /// Callers that know they are about to read several unrelated
+    /// locations, e.g. a set of pointers, can use this to fetch all of
+    /// them with as few reads from the process as possible.
+    //------------------------------------------------------------------
+    void
+    PrefetchMemory (const MemoryRangeList &ranges);
     
     //------------------------------------------------------------------
     /// Reads an unsigned integer of the specified byte size from 
@@ -2708,6 +2779,17 @@ public:
         return error;
     }
 
+    //------------------------------------------------------------------
+    /// Called when the conditions of the owners of an enabled breakpoint
+    /// site or the owners themselves changed. Process plug-ins that let
+    /// the remote stub evaluate breakpoint conditions resend them here.
+    //------------------------------------------------------------------
+    virtual Error
+    UpdateBreakpointSiteConditions (BreakpointSite *bp_site)
+    {
+        return Error();
+    }
+
     // This is implemented completely using the lldb::Process API. Subclasses
     // don't need to implement this function unless the standard flow of
     // read existing opcode, write breakpoint opcode, verify breakpoint opcode
@@ -2792,6 +2874,14 @@ public:
         return m_thread_list.Threads();
     }
 
+    // The unwinder's symbol lookups for caller frame pcs, shared by all
+    // threads and kept across stops until modules are loaded or unloaded.
+    UnwindSymbolCache &
+    GetUnwindSymbolCache ()
+    {
+        return m_unwind_symbol_cache;
+    }
+
     uint32_t
     GetNextThreadIndexID (uint64_t thread_id);
 
@@ -3348,6 +3438,7 @@ protected:
     Predicate<uint32_t>         m_iohandler_sync;
     MemoryCache                 m_memory_cache;
     AllocatedMemoryCache        m_allocated_memory_cache;
+    UnwindSymbolCache           m_unwind_symbol_cache;     ///< Symbol lookups for caller frame pcs, kept across stops until modules change
     bool                        m_should_detach;   /// Should we detach if the process object goes away with an explicit call to Kill or Detach?
     LanguageRuntimeCollection   m_language_runtimes;
     InstrumentationRuntimeCollection m_instrumentation_runtimes;
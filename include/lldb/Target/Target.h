@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <atomic>
 #include <list>
 #include <map>
 #include <memory>
@@ -969,6 +970,22 @@ public:
     void
     ModulesDidLoad (ModuleList &module_list);
 
+    //------------------------------------------------------------------
+    /// Bracket the addition of several modules, like a dynamic loader
+    /// reporting all the libraries that were loaded since the last stop.
+    ///
+    /// Between the two calls, modules added to the target's image list
+    /// don't get their breakpoints resolved one module at a time.
+    /// EndModuleBatch() calls ModulesDidLoad() once instead, with
+    /// \a module_list and the modules added during the batch that it
+    /// lacks, so the breakpoints are resolved in all of them together.
+    //------------------------------------------------------------------
+    void
+    BeginModuleBatch ();
+
+    void
+    EndModuleBatch (ModuleList &module_list);
+
     void
     ModulesDidUnload (ModuleList &module_list, bool delete_locations);
     
@@ -1586,6 +1603,8 @@ protected:
     bool                    m_valid;
     bool                    m_suppress_stop_hooks;
     bool                    m_is_dummy_target;
+    std::atomic<uint32_t>   m_module_batch_depth;   ///< Nesting level of BeginModuleBatch() calls
+    ModuleList              m_batched_modules;      ///< The modules added during the current module batch
     
     static void
     ImageSearchPathsChanged (const PathMappingList &path_list,
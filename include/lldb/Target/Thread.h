@@ -57,6 +57,9 @@ public:
     
     bool
     GetTraceEnabledState() const;
+
+    bool
+    GetFastUnwind() const;
     
     bool
     GetStepInAvoidsNoDebug () const;
@@ -528,6 +531,14 @@ public:
     virtual void
     ClearStackFrames ();
 
+    //------------------------------------------------------------------
+    /// Drop the current stack frame list but keep the unwinder's frames,
+    /// so that the next request builds a new list from them. Used by the
+    /// unwinder when the frames it handed out so far turn out wrong.
+    //------------------------------------------------------------------
+    void
+    DiscardStackFrameList ();
+
     virtual bool
     SetBackingThread (const lldb::ThreadSP &thread_sp)
     {
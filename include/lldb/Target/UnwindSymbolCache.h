@@ -0,0 +1,83 @@
+//===-- UnwindSymbolCache.h -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_UnwindSymbolCache_h_
+#define liblldb_UnwindSymbolCache_h_
+
+// C Includes
+// C++ Includes
+#include <map>
+#include <utility>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/AddressRange.h"
+#include "lldb/Host/Mutex.h"
+#include "lldb/Symbol/SymbolContext.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+// A cache of the symbol lookups the unwinder does for the pc values of
+// caller frames. The same return addresses show up in the backtraces
+// of every stop, so the results are kept across stops until the set of
+// loaded modules changes.
+//----------------------------------------------------------------------
+class UnwindSymbolCache
+{
+public:
+    struct Entry
+    {
+        Entry () :
+            sym_ctx (),
+            addr_range (),
+            sym_ctx_valid (false),
+            decr_pc (false)
+        {
+        }
+
+        SymbolContext sym_ctx;  // The function or symbol containing the pc
+        AddressRange addr_range;// The address range of sym_ctx
+        bool sym_ctx_valid;
+        bool decr_pc;           // The lookup was redone at pc - 1
+    };
+
+    UnwindSymbolCache ();
+
+    ~UnwindSymbolCache ();
+
+    //------------------------------------------------------------------
+    // Whether the pc had to be backed up depends on the frame below
+    // being an asynchronous frame like a trap handler, so that is part
+    // of the key.
+    //------------------------------------------------------------------
+    bool
+    Lookup (lldb::addr_t pc, bool above_async_frame, Entry &entry);
+
+    void
+    Insert (lldb::addr_t pc, bool above_async_frame, const Entry &entry);
+
+    void
+    Clear ();
+
+protected:
+    typedef std::pair<lldb::addr_t, bool> Key;
+    typedef std::map<Key, Entry> collection;
+
+    Mutex m_mutex;
+    collection m_entries;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (UnwindSymbolCache);
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_UnwindSymbolCache_h_
@@ -27,23 +27,33 @@
 #endif
 
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <functional>
 #include <future>
 #include <list>
-#include <queue>
+#include <mutex>
 #include <thread>
 #include <vector>
 
-// Global TaskPool class for running tasks in parallel on a set of worker thread created the first
-// time the task pool is used. The TaskPool provide no gurantee about the order the task will be run
-// and about what tasks will run in parrallel. None of the task added to the task pool should block
-// on something (mutex, future, condition variable) what will be set only by the completion of an
-// other task on the task pool as they may run on the same thread sequentally.
+// Global TaskPool class for running tasks in parallel on a set of long lived worker threads created
+// the first time the task pool is used. Each worker keeps its own queue of tasks: tasks added from a
+// worker go to the front of that worker's queue, tasks added from other threads go to a shared queue,
+// and idle workers steal tasks from the back of the other workers' queues. The TaskPool provides no
+// guarantee about the order the tasks will be run in and about which tasks will run in parallel.
+//
+// A task may wait for other tasks it added (through WaitForFuture, RunTasks or TaskRunner) because a
+// waiting thread keeps running the pending tasks it added itself until the task it waits for is done.
+// It never runs tasks added by anyone else, which may take locks the waiter already holds. Tasks
+// should not block on anything else (mutex, condition variable) that will be set only by the
+// completion of another task on the task pool.
 class TaskPool
 {
 public:
     // Add a new task to the task pool and return a std::future belonging to the newly created task.
-    // The caller of this function has to wait on the future for this task to complete.
+    // The caller of this function has to wait on the future for this task to complete, preferably
+    // with WaitForFuture.
     template<typename F, typename... Args>
     static std::future<typename std::result_of<F(Args...)>::type>
     AddTask(F&& f, Args&&... args);
@@ -51,11 +61,35 @@ public:
     // Run all of the specified tasks on the task pool and wait until all of them are finished
     // before returning. This method is intended to be used for small number tasks where listing
     // them as function arguments is acceptable. For running large number of tasks you should use
-    // AddTask for each task and then call wait() on each returned future.
+    // AddTask for each task and then call WaitForFuture on each returned future, or use
+    // TaskMapOverInt.
     template<typename... T>
     static void
     RunTasks(T&&... tasks);
 
+    // Wait until the task belonging to the given future is finished. While waiting the calling
+    // thread runs the pending tasks it added itself, so it is safe to call this from a task running
+    // on the pool.
+    template<typename T>
+    static void
+    WaitForFuture(const std::future<T> &future);
+
+    // Run one pending task that was added by the task (or thread) calling this, on the calling
+    // thread. Returns false if there is no such task left to run.
+    static bool
+    RunPendingTask();
+
+    // Get the number of worker threads. Before the pool is started this is the number of threads
+    // it will be started with: the value set by SetThreadCount, otherwise the value of the
+    // LLDB_TASK_POOL_THREADS environment variable, otherwise the number of hardware threads.
+    static uint32_t
+    GetThreadCount();
+
+    // Set the number of worker threads, or 0 to use the default. Only has an effect if it is called
+    // before the first task is added to the pool. Returns false if the pool is already running.
+    static bool
+    SetThreadCount(uint32_t thread_count);
+
 private:
     TaskPool() = delete;
 
@@ -66,6 +100,12 @@ private:
     AddTaskImpl(std::function<void()>&& task_fn);
 };
 
+// Call func(i) for every i in [begin, end) on the task pool and wait until all calls are finished.
+// The indexes are handed out dynamically to at most TaskPool::GetThreadCount() tasks, so func
+// should be reasonably coarse grained, and may be called in any order and from any thread.
+void
+TaskMapOverInt(size_t begin, size_t end, std::function<void(size_t)> const &func);
+
 // Wrapper class around the global TaskPool implementation to make it possible to create a set of
 // tasks and then wait for the tasks to be completed by the WaitForNextCompletedTask call. This
 // class should be used when WaitForNextCompletedTask is needed because this class add no other
@@ -121,6 +161,22 @@ TaskPool::RunTasks(T&&... tasks)
     RunTaskImpl<T...>::Run(std::forward<T>(tasks)...);
 }
 
+template<typename T>
+void
+TaskPool::WaitForFuture(const std::future<T> &future)
+{
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        // If none of our tasks is queued the task we are waiting for is already running on an other
+        // thread and it will finish without our help.
+        if (!RunPendingTask())
+        {
+            future.wait();
+            break;
+        }
+    }
+}
+
 template<typename Head, typename... Tail>
 struct TaskPool::RunTaskImpl<Head, Tail...>
 {
@@ -129,7 +185,7 @@ struct TaskPool::RunTaskImpl<Head, Tail...>
     {
         auto f = AddTask(std::forward<Head>(h));
         RunTaskImpl<Tail...>::Run(std::forward<Tail>(t)...);
-        f.wait();
+        WaitForFuture(f);
     }
 };
 
@@ -194,14 +250,22 @@ TaskRunner<T>::WaitForNextCompletedTask()
     if (m_ready.empty() && m_pending.empty())
         return std::future<T>(); // No more tasks
 
-    if (m_ready.empty())
-        m_cv.wait(lock, [this](){ return !this->m_ready.empty(); });
+    while (m_ready.empty())
+    {
+        // Help running the pending tasks instead of blocking the thread, which may be a worker of the
+        // task pool itself.
+        lock.unlock();
+        const bool ran_task = TaskPool::RunPendingTask();
+        lock.lock();
+        if (!ran_task)
+            m_cv.wait(lock, [this](){ return !this->m_ready.empty(); });
+    }
 
     std::future<T> res = std::move(m_ready.front());
     m_ready.pop_front();
     
     lock.unlock();
-    res.wait();
+    TaskPool::WaitForFuture(res);
 
     return std::move(res);
 }
@@ -622,7 +622,8 @@ namespace lldb {
         eSectionTypeARMextab,
         eSectionTypeCompactUnwind,        // compact unwind section in Mach-O, __TEXT,__unwind_info
         eSectionTypeGoSymtab,
-        eSectionTypeOther
+        eSectionTypeOther,
+        eSectionTypeDWARFGdbIndex         // .gdb_index accelerator table
     };
 
     FLAGS_ENUM(EmulateInstructionOptions)
@@ -0,0 +1,78 @@
+"""
+Test that the summaries of the function names and source files of a module
+skip the modules that can't match a breakpoint, and only those.
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.lldbutil as lldbutil
+
+class ModuleSummariesTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.main_line = line_number('main.cpp', '// Set main breakpoint here.')
+        self.other_line = line_number('other.cpp', '// Set other breakpoint here.')
+        self.common_line = line_number('common.h', '// Set common breakpoint here.')
+        self.shlib_names = ["other"]
+
+    def location_modules(self, breakpoint):
+        """Return the names of the modules of the breakpoint's locations."""
+        return sorted([breakpoint.GetLocationAtIndex(i).GetAddress().GetModule().GetFileSpec().GetFilename()
+                       for i in range(breakpoint.GetNumLocations())])
+
+    @skipIfWindows # The shared library is not found on startup, and the names are Itanium mangled.
+    def test(self):
+        """Test the positives and negatives of the module name and source file summaries."""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        main_breakpoint = target.BreakpointCreateByLocation("main.cpp", self.main_line)
+        self.assertTrue(main_breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+
+        environment = self.registerSharedLibrariesWithTarget(target, self.shlib_names)
+        process = target.LaunchSimple(None, environment, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, main_breakpoint)
+        self.assertEqual(1, len(threads))
+
+        exe_name = "a.out"
+        lib_name = self.platformContext.shlib_prefix + "other." + self.platformContext.shlib_extension
+
+        # Each name is found in the module that defines it and no other,
+        # whichever form of the name is used.
+        self.assertEqual([exe_name], self.location_modules(target.BreakpointCreateByName("main_only_function")))
+        for name in ["other_function",
+                     "other_ns::other_function",
+                     "other_method",
+                     "OtherClass::other_method",
+                     "other_ns::OtherClass::other_method",
+                     "_ZN8other_ns10OtherClass12other_methodEi"]:
+            self.assertEqual([lib_name], self.location_modules(target.BreakpointCreateByName(name)), name)
+
+        # Names that are only in the symbol table are found as well.
+        printf_modules = self.location_modules(target.BreakpointCreateByName("printf"))
+        self.assertTrue(any(module.startswith("libc") for module in printf_modules), str(printf_modules))
+
+        # Source files are found in the modules with a compile unit for
+        # them, or whose compile units include them.
+        self.assertEqual([exe_name], self.location_modules(target.BreakpointCreateByLocation("main.cpp", self.main_line)))
+        self.assertEqual([lib_name], self.location_modules(target.BreakpointCreateByLocation("other.cpp", self.other_line)))
+        self.assertEqual([lib_name], self.location_modules(target.BreakpointCreateByLocation(
+            os.path.join(os.getcwd(), "other.cpp"), self.other_line)))
+        self.assertEqual(sorted([exe_name, lib_name]), self.location_modules(target.BreakpointCreateByLocation("common.h", self.common_line)))
+
+        # Nothing is found for names and files that no module has.
+        self.assertEqual([], self.location_modules(target.BreakpointCreateByName("no_such_function")))
+        self.assertEqual([], self.location_modules(target.BreakpointCreateByName("other_ns::no_such_function")))
+        self.assertEqual([], self.location_modules(target.BreakpointCreateByLocation("no_such_file.cpp", 1)))
@@ -0,0 +1,6 @@
+template <typename T>
+T
+common_template (T value)
+{
+    return value + 1; // Set common breakpoint here.
+}
@@ -0,0 +1,18 @@
+#include <stdio.h>
+
+#include "common.h"
+#include "other.h"
+
+static int
+main_only_function (int value)
+{
+    return common_template (value) - 1;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int result = main_only_function (argc) + other_ns::other_function (argc);
+    printf ("result: %d\n", result); // Set main breakpoint here.
+    return 0;
+}
@@ -0,0 +1,15 @@
+#include "common.h"
+#include "other.h"
+
+int
+other_ns::OtherClass::other_method (int value)
+{
+    return common_template (value) * 2; // Set other breakpoint here.
+}
+
+int
+other_ns::other_function (int value)
+{
+    OtherClass object;
+    return object.other_method (value);
+}
@@ -0,0 +1,12 @@
+namespace other_ns
+{
+    class OtherClass
+    {
+    public:
+        int
+        other_method (int value);
+    };
+
+    int
+    other_function (int value);
+}
@@ -0,0 +1,82 @@
+"""
+Test that breakpoints resolved in modules that are loaded together get the
+same locations as breakpoints resolved once the modules are loaded.
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import re
+import lldb
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.lldbutil as lldbutil
+
+class ParallelBreakpointResolutionTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.main_line = line_number('main.c', '// Set main breakpoint here.')
+        self.common_line = line_number('shared.h', '// Set common breakpoint here.')
+        self.shlib_names = ["shared"]
+
+    def create_breakpoints(self, target):
+        return [target.BreakpointCreateByName("same_name_function"),
+                target.BreakpointCreateByName("printf"),
+                target.BreakpointCreateByLocation("shared.h", self.common_line)]
+
+    def location_addresses(self, breakpoint):
+        return sorted([breakpoint.GetLocationAtIndex(i).GetLoadAddress() for i in range(breakpoint.GetNumLocations())])
+
+    @skipIfWindows # The shared library is not found on startup.
+    def test(self):
+        """Test that parallel and serial breakpoint resolution yield the same locations."""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        # Leave the dependent modules out, so they are all searched when the
+        # process loads them together.
+        error = lldb.SBError()
+        target = self.dbg.CreateTarget(exe, None, None, False, error)
+        self.assertTrue(target, VALID_TARGET)
+
+        main_breakpoint = target.BreakpointCreateByLocation("main.c", self.main_line)
+        self.assertTrue(main_breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+        pending_breakpoints = self.create_breakpoints(target)
+
+        # The breakpoints log says when modules are searched concurrently.
+        log_file = os.path.join(os.getcwd(), "breakpoints.log")
+        if os.path.exists(log_file):
+            os.remove(log_file)
+        self.runCmd("log enable -f '%s' lldb break" % log_file)
+        self.addTearDownHook(lambda: self.runCmd("log disable lldb break", check=False))
+
+        environment = self.registerSharedLibrariesWithTarget(target, self.shlib_names)
+        process = target.LaunchSimple(None, environment, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, main_breakpoint)
+        self.assertEqual(1, len(threads))
+
+        # The libraries the process loaded together were searched for all
+        # the pending breakpoints at once, not one library at a time.
+        self.runCmd("log disable lldb break")
+        with open(log_file, "r") as f:
+            batches = re.findall(r"searching (\d+) modules for (\d+) breakpoints concurrently, (\d+) searches", f.read())
+        self.assertTrue(any(int(modules) >= 2 and int(breakpoints) >= len(pending_breakpoints) and int(searches) >= int(modules)
+                            for (modules, breakpoints, searches) in batches), str(batches))
+
+        # Breakpoints created now are resolved in all the modules at once.
+        breakpoints = self.create_breakpoints(target)
+        for (pending_breakpoint, breakpoint) in zip(pending_breakpoints, breakpoints):
+            self.assertEqual(self.location_addresses(breakpoint), self.location_addresses(pending_breakpoint))
+            for i in range(pending_breakpoint.GetNumLocations()):
+                self.assertTrue(pending_breakpoint.GetLocationAtIndex(i).IsResolved())
+
+        # The functions in both the executable and the shared library were found.
+        self.assertEqual(2, breakpoints[0].GetNumLocations())
+        self.assertTrue(breakpoints[1].GetNumLocations() >= 1)
+        self.assertEqual(2, breakpoints[2].GetNumLocations())
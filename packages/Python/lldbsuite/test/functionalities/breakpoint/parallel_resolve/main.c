@@ -0,0 +1,16 @@
+#include <stdio.h>
+#include "shared.h"
+
+static int
+same_name_function (int value)
+{
+    return common_function (value) - 1;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int result = same_name_function (argc) + shared_call (argc);
+    printf ("result: %d\n", result); // Set main breakpoint here.
+    return 0;
+}
@@ -0,0 +1,13 @@
+#include "shared.h"
+
+int
+same_name_function (int value)
+{
+    return common_function (value) + 1;
+}
+
+int
+shared_call (int value)
+{
+    return same_name_function (value);
+}
@@ -0,0 +1,7 @@
+static inline int
+common_function (int value)
+{
+    return value * 2; // Set common breakpoint here.
+}
+
+int shared_call (int value);
@@ -0,0 +1,57 @@
+"""
+Test that printing a struct reads the pointees of its members in one batch.
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.lldbutil as lldbutil
+
+class MemoryPrefetchTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside main().
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    # lldb-server is the stub that implements jMultiMemRead.
+    @skipUnlessPlatform(['linux'])
+    def test_child_pointees_are_read_together(self):
+        """Test that the C strings of a struct's members come from one jMultiMemRead packet."""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1, loc_exact=True)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint'])
+
+        log_file = os.path.join(os.getcwd(), 'TestMemoryPrefetch.log')
+        def remove_log(self):
+            if os.path.exists(log_file):
+                os.remove(log_file)
+        self.addTearDownHook(remove_log)
+
+        self.runCmd("log enable -f " + log_file + " gdb-remote packets")
+        self.expect("frame variable names",
+            substrs = ['first = 0x', '"alpha"',
+                       'second = 0x', '"beta"',
+                       'third = 0x', '"gamma"',
+                       'fourth = 0x', '"delta"'])
+        self.runCmd("log disable gdb-remote packets")
+
+        # The four names were asked for in a single packet.
+        with open(log_file, "r") as f:
+            range_counts = [line.split("jMultiMemRead:ranges:")[1].count(",") // 2 + 1
+                            for line in f if "send packet" in line and "jMultiMemRead:ranges:" in line]
+        self.assertTrue(4 in range_counts, "one jMultiMemRead packet for the members' pointees")
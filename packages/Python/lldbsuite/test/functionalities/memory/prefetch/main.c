@@ -0,0 +1,30 @@
+#include <stdlib.h>
+#include <string.h>
+
+struct names
+{
+    char *first;
+    char *second;
+    char *third;
+    char *fourth;
+};
+
+static char *
+make_name (const char *name)
+{
+    // Keep the names far enough apart that each one is in its own cache line.
+    char *buffer = malloc (4096);
+    strcpy (buffer, name);
+    return buffer;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    struct names names;
+    names.first = make_name ("alpha");
+    names.second = make_name ("beta");
+    names.third = make_name ("gamma");
+    names.fourth = make_name ("delta");
+    return 0; // Set break point at this line.
+}
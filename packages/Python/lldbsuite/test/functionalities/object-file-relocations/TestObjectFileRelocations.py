@@ -0,0 +1,51 @@
+"""
+Test that the debug info of a relocatable ELF object file is relocated when
+it is read. Only the first function in .text has a DW_AT_low_pc of zero
+before relocation, the others rely on the addend of their relocation.
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.lldbutil as lldbutil
+
+class ObjectFileRelocationsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipUnlessPlatform(['linux', 'freebsd'])
+    @no_debug_info_test
+    def test_relocated_function_addresses(self):
+        """Resolve functions of a .o file through its relocated debug info."""
+        self.build()
+
+        obj = os.path.join(os.getcwd(), "main.o")
+        target = self.dbg.CreateTarget(obj)
+        self.assertTrue(target, VALID_TARGET)
+        module = target.GetModuleAtIndex(0)
+        self.assertTrue(module, VALID_MODULE)
+
+        for name in ["first", "second", "main"]:
+            symbol = module.FindSymbol(name)
+            self.assertTrue(symbol, VALID_SYMBOL)
+            sc = target.ResolveSymbolContextForAddress(symbol.GetStartAddress(),
+                                                       lldb.eSymbolContextFunction | lldb.eSymbolContextLineEntry)
+            self.assertTrue(sc.GetFunction(), "Got a valid function")
+            self.assertEqual(name, sc.GetFunction().GetName())
+            self.assertEqual(symbol.GetStartAddress().GetFileAddress(),
+                             sc.GetFunction().GetStartAddress().GetFileAddress())
+
+        # The line table is relocated along with .debug_info.
+        line = line_number('main.c', '// Line in second().')
+        function = target.ResolveSymbolContextForAddress(module.FindSymbol("second").GetStartAddress(),
+                                                         lldb.eSymbolContextFunction).GetFunction()
+        cu = module.GetCompileUnitAtIndex(0)
+        index = cu.FindLineEntryIndex(0, line, cu.GetFileSpec(), True)
+        self.assertNotEqual(lldb.UINT32_MAX, index)
+        addr = cu.GetLineEntryAtIndex(index).GetStartAddress().GetFileAddress()
+        self.assertTrue(function.GetStartAddress().GetFileAddress() <= addr < function.GetEndAddress().GetFileAddress(),
+                        "Line entry is inside of second()")
@@ -0,0 +1,24 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+int g_value = 1;
+
+int first(int arg)
+{
+    return arg + g_value; // Line in first().
+}
+
+int second(int arg)
+{
+    return arg - g_value; // Line in second().
+}
+
+int main(int argc, char const *argv[])
+{
+    return first(argc) + second(argc);
+}
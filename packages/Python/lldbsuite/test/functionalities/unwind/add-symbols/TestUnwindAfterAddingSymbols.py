@@ -0,0 +1,64 @@
+"""
+Test that backtraces are right after 'target symbols add' replaces the
+symbols of a module whose functions are already on the stack.
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import shutil
+import lldb
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.lldbutil as lldbutil
+
+class UnwindAfterAddingSymbolsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def function_names(self, thread):
+        return [thread.GetFrameAtIndex(i).GetFunctionName() for i in range(3)]
+
+    @skipUnlessPlatform(['linux', 'freebsd']) # The debug information is split off with objcopy.
+    @no_debug_info_test # The Makefile splits off the debug information itself.
+    def test(self):
+        """Test that the unwinder doesn't reuse the symbols of a symbol file that was replaced."""
+        self.build()
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        # Hide the debug information from the debug link search, so it is
+        # only found once it is added.
+        hidden_dir = os.path.join(os.getcwd(), "hide")
+        if not os.path.isdir(hidden_dir):
+            os.mkdir(hidden_dir)
+        symbol_file = os.path.join(hidden_dir, "a.out.debug")
+        shutil.move(os.path.join(os.getcwd(), "a.out.debug"), symbol_file)
+        self.addTearDownHook(lambda: shutil.rmtree(hidden_dir, ignore_errors=True))
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        breakpoint = target.BreakpointCreateByName("func_b")
+        self.assertTrue(breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertEqual(1, len(threads))
+
+        # Unwind through the callers while they only have the symbol table.
+        self.assertEqual(["func_b", "func_a", "main"], self.function_names(threads[0]))
+        self.assertFalse(threads[0].GetFrameAtIndex(1).GetLineEntry().IsValid())
+
+        self.expect("target symbols add " + symbol_file,
+                    substrs = ['symbol file', 'has been added to'])
+
+        # The callers' return addresses are the same as at the first stop,
+        # their symbols must come from the new symbol file.
+        threads = lldbutil.continue_to_breakpoint(process, breakpoint)
+        self.assertEqual(1, len(threads))
+        self.assertEqual(["func_b", "func_a", "main"], self.function_names(threads[0]))
+        for i in range(1, 3):
+            line_entry = threads[0].GetFrameAtIndex(i).GetLineEntry()
+            self.assertTrue(line_entry.IsValid())
+            self.assertEqual("main.c", line_entry.GetFileSpec().GetFilename())
@@ -0,0 +1,26 @@
+#include <stdio.h>
+
+int func_b (int value) __attribute__((noinline));
+int func_a (int value) __attribute__((noinline));
+
+int
+func_b (int value)
+{
+    return printf ("%d\n", value);
+}
+
+int
+func_a (int value)
+{
+    return func_b (value) + 1;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int total = 0;
+    int i;
+    for (i = 0; i < 2; ++i)
+        total += func_a (i);
+    return total > 0 ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+"""
+Test that the frames found by following the frame pointer chain are the
+frames the unwind information gives, and that the frames stay right once
+the full unwinder takes over to create their register contexts.
+"""
+
+from __future__ import print_function
+
+
+
+import os
+import lldb
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.lldbutil as lldbutil
+
+class FastUnwindTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.line = line_number('main.c', '// Set breakpoint here.')
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.process.thread.fast-unwind", check=False))
+
+    def stop_in_recursion(self, fast_unwind):
+        """Launch the program and return the thread stopped at the bottom of the recursion."""
+        self.runCmd("settings set target.process.thread.fast-unwind %s" % ("true" if fast_unwind else "false"))
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        breakpoint = target.BreakpointCreateByLocation("main.c", self.line)
+        self.assertTrue(breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertEqual(1, len(threads))
+        return threads[0]
+
+    def frame_summary(self, thread):
+        """Return the pc, CFA and function name of each of the thread's frames."""
+        return [(frame.GetPC(), frame.GetCFA(), frame.GetFunctionName()) for frame in thread.frames]
+
+    def check_recursion(self, thread):
+        """Check that the recursion is on the stack, with the right locals in every frame."""
+        for depth in range(6):
+            frame = thread.GetFrameAtIndex(depth)
+            self.assertEqual("recurse", frame.GetFunctionName())
+            self.assertEqual(depth, frame.FindVariable("depth").GetValueAsSigned(-1))
+            self.assertEqual(depth * 10, frame.FindVariable("local").GetValueAsSigned(-1))
+        self.assertEqual("main", thread.GetFrameAtIndex(6).GetFunctionName())
+
+    @skipIfWindows # clang-cl does not support gcc style attributes.
+    def test(self):
+        """Test that fast unwinding and its fallback to the full unwinder agree with full unwinding."""
+        self.build()
+
+        thread = self.stop_in_recursion(False)
+        full_frames = self.frame_summary(thread)
+        self.check_recursion(thread)
+        thread.GetProcess().Kill()
+
+        # The backtrace alone only follows the frame pointer chain.
+        thread = self.stop_in_recursion(True)
+        self.assertEqual(full_frames, self.frame_summary(thread))
+
+        # Reading the variables of the upper frames needs their register
+        # contexts, which makes the full unwinder redo the fast frames. The
+        # frames must not change under it.
+        self.check_recursion(thread)
+        self.assertEqual(full_frames, self.frame_summary(thread))
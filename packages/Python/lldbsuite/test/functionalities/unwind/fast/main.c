@@ -0,0 +1,18 @@
+#include <stdio.h>
+
+static int recurse (int depth) __attribute__((noinline));
+
+static int
+recurse (int depth)
+{
+    int local = depth * 10;
+    if (depth == 0)
+        return printf ("bottom\n"); // Set breakpoint here.
+    return recurse (depth - 1) + local;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    return recurse (5) > 0 ? 0 : 1;
+}
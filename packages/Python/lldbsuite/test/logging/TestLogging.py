@@ -105,3 +105,9 @@ class LogTestCase(TestBase):
 
         # check that it is still there
         self.assertTrue(string.find(contents, "bacon") == 0)
+
+    # Check that the timer dump shows the string pool statistics
+    @no_debug_info_test
+    def test_log_timers_dump (self):
+        self.expect("log timers dump",
+                    patterns = [ "String pool: [0-9]+ bytes, [0-9]+ thread cache hits, [0-9]+ pool lookups, [0-9]+ insertions, [0-9]+ contended lookups" ])
@@ -0,0 +1,152 @@
+from __future__ import print_function
+
+
+
+import binascii
+import gdbremote_testcase
+import json
+import re
+import struct
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+class TestGdbRemoteBreakpointCommands(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    MESSAGE = "collected"
+
+    # The agent expression opcodes the commands use.
+    OP_TRACE_QUICK = 0x0d
+    OP_CONST64 = 0x25
+    OP_REG = 0x26
+    OP_END = 0x27
+
+    def breakpoint_kind(self):
+        if self.getArchitecture() == "arm":
+            return 4
+        return 1
+
+    def encode_expression(self, bytecode):
+        return "X{:x},{}".format(len(bytecode), binascii.hexlify(bytearray(bytecode)).decode())
+
+    def start_inferior_and_get_addresses(self):
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["set-message:%s" % self.MESSAGE, "get-data-address-hex:g_message", "get-code-address-hex:swap_chars",
+                           "sleep:1", "call-function:swap_chars", "call-function:swap_chars", "print-message:", "sleep:5"])
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             { "type":"output_match", "regex":r"^data address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"message_address"} },
+             { "type":"output_match", "regex":r"^code address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"function_address"} },
+            ], True)
+        self.add_interrupt_packets()
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("message_address"))
+        self.assertIsNotNone(context.get("function_address"))
+        return (int(context.get("message_address"), 16), int(context.get("function_address"), 16))
+
+    def send_breakpoint(self, address, suffix):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $Z0,{:x},{}{}#00".format(address, self.breakpoint_kind(), suffix),
+             {"direction":"send", "regex":r"^\$(OK|E[0-9a-fA-F]{2})#[0-9a-fA-F]{2}$", "capture":{1:"response"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        return context.get("response")
+
+    def collected_samples(self):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $jCollectedSamples#00",
+             {"direction":"send", "regex":re.compile(r"^\$(.*)#[0-9a-fA-F]{2}$", re.MULTILINE|re.DOTALL), "capture":{1:"response"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        return json.loads(self.decode_gdbremote_binary(context.get("response")))
+
+    def commands_collect_samples(self):
+        (message_address, function_address) = self.start_inferior_and_get_addresses()
+
+        # Collect register 0 and 16 bytes of the message each time swap_chars is called.
+        collect_register = [self.OP_REG, 0, 0, self.OP_END]
+        collect_message = ([self.OP_CONST64] + list(bytearray(struct.pack(">Q", message_address))) +
+                           [self.OP_TRACE_QUICK, 16, self.OP_END])
+        self.assertEqual("OK", self.send_breakpoint(function_address, ";cmds:0,{}{}".format(
+            self.encode_expression(collect_register), self.encode_expression(collect_message))))
+
+        # The hits are not reported, the inferior goes on to print the message.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             { "type":"output_match", "regex":r"^message: {}\r\n$".format(self.MESSAGE) }],
+            True)
+        self.add_interrupt_packets()
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        (stop_signo, _) = self.parse_interrupt_packets(context)
+        self.assertEqual(lldbutil.get_signal_number('SIGSTOP'), stop_signo)
+
+        reply = self.collected_samples()
+        self.assertEqual(0, reply["dropped"])
+        samples = reply["samples"]
+        self.assertEqual([0, 1], [sample["id"] for sample in samples])
+        expected_bytes = binascii.hexlify((self.MESSAGE + "\0" * (16 - len(self.MESSAGE))).encode()).decode()
+        for sample in samples:
+            self.assertEqual(function_address, sample["address"])
+            self.assertEqual(samples[0]["tid"], sample["tid"])
+            self.assertEqual(["0"], list(sample["registers"].keys()))
+            self.assertTrue(len(sample["registers"]["0"]) > 0)
+            self.assertEqual([{"address":message_address, "bytes":expected_bytes}], sample["memory"])
+
+        # The samples were removed from the buffer.
+        self.assertEqual({"dropped":0, "samples":[]}, self.collected_samples())
+
+    @llgs_test
+    def test_commands_collect_samples_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.commands_collect_samples()
+
+    def malformed_commands_are_rejected(self):
+        (message_address, function_address) = self.start_inferior_and_get_addresses()
+
+        command = self.encode_expression([self.OP_REG, 0, 0, self.OP_END])
+        for suffix in [";cmds:",
+                       ";cmds:0",
+                       ";cmds:0,",
+                       ";cmds:0;" + command,
+                       ";cmds:0," + command + ";",
+                       ";cmds:0,X0,",
+                       ";cmds:0,X4,2600",
+                       ";cmds:0,X4,260000zz",
+                       ";cmd:0," + command,
+                       ";" + command + "cmds:0," + command]:
+            self.assertEqual("E03", self.send_breakpoint(function_address, suffix), suffix)
+
+        # Watchpoints don't take commands.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $Z2,{:x},1;cmds:0,{}#00".format(message_address, command),
+             "send packet: $E03#00"],
+            True)
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+
+        # A condition followed by commands, and the commands of an existing breakpoint
+        # can be replaced.
+        self.assertEqual("OK", self.send_breakpoint(function_address, ";{};cmds:1,{}{}".format(command, command, command)))
+        self.assertEqual("OK", self.send_breakpoint(function_address, ";cmds:0," + command))
+        self.reset_test_sequence()
+        self.add_remove_breakpoint_packets(function_address, breakpoint_kind=self.breakpoint_kind())
+        self.add_remove_breakpoint_packets(function_address, breakpoint_kind=self.breakpoint_kind())
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+
+    @llgs_test
+    def test_malformed_commands_are_rejected_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.malformed_commands_are_rejected()
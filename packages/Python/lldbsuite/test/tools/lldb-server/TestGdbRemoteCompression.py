@@ -0,0 +1,140 @@
+from __future__ import print_function
+
+
+
+import gdbremote_testcase
+import re
+import zlib
+from lldbsuite.test.lldbtest import *
+
+class TestGdbRemoteCompression(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # Every character that has to be escaped in a packet, repeated so that
+    # the message compresses.
+    MESSAGE = ("#$}* compressible message " * 10)[:250]
+
+    def start_inferior_and_get_message_address(self):
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["set-message:%s" % self.MESSAGE, "get-data-address-hex:g_message", "sleep:5"])
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             { "type":"output_match", "regex":r"^data address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"message_address"} },
+            ], True)
+        self.add_interrupt_packets()
+        self.add_qSupported_packets()
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("message_address"))
+
+        features = self.parse_qSupported_response(context)
+        return (int(context.get("message_address"), 16), features)
+
+    def decompress(self, compression_type, data, size):
+        if compression_type == "zlib-deflate":
+            # Raw deflate stream without the zlib header.
+            return zlib.decompress(data, -15)
+        import lz4.block
+        return lz4.block.decompress(data, uncompressed_size=size)
+
+    def decode_compressed_packet(self, compression_type, payload):
+        if payload.startswith("N"):
+            return (False, payload[1:])
+        match = re.match(r"^C([0-9]+):(.*)$", payload, re.DOTALL)
+        self.assertIsNotNone(match, "Compressed packet starts with N or C<size>:")
+        size = int(match.group(1))
+        decoded = self.decompress(compression_type, self.decode_gdbremote_binary(match.group(2)), size)
+        self.assertEqual(size, len(decoded))
+        return (True, decoded)
+
+    def read_memory(self, command, address, length):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: ${}{:x},{:x}#00".format(command, address, length),
+             {"direction":"send", "regex":re.compile(r"^\$([^#]*)#[0-9a-fA-F]{2}$", re.MULTILINE|re.DOTALL), "capture":{1:"payload"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("payload"))
+        return context.get("payload")
+
+    def compressed_packets_round_trip(self, compression_type):
+        (message_address, features) = self.start_inferior_and_get_message_address()
+        if compression_type not in features.get("SupportedCompressions", "").split(","):
+            self.skipTest("%s compression not supported" % compression_type)
+        if compression_type == "lz4":
+            try:
+                import lz4.block
+            except ImportError:
+                self.skipTest("lz4 module not available")
+
+        expected_memory = self.MESSAGE + "\0" * (256 - len(self.MESSAGE))
+
+        # The response is sent before compression is enabled.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $QEnableCompression:type:{};#00".format(compression_type),
+             "send packet: $OK#00"],
+            True)
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+
+        # Binary reads escape the special characters of the message once, the
+        # compressed packet escapes them again.
+        (compressed, decoded) = self.decode_compressed_packet(compression_type, self.read_memory("x", message_address, 256))
+        self.assertTrue(compressed)
+        self.assertEqual(expected_memory, self.decode_gdbremote_binary(decoded))
+
+        (compressed, decoded) = self.decode_compressed_packet(compression_type, self.read_memory("m", message_address, 256))
+        self.assertTrue(compressed)
+        self.assertEqual(expected_memory, decoded.decode("hex"))
+
+        # Payloads up to the minimum size are sent as they are.
+        payload = self.read_memory("m", message_address, 16)
+        self.assertEqual(("N", self.MESSAGE[:16].encode("hex")), (payload[0], payload[1:]))
+
+        # With a minimum size of zero, even small payloads are compressed as
+        # long as they get smaller.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $QEnableCompression:type:{};minsize:0;#00".format(compression_type),
+             "send packet: $NOK#00"],
+            True)
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+        (compressed, decoded) = self.decode_compressed_packet(compression_type, self.read_memory("m", message_address, 64))
+        self.assertEqual(expected_memory[:64], decoded.decode("hex"))
+
+    @llgs_test
+    def test_zlib_compressed_packets_round_trip_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.compressed_packets_round_trip("zlib-deflate")
+
+    @llgs_test
+    def test_lz4_compressed_packets_round_trip_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.compressed_packets_round_trip("lz4")
+
+    def unsupported_compression_is_rejected(self):
+        self.prep_debug_monitor_and_inferior()
+        self.test_sequence.add_log_lines(
+            ["read packet: $QEnableCompression:type:lzma;#00",
+             {"direction":"send", "regex":r"^\$E[0-9a-fA-F]{2}#[0-9a-fA-F]{2}$"},
+             # Compression stays off.
+             "read packet: $QEnableCompression:type:lzma;minsize:x;#00",
+             {"direction":"send", "regex":r"^\$E[0-9a-fA-F]{2}.*#[0-9a-fA-F]{2}$"},
+             "read packet: $qC#00",
+             {"direction":"send", "regex":r"^\$QC[0-9a-fA-F]+#[0-9a-fA-F]{2}$"}],
+            True)
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+
+    @llgs_test
+    def test_unsupported_compression_is_rejected_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.unsupported_compression_is_rejected()
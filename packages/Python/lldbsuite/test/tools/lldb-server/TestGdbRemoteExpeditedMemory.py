@@ -0,0 +1,104 @@
+from __future__ import print_function
+
+
+
+import gdbremote_testcase
+import json
+import lldbgdbserverutils
+import re
+from lldbsuite.test.lldbtest import *
+
+class TestGdbRemoteExpeditedMemory(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def gather_stop_reply_key_vals(self):
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=["sleep:5"])
+        self.test_sequence.add_log_lines([
+            "read packet: $c#63",
+            "read packet: {}".format(chr(3)),
+            {"direction":"send", "regex":r"^\$T([0-9a-fA-F]+)([^#]+)#[0-9a-fA-F]{2}$", "capture":{1:"stop_result", 2:"key_vals_text"} },
+            ], True)
+        self.add_process_info_collection_packets()
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("key_vals_text"))
+        process_info = self.parse_process_info_response(context)
+        self.assertIsNotNone(process_info)
+        return (context.get("key_vals_text"), process_info.get("endian"))
+
+    def read_memory(self, address, length):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $m{0:x},{1:x}#00".format(address, length),
+             {"direction":"send", "regex":r"^\$([0-9a-fA-F]+)#[0-9a-fA-F]{2}$", "capture":{1:"read_contents"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        return context.get("read_contents")
+
+    def assert_expedited_memory_matches(self, address, hex_bytes):
+        self.assertTrue(len(hex_bytes) > 0)
+        self.assertEqual(0, len(hex_bytes) % 2)
+        self.assertEqual(hex_bytes.lower(), self.read_memory(address, len(hex_bytes) // 2).lower())
+
+    def stop_reply_expedites_pc_memory(self):
+        (key_vals_text, endian) = self.gather_stop_reply_key_vals()
+        kv_dict = self.parse_key_val_dict(key_vals_text)
+        self.assertTrue("memory" in kv_dict)
+        memory = kv_dict["memory"]
+        if type(memory) != list:
+            memory = [memory]
+
+        expedited_memory = {}
+        for entry in memory:
+            match = re.match(r"^0x([0-9a-fA-F]+)=([0-9a-fA-F]+)$", entry)
+            self.assertIsNotNone(match, "memory:0x<addr>=<hex bytes>")
+            expedited_memory[int(match.group(1), 16)] = match.group(2)
+
+        # The bytes at the PC and at most two frame records.
+        self.assertTrue(len(expedited_memory) <= 3)
+
+        expedited_registers = self.extract_registers_from_stop_notification(key_vals_text)
+        reg_infos = self.gather_register_infos()
+        pc_info = self.find_generic_register_with_name(reg_infos, "pc")
+        self.assertIsNotNone(pc_info)
+        self.assertTrue(pc_info["lldb_register_index"] in expedited_registers)
+        pc = lldbgdbserverutils.unpack_register_hex_unsigned(endian, expedited_registers[pc_info["lldb_register_index"]])
+        self.assertTrue(pc in expedited_memory)
+
+        for (address, hex_bytes) in expedited_memory.items():
+            self.assert_expedited_memory_matches(address, hex_bytes)
+
+    @llgs_test
+    def test_stop_reply_expedites_pc_memory_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.stop_reply_expedites_pc_memory()
+
+    def jThreadsInfo_expedites_memory(self):
+        self.gather_stop_reply_key_vals()
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $jThreadsInfo#c1",
+             {"direction":"send", "regex":r"^\$(.*)#[0-9a-fA-F]{2}$", "capture":{1:"threads_info"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        threads_info = json.loads(self.decode_gdbremote_binary(context.get("threads_info")))
+        self.assertTrue(len(threads_info) > 0)
+
+        for thread_info in threads_info:
+            # Every thread at least has the memory at its PC.
+            self.assertTrue("memory" in thread_info)
+            for memory in thread_info["memory"]:
+                self.assert_expedited_memory_matches(memory["address"], memory["bytes"])
+
+    @llgs_test
+    def test_jThreadsInfo_expedites_memory_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.jThreadsInfo_expedites_memory()
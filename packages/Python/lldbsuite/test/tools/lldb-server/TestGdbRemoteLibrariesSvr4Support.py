@@ -0,0 +1,99 @@
+from __future__ import print_function
+
+
+
+import gdbremote_testcase
+import re
+import xml.etree.ElementTree as ET
+from lldbsuite.test.lldbtest import *
+
+class TestGdbRemoteLibrariesSvr4Support(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    FEATURE_NAME = "qXfer:libraries-svr4:read"
+
+    def setup_test(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+
+        # Wait for main so that the dynamic linker has loaded all libraries.
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=["message:main entered", "sleep:5"])
+        self.test_sequence.add_log_lines([
+            "read packet: $c#63",
+            { "type":"output_match", "regex":r"^message:main entered\r\n$" },
+            ], True)
+        self.add_interrupt_packets()
+        self.add_qSupported_packets()
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        features = self.parse_qSupported_response(context)
+        if features.get(self.FEATURE_NAME) != "+":
+            self.skipTest("%s not supported" % self.FEATURE_NAME)
+
+    def send_libraries_svr4_read(self, annex):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines([
+            "read packet: ${}:{}:0,fffff#00".format(self.FEATURE_NAME, annex),
+            {"direction":"send", "regex":re.compile(r"^\$(.)(.*)#[0-9a-fA-F]{2}$", re.MULTILINE|re.DOTALL), "capture":{1:"response_type", 2:"content_raw"} }
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        return (context.get("response_type"), context.get("content_raw"))
+
+    def get_library_list(self, annex=""):
+        (response_type, content_raw) = self.send_libraries_svr4_read(annex)
+        # Everything fits into one reply.
+        self.assertEqual("l", response_type)
+        root = ET.fromstring(self.decode_gdbremote_binary(content_raw))
+        self.assertEqual("library-list-svr4", root.tag)
+        return root
+
+    def library_link_maps(self, root):
+        return [int(library.get("lm"), 16) for library in root.findall("library")]
+
+    @llgs_test
+    def test_libraries_svr4_full_list_llgs(self):
+        self.setup_test()
+        root = self.get_library_list()
+        self.assertTrue(root.get("main-lm") is not None)
+        libraries = root.findall("library")
+        self.assertTrue(len(libraries) > 0)
+        for library in libraries:
+            for attribute in ["name", "lm", "l_addr", "l_ld"]:
+                self.assertTrue(library.get(attribute) is not None)
+
+    @llgs_test
+    def test_libraries_svr4_from_start_llgs(self):
+        self.setup_test()
+        link_maps = self.library_link_maps(self.get_library_list())
+        if len(link_maps) < 3:
+            self.skipTest("not enough shared libraries")
+
+        # Only the entries from start on come back, and there is no main-lm.
+        root = self.get_library_list("start={:x};prev={:x}".format(link_maps[1], link_maps[0]))
+        self.assertTrue(root.get("main-lm") is None)
+        self.assertEqual(link_maps[1:], self.library_link_maps(root))
+
+        root = self.get_library_list("start={:x}".format(link_maps[2]))
+        self.assertEqual(link_maps[2:], self.library_link_maps(root))
+
+    @llgs_test
+    def test_libraries_svr4_stale_prev_llgs(self):
+        self.setup_test()
+        link_maps = self.library_link_maps(self.get_library_list())
+        if len(link_maps) < 3:
+            self.skipTest("not enough shared libraries")
+
+        # start is no longer preceded by prev.
+        (response_type, content_raw) = self.send_libraries_svr4_read(
+            "start={:x};prev={:x}".format(link_maps[2], link_maps[0]))
+        self.assertEqual("E", response_type)
+
+    @llgs_test
+    def test_libraries_svr4_malformed_annex_llgs(self):
+        self.setup_test()
+        (response_type, content_raw) = self.send_libraries_svr4_read("start=xyz")
+        self.assertEqual("E", response_type)
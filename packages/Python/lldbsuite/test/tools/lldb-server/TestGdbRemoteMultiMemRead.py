@@ -0,0 +1,133 @@
+from __future__ import print_function
+
+
+
+import gdbremote_testcase
+import re
+from lldbsuite.test.lldbtest import *
+
+class TestGdbRemoteMultiMemRead(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    MESSAGE = "Hello, #$}* jMultiMemRead"
+
+    # The most bytes lldb-server reads for one packet.
+    MAX_READ_SIZE = 1024 * 1024
+
+    def start_inferior_and_get_addresses(self):
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["set-message:%s" % self.MESSAGE, "get-data-address-hex:g_message", "get-code-address-hex:hello", "sleep:5"])
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             { "type":"output_match", "regex":r"^data address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"message_address"} },
+             { "type":"output_match", "regex":r"^code address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"code_address"} },
+            ], True)
+        self.add_interrupt_packets()
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("message_address"))
+        self.assertIsNotNone(context.get("code_address"))
+        return (int(context.get("message_address"), 16), int(context.get("code_address"), 16))
+
+    def send_multi_mem_read(self, ranges_text):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $jMultiMemRead:ranges:{}#00".format(ranges_text),
+             {"direction":"send", "regex":re.compile(r"^\$([^#]*)#[0-9a-fA-F]{2}$", re.MULTILINE|re.DOTALL), "capture":{1:"response"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("response"))
+        return context.get("response")
+
+    def multi_mem_read(self, ranges):
+        response = self.send_multi_mem_read(
+            ",".join("{:x},{:x}".format(address, size) for (address, size) in ranges) + ";")
+        match = re.match(r"^([0-9a-fA-F,]+);(.*)$", response, re.DOTALL)
+        self.assertIsNotNone(match, "jMultiMemRead response is <sizes>;<data>")
+
+        sizes = [int(size, 16) for size in match.group(1).split(",")]
+        self.assertEqual(len(ranges), len(sizes))
+        data = self.decode_gdbremote_binary(match.group(2))
+        self.assertEqual(sum(sizes), len(data))
+
+        contents = []
+        offset = 0
+        for size in sizes:
+            contents.append(data[offset:offset + size])
+            offset += size
+        return contents
+
+    def read_memory(self, address, length):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $m{0:x},{1:x}#00".format(address, length),
+             {"direction":"send", "regex":r"^\$([0-9a-fA-F]+)#[0-9a-fA-F]{2}$", "capture":{1:"read_contents"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        return context.get("read_contents").decode("hex")
+
+    def multi_mem_read_matches_single_reads(self):
+        (message_address, code_address) = self.start_inferior_and_get_addresses()
+
+        ranges = [(message_address, len(self.MESSAGE) + 1), (code_address, 16), (message_address + 7, 4)]
+        contents = self.multi_mem_read(ranges)
+        self.assertEqual(self.MESSAGE + "\0", contents[0])
+        self.assertEqual(self.MESSAGE[7:11], contents[2])
+        for ((address, size), content) in zip(ranges, contents):
+            self.assertEqual(self.read_memory(address, size), content)
+
+    @llgs_test
+    def test_multi_mem_read_matches_single_reads_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.multi_mem_read_matches_single_reads()
+
+    def multi_mem_read_reports_unreadable_ranges(self):
+        (message_address, code_address) = self.start_inferior_and_get_addresses()
+
+        # The first page is never mapped, the ranges around it still come back.
+        contents = self.multi_mem_read([(message_address, 5), (0, 16), (code_address, 4)])
+        self.assertEqual(self.MESSAGE[:5], contents[0])
+        self.assertEqual("", contents[1])
+        self.assertEqual(self.read_memory(code_address, 4), contents[2])
+
+        # A range of zero bytes reads nothing.
+        contents = self.multi_mem_read([(message_address, 0), (message_address, 5)])
+        self.assertEqual(["", self.MESSAGE[:5]], contents)
+
+    @llgs_test
+    def test_multi_mem_read_reports_unreadable_ranges_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.multi_mem_read_reports_unreadable_ranges()
+
+    def multi_mem_read_rejects_bad_requests(self):
+        (message_address, code_address) = self.start_inferior_and_get_addresses()
+
+        # Too many bytes altogether, even though each range fits.
+        half = self.MAX_READ_SIZE // 2 + 1
+        self.assertTrue(self.send_multi_mem_read(
+            "{0:x},{1:x},{0:x},{1:x};".format(message_address, half)).startswith("E"))
+
+        # Malformed range lists.
+        for ranges_text in [";",
+                            "{:x};".format(message_address),
+                            "{:x},4".format(message_address),
+                            "xyz,4;"]:
+            self.assertTrue(self.send_multi_mem_read(ranges_text).startswith("E"), ranges_text)
+
+        # The process is still there to read from.
+        self.assertEqual([self.MESSAGE[:4]], self.multi_mem_read([(message_address, 4)]))
+
+    @llgs_test
+    def test_multi_mem_read_rejects_bad_requests_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.multi_mem_read_rejects_bad_requests()
@@ -0,0 +1,160 @@
+from __future__ import print_function
+
+
+
+import gdbremote_testcase
+from lldbsuite.test.lldbtest import *
+
+class TestGdbRemoteNonStop(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def enable_non_stop(self):
+        self.test_sequence.add_log_lines(
+            ["read packet: $QNonStop:1#00",
+             "send packet: $OK#00"],
+            True)
+
+    def continue_all(self):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $vCont;c#00",
+             "send packet: $OK#00"],
+            True)
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+
+    def expect_stop_notification(self, read_packet, signo):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: {}".format(read_packet),
+             "send packet: $OK#00",
+             {"direction":"send", "regex":r"^%Stop:T{:02x}thread:([0-9a-fA-F]+);".format(signo), "capture":{1:"stop_thread_id"} },
+             "read packet: $vStopped#00",
+             "send packet: $OK#00"],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        return int(context.get("stop_thread_id"), 16)
+
+    def stop_thread(self, thread_id):
+        self.assertEqual(thread_id, self.expect_stop_notification("$vCont;t:{:x}#00".format(thread_id), 0))
+
+    def stopped_thread_ids(self):
+        """Return the ids of the threads reported by "?" and the vStopped replies following it."""
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $?#00",
+             {"direction":"send", "regex":r"^\$(OK|T[0-9a-fA-F]{2}thread:([0-9a-fA-F]+);)", "capture":{1:"reply", 2:"stop_thread_id"} }],
+            True)
+        thread_ids = []
+        while True:
+            context = self.expect_gdbremote_sequence()
+            self.assertIsNotNone(context)
+            if context.get("reply") == "OK":
+                return thread_ids
+            thread_ids.append(int(context.get("stop_thread_id"), 16))
+
+            self.reset_test_sequence()
+            self.test_sequence.add_log_lines(
+                ["read packet: $vStopped#00",
+                 {"direction":"send", "regex":r"^\$(OK|T[0-9a-fA-F]{2}thread:([0-9a-fA-F]+);)", "capture":{1:"reply", 2:"stop_thread_id"} }],
+                True)
+
+    def threads_stop_one_by_one(self):
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=["thread:new", "thread:new", "sleep:10"])
+        self.enable_non_stop()
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+        self.continue_all()
+
+        thread_ids = self.wait_for_thread_count(3)
+        self.assertEqual(3, len(thread_ids))
+
+        # Nothing is stopped yet.
+        self.assertEqual([], self.stopped_thread_ids())
+
+        # Each thread is stopped on its own, and only the stopped ones are
+        # reported again.
+        for (index, thread_id) in enumerate(thread_ids):
+            self.stop_thread(thread_id)
+            self.assertEqual(sorted(thread_ids[:index + 1]), sorted(self.stopped_thread_ids()))
+
+        # A default action resumes the stopped threads.
+        self.continue_all()
+        self.assertEqual([], self.stopped_thread_ids())
+        self.stop_thread(thread_ids[0])
+
+    @llgs_test
+    def test_threads_stop_one_by_one_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.threads_stop_one_by_one()
+
+    def output_is_forwarded_as_notifications(self):
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["set-message:non-stop output", "thread:new", "sleep:1", "print-message:", "sleep:5"])
+        self.enable_non_stop()
+        self.test_sequence.add_log_lines(
+            ["read packet: $vCont;c#00",
+             "send packet: $OK#00",
+             { "type":"output_match", "regex":r"^message: non-stop output\r\n$" }],
+            True)
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+
+    @llgs_test
+    def test_output_is_forwarded_as_notifications_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.output_is_forwarded_as_notifications()
+
+    def threads_run_after_breakpoint_step(self):
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["thread:new", "get-code-address-hex:swap_chars", "sleep:1", "call-function:swap_chars", "sleep:5"])
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             { "type":"output_match", "regex":r"^code address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"function_address"} }],
+            True)
+        self.add_interrupt_packets()
+        self.add_process_info_collection_packets()
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        function_address = int(context.get("function_address"), 16)
+        process_info = self.parse_process_info_response(context)
+
+        # The main thread is the one calling swap_chars.
+        thread_ids = self.wait_for_thread_count(2)
+        main_thread_id = int(process_info["pid"], 16)
+        self.assertTrue(main_thread_id in thread_ids)
+        other_thread_id = [thread_id for thread_id in thread_ids if thread_id != main_thread_id][0]
+
+        if self.getArchitecture() == "arm":
+            BREAKPOINT_KIND = 4
+        else:
+            BREAKPOINT_KIND = 1
+        self.reset_test_sequence()
+        self.add_set_breakpoint_packets(function_address, do_continue=False, breakpoint_kind=BREAKPOINT_KIND)
+        self.enable_non_stop()
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+        self.assertEqual(main_thread_id, self.expect_stop_notification("$vCont;c#00", 5))
+
+        # Step the main thread off the breakpoint the way lldb does. The other
+        # thread is held while the breakpoint is out, and runs again once it is
+        # back.
+        self.reset_test_sequence()
+        self.add_remove_breakpoint_packets(function_address, breakpoint_kind=BREAKPOINT_KIND)
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+        self.assertEqual(main_thread_id, self.expect_stop_notification("$vCont;s:{:x}#00".format(main_thread_id), 5))
+        self.reset_test_sequence()
+        self.add_set_breakpoint_packets(function_address, do_continue=False, breakpoint_kind=BREAKPOINT_KIND)
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+
+        self.assertEqual([main_thread_id], self.stopped_thread_ids())
+        self.stop_thread(other_thread_id)
+
+    @llgs_test
+    def test_threads_run_after_breakpoint_step_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.threads_run_after_breakpoint_step()
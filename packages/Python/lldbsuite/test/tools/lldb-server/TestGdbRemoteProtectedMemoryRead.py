@@ -0,0 +1,70 @@
+from __future__ import print_function
+
+
+
+import gdbremote_testcase
+import re
+from lldbsuite.test.lldbtest import *
+
+class TestGdbRemoteProtectedMemoryRead(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def start_inferior_and_get_protected_address(self):
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=["get-protected-address-hex:", "sleep:5"])
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             { "type":"output_match", "regex":r"^protected address: (\S+)\r\n$", "capture":{ 1:"protected_address"} },
+            ], True)
+        self.add_interrupt_packets()
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        match = re.match(r"^0x([0-9a-fA-F]+)$", context.get("protected_address"))
+        if not match:
+            self.skipTest("the inferior couldn't map a protected page")
+        return int(match.group(1), 16)
+
+    def read_memory(self, address, length):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $m{0:x},{1:x}#00".format(address, length),
+             {"direction":"send", "regex":r"^\$([0-9a-fA-F]+)#[0-9a-fA-F]{2}$", "capture":{1:"read_contents"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        return context.get("read_contents").decode("hex")
+
+    def expected_bytes(self, offset, length):
+        # The inferior fills the pages with the low byte of each byte's offset
+        # from their start, and the protected page starts at a page boundary.
+        return "".join(chr((offset + i) & 0xff) for i in range(length))
+
+    def protected_page_is_read_through_proc_mem(self):
+        protected_address = self.start_inferior_and_get_protected_address()
+
+        # process_vm_readv reads the readable part and stops at the protected
+        # page, the rest comes from /proc/<pid>/mem.
+        self.assertEqual(self.expected_bytes(-16, 48), self.read_memory(protected_address - 16, 48))
+
+        # Reads that start in the protected page don't get anything from
+        # process_vm_readv at all.
+        self.assertEqual(self.expected_bytes(0x100, 64), self.read_memory(protected_address + 0x100, 64))
+
+        # Ranges read together take the same way around.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $jMultiMemRead:ranges:{:x},20,{:x},10;#00".format(protected_address - 16, protected_address + 0x40),
+             {"direction":"send", "regex":re.compile(r"^\$20,10;(.*)#[0-9a-fA-F]{2}$", re.MULTILINE|re.DOTALL), "capture":{1:"data"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertEqual(self.expected_bytes(-16, 32) + self.expected_bytes(0x40, 16),
+                         self.decode_gdbremote_binary(context.get("data")))
+
+    @llgs_test
+    def test_protected_page_is_read_through_proc_mem_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.protected_page_is_read_through_proc_mem()
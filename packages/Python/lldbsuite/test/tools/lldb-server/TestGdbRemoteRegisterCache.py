@@ -0,0 +1,158 @@
+from __future__ import print_function
+
+
+
+import gdbremote_testcase
+import lldbgdbserverutils
+from lldbsuite.test.lldbtest import *
+
+class TestGdbRemoteRegisterCache(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def start_inferior(self, inferior_args):
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=inferior_args)
+        self.add_register_info_collection_packets()
+        self.add_process_info_collection_packets()
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        process_info = self.parse_process_info_response(context)
+        self.assertIsNotNone(process_info)
+        endian = process_info.get("endian")
+        self.assertIsNotNone(endian)
+
+        reg_infos = self.parse_register_info_packets(context)
+        self.assertIsNotNone(reg_infos)
+        self.add_lldb_register_index(reg_infos)
+        return (reg_infos, endian)
+
+    def start_inferior_at_swap_chars(self):
+        (reg_infos, endian) = self.start_inferior(
+            ["get-code-address-hex:swap_chars", "sleep:1", "call-function:swap_chars", "sleep:5"])
+
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             { "type":"output_match", "regex":r"^code address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"function_address"} },
+             "read packet: {}".format(chr(3)),
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);"}],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("function_address"))
+        function_address = int(context.get("function_address"), 16)
+
+        # Stop at the start of swap_chars, whose instructions all move the pc.
+        if self.getArchitecture() == "arm":
+            BREAKPOINT_KIND = 4
+        else:
+            BREAKPOINT_KIND = 1
+        self.reset_test_sequence()
+        self.add_set_breakpoint_packets(function_address, do_continue=True, breakpoint_kind=BREAKPOINT_KIND)
+        self.add_remove_breakpoint_packets(function_address, breakpoint_kind=BREAKPOINT_KIND)
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+        return (reg_infos, endian, function_address)
+
+    def read_register_hex(self, reg_index):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $p{:x}#00".format(reg_index),
+             { "direction":"send", "regex":r"^\$([0-9a-fA-F]+)#", "capture":{1:"p_response"} }],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("p_response"))
+        return context.get("p_response").lower()
+
+    def write_register_hex(self, reg_index, value_hex):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $P{:x}={}#00".format(reg_index, value_hex),
+             "send packet: $OK#00"],
+            True)
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+
+    def flipped_hex(self, value_hex):
+        return "".join("{:02x}".format(int(value_hex[i:i + 2], 16) ^ 0xff) for i in range(0, len(value_hex), 2))
+
+    def single_step(self):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $s#00",
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);"}],
+            True)
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+
+    def registers_are_reread_after_resume(self):
+        (reg_infos, endian, function_address) = self.start_inferior_at_swap_chars()
+        pc_info = self.find_pc_reg_info(reg_infos)
+        self.assertIsNotNone(pc_info)
+        pc_index = pc_info["lldb_register_index"]
+
+        pc_hex = self.read_register_hex(pc_index)
+        self.assertEqual(function_address, lldbgdbserverutils.unpack_register_hex_unsigned(endian, pc_hex))
+
+        # Each step moves the pc. Reading it takes a snapshot of the register
+        # set, which the next step has to throw away.
+        for i in range(3):
+            self.single_step()
+            new_pc_hex = self.read_register_hex(pc_index)
+            self.assertNotEqual(pc_hex, new_pc_hex)
+            pc_hex = new_pc_hex
+
+        # Continuing throws it away as well.
+        self.reset_test_sequence()
+        self.run_process_then_stop(run_seconds=1)
+        self.assertNotEqual(pc_hex, self.read_register_hex(pc_index))
+
+    @llgs_test
+    def test_registers_are_reread_after_resume_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.registers_are_reread_after_resume()
+
+    def register_writes_update_snapshot(self):
+        (reg_infos, endian) = self.start_inferior(["sleep:5"])
+        self.reset_test_sequence()
+        self.assertIsNotNone(self.run_process_then_stop(run_seconds=1))
+
+        # A general purpose register, and a floating point one if there is one.
+        reg_indexes = [self.select_modifiable_register(reg_infos)]
+        self.assertIsNotNone(reg_indexes[0])
+        for reg_info in reg_infos:
+            if reg_info.get("name") in ["xmm0", "d0", "v0", "f0"] and "container-regs" not in reg_info:
+                reg_indexes.append(reg_info["lldb_register_index"])
+                break
+
+        # Read the registers first, so the writes find the register sets
+        # already buffered.
+        old_values = {}
+        for reg_info in reg_infos:
+            reg_index = reg_info["lldb_register_index"]
+            if reg_index in reg_indexes or (reg_info.get("set") == "General Purpose Registers" and "container-regs" not in reg_info):
+                old_values[reg_index] = self.read_register_hex(reg_index)
+
+        for reg_index in reg_indexes:
+            new_value = self.flipped_hex(old_values[reg_index])
+            self.write_register_hex(reg_index, new_value)
+            self.assertEqual(new_value, self.read_register_hex(reg_index))
+
+        # The other general purpose registers kept their values.
+        for (reg_index, old_value) in old_values.items():
+            if reg_index not in reg_indexes:
+                self.assertEqual(old_value, self.read_register_hex(reg_index))
+
+        # Writing the old values back is seen as well.
+        for reg_index in reg_indexes:
+            self.write_register_hex(reg_index, old_values[reg_index])
+            self.assertEqual(old_values[reg_index], self.read_register_hex(reg_index))
+
+    @llgs_test
+    def test_register_writes_update_snapshot_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.register_writes_update_snapshot()
@@ -733,7 +733,11 @@ class GdbRemoteTestCaseBase(TestBase):
         "qXfer:libraries:read",
         "qXfer:libraries-svr4:read",
         "qXfer:features:read",
-        "qEcho"
+        "qEcho",
+        "SupportedCompressions",
+        "DefaultCompressionMinSize",
+        "ConditionalBreakpoints",
+        "BreakpointCommands"
     ]
 
     def parse_qSupported_response(self, context):
@@ -21,6 +21,7 @@ int pthread_threadid_np(pthread_t,__uint64_t*);
 #endif
 
 #if defined(__linux__)
+#include <sys/mman.h>
 #include <sys/prctl.h>
 #endif
 
@@ -32,6 +33,7 @@ static const char *const PRINT_MESSAGE_COMMAND       = "print-message:";
 static const char *const GET_DATA_ADDRESS_PREFIX     = "get-data-address-hex:";
 static const char *const GET_STACK_ADDRESS_COMMAND   = "get-stack-address-hex:";
 static const char *const GET_HEAP_ADDRESS_COMMAND    = "get-heap-address-hex:";
+static const char *const GET_PROTECTED_ADDRESS_COMMAND = "get-protected-address-hex:";
 
 static const char *const GET_CODE_ADDRESS_PREFIX     = "get-code-address-hex:";
 static const char *const CALL_FUNCTION_PREFIX        = "call-function:";
@@ -314,6 +316,29 @@ int main (int argc, char **argv)
             printf ("heap address: %p\n", heap_array_up.get ());
 			pthread_mutex_unlock (&g_print_mutex);
         }
+        else if (std::strstr (argv[i], GET_PROTECTED_ADDRESS_COMMAND))
+        {
+            // Map two pages filled with their offset from the start, and take
+            // away all access to the second one. Prints the address of the
+            // second page.
+            void *protected_p = nullptr;
+#if defined(__linux__)
+            const long page_size = sysconf (_SC_PAGESIZE);
+            void *pages_p = mmap (nullptr, 2 * page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (pages_p != MAP_FAILED)
+            {
+                uint8_t *bytes = static_cast<uint8_t *> (pages_p);
+                for (long offset = 0; offset < 2 * page_size; ++offset)
+                    bytes[offset] = static_cast<uint8_t> (offset);
+                if (mprotect (bytes + page_size, page_size, PROT_NONE) == 0)
+                    protected_p = bytes + page_size;
+            }
+#endif
+
+			pthread_mutex_lock (&g_print_mutex);
+            printf ("protected address: %p\n", protected_p);
+			pthread_mutex_unlock (&g_print_mutex);
+        }
         else if (std::strstr (argv[i], GET_STACK_ADDRESS_COMMAND))
         {
 			pthread_mutex_lock (&g_print_mutex);
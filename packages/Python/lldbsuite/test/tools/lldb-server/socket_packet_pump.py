@@ -11,9 +11,14 @@ import codecs
 
 from six.moves import queue
 
-def _handle_output_packet_string(packet_contents):
+def _handle_output_packet_string(packet_contents, is_notification=False):
     if (not packet_contents) or (len(packet_contents) < 1):
         return None
+    elif is_notification:
+        # Non-stop mode sends output as %O:<hex> notifications.
+        if not packet_contents.startswith("O:"):
+            return None
+        return packet_contents[2:].decode("hex")
     elif packet_contents[0] != "O":
         return None
     elif packet_contents == "OK":
@@ -29,16 +34,16 @@ def _dump_queue(the_queue):
 class SocketPacketPump(object):
     """A threaded packet reader that partitions packets into two streams.
 
-    All incoming $O packet content is accumulated with the current accumulation
-    state put into the OutputQueue.
+    All incoming $O packet and %O notification content is accumulated with the
+    current accumulation state put into the OutputQueue.
 
-    All other incoming packets are placed in the packet queue.
+    All other incoming packets and notifications are placed in the packet queue.
 
     A select thread can be started and stopped, and runs to place packet
     content into the two queues.
     """
 
-    _GDB_REMOTE_PACKET_REGEX = re.compile(r'^\$([^\#]*)#[0-9a-fA-F]{2}')
+    _GDB_REMOTE_PACKET_REGEX = re.compile(r'^([\$%])([^\#]*)#[0-9a-fA-F]{2}')
 
     def __init__(self, pump_socket, logger=None):
         if not pump_socket:
@@ -128,9 +133,9 @@ class SocketPacketPump(object):
                     # Our receive buffer matches a packet at the
                     # start of the receive buffer.
                     new_output_content = _handle_output_packet_string(
-                        packet_match.group(1))
+                        packet_match.group(2), packet_match.group(1) == "%")
                     if new_output_content:
-                        # This was an $O packet with new content.
+                        # This was an $O packet or %O notification with new content.
                         self._accumulated_output += new_output_content
                         self._output_queue.put(self._accumulated_output)
                     else:
@@ -302,6 +302,12 @@ void
 Breakpoint::SetCondition (const char *condition)
 {
     m_options.SetCondition (condition);
+
+    // Locations without their own condition use the breakpoint's.
+    const size_t num_locations = m_locations.GetSize();
+    for (size_t i = 0; i < num_locations; ++i)
+        m_locations.GetByIndex(i)->UpdateBreakpointSiteConditions();
+
     SendBreakpointChangedEvent (eBreakpointEventTypeConditionChanged);
 }
 
@@ -414,46 +420,8 @@ Breakpoint::ModulesChanged (ModuleList &module_list, bool load, bool delete_loca
     Mutex::Locker modules_mutex(module_list.GetMutex());
     if (load)
     {
-        // The logic for handling new modules is:
-        // 1) If the filter rejects this module, then skip it.
-        // 2) Run through the current location list and if there are any locations
-        //    for that module, we mark the module as "seen" and we don't try to re-resolve
-        //    breakpoint locations for that module.
-        //    However, we do add breakpoint sites to these locations if needed.
-        // 3) If we don't see this module in our breakpoint location list, call ResolveInModules.
-
-        ModuleList new_modules;  // We'll stuff the "unseen" modules in this list, and then resolve
-                                 // them after the locations pass.  Have to do it this way because
-                                 // resolving breakpoints will add new locations potentially.
-
-        for (ModuleSP module_sp : module_list.ModulesNoLocking())
-        {
-            bool seen = false;
-            if (!m_filter_sp->ModulePasses (module_sp))
-                continue;
-
-            for (BreakpointLocationSP break_loc_sp : m_locations.BreakpointLocations())
-            {
-                if (!break_loc_sp->IsEnabled())
-                    continue;
-                SectionSP section_sp (break_loc_sp->GetAddress().GetSection());
-                if (!section_sp || section_sp->GetModule() == module_sp)
-                {
-                    if (!seen)
-                        seen = true;
-
-                    if (!break_loc_sp->ResolveBreakpointSite())
-                    {
-                        if (log)
-                            log->Printf ("Warning: could not set breakpoint site for breakpoint location %d of breakpoint %d.\n",
-                                         break_loc_sp->GetID(), GetID());
-                    }
-                }
-            }
-
-            if (!seen)
-                new_modules.AppendIfNeeded (module_sp);
-        }
+        ModuleList new_modules;
+        FindModulesToResolve (module_list, new_modules);
         
         if (new_modules.GetSize() > 0)
         {
@@ -513,6 +481,106 @@ Breakpoint::ModulesChanged (ModuleList &module_list, bool load, bool delete_loca
     }
 }
 
+void
+Breakpoint::FindModulesToResolve (ModuleList &module_list, ModuleList &new_modules)
+{
+    // The logic for handling new modules is:
+    // 1) If the filter rejects this module, then skip it.
+    // 2) Run through the current location list and if there are any locations
+    //    for that module, we mark the module as "seen" and we don't try to re-resolve
+    //    breakpoint locations for that module.
+    //    However, we do add breakpoint sites to these locations if needed.
+    // 3) If we don't see this module in our breakpoint location list, the caller resolves it.
+    //
+    // We stuff the "unseen" modules in new_modules, and they are resolved after the
+    // locations pass.  Have to do it this way because resolving breakpoints will add
+    // new locations potentially.
+
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+
+    for (ModuleSP module_sp : module_list.ModulesNoLocking())
+    {
+        bool seen = false;
+        if (!m_filter_sp->ModulePasses (module_sp))
+            continue;
+
+        for (BreakpointLocationSP break_loc_sp : m_locations.BreakpointLocations())
+        {
+            if (!break_loc_sp->IsEnabled())
+                continue;
+            SectionSP section_sp (break_loc_sp->GetAddress().GetSection());
+            if (!section_sp || section_sp->GetModule() == module_sp)
+            {
+                if (!seen)
+                    seen = true;
+
+                if (!break_loc_sp->ResolveBreakpointSite())
+                {
+                    if (log)
+                        log->Printf ("Warning: could not set breakpoint site for breakpoint location %d of breakpoint %d.\n",
+                                     break_loc_sp->GetID(), GetID());
+                }
+            }
+        }
+
+        if (!seen)
+            new_modules.AppendIfNeeded (module_sp);
+    }
+}
+
+bool
+Breakpoint::SupportsDeferredLocations () const
+{
+    return m_resolver_sp && m_resolver_sp->SupportsDeferredLocations();
+}
+
+bool
+Breakpoint::FindDeferredLocations (const ModuleSP &module_sp, std::vector<DeferredLocation> &locations)
+{
+    if (!SupportsDeferredLocations())
+        return false;
+
+    // Search with a copy of the resolver, so searches of other modules can
+    // run at the same time without sharing any resolver state.
+    BreakpointResolverSP resolver_sp (m_resolver_sp->CopyForBreakpoint (*this));
+    resolver_sp->SetDeferredLocations (&locations);
+
+    ModuleList module_list;
+    module_list.Append (module_sp);
+    resolver_sp->ResolveBreakpointInModules (*m_filter_sp, module_list);
+    return true;
+}
+
+void
+Breakpoint::AddDeferredLocations (const std::vector<DeferredLocation> &locations)
+{
+    if (locations.empty())
+        return;
+
+    BreakpointEventData *new_locations_event = nullptr;
+    if (!IsInternal())
+    {
+        new_locations_event = new BreakpointEventData (eBreakpointEventTypeLocationsAdded, shared_from_this());
+        m_locations.StartRecordingNewLocations (new_locations_event->GetBreakpointLocationCollection());
+    }
+
+    for (const DeferredLocation &location : locations)
+    {
+        BreakpointLocationSP bp_loc_sp (AddLocation (location.addr));
+        if (bp_loc_sp && location.is_reexported != eLazyBoolCalculate)
+            bp_loc_sp->SetIsReExported (location.is_reexported == eLazyBoolYes);
+    }
+
+    if (new_locations_event)
+    {
+        m_locations.StopRecordingNewLocations();
+        if (new_locations_event->GetBreakpointLocationCollection().GetSize() != 0)
+            SendBreakpointChangedEvent (new_locations_event);
+        else
+            delete new_locations_event;
+    }
+}
+
 namespace
 {
 static bool
@@ -13,7 +13,11 @@
 // C++ Includes
 // Other libraries and framework includes
 // Project includes
+#include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
 #include "lldb/Target/Target.h"
+#include "lldb/Utility/TaskPool.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -213,9 +217,78 @@ void
 BreakpointList::UpdateBreakpoints (ModuleList& module_list, bool added, bool delete_locations)
 {
     Mutex::Locker locker(m_mutex);
+
+    // A single module is resolved serially: it is usually added while the
+    // target's image list is locked, and searching it on the task pool
+    // wouldn't overlap anything anyway.
+    if (!added || module_list.GetSize() < 2)
+    {
+        for (const auto &bp_sp : m_breakpoints)
+            bp_sp->ModulesChanged (module_list, added, delete_locations);
+        return;
+    }
+
+    // Otherwise search the new modules concurrently, one task per module.
+    // The searches only collect addresses, the locations and their sites
+    // are added afterwards in the same order as a serial resolve would.
+    Mutex::Locker modules_locker(module_list.GetMutex());
+
+    const size_t num_modules = module_list.GetSize();
+    std::vector<BreakpointSP> deferred_breakpoints;
+    std::vector<ModuleList> modules_to_resolve;
     for (const auto &bp_sp : m_breakpoints)
-        bp_sp->ModulesChanged (module_list, added, delete_locations);
+    {
+        ModuleList new_modules;
+        bp_sp->FindModulesToResolve (module_list, new_modules);
+        if (new_modules.GetSize() == 0)
+            continue;
 
+        if (bp_sp->SupportsDeferredLocations())
+        {
+            deferred_breakpoints.push_back (bp_sp);
+            modules_to_resolve.push_back (new_modules);
+        }
+        else
+            bp_sp->ResolveBreakpointInModules (new_modules);
+    }
+
+    if (deferred_breakpoints.empty())
+        return;
+
+    const size_t num_breakpoints = deferred_breakpoints.size();
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+    {
+        size_t num_searches = 0;
+        for (const ModuleList &new_modules : modules_to_resolve)
+            num_searches += new_modules.GetSize();
+        log->Printf ("BreakpointList::UpdateBreakpoints: searching %zu modules for %zu breakpoints concurrently, %zu searches\n",
+                     num_modules, num_breakpoints, num_searches);
+    }
+
+    typedef std::vector<Breakpoint::DeferredLocation> DeferredLocations;
+    std::vector<std::vector<DeferredLocations>> locations (num_modules, std::vector<DeferredLocations> (num_breakpoints));
+
+    TaskMapOverInt (0, num_modules, [&](size_t module_idx)
+    {
+        ModuleSP module_sp (module_list.GetModuleAtIndexUnlocked (module_idx));
+        for (size_t bp_idx = 0; bp_idx < num_breakpoints; ++bp_idx)
+        {
+            if (modules_to_resolve[bp_idx].FindModule (module_sp.get()))
+                deferred_breakpoints[bp_idx]->FindDeferredLocations (module_sp, locations[module_idx][bp_idx]);
+        }
+    });
+
+    for (size_t bp_idx = 0; bp_idx < num_breakpoints; ++bp_idx)
+    {
+        DeferredLocations bp_locations;
+        for (size_t module_idx = 0; module_idx < num_modules; ++module_idx)
+        {
+            DeferredLocations &module_locations = locations[module_idx][bp_idx];
+            bp_locations.insert (bp_locations.end(), module_locations.begin(), module_locations.end());
+        }
+        deferred_breakpoints[bp_idx]->AddDeferredLocations (bp_locations);
+    }
 }
 
 void
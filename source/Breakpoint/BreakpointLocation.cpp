@@ -253,9 +253,21 @@ void
 BreakpointLocation::SetCondition (const char *condition)
 {
     GetLocationOptions()->SetCondition (condition);
+    UpdateBreakpointSiteConditions ();
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeConditionChanged);
 }
 
+void
+BreakpointLocation::UpdateBreakpointSiteConditions ()
+{
+    if (!m_bp_site_sp)
+        return;
+
+    ProcessSP process_sp (m_owner.GetTarget().GetProcessSP());
+    if (process_sp && process_sp->IsAlive())
+        process_sp->UpdateBreakpointSiteConditions (m_bp_site_sp.get());
+}
+
 const char *
 BreakpointLocation::GetConditionText (size_t *hash) const
 {
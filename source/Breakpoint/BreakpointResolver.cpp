@@ -34,6 +34,7 @@ using namespace lldb;
 //----------------------------------------------------------------------
 BreakpointResolver::BreakpointResolver (Breakpoint *bkpt, const unsigned char resolverTy) :
     m_breakpoint (bkpt),
+    m_deferred_locations (nullptr),
     SubclassID (resolverTy)
 {
 }
@@ -49,6 +50,23 @@ BreakpointResolver::SetBreakpoint (Breakpoint *bkpt)
     m_breakpoint = bkpt;
 }
 
+BreakpointLocationSP
+BreakpointResolver::AddLocation (const Address &addr, bool *new_location, LazyBool is_reexported)
+{
+    if (m_deferred_locations)
+    {
+        if (new_location)
+            *new_location = false;
+        m_deferred_locations->push_back (Breakpoint::DeferredLocation (addr, is_reexported));
+        return BreakpointLocationSP();
+    }
+
+    BreakpointLocationSP bp_loc_sp (m_breakpoint->AddLocation (addr, new_location));
+    if (bp_loc_sp && is_reexported != eLazyBoolCalculate)
+        bp_loc_sp->SetIsReExported (is_reexported == eLazyBoolYes);
+    return bp_loc_sp;
+}
+
 void
 BreakpointResolver::ResolveBreakpointInModules (SearchFilter &filter, ModuleList &modules)
 {
@@ -176,7 +194,7 @@ BreakpointResolver::SetSCMatchesByLine (SearchFilter &filter, SymbolContextList
                             }
                         }
                     
-                        BreakpointLocationSP bp_loc_sp (m_breakpoint->AddLocation(line_start));
+                        BreakpointLocationSP bp_loc_sp (AddLocation(line_start));
                         if (log && bp_loc_sp && !m_breakpoint->IsInternal())
                         {
                             StreamString s;
@@ -72,7 +72,11 @@ BreakpointResolverFileLine::SearchCallback
     // the resultant list.  The closest line match for one will not be right for some totally different file.
     // So we go through the match list and pull out the sets that have the same file spec in their line_entry
     // and treat each set separately.
-    
+
+    // Most modules don't have the file at all, so don't look at their line tables.
+    if (!context.module_sp->MayContainSourceFile (m_file_spec))
+        return Searcher::eCallbackReturnContinue;
+
     const size_t num_comp_units = context.module_sp->GetNumCompileUnits();
     for (size_t i = 0; i < num_comp_units; i++)
     {
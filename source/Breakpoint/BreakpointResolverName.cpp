@@ -224,6 +224,10 @@ BreakpointResolverName::SearchCallback(SearchFilter &filter,
             {
                 for (const LookupInfo &lookup : m_lookups)
                 {
+                    // Skip modules that can't define the name without searching them.
+                    if (!context.module_sp->MayContainFunctionName(lookup.lookup_name))
+                        continue;
+
                     const size_t start_func_idx = func_list.GetSize();
                     context.module_sp->FindFunctions(lookup.lookup_name,
                                                      nullptr,
@@ -344,8 +348,9 @@ BreakpointResolverName::SearchCallback(SearchFilter &filter,
                 {
                     if (filter.AddressPasses(break_addr))
                     {
-                        BreakpointLocationSP bp_loc_sp (m_breakpoint->AddLocation(break_addr, &new_location));
-                        bp_loc_sp->SetIsReExported(is_reexported);
+                        BreakpointLocationSP bp_loc_sp (AddLocation(break_addr,
+                                                                    &new_location,
+                                                                    is_reexported ? eLazyBoolYes : eLazyBoolNo));
                         if (bp_loc_sp && new_location && !m_breakpoint->IsInternal())
                         {
                             if (log)
@@ -652,7 +652,7 @@ protected:
                 bp->GetOptions()->SetIgnoreCount(m_options.m_ignore_count);
 
             if (!m_options.m_condition.empty())
-                bp->GetOptions()->SetCondition(m_options.m_condition.c_str());
+                bp->SetCondition(m_options.m_condition.c_str());
 
             if (!m_options.m_breakpoint_names.empty())
             {
@@ -14,6 +14,7 @@
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Interpreter/Args.h"
+#include "lldb/Core/ConstString.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Core/Log.h"
@@ -378,6 +379,22 @@ protected:
     }
 };
 
+//----------------------------------------------------------------------
+// Dump how often uniqued strings were found in the per-thread caches and
+// how contended the shared string pool was since lldb started.
+//----------------------------------------------------------------------
+static void
+DumpStringPoolStatistics (Stream &strm)
+{
+    const ConstString::PoolStatistics stats = ConstString::GetPoolStatistics();
+    strm.Printf ("String pool: %" PRIu64 " bytes, %" PRIu64 " thread cache hits, %" PRIu64 " pool lookups, %" PRIu64 " insertions, %" PRIu64 " contended lookups\n",
+                 (uint64_t)ConstString::StaticMemorySize(),
+                 stats.thread_cache_hits,
+                 stats.pool_lookups,
+                 stats.pool_insertions,
+                 stats.contended_lookups);
+}
+
 class CommandObjectLogTimer : public CommandObjectParsed
 {
 public:
@@ -387,7 +404,7 @@ public:
     CommandObjectLogTimer(CommandInterpreter &interpreter) :
         CommandObjectParsed (interpreter,
                            "log timers",
-                           "Enable, disable, dump, and reset LLDB internal performance timers.",
+                           "Enable, disable, dump, and reset LLDB internal performance timers. Dumping also shows the string pool statistics.",
                            "log timers < enable <depth> | disable | dump | increment <bool> | reset >")
     {
     }
@@ -416,12 +433,14 @@ protected:
             else if (strcasecmp(sub_command, "disable") == 0)
             {
                 Timer::DumpCategoryTimes (&result.GetOutputStream());
+                DumpStringPoolStatistics (result.GetOutputStream());
                 Timer::SetDisplayDepth (0);
                 result.SetStatus(eReturnStatusSuccessFinishResult);
             }
             else if (strcasecmp(sub_command, "dump") == 0)
             {
                 Timer::DumpCategoryTimes (&result.GetOutputStream());
+                DumpStringPoolStatistics (result.GetOutputStream());
                 result.SetStatus(eReturnStatusSuccessFinishResult);
             }
             else if (strcasecmp(sub_command, "reset") == 0)
@@ -4565,6 +4565,12 @@ protected:
                 }
                 // Clear the symbol file spec if anything went wrong
                 module_sp->SetSymbolFileFileSpec (FileSpec());
+
+                // The module's symbols were replaced twice on the way here,
+                // drop the unwinder's symbol lookups that point into them.
+                ProcessSP process_sp (target->GetProcessSP());
+                if (process_sp)
+                    process_sp->GetUnwindSymbolCache().Clear();
             }
 
             if (module_spec.GetUUID().IsValid())
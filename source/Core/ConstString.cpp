@@ -10,20 +10,72 @@
 #include "lldb/Core/Stream.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringExtras.h"
-#include "llvm/Support/RWMutex.h"
+#include "llvm/Support/Compiler.h"
 
 #include <array>
+#include <atomic>
 #include <mutex>
 
 using namespace lldb_private;
 
+namespace
+{
+    // Every thread keeps a small direct mapped cache of the strings it
+    // uniqued last, so repeated lookups of common strings (type names,
+    // "this", ...) don't have to lock one of the pool's shards.
+    const uint32_t kThreadCacheSize = 256; // Must be a power of two
+    LLVM_THREAD_LOCAL const char *g_thread_cache[kThreadCacheSize];
+
+    // Thread cache hits are accumulated per thread and only added to the
+    // pool statistics in batches to avoid a shared counter on the fast
+    // path.
+    const uint32_t kThreadCacheHitsBatchSize = 64;
+    LLVM_THREAD_LOCAL uint32_t g_thread_cache_hits;
+}
+
 class Pool
 {
 public:
-    typedef const char * StringPoolValueType;
+    //------------------------------------------------------------------
+    // The mangled counterpart is read without taking a lock, so it is
+    // stored as an atomic. StringMap requires copyable values, which
+    // std::atomic isn't.
+    //------------------------------------------------------------------
+    struct StringPoolValueType
+    {
+        StringPoolValueType (const char *ccstr = nullptr) :
+            m_ccstr (ccstr)
+        {
+        }
+
+        StringPoolValueType (const StringPoolValueType &rhs) :
+            m_ccstr (rhs.Get ())
+        {
+        }
+
+        const char *
+        Get () const
+        {
+            return m_ccstr.load (std::memory_order_acquire);
+        }
+
+        void
+        Set (const char *ccstr)
+        {
+            m_ccstr.store (ccstr, std::memory_order_release);
+        }
+
+        std::atomic<const char *> m_ccstr;
+    };
     typedef llvm::StringMap<StringPoolValueType, llvm::BumpPtrAllocator> StringPool;
     typedef llvm::StringMapEntry<StringPoolValueType> StringPoolEntryType;
 
+    Pool () :
+        m_string_pools (),
+        m_thread_cache_hits (0)
+    {
+    }
+
     static StringPoolEntryType &
     GetStringMapEntryFromKeyData (const char *keyData)
     {
@@ -31,29 +83,23 @@ public:
         return *reinterpret_cast<StringPoolEntryType*>(ptr);
     }
 
+    // Entries are allocated in a BumpPtrAllocator and never move or get
+    // freed, and the key length never changes after insertion, so the
+    // length of a uniqued string can be read without locking its shard.
     size_t
     GetConstCStringLength (const char *ccstr) const
     {
         if (ccstr)
-        {
-            const uint8_t h = hash (llvm::StringRef(ccstr));
-            llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-            const StringPoolEntryType& entry = GetStringMapEntryFromKeyData (ccstr);
-            return entry.getKey().size();
-        }
+            return GetStringMapEntryFromKeyData (ccstr).getKeyLength();
         return 0;
     }
 
-    StringPoolValueType
+    const char *
     GetMangledCounterpart (const char *ccstr) const
     {
         if (ccstr)
-        {
-            const uint8_t h = hash (llvm::StringRef(ccstr));
-            llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-            return GetStringMapEntryFromKeyData (ccstr).getValue();
-        }
-        return 0;
+            return GetStringMapEntryFromKeyData (ccstr).getValue().Get();
+        return nullptr;
     }
 
     bool
@@ -61,16 +107,8 @@ public:
     {
         if (key_ccstr && value_ccstr)
         {
-            {
-                const uint8_t h = hash (llvm::StringRef(key_ccstr));
-                llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-                GetStringMapEntryFromKeyData (key_ccstr).setValue(value_ccstr);
-            }
-            {
-                const uint8_t h = hash (llvm::StringRef(value_ccstr));
-                llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-                GetStringMapEntryFromKeyData (value_ccstr).setValue(key_ccstr);
-            }
+            GetStringMapEntryFromKeyData (key_ccstr).getValue().Set(value_ccstr);
+            GetStringMapEntryFromKeyData (value_ccstr).getValue().Set(key_ccstr);
             return true;
         }
         return false;
@@ -97,18 +135,22 @@ public:
     {
         if (string_ref.data())
         {
-            const uint8_t h = hash (string_ref);
-
+            const uint32_t full_hash = llvm::HashString (string_ref);
+            const char *&cached_ccstr = g_thread_cache[full_hash & (kThreadCacheSize - 1)];
+            if (cached_ccstr &&
+                GetConstCStringLength (cached_ccstr) == string_ref.size() &&
+                ::memcmp (cached_ccstr, string_ref.data(), string_ref.size()) == 0)
             {
-                llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-                auto it = m_string_pools[h].m_string_map.find (string_ref);
-                if (it != m_string_pools[h].m_string_map.end())
-                    return it->getKeyData();
+                if (++g_thread_cache_hits == kThreadCacheHitsBatchSize)
+                {
+                    m_thread_cache_hits += kThreadCacheHitsBatchSize;
+                    g_thread_cache_hits = 0;
+                }
+                return cached_ccstr;
             }
 
-            llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-            StringPoolEntryType& entry = *m_string_pools[h].m_string_map.insert (std::make_pair (string_ref, nullptr)).first;
-            return entry.getKeyData();
+            cached_ccstr = Insert (full_hash, string_ref, nullptr);
+            return cached_ccstr;
         }
         return nullptr;
     }
@@ -118,28 +160,13 @@ public:
     {
         if (demangled_cstr)
         {
-            const char *demangled_ccstr = nullptr;
-
-            {
-                llvm::StringRef string_ref (demangled_cstr);
-                const uint8_t h = hash (string_ref);
-                llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-
-                // Make string pool entry with the mangled counterpart already set
-                StringPoolEntryType& entry = *m_string_pools[h].m_string_map.insert (
-                    std::make_pair (string_ref, mangled_ccstr)).first;
-
-                // Extract the const version of the demangled_cstr
-                demangled_ccstr = entry.getKeyData();
-            }
+            // Make string pool entry with the mangled counterpart already set
+            llvm::StringRef string_ref (demangled_cstr);
+            const char *demangled_ccstr = Insert (llvm::HashString (string_ref), string_ref, mangled_ccstr);
 
-            {
-                // Now assign the demangled const string as the counterpart of the
-                // mangled const string...
-                const uint8_t h = hash (llvm::StringRef(mangled_ccstr));
-                llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-                GetStringMapEntryFromKeyData (mangled_ccstr).setValue(demangled_ccstr);
-            }
+            // Now assign the demangled const string as the counterpart of the
+            // mangled const string...
+            GetStringMapEntryFromKeyData (mangled_ccstr).getValue().Set(demangled_ccstr);
 
             // Return the constant demangled C string
             return demangled_ccstr;
@@ -169,28 +196,83 @@ public:
         size_t mem_size = sizeof(Pool);
         for (const auto& pool : m_string_pools)
         {
-            llvm::sys::SmartScopedReader<false> rlock(pool.m_mutex);
+            std::lock_guard<std::mutex> guard(pool.m_mutex);
             for (const auto& entry : pool.m_string_map)
                 mem_size += sizeof(StringPoolEntryType) + entry.getKey().size();
         }
         return mem_size;
     }
 
+    ConstString::PoolStatistics
+    GetStatistics() const
+    {
+        ConstString::PoolStatistics stats;
+        stats.thread_cache_hits = m_thread_cache_hits;
+        stats.pool_lookups = 0;
+        stats.pool_insertions = 0;
+        stats.contended_lookups = 0;
+        for (const auto& pool : m_string_pools)
+        {
+            std::lock_guard<std::mutex> guard(pool.m_mutex);
+            stats.pool_lookups += pool.m_num_lookups;
+            stats.pool_insertions += pool.m_num_insertions;
+            stats.contended_lookups += pool.m_num_contended_lookups;
+        }
+        return stats;
+    }
+
 protected:
     uint8_t
-    hash(const llvm::StringRef &s) const
+    hash(uint32_t h) const
     {
-        uint32_t h = llvm::HashString(s);
         return ((h >> 24) ^ (h >> 16) ^ (h >> 8) ^ h) & 0xff;
     }
 
+    //------------------------------------------------------------------
+    // Find or insert "string_ref" in its shard with a single lock
+    // acquisition. "mangled_ccstr" is only used for new entries.
+    //------------------------------------------------------------------
+    const char *
+    Insert (uint32_t full_hash, const llvm::StringRef &string_ref, const char *mangled_ccstr)
+    {
+        PoolEntry &pool = m_string_pools[hash (full_hash)];
+        std::unique_lock<std::mutex> lock (pool.m_mutex, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            lock.lock();
+            ++pool.m_num_contended_lookups;
+        }
+
+        ++pool.m_num_lookups;
+        auto result = pool.m_string_map.insert (std::make_pair (string_ref, StringPoolValueType (mangled_ccstr)));
+        if (result.second)
+            ++pool.m_num_insertions;
+        return result.first->getKeyData();
+    }
+
     struct PoolEntry
     {
-        mutable llvm::sys::SmartRWMutex<false> m_mutex;
+        PoolEntry () :
+            m_mutex (),
+            m_string_map (),
+            m_num_lookups (0),
+            m_num_insertions (0),
+            m_num_contended_lookups (0)
+        {
+        }
+
+        // Lookups are only done on thread cache misses, so a plain mutex
+        // is held for about as long as a reader/writer lock would be, and
+        // it lets us count how often threads had to wait for each other.
+        mutable std::mutex m_mutex;
         StringPool m_string_map;
+        uint64_t m_num_lookups;           // All counters are protected by m_mutex
+        uint64_t m_num_insertions;
+        uint64_t m_num_contended_lookups;
     };
 
     std::array<PoolEntry, 256> m_string_pools;
+    std::atomic<uint64_t> m_thread_cache_hits;
 };
 
 //----------------------------------------------------------------------
@@ -353,3 +435,9 @@ ConstString::StaticMemorySize()
     // Get the size of the static string pool
     return StringPool().MemorySize();
 }
+
+ConstString::PoolStatistics
+ConstString::GetPoolStatistics()
+{
+    return StringPool().GetStatistics();
+}
@@ -53,6 +53,7 @@
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Utility/AnsiTerminal.h"
+#include "lldb/Utility/TaskPool.h"
 
 #include "llvm/Support/DynamicLibrary.h"
 
@@ -163,6 +164,7 @@ g_properties[] =
 {   "print-decls",              OptionValue::eTypeBoolean     , true, true , NULL, NULL, "If true, LLDB will print the values of variables declared in an expression. Currently only supported in the REPL (default: true)." },
 {   "tab-size",                 OptionValue::eTypeUInt64      , true, 4    , NULL, NULL, "The tab size to use when indenting code in multi-line input mode (default: 4)." },
 {   "escape-non-printables",    OptionValue::eTypeBoolean     , true, true, NULL, NULL, "If true, LLDB will automatically escape non-printable and escape characters when formatting strings." },
+{   "task-pool-threads",        OptionValue::eTypeUInt64      , true, 0    , NULL, NULL, "The number of worker threads LLDB uses for parallel work such as indexing debug information. Zero means the value of the LLDB_TASK_POOL_THREADS environment variable if set, or the number of hardware threads. Only takes effect if set before the first target is created." },
 {   NULL,                       OptionValue::eTypeInvalid     , true, 0    , NULL, NULL, NULL }
 };
 
@@ -186,7 +188,8 @@ enum
     ePropertyAutoIndent,
     ePropertyPrintDecls,
     ePropertyTabSize,
-    ePropertyEscapeNonPrintables
+    ePropertyEscapeNonPrintables,
+    ePropertyTaskPoolThreads
 };
 
 LoadPluginCallbackType Debugger::g_load_plugin_callback = NULL;
@@ -250,6 +253,11 @@ Debugger::SetPropertyValue (const ExecutionContext *exe_ctx,
         {
             DataVisualization::ForceUpdate();
         }
+        else if (strcmp(property_path, g_properties[ePropertyTaskPoolThreads].name) == 0)
+        {
+            // This is ignored once the task pool has started its worker threads.
+            TaskPool::SetThreadCount(GetTaskPoolThreads());
+        }
     }
     return error;
 }
@@ -443,6 +451,13 @@ Debugger::SetTabSize (uint32_t tab_size)
     return m_collection_sp->SetPropertyAtIndexAsUInt64 (NULL, idx, tab_size);
 }
 
+uint32_t
+Debugger::GetTaskPoolThreads () const
+{
+    const uint32_t idx = ePropertyTaskPoolThreads;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
 
 #pragma mark Debugger
 
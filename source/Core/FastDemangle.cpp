@@ -62,6 +62,9 @@ struct BufferRange
 {
     int offset;
     int length;
+    bool is_function_or_array; // Can't have qualifiers appended, eg: void (*)(int)
+    bool is_pack;              // A template argument pack, written as its comma separated elements
+    int pack_size;
 };
 
 /// @brief Transient state required while parsing a name
@@ -321,13 +324,14 @@ private:
     }
 
     void
-    EndSubstitution(int start_cookie)
+    EndSubstitution(int start_cookie, bool is_function_or_array = false)
     {
         if (m_next_substitute_index == m_next_template_arg_index)
             GrowRewriteRanges();
 
         int index = m_next_substitute_index++;
         m_rewrite_ranges[index] = EndRange(start_cookie);
+        m_rewrite_ranges[index].is_function_or_array = is_function_or_array;
 #ifdef DEBUG_SUBSTITUTIONS
         printf("Saved substitution # %d = %.*s\n", index,
                m_rewrite_ranges[index].length, m_buffer + start_cookie);
@@ -335,13 +339,22 @@ private:
     }
 
     void
-    EndTemplateArg(int start_cookie)
+    EndTemplateArg(int start_cookie, bool is_function_or_array = false, int pack_size = -1)
     {
         if (m_next_substitute_index == m_next_template_arg_index)
             GrowRewriteRanges();
 
         int index = m_next_template_arg_index--;
         m_rewrite_ranges[index] = EndRange(start_cookie);
+        m_rewrite_ranges[index].is_function_or_array = is_function_or_array;
+        if (pack_size >= 0)
+        {
+            // Packs are split into their elements again when expanded, which
+            // isn't possible if an element looks like more than one
+            m_rewrite_ranges[index].is_pack = true;
+            m_rewrite_ranges[index].pack_size =
+                CountPackElements(m_rewrite_ranges[index]) == pack_size ? pack_size : -1;
+        }
 #ifdef DEBUG_TEMPLATE_ARGS
         printf("Saved template arg # %d = %.*s\n",
                m_rewrite_ranges_size - index - 1,
@@ -349,12 +362,26 @@ private:
 #endif
     }
 
+    // Records a substitution candidate that has no contiguous representation
+    // in the output, such as the function type inside void (*)(int).  Any
+    // reference to it fails the demangling.
+
+    void
+    EndUnrepresentableSubstitution()
+    {
+        if (m_next_substitute_index == m_next_template_arg_index)
+            GrowRewriteRanges();
+
+        int index = m_next_substitute_index++;
+        m_rewrite_ranges[index] = { 0, -1, true, false, 0 };
+    }
+
     void
     ResetTemplateArgs()
     {
         //TODO: this works, but is it the right thing to do?
         // Should we push/pop somehow at the call sites?
-        m_next_template_arg_index = m_rewrite_ranges_size - 1;
+        m_next_template_arg_index = m_rewrite_ranges_size - 1 - m_enclosing_template_arg_count;
     }
 
     //----------------------------------------------------
@@ -458,6 +485,60 @@ private:
         }
     }
 
+    void
+    WritePointerOrReference(char kind)
+    {
+        if (kind == 'P')
+            Write('*');
+        else if (kind == 'R')
+            Write('&');
+        else WRITE("&&");
+    }
+
+    // Appends a pointer or reference to the type just written, collapsing
+    // references to references the way the language does: T& && is T&,
+    // T&& && is T&& and so on.  Returns false when collapsing would require
+    // removing output that may already be recorded as a substitution.
+
+    bool
+    WriteCollapsedPointerOrReference(char kind)
+    {
+        if (kind == 'P' || m_write_ptr == m_buffer || *(m_write_ptr - 1) != '&')
+        {
+            WritePointerOrReference(kind);
+            return true;
+        }
+        bool is_rvalue_reference = m_write_ptr - m_buffer >= 2 && *(m_write_ptr - 2) == '&';
+        if (kind == 'R' && is_rvalue_reference)
+        {
+#ifdef DEBUG_FAILURES
+            printf("*** Unsupported reference collapsing\n");
+#endif
+            return false;
+        }
+        return true;
+    }
+
+    // Empty argument packs don't produce any output, not even a separator.
+    // Anything recorded for the empty range is still empty after the
+    // separator is dropped.
+
+    void
+    DropSeparatorIfEmpty(int separator_cookie, int item_cookie, bool & first_item)
+    {
+        if (GetStartCookie() == item_cookie)
+            m_write_ptr = m_buffer + separator_cookie;
+        else first_item = false;
+    }
+
+    bool
+    EndsWith(const char *suffix)
+    {
+        long length = strlen(suffix);
+        return m_write_ptr - m_buffer >= length &&
+               memcmp(m_write_ptr - length, suffix, length) == 0;
+    }
+
     //----------------------------------------------------
     // Rewrite methods
     //
@@ -478,17 +559,25 @@ private:
         {
 #ifdef DEBUG_FAILURES
             printf("*** Invalid substitution #%d\n", index);
+#endif
+            return false;
+        }
+        if (m_rewrite_ranges[index].length < 0)
+        {
+#ifdef DEBUG_FAILURES
+            printf("*** Unrepresentable substitution #%d\n", index);
 #endif
             return false;
         }
         RewriteRange(m_rewrite_ranges[index]);
+        m_last_rewrite_is_function_or_array = m_rewrite_ranges[index].is_function_or_array;
         return true;
     }
 
     bool
     RewriteTemplateArg(int template_index)
     {
-        int index = m_rewrite_ranges_size - 1 - template_index;
+        int index = m_rewrite_ranges_size - 1 - m_enclosing_template_arg_count - template_index;
         if (template_index < 0 || index <= m_next_template_arg_index)
         {
 #ifdef DEBUG_FAILURES
@@ -496,7 +585,82 @@ private:
 #endif
             return false;
         }
-        RewriteRange(m_rewrite_ranges[index]);
+        BufferRange range = m_rewrite_ranges[index];
+        m_last_rewrite_is_function_or_array = range.is_function_or_array;
+        if (range.is_pack)
+            return RewritePackElement(range);
+        RewriteRange(range);
+        return true;
+    }
+
+    // Returns the number of elements in an argument pack, found by looking
+    // for separators outside of any brackets
+
+    int
+    CountPackElements(BufferRange pack)
+    {
+        if (pack.length == 0)
+            return 0;
+        int count = 1;
+        int depth = 0;
+        const char *end = m_buffer + pack.offset + pack.length;
+        for (const char *p = m_buffer + pack.offset; p < end; ++p)
+        {
+            switch (*p)
+            {
+                case '<': case '(': case '[': ++depth; break;
+                case '>': case ')': case ']': --depth; break;
+                case ',':
+                    if (depth == 0)
+                        ++count;
+                    break;
+            }
+        }
+        return count;
+    }
+
+    // Writes the element of a template argument pack that is being expanded
+    // by ParsePackExpansion()
+
+    bool
+    RewritePackElement(BufferRange pack)
+    {
+        if (m_pack_element_index < 0 || pack.pack_size < 0 ||
+            (m_pack_size >= 0 && m_pack_size != pack.pack_size))
+        {
+#ifdef DEBUG_FAILURES
+            printf("*** Unsupported template argument pack reference\n");
+#endif
+            return false;
+        }
+        m_pack_size = pack.pack_size;
+        if (m_pack_element_index >= pack.pack_size)
+            return true;
+
+        const char *element = m_buffer + pack.offset;
+        const char *end = element + pack.length;
+        int element_index = 0;
+        int depth = 0;
+        for (const char *p = element; p < end; ++p)
+        {
+            switch (*p)
+            {
+                case '<': case '(': case '[': ++depth; break;
+                case '>': case ')': case ']': --depth; break;
+                case ',':
+                    if (depth != 0)
+                        break;
+                    if (element_index == m_pack_element_index)
+                    {
+                        end = p;
+                        break;
+                    }
+                    ++element_index;
+                    element = p + 2; // Skip ", "
+                    break;
+            }
+        }
+        Write(element, end - element);
         return true;
     }
 
@@ -621,6 +785,7 @@ private:
                     case 'h': return "decimal16";
                     case 'i': return "char32_t";
                     case 's': return "char16_t";
+                    case 'u': return "char8_t";
                     case 'a': return "auto";
                     case 'c': return "decltype(auto)";
                     case 'n': return "std::nullptr_t";
@@ -812,7 +977,7 @@ private:
                 case 'm': return { "%", OperatorKind::Binary };
                 case 'M': return { "%=", OperatorKind::Binary };
                 case 's': return { ">>", OperatorKind::Binary };
-                case 'S': return { ">=", OperatorKind::Binary };
+                case 'S': return { ">>=", OperatorKind::Binary };
             }
                 --m_read_ptr;
                 break;
@@ -925,8 +1090,12 @@ private:
     bool
     Parse(char character)
     {
-        if (*m_read_ptr++ == character)
+        // Never step past the terminating null of a malformed mangled name
+        if (*m_read_ptr == character)
+        {
+            ++m_read_ptr;
             return true;
+        }
 #ifdef DEBUG_FAILURES
         printf("*** Expected '%c'\n", character);
 #endif
@@ -973,18 +1142,36 @@ private:
     // <substitution> ::= So # ::std::basic_ostream<char,  std::char_traits<char> >
     // <substitution> ::= Sd # ::std::basic_iostream<char, std::char_traits<char> >
 
+    //
+    // When parsing a nested name prefix, name_state is updated so that the
+    // abbreviations can be followed by constructors and destructors, which
+    // use the unabbreviated class name.
+
     bool
-    ParseSubstitution()
+    ParseSubstitution(NameState *name_state = nullptr)
     {
         const char *substitution;
+        const char *expanded_substitution = nullptr;
         switch (*m_read_ptr)
         {
             case 'a': substitution = "std::allocator"; break;
             case 'b': substitution = "std::basic_string"; break;
-            case 's': substitution = "std::string"; break;
-            case 'i': substitution = "std::istream"; break;
-            case 'o': substitution = "std::ostream"; break;
-            case 'd': substitution = "std::iostream"; break;
+            case 's':
+                substitution = "std::string";
+                expanded_substitution = "std::basic_string<char, std::char_traits<char>, std::allocator<char> >";
+                break;
+            case 'i':
+                substitution = "std::istream";
+                expanded_substitution = "std::basic_istream<char, std::char_traits<char> >";
+                break;
+            case 'o':
+                substitution = "std::ostream";
+                expanded_substitution = "std::basic_ostream<char, std::char_traits<char> >";
+                break;
+            case 'd':
+                substitution = "std::iostream";
+                expanded_substitution = "std::basic_iostream<char, std::char_traits<char> >";
+                break;
             default:
                 // A failed attempt to parse a number will return -1 which turns out to be
                 // perfect here as S_ is the first substitution, S0_ the next and so forth
@@ -998,48 +1185,70 @@ private:
                 }
                 return RewriteSubstitution (substitution_index + 1);
         }
-        Write(substitution);
         ++m_read_ptr;
+        if (name_state)
+        {
+            char next = *m_read_ptr;
+            if (expanded_substitution && (next == 'C' || next == 'D'))
+                substitution = expanded_substitution;
+
+            // Skip the std:: prefix and any template arguments
+            const char *name = substitution + 5;
+            name_state->last_name_range = { GetStartCookie() + 5, (int)strcspn(name, "<") };
+        }
+        Write(substitution);
         return true;
     }
 
     // <function-type> ::= F [Y] <bare-function-type> [<ref-qualifier>] E
     //
     // <bare-function-type> ::= <signature type>+      # types are possible return type, then parameter types
+    //
+    // Function types bracket the declarator of pointers and references to
+    // them, eg: int (*)() or void (Class::*)(int) const.  When a declarator
+    // is present it has already been written starting at declarator_cookie,
+    // and the return type is moved in front of it.  cv_qualifiers are the
+    // qualifiers of a member function type.
 
     bool
-    ParseFunctionType (int inner_qualifiers = QualifierNone)
+    ParseFunctionType (int declarator_cookie = -1, int cv_qualifiers = QualifierNone)
     {
-#ifdef DEBUG_FAILURES
-        printf("*** Function types not supported\n");
-#endif
-        //TODO: first steps toward an implementation follow, but they're far
-        // from complete.  Function types tend to bracket other types eg:
-        // int (*)() when used as the type for "name" becomes int (*name)().
-        // This makes substitution et al ... interesting.
-        return false;
-
-#if 0 // TODO
         if (*m_read_ptr == 'Y')
             ++m_read_ptr;
 
         int return_type_start_cookie = GetStartCookie();
         if (!ParseType())
             return false;
+        if (m_last_type_is_function_or_array)
+        {
+#ifdef DEBUG_FAILURES
+            printf("*** Functions returning function pointers unsupported\n");
+#endif
+            return false;
+        }
         Write(' ');
+        if (declarator_cookie >= 0)
+        {
+            Write('(');
+            ReorderRange (EndRange (return_type_start_cookie), declarator_cookie);
+            Write(')');
+        }
 
-        int insert_cookie = GetStartCookie();
         Write('(');
         bool first_param = true;
-        int qualifiers = QualifierNone;
+        int ref_qualifiers = QualifierNone;
         while (true)
         {
             switch (*m_read_ptr)
             {
                 case 'E':
                     ++m_read_ptr;
-                    Write(')');
                     break;
+                case '\0':
+#ifdef DEBUG_FAILURES
+                    printf("*** Unterminated function type\n");
+#endif
+                    return false;
                 case 'v':
                     ++m_read_ptr;
                     continue;
@@ -1047,131 +1256,169 @@ private:
                 case 'O':
                     if (*(m_read_ptr + 1) == 'E')
                     {
-                        qualifiers = TryParseQualifiers (false, true);
-                        Parse('E');
+                        ref_qualifiers = TryParseQualifiers (false, true);
+                        ++m_read_ptr;
                         break;
                     }
                     // fallthrough
                 default:
                 {
-                    if (first_param)
-                        first_param = false;
-                    else WriteCommaSpace();
+                    int separator_cookie = GetStartCookie();
+                    if (!first_param)
+                        WriteCommaSpace();
 
+                    int param_cookie = GetStartCookie();
                     if (!ParseType())
                         return false;
+                    DropSeparatorIfEmpty(separator_cookie, param_cookie, first_param);
                     continue;
                 }
             }
             break;
         }
+        Write(')');
+        WriteQualifiers (cv_qualifiers | ref_qualifiers);
 
-        if (qualifiers)
-        {
-            WriteQualifiers (qualifiers);
-            EndSubstitution (return_type_start_cookie);
-        }
-
-        if (inner_qualifiers)
-        {
-            int qualifier_start_cookie = GetStartCookie();
-            Write ('(');
-            WriteQualifiers (inner_qualifiers);
-            Write (')');
-            ReorderRange (EndRange (qualifier_start_cookie), insert_cookie);
-        }
+        // The function type itself is a substitution candidate, but only
+        // has a contiguous representation when there's no declarator
+        if (declarator_cookie >= 0)
+            EndUnrepresentableSubstitution();
         return true;
-#endif // TODO 
     }
 
     // <array-type> ::= A <positive dimension number> _ <element type>
     //              ::= A [<dimension expression>] _ <element type>
+    //
+    // Like function types, array types bracket the declarator of pointers
+    // and references to them, eg: char const (&) [16]
 
     bool
-    ParseArrayType(int qualifiers = QualifierNone)
+    ParseArrayType(int declarator_cookie = -1)
     {
-#ifdef DEBUG_FAILURES
-        printf("*** Array type unsupported\n");
-#endif
-        //TODO: We fail horribly when recalling these as substitutions or
-        // templates and trying to constify them eg:
-        // _ZN4llvm2cl5applyIA28_cNS0_3optIbLb0ENS0_6parserIbEEEEEEvRKT_PT0_
-        //
-        //TODO: Chances are we don't do any better with references and pointers
-        // that should be type (&) [] instead of type & []
-
-        return false;
+        //TODO: dimension expressions used by dependent array types
+        const char *before_digits = m_read_ptr;
+        TryParseNumber();
+        const char *after_digits = m_read_ptr;
+        if (!Parse('_'))
+            return false;
 
-#if 0 // TODO
-        if (*m_read_ptr == '_')
+        int element_type_start_cookie = GetStartCookie();
+        if (!ParseType())
+            return false;
+        if (m_last_type_is_function_or_array)
         {
-            ++m_read_ptr;
-            if (!ParseType())
-                return false;
-            if (qualifiers)
-                WriteQualifiers(qualifiers);
-            WRITE(" []");
-            return true;
+#ifdef DEBUG_FAILURES
+            printf("*** Arrays of arrays and function pointers unsupported\n");
+#endif
+            return false;
         }
-        else
+        Write(' ');
+        if (declarator_cookie >= 0)
         {
-            const char *before_digits = m_read_ptr;
-            if (TryParseNumber() != -1)
-            {
-                const char *after_digits = m_read_ptr;
-                if (!Parse('_'))
-                    return false;
-                if (!ParseType())
-                    return false;
-                if (qualifiers)
-                    WriteQualifiers(qualifiers);
-                Write(' ');
-                Write('[');
-                Write(before_digits, after_digits - before_digits);
-            }
-            else
-            {
-                int type_insertion_cookie = GetStartCookie();
-                if (!ParseExpression())
-                    return false;
-                if (!Parse('_'))
-                    return false;
-
-                int type_start_cookie = GetStartCookie();
-                if (!ParseType())
-                    return false;
-                if (qualifiers)
-                    WriteQualifiers(qualifiers);
-                Write(' ');
-                Write('[');
-                ReorderRange (EndRange (type_start_cookie), type_insertion_cookie);
-            }
-            Write(']');
-            return true;
+            Write('(');
+            ReorderRange (EndRange (element_type_start_cookie), declarator_cookie);
+            WRITE(") ");
         }
-#endif // TODO
+        Write('[');
+        Write(before_digits, after_digits - before_digits);
+        Write(']');
+
+        // As with function types, the array type itself is a substitution
+        // candidate without a contiguous representation
+        if (declarator_cookie >= 0)
+            EndUnrepresentableSubstitution();
+        return true;
     }
 
     // <pointer-to-member-type> ::= M <class type> <member type>
 
-    //TODO: Determine how to handle pointers to function members correctly,
-    // currently not an issue because we don't have function types at all...
     bool
-    ParsePointerToMemberType()
+    ParsePointerToMemberType(bool & is_function_or_array)
     {
         int insertion_cookie = GetStartCookie();
-        Write(' ');
         if (!ParseType())
             return false;
         WRITE("::*");
 
+        // Pointers to member functions are written inside the function type
+        const char *member_type_start = m_read_ptr;
+        int member_qualifiers = TryParseQualifiers (true, false);
+        if (*m_read_ptr == 'F')
+        {
+            ++m_read_ptr;
+            is_function_or_array = true;
+            return ParseFunctionType (insertion_cookie, member_qualifiers);
+        }
+        m_read_ptr = member_type_start;
+
         int type_cookie = GetStartCookie();
         if (!ParseType())
             return false;
+        if (m_last_type_is_function_or_array)
+        {
+#ifdef DEBUG_FAILURES
+            printf("*** Pointer to member of substituted function type unsupported\n");
+#endif
+            return false;
+        }
+        Write(' ');
         ReorderRange (EndRange (type_cookie), insertion_cookie);
         return true;
     }
 
+    // <type> ::= Dp <type>    # pack expansion (C++0x)
+    //
+    // The pattern type is written once for each element of the template
+    // argument pack it refers to, eg: int const&, char const& for Args const&...
+    // Substitutions recorded while writing the pattern differ for each
+    // element, so they are all unrepresentable.
+
+    bool
+    ParsePackExpansion()
+    {
+        const char *pattern = m_read_ptr;
+        int expansion_cookie = GetStartCookie();
+        int first_substitute_index = m_next_substitute_index;
+        int saved_pack_element_index = m_pack_element_index;
+        int saved_pack_size = m_pack_size;
+
+        int pack_size = 1;
+        bool is_function_or_array = false;
+        for (int element = 0; element < pack_size; ++element)
+        {
+            if (element > 0)
+                WriteCommaSpace();
+            m_read_ptr = pattern;
+            m_next_substitute_index = first_substitute_index;
+            m_pack_element_index = element;
+            m_pack_size = -1;
+            if (!ParseType())
+                return false;
+            if (m_pack_size < 0)
+            {
+#ifdef DEBUG_FAILURES
+                printf("*** Pack expansion doesn't reference a pack\n");
+#endif
+                return false;
+            }
+            pack_size = m_pack_size;
+            is_function_or_array |= m_last_type_is_function_or_array;
+        }
+
+        // Expanding an empty pack writes nothing at all
+        if (pack_size == 0)
+            m_write_ptr = m_buffer + expansion_cookie;
+
+        for (int index = first_substitute_index; index < m_next_substitute_index; ++index)
+            m_rewrite_ranges[index] = { 0, -1, true, false, 0 };
+        EndUnrepresentableSubstitution();
+
+        m_pack_element_index = saved_pack_element_index;
+        m_pack_size = saved_pack_size;
+        m_last_type_is_function_or_array = is_function_or_array;
+        return true;
+    }
+
     // <template-param> ::= T_    # first template parameter
     //                  ::= T <parameter-2 non-negative number> _
 
@@ -1218,22 +1465,35 @@ private:
 #endif
         int type_start_cookie = GetStartCookie();
         bool suppress_substitution = false;
+        bool is_function_or_array = false;
 
         int qualifiers = TryParseQualifiers (true, false);
         switch (*m_read_ptr)
         {
             case 'D':
-                ++m_read_ptr;
-                switch (*m_read_ptr++)
+                switch (*(m_read_ptr + 1))
             {
                 case 'p':
-                    if (!ParseType())
+                    m_read_ptr += 2;
+                    if (!ParsePackExpansion())
                         return false;
+                    is_function_or_array = m_last_type_is_function_or_array;
+                    suppress_substitution = true;
                     break;
                 case 'T':
                 case 't':
                 case 'v':
+#ifdef DEBUG_FAILURES
+                    printf("*** Unsupported type: %.3s\n", failed_type);
+#endif
+                    return false;
                 default:
+                    if (const char *builtin = TryParseBuiltinType())
+                    {
+                        Write(builtin);
+                        suppress_substitution = true;
+                        break;
+                    }
 #ifdef DEBUG_FAILURES
                     printf("*** Unsupported type: %.3s\n", failed_type);
 #endif
@@ -1244,69 +1504,86 @@ private:
                 ++m_read_ptr;
                 if (!ParseTemplateParam())
                     return false;
+                is_function_or_array = m_last_rewrite_is_function_or_array;
                 break;
             case 'M':
                 ++m_read_ptr;
-                if (!ParsePointerToMemberType())
+                if (!ParsePointerToMemberType(is_function_or_array))
                     return false;
                 break;
             case 'A':
                 ++m_read_ptr;
                 if (!ParseArrayType())
                     return false;
+                is_function_or_array = true;
                 break;
             case 'F':
                 ++m_read_ptr;
                 if (!ParseFunctionType())
                     return false;
+                is_function_or_array = true;
                 break;
             case 'S':
-                if (*++m_read_ptr == 't')
+                if (*(m_read_ptr + 1) == 't')
                 {
-                    ++m_read_ptr;
-                    WriteStdPrefix();
+                    // Let ParseName() write the std:: prefix so that it is
+                    // part of any template name substitution it records
                     if (!ParseName())
                         return false;
                 }
                 else
                 {
-                    suppress_substitution = true;
+                    ++m_read_ptr;
+                    m_last_rewrite_is_function_or_array = false;
                     if (!ParseSubstitution())
                         return false;
-                }
-                break;
-            case 'P':
-            {
-                switch (*++m_read_ptr)
-                {
-                    case 'F':
+                    is_function_or_array = m_last_rewrite_is_function_or_array;
+
+                    // A substitution followed by template arguments names a
+                    // new type, which is a substitution candidate itself
+                    if (*m_read_ptr == 'I')
+                    {
                         ++m_read_ptr;
-                        if (!ParseFunctionType(QualifierPointer))
-                            return false;
-                        break;
-                    default:
-                        if (!ParseType())
+                        WriteTemplateStart();
+                        if (!ParseTemplateArgs())
                             return false;
-                        Write('*');
-                        break;
+                        WriteTemplateEnd();
+                        is_function_or_array = false;
+                    }
+                    else suppress_substitution = true;
                 }
                 break;
-            }
+            case 'P':
             case 'R':
-            {
-                ++m_read_ptr;
-                if (!ParseType())
-                    return false;
-                Write('&');
-                break;
-            }
             case 'O':
             {
-                ++m_read_ptr;
+                char kind = *m_read_ptr++;
+                char next = *m_read_ptr;
+                if (next == 'F' || next == 'A')
+                {
+                    // Pointers and references to functions and arrays are
+                    // written inside the type eg: void (*)(int)
+                    ++m_read_ptr;
+                    int declarator_cookie = GetStartCookie();
+                    WritePointerOrReference(kind);
+                    if (next == 'F' ? !ParseFunctionType(declarator_cookie)
+                                    : !ParseArrayType(declarator_cookie))
+                        return false;
+                    is_function_or_array = true;
+                    break;
+                }
+
                 if (!ParseType())
                     return false;
-                Write('&');
-                Write('&');
+                if (m_last_type_is_function_or_array)
+                {
+#ifdef DEBUG_FAILURES
+                    printf("*** Pointer or reference to substituted function type unsupported\n");
+#endif
+                    return false;
+                }
+                if (!WriteCollapsedPointerOrReference(kind))
+                    return false;
                 break;
             }
             case 'C':
@@ -1340,12 +1617,25 @@ private:
         // Allow base substitutions to be suppressed, but always record
         // substitutions for the qualified variant
         if (!suppress_substitution)
-            EndSubstitution(type_start_cookie);
+            EndSubstitution(type_start_cookie, is_function_or_array);
         if (qualifiers)
         {
-            WriteQualifiers(qualifiers, false);
+            if (is_function_or_array)
+            {
+#ifdef DEBUG_FAILURES
+                printf("*** Qualified function types unsupported\n");
+#endif
+                return false;
+            }
+
+            // Qualifiers applied to a template parameter that is already
+            // const qualified collapse eg: T const with T = int const
+            if ((qualifiers & QualifierConst) && EndsWith(" const"))
+                WriteQualifiers(qualifiers & ~QualifierConst, false);
+            else WriteQualifiers(qualifiers, false);
             EndSubstitution(type_start_cookie);
         }
+        m_last_type_is_function_or_array = is_function_or_array;
         return true;
     }
 
@@ -1388,10 +1678,44 @@ private:
                 return true;
             }
             case 'l':
-#ifdef DEBUG_FAILURES
-                printf("*** Lambda type names unsupported\n");
-#endif
-                return false;
+            {
+                // The discriminating number follows the parameters in the
+                // mangling, but is written in the name eg: 'lambda0'(int)
+                int cookie = GetStartCookie();
+                WRITE("'lambda");
+                int number_insert_cookie = GetStartCookie();
+                WRITE("'(");
+                bool first_param = true;
+                while (*m_read_ptr != 'E')
+                {
+                    if (*m_read_ptr == 'v' && *(m_read_ptr + 1) == 'E')
+                    {
+                        ++m_read_ptr;
+                        continue;
+                    }
+                    int separator_cookie = GetStartCookie();
+                    if (!first_param)
+                        WriteCommaSpace();
+
+                    int param_cookie = GetStartCookie();
+                    if (!ParseType())
+                        return false;
+                    DropSeparatorIfEmpty(separator_cookie, param_cookie, first_param);
+                }
+                ++m_read_ptr;
+                Write(')');
+                int number_cookie = GetStartCookie();
+                const char *before_digits = m_read_ptr;
+                if (TryParseNumber() != -1)
+                {
+                    Write (before_digits, m_read_ptr - before_digits);
+                    ReorderRange (EndRange (number_cookie), number_insert_cookie);
+                }
+                if (!Parse('_'))
+                    return false;
+                name_state.last_name_range = EndRange (cookie);
+                return true;
+            }
         }
 #ifdef DEBUG_FAILURES
         printf("*** Unknown unnamed type %.3s\n", m_read_ptr - 2);
@@ -1508,13 +1832,38 @@ private:
         return true;
     }
 
-    // <unqualified-name> ::= <operator-name>
+    // <abi-tags> ::= <abi-tag>*
+    // <abi-tag>  ::= B <source-name>
+
+    bool
+    ParseAbiTags()
+    {
+        while (*m_read_ptr == 'B')
+        {
+            ++m_read_ptr;
+            WRITE("[abi:");
+            if (!ParseSourceName())
+                return false;
+            Write(']');
+        }
+        return true;
+    }
+
+    // <unqualified-name> ::= <operator-name> [<abi-tags>]
     //                    ::= <ctor-dtor-name>
-    //                    ::= <source-name>
+    //                    ::= <source-name> [<abi-tags>]
     //                    ::= <unnamed-type-name>
 
     bool
     ParseUnqualifiedName(NameState & name_state)
+    {
+        if (!ParseUntaggedUnqualifiedName(name_state))
+            return false;
+        return *m_read_ptr != 'B' || ParseAbiTags();
+    }
+
+    bool
+    ParseUntaggedUnqualifiedName(NameState & name_state)
     {
         // Note that these are detected directly in ParseNestedName for
         // performance rather than switching on the same options twice
@@ -1607,6 +1956,8 @@ private:
     bool
     ParseExpressionPrimary()
     {
+        if (*m_read_ptr == '\0')
+            return false;
         switch (*m_read_ptr++)
         {
             case 'b': return ParseBooleanLiteral();
@@ -1819,10 +2170,22 @@ private:
                 return false;
         }
 
+        if (*m_read_ptr == '\0')
+            return false;
         switch (*m_read_ptr++)
         {
             case 'T': return ParseTemplateParam();
-            case 'L': return ParseExpressionPrimary();
+            case 'L':
+                // External names are written without their parameter list
+                // when they are operands eg: &f rather than &f(int)
+                if (m_read_ptr[0] == '_' && m_read_ptr[1] == 'Z')
+                {
+#ifdef DEBUG_FAILURES
+                    printf("*** External names in expressions unsupported\n");
+#endif
+                    return false;
+                }
+                return ParseExpressionPrimary();
             case 's':
                 if (*m_read_ptr++ == 'r')
                     return ParseUnresolvedName();
@@ -1840,22 +2203,31 @@ private:
     //                ::= LZ <encoding> E                                    # extension
 
     bool
-    ParseTemplateArg()
+    ParseTemplateArg(int *pack_size = nullptr)
     {
         switch (*m_read_ptr) {
             case 'J':
-#ifdef DEBUG_FAILURES
-                printf("*** Template argument packs unsupported\n");
-#endif
-                return false;
+            {
+                // Argument packs are written as a list of their elements
+                ++m_read_ptr;
+                bool has_function_or_array = false;
+                if (!ParseTemplateArgs(false, pack_size, &has_function_or_array))
+                    return false;
+                m_last_type_is_function_or_array = has_function_or_array;
+                return true;
+            }
             case 'X':
                 ++m_read_ptr;
                 if (!ParseExpression())
                     return false;
+                m_last_type_is_function_or_array = false;
                 return Parse('E');
             case 'L':
                 ++m_read_ptr;
-                return ParseExpressionPrimary();
+                if (!ParseExpressionPrimary())
+                    return false;
+                m_last_type_is_function_or_array = false;
+                return true;
             default:
                 return ParseType();
         }
@@ -1865,23 +2237,40 @@ private:
     //     extension, the abi says <template-arg>+
 
     bool
-    ParseTemplateArgs(bool record_template_args = false)
+    ParseTemplateArgs(bool record_template_args = false, int *arg_count = nullptr,
+                      bool *has_function_or_array = nullptr)
     {
         if (record_template_args)
             ResetTemplateArgs();
+        if (arg_count)
+            *arg_count = 0;
 
         bool first_arg = true;
         while (*m_read_ptr != 'E')
         {
-            if (first_arg)
-                first_arg = false;
-            else WriteCommaSpace();
+            if (*m_read_ptr == '\0')
+            {
+#ifdef DEBUG_FAILURES
+                printf("*** Unterminated template arguments\n");
+#endif
+                return false;
+            }
+
+            int separator_cookie = GetStartCookie();
+            if (!first_arg)
+                WriteCommaSpace();
 
             int template_start_cookie = GetStartCookie();
-            if (!ParseTemplateArg())
+            int pack_size = -1;
+            if (!ParseTemplateArg(&pack_size))
                 return false;
             if (record_template_args)
-                EndTemplateArg(template_start_cookie);
+                EndTemplateArg(template_start_cookie, m_last_type_is_function_or_array, pack_size);
+            if (arg_count)
+                ++*arg_count;
+            if (has_function_or_array && m_last_type_is_function_or_array)
+                *has_function_or_array = true;
+            DropSeparatorIfEmpty(separator_cookie, template_start_cookie, first_arg);
         }
         ++m_read_ptr;
         return true;
@@ -1924,6 +2313,14 @@ private:
                 break;
             }
 
+            // ABI tags are part of the preceding unqualified name
+            if (next == 'B')
+            {
+                if (!ParseAbiTags())
+                    return false;
+                continue;
+            }
+
             // Record a substitution candidate for all prefixes, but not the full name
             if (suppress_substitution)
                 suppress_substitution = false;
@@ -1974,7 +2371,7 @@ private:
                     }
                     else
                     {
-                        if (!ParseSubstitution())
+                        if (!ParseSubstitution(&name_state))
                             return false;
                         suppress_substitution = true;
                     }
@@ -2040,8 +2437,18 @@ private:
     bool
     ParseLocalName(bool parse_function_params)
     {
+        // The function encoding and entity have their own template arguments,
+        // so record them after any recorded for the enclosing scope eg: when
+        // the local name is a lambda passed as a template argument
+        int saved_enclosing_template_arg_count = m_enclosing_template_arg_count;
+        int template_arg_count = m_rewrite_ranges_size - 1 - m_next_template_arg_index;
+        m_enclosing_template_arg_count = template_arg_count;
+
+        bool saved_parsing_local_scope = m_parsing_local_scope;
+        m_parsing_local_scope = true;
         if (!ParseEncoding())
             return false;
+        m_parsing_local_scope = saved_parsing_local_scope;
         if (!Parse('E'))
             return false;
 
@@ -2053,20 +2460,21 @@ private:
                 WRITE("::string literal");
                 break;
             case 'd':
-                ++m_read_ptr;
-                TryParseNumber(); // Optional and ignored
-                if (!Parse('_'))
-                    return false;
-                WriteNamespaceSeparator();
-                if (!ParseName())
-                    return false;
-                break;
+                // The default argument scope is written as {default arg#N}
+                // and the entity in it numbered differently, eg: lambdas
+#ifdef DEBUG_FAILURES
+                printf("*** Default argument scopes unsupported\n");
+#endif
+                return false;
             default:
                 WriteNamespaceSeparator();
                 if (!ParseName(parse_function_params, true))
                     return false;
                 TryParseDiscriminator(); // Optional and ignored
         }
+
+        m_enclosing_template_arg_count = saved_enclosing_template_arg_count;
+        m_next_template_arg_index = m_rewrite_ranges_size - 1 - template_arg_count;
         return true;
     }
 
@@ -2265,9 +2673,27 @@ private:
 
         if (name_state.is_last_generic && !name_state.has_no_return_type)
         {
+            // The return type of a function template is left out when it
+            // is the scope of a local name, and the substitutions recorded
+            // in the scope would have to be renumbered to match
+            if (m_parsing_local_scope)
+            {
+#ifdef DEBUG_FAILURES
+                printf("*** Function templates as local name scopes unsupported\n");
+#endif
+                return false;
+            }
+
             int return_type_start_cookie = GetStartCookie();
             if (!ParseType())
                 return false;
+            if (m_last_type_is_function_or_array)
+            {
+#ifdef DEBUG_FAILURES
+                printf("*** Function pointer return types unsupported\n");
+#endif
+                return false;
+            }
             Write(' ');
             ReorderRange(EndRange(return_type_start_cookie),
                          return_insert_cookie);
@@ -2295,12 +2721,14 @@ private:
                     }
                     // fallthrough
                 default:
-                    if (first_param)
-                        first_param = false;
-                    else WriteCommaSpace();
+                    int separator_cookie = GetStartCookie();
+                    if (!first_param)
+                        WriteCommaSpace();
 
+                    int param_cookie = GetStartCookie();
                     if (!ParseType())
                         return false;
+                    DropSeparatorIfEmpty(separator_cookie, param_cookie, first_param);
                     continue;
             }
             break;
@@ -2346,6 +2774,12 @@ private:
         m_write_ptr = m_buffer;
         m_next_substitute_index = 0;
         m_next_template_arg_index = m_rewrite_ranges_size - 1;
+        m_enclosing_template_arg_count = 0;
+        m_parsing_local_scope = false;
+        m_pack_element_index = -1;
+        m_pack_size = -1;
+        m_last_type_is_function_or_array = false;
+        m_last_rewrite_is_function_or_array = false;
 
         if (*m_read_ptr++ != '_' || *m_read_ptr++ != 'Z')
         {
@@ -2391,6 +2825,12 @@ private:
     char *m_write_ptr;
     int m_next_template_arg_index;
     int m_next_substitute_index;
+    int m_enclosing_template_arg_count;         // Template args of enclosing local name scopes
+    bool m_parsing_local_scope;                 // Set while parsing the function encoding of a local name
+    int m_pack_element_index;                   // Element being written by ParsePackExpansion(), or -1
+    int m_pack_size;                            // Size of the pack referenced by the pattern, or -1
+    bool m_last_type_is_function_or_array;      // Set by ParseType()
+    bool m_last_rewrite_is_function_or_array;   // Set when rewriting substitutions and template args
 };
 
 } // Anonymous namespace
@@ -152,6 +152,10 @@ Module::Module (const ModuleSpec &module_spec) :
     m_type_system_map(),
     m_source_mappings (),
     m_sections_ap(),
+    m_function_names (),
+    m_source_file_names (),
+    m_has_function_names (eLazyBoolCalculate),
+    m_has_source_file_names (eLazyBoolCalculate),
     m_did_load_objfile (false),
     m_did_load_symbol_vendor (false),
     m_did_parse_uuid (false),
@@ -255,6 +259,10 @@ Module::Module(const FileSpec& file_spec,
     m_type_system_map(),
     m_source_mappings (),
     m_sections_ap(),
+    m_function_names (),
+    m_source_file_names (),
+    m_has_function_names (eLazyBoolCalculate),
+    m_has_source_file_names (eLazyBoolCalculate),
     m_did_load_objfile (false),
     m_did_load_symbol_vendor (false),
     m_did_parse_uuid (false),
@@ -300,6 +308,10 @@ Module::Module () :
     m_type_system_map(),
     m_source_mappings (),
     m_sections_ap(),
+    m_function_names (),
+    m_source_file_names (),
+    m_has_function_names (eLazyBoolCalculate),
+    m_has_source_file_names (eLazyBoolCalculate),
     m_did_load_objfile (false),
     m_did_load_symbol_vendor (false),
     m_did_parse_uuid (false),
@@ -895,6 +907,63 @@ Module::FindFunctions (const RegularExpression& regex,
     return sc_list.GetSize() - start_size;
 }
 
+bool
+Module::MayContainFunctionName (const ConstString &name)
+{
+    Mutex::Locker locker (m_mutex);
+    if (m_has_function_names == eLazyBoolCalculate)
+    {
+        Timer scoped_timer(__PRETTY_FUNCTION__,
+                           "Module::MayContainFunctionName (module = %p)",
+                           static_cast<void*>(this));
+        SymbolVendor *symbols = GetSymbolVendor ();
+        if (symbols && !symbols->GetFunctionNames (m_function_names))
+        {
+            m_function_names.clear();
+            m_has_function_names = eLazyBoolNo;
+        }
+        else
+        {
+            Symtab *symtab = symbols ? symbols->GetSymtab() : nullptr;
+            if (symtab)
+                symtab->AppendFunctionSymbolNames (m_function_names);
+            m_has_function_names = eLazyBoolYes;
+        }
+    }
+
+    if (m_has_function_names == eLazyBoolNo)
+        return true;
+    return m_function_names.count (name.GetCString()) != 0;
+}
+
+bool
+Module::MayContainSourceFile (const FileSpec &file_spec)
+{
+    Mutex::Locker locker (m_mutex);
+    if (m_has_source_file_names == eLazyBoolCalculate)
+    {
+        Timer scoped_timer(__PRETTY_FUNCTION__,
+                           "Module::MayContainSourceFile (module = %p)",
+                           static_cast<void*>(this));
+        const size_t num_comp_units = GetNumCompileUnits();
+        for (size_t i = 0; i < num_comp_units; ++i)
+        {
+            CompUnitSP cu_sp (GetCompileUnitAtIndex (i));
+            if (!cu_sp)
+                continue;
+            m_source_file_names.insert (cu_sp->GetFilename().GetCString());
+            const FileSpecList &support_files = cu_sp->GetSupportFiles();
+            const size_t num_files = support_files.GetSize();
+            for (size_t file_idx = 0; file_idx < num_files; ++file_idx)
+                m_source_file_names.insert (support_files.GetFileSpecAtIndex(file_idx).GetFilename().GetCString());
+        }
+        m_has_source_file_names = eLazyBoolYes;
+    }
+
+    // Line tables are only ever matched by comparing filenames first.
+    return m_source_file_names.count (file_spec.GetFilename().GetCString()) != 0;
+}
+
 void
 Module::FindAddressesForLine (const lldb::TargetSP target_sp,
                               const FileSpec &file, uint32_t line,
@@ -1514,6 +1583,10 @@ Module::SetSymbolFileFileSpec (const FileSpec &file)
     m_symfile_spec = file;
     m_symfile_ap.reset();
     m_did_load_symbol_vendor = false;
+    m_function_names.clear();
+    m_source_file_names.clear();
+    m_has_function_names = eLazyBoolCalculate;
+    m_has_source_file_names = eLazyBoolCalculate;
 }
 
 bool
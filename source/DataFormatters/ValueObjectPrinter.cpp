@@ -18,6 +18,7 @@
 #include "lldb/DataFormatters/DataVisualization.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Target/Language.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 
 using namespace lldb;
@@ -704,6 +705,58 @@ ValueObjectPrinter::GetMaxNumChildrenToPrint (bool& print_dotdotdot)
     return num_children;
 }
 
+// The most bytes of a pointee that get prefetched, larger pointees are read
+// when their children are printed.
+static const size_t k_max_prefetched_pointee_size = 512;
+
+void
+ValueObjectPrinter::PrefetchChildPointees (size_t num_children,
+                                           const DumpValueObjectOptions::PointerDepth& curr_ptr_depth)
+{
+    // Printing the children of a struct or array reads the pointees of its
+    // pointer children one at a time, when the summary of a C string or the
+    // expansion of a pointer needs them. Hand those addresses to the process
+    // up front so that it can read them in one batch.
+    ProcessSP process_sp (m_valobj->GetProcessSP());
+    if (!process_sp || !process_sp->IsAlive())
+        return;
+
+    ValueObject* synth_m_valobj = GetValueObjectForChildrenGeneration();
+    const DumpValueObjectOptions::PointerDepth child_ptr_depth = (IsPtr() || IsRef()) ? --curr_ptr_depth : curr_ptr_depth;
+    const bool children_expand_pointers = child_ptr_depth.CanAllowExpansion() && m_curr_depth + 1 < m_options.m_max_depth;
+    ExecutionContext exe_ctx (m_valobj->GetExecutionContextRef());
+
+    Process::MemoryRangeList ranges;
+    for (size_t idx=0; idx<num_children; ++idx)
+    {
+        ValueObjectSP child_sp(synth_m_valobj->GetChildAtIndex(idx, true));
+        if (!child_sp)
+            continue;
+
+        CompilerType pointee_type;
+        if (!child_sp->GetCompilerType().IsPointerType(&pointee_type))
+            continue;
+
+        size_t pointee_size;
+        if (pointee_type.IsCharType())
+            pointee_size = 1;
+        else if (children_expand_pointers)
+            pointee_size = std::min<size_t>(pointee_type.GetByteSize(exe_ctx.GetBestExecutionContextScope()), k_max_prefetched_pointee_size);
+        else
+            continue;
+
+        AddressType address_type = eAddressTypeInvalid;
+        const addr_t pointee_addr = child_sp->GetPointerValue(&address_type);
+        if (address_type != eAddressTypeLoad || pointee_addr == 0 || pointee_addr == LLDB_INVALID_ADDRESS || pointee_size == 0)
+            continue;
+        ranges.push_back(std::make_pair(pointee_addr, pointee_size));
+    }
+
+    // A single pointee gains nothing from batching.
+    if (ranges.size() > 1)
+        process_sp->PrefetchMemory(ranges);
+}
+
 void
 ValueObjectPrinter::PrintChildrenPostamble (bool print_dotdotdot)
 {
@@ -756,6 +809,8 @@ ValueObjectPrinter::PrintChildren (bool value_printed,
     {
         bool any_children_printed = false;
         
+        PrefetchChildPointees (num_children, curr_ptr_depth);
+        
         for (size_t idx=0; idx<num_children; ++idx)
         {
             ValueObjectSP child_sp(synth_m_valobj->GetChildAtIndex(idx, true));
@@ -818,6 +818,7 @@ IRExecutionUnit::CommitAllocations (lldb::ProcessSP &process_sp)
         case lldb::eSectionTypeDWARFAppleTypes:
         case lldb::eSectionTypeDWARFAppleNamespaces:
         case lldb::eSectionTypeDWARFAppleObjC:
+        case lldb::eSectionTypeDWARFGdbIndex:
             err.Clear();
             break;
         default:
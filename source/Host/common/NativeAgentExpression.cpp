@@ -0,0 +1,348 @@
+//===-- NativeAgentExpression.cpp -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Host/common/NativeAgentExpression.h"
+
+#include <algorithm>
+
+#include "lldb/Core/RegisterValue.h"
+#include "lldb/Host/common/NativeCollectBuffer.h"
+#include "lldb/Host/common/NativeProcessProtocol.h"
+#include "lldb/Host/common/NativeRegisterContext.h"
+#include "lldb/Host/common/NativeThreadProtocol.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    // Bounds on the work a single evaluation may do. Jumps can go backwards,
+    // so a malformed expression could otherwise loop forever while the
+    // inferior thread is stopped at the breakpoint.
+    const size_t k_max_stack_depth = 1024;
+    const size_t k_max_instructions = 65536;
+
+    // The most memory a single trace opcode may collect.
+    const uint64_t k_max_trace_size = 65536;
+
+    uint64_t
+    SignExtend (uint64_t value, uint32_t bits)
+    {
+        if (bits == 0 || bits >= 64)
+            return value;
+        const uint64_t sign_bit = 1ull << (bits - 1);
+        value &= (sign_bit << 1) - 1;
+        return (value ^ sign_bit) - sign_bit;
+    }
+
+    uint64_t
+    ZeroExtend (uint64_t value, uint32_t bits)
+    {
+        if (bits == 0 || bits >= 64)
+            return value;
+        return value & ((1ull << bits) - 1);
+    }
+}
+
+NativeAgentExpression::NativeAgentExpression (std::vector<uint8_t> &&bytecode) :
+    m_bytecode (std::move (bytecode))
+{
+}
+
+Error
+NativeAgentExpression::Evaluate (NativeProcessProtocol &process, NativeThreadProtocol &thread, uint64_t &result,
+                                 NativeCollectSample *sample) const
+{
+    std::vector<uint64_t> stack;
+    const size_t size = m_bytecode.size ();
+    size_t pc = 0;
+
+    // Read an immediate operand of the current instruction.
+    auto read_immediate = [&](size_t byte_size, uint64_t &value) -> bool
+    {
+        if (pc + byte_size > size)
+            return false;
+        value = 0;
+        for (size_t i = 0; i < byte_size; ++i)
+            value = (value << 8) | m_bytecode[pc++];
+        return true;
+    };
+
+    for (size_t count = 0; count < k_max_instructions; ++count)
+    {
+        if (pc >= size)
+            return Error ("agent expression ran past its end");
+
+        const uint8_t opcode = m_bytecode[pc++];
+
+        // Check the stack has enough operands for the opcode.
+        size_t operands = 0;
+        switch (opcode)
+        {
+            case eOpAdd: case eOpSub: case eOpMul:
+            case eOpDivSigned: case eOpDivUnsigned: case eOpRemSigned: case eOpRemUnsigned:
+            case eOpLsh: case eOpRshSigned: case eOpRshUnsigned:
+            case eOpBitAnd: case eOpBitOr: case eOpBitXor:
+            case eOpEqual: case eOpLessSigned: case eOpLessUnsigned:
+            case eOpSwap: case eOpTrace:
+                operands = 2;
+                break;
+            case eOpRot:
+                operands = 3;
+                break;
+            case eOpLogNot: case eOpBitNot: case eOpExt: case eOpZeroExt:
+            case eOpRef8: case eOpRef16: case eOpRef32: case eOpRef64:
+            case eOpIfGoto: case eOpEnd: case eOpDup: case eOpPop:
+            case eOpTraceQuick: case eOpTrace16:
+                operands = 1;
+                break;
+            default:
+                break;
+        }
+        if (stack.size () < operands)
+            return Error ("agent expression stack underflow at offset %" PRIu64, (uint64_t)(pc - 1));
+        if (stack.size () >= k_max_stack_depth)
+            return Error ("agent expression stack overflow at offset %" PRIu64, (uint64_t)(pc - 1));
+
+        switch (opcode)
+        {
+            case eOpAdd: case eOpSub: case eOpMul:
+            case eOpDivSigned: case eOpDivUnsigned: case eOpRemSigned: case eOpRemUnsigned:
+            case eOpLsh: case eOpRshSigned: case eOpRshUnsigned:
+            case eOpBitAnd: case eOpBitOr: case eOpBitXor:
+            case eOpEqual: case eOpLessSigned: case eOpLessUnsigned:
+            {
+                const uint64_t b = stack.back ();
+                stack.pop_back ();
+                const uint64_t a = stack.back ();
+                const int64_t sa = static_cast<int64_t> (a);
+                const int64_t sb = static_cast<int64_t> (b);
+                uint64_t value = 0;
+                switch (opcode)
+                {
+                    case eOpAdd:            value = a + b; break;
+                    case eOpSub:            value = a - b; break;
+                    case eOpMul:            value = a * b; break;
+                    case eOpLsh:            value = b < 64 ? a << b : 0; break;
+                    case eOpRshSigned:      value = static_cast<uint64_t> (sa >> (b < 64 ? b : 63)); break;
+                    case eOpRshUnsigned:    value = b < 64 ? a >> b : 0; break;
+                    case eOpBitAnd:         value = a & b; break;
+                    case eOpBitOr:          value = a | b; break;
+                    case eOpBitXor:         value = a ^ b; break;
+                    case eOpEqual:          value = a == b; break;
+                    case eOpLessSigned:     value = sa < sb; break;
+                    case eOpLessUnsigned:   value = a < b; break;
+                    default:
+                        if (b == 0)
+                            return Error ("agent expression division by zero at offset %" PRIu64, (uint64_t)(pc - 1));
+                        // INT64_MIN / -1 overflows, the result wraps like the unsigned operation would.
+                        if (sb == -1 && (opcode == eOpDivSigned || opcode == eOpRemSigned))
+                            value = opcode == eOpDivSigned ? 0 - a : 0;
+                        else if (opcode == eOpDivSigned)
+                            value = static_cast<uint64_t> (sa / sb);
+                        else if (opcode == eOpRemSigned)
+                            value = static_cast<uint64_t> (sa % sb);
+                        else if (opcode == eOpDivUnsigned)
+                            value = a / b;
+                        else
+                            value = a % b;
+                        break;
+                }
+                stack.back () = value;
+                break;
+            }
+
+            case eOpLogNot:
+                stack.back () = stack.back () == 0;
+                break;
+
+            case eOpBitNot:
+                stack.back () = ~stack.back ();
+                break;
+
+            case eOpExt:
+            case eOpZeroExt:
+            {
+                uint64_t bits;
+                if (!read_immediate (1, bits))
+                    return Error ("truncated agent expression");
+                stack.back () = opcode == eOpExt ? SignExtend (stack.back (), bits) : ZeroExtend (stack.back (), bits);
+                break;
+            }
+
+            case eOpRef8:
+            case eOpRef16:
+            case eOpRef32:
+            case eOpRef64:
+            {
+                const size_t byte_size = 1u << (opcode - eOpRef8);
+                const lldb::addr_t addr = stack.back ();
+                uint8_t buffer[8];
+                size_t bytes_read = 0;
+                Error error = process.ReadMemoryWithoutTrap (addr, buffer, byte_size, bytes_read);
+                if (error.Fail ())
+                    return error;
+                if (bytes_read != byte_size)
+                    return Error ("failed to read %" PRIu64 " bytes at 0x%" PRIx64, (uint64_t)byte_size, addr);
+
+                lldb::ByteOrder byte_order = lldb::eByteOrderLittle;
+                process.GetByteOrder (byte_order);
+                uint64_t value = 0;
+                for (size_t i = 0; i < byte_size; ++i)
+                {
+                    const size_t index = byte_order == lldb::eByteOrderBig ? i : byte_size - 1 - i;
+                    value = (value << 8) | buffer[index];
+                }
+                stack.back () = value;
+                break;
+            }
+
+            case eOpTrace:
+            case eOpTraceQuick:
+            case eOpTrace16:
+            {
+                // trace pops the address and size, the quick forms take the
+                // size as an immediate and leave the address on the stack.
+                uint64_t byte_size;
+                if (opcode == eOpTrace)
+                {
+                    byte_size = stack.back ();
+                    stack.pop_back ();
+                }
+                else if (!read_immediate (opcode == eOpTraceQuick ? 1 : 2, byte_size))
+                    return Error ("truncated agent expression");
+                const lldb::addr_t addr = stack.back ();
+                if (opcode == eOpTrace)
+                    stack.pop_back ();
+
+                if (!sample || byte_size == 0)
+                    break;
+                if (byte_size > k_max_trace_size)
+                    return Error ("agent expression collects too much memory at 0x%" PRIx64, addr);
+
+                // Collect what is readable, a partial block is still useful.
+                NativeCollectSample::MemoryBlock block;
+                block.addr = addr;
+                block.bytes.resize (byte_size);
+                size_t bytes_read = 0;
+                process.ReadMemoryWithoutTrap (addr, block.bytes.data (), byte_size, bytes_read);
+                block.bytes.resize (bytes_read);
+                sample->memory.push_back (std::move (block));
+                break;
+            }
+
+            case eOpIfGoto:
+            case eOpGoto:
+            {
+                uint64_t target;
+                if (!read_immediate (2, target))
+                    return Error ("truncated agent expression");
+                bool jump = true;
+                if (opcode == eOpIfGoto)
+                {
+                    jump = stack.back () != 0;
+                    stack.pop_back ();
+                }
+                if (jump)
+                {
+                    if (target >= size)
+                        return Error ("agent expression jump target %" PRIu64 " out of range", target);
+                    pc = target;
+                }
+                break;
+            }
+
+            case eOpConst8:
+            case eOpConst16:
+            case eOpConst32:
+            case eOpConst64:
+            {
+                uint64_t value;
+                if (!read_immediate (1u << (opcode - eOpConst8), value))
+                    return Error ("truncated agent expression");
+                stack.push_back (value);
+                break;
+            }
+
+            case eOpReg:
+            {
+                uint64_t reg;
+                if (!read_immediate (2, reg))
+                    return Error ("truncated agent expression");
+                NativeRegisterContextSP reg_ctx_sp = thread.GetRegisterContext ();
+                if (!reg_ctx_sp)
+                    return Error ("no register context for thread %" PRIu64, thread.GetID ());
+                const RegisterInfo *reg_info = reg_ctx_sp->GetRegisterInfoAtIndex (reg);
+                if (!reg_info)
+                    return Error ("invalid register %" PRIu64 " in agent expression", reg);
+                RegisterValue reg_value;
+                Error error = reg_ctx_sp->ReadRegister (reg_info, reg_value);
+                if (error.Fail ())
+                    return error;
+                if (sample && sample->registers.find (reg) == sample->registers.end ())
+                {
+                    const uint8_t *bytes = static_cast<const uint8_t *> (reg_value.GetBytes ());
+                    if (bytes)
+                        sample->registers[reg].assign (bytes, bytes + reg_value.GetByteSize ());
+                }
+                bool success = false;
+                const uint64_t value = reg_value.GetAsUInt64 (0, &success);
+                if (!success)
+                {
+                    // Registers that don't fit in a stack entry can still be collected.
+                    if (!sample)
+                        return Error ("register %s can't be used in an agent expression", reg_info->name);
+                    stack.push_back (0);
+                    break;
+                }
+                stack.push_back (value);
+                break;
+            }
+
+            case eOpEnd:
+                result = stack.back ();
+                return Error ();
+
+            case eOpDup:
+                stack.push_back (stack.back ());
+                break;
+
+            case eOpPop:
+                stack.pop_back ();
+                break;
+
+            case eOpSwap:
+                std::swap (stack[stack.size () - 1], stack[stack.size () - 2]);
+                break;
+
+            case eOpPick:
+            {
+                uint64_t depth;
+                if (!read_immediate (1, depth))
+                    return Error ("truncated agent expression");
+                if (depth >= stack.size ())
+                    return Error ("agent expression stack underflow at offset %" PRIu64, (uint64_t)(pc - 2));
+                stack.push_back (stack[stack.size () - 1 - depth]);
+                break;
+            }
+
+            case eOpRot:
+            {
+                // a b c => c a b, the top item becomes the third one.
+                std::rotate (stack.end () - 3, stack.end () - 1, stack.end ());
+                break;
+            }
+
+            default:
+                return Error ("unsupported agent expression opcode 0x%2.2x at offset %" PRIu64, opcode, (uint64_t)(pc - 1));
+        }
+    }
+
+    return Error ("agent expression exceeded the instruction limit");
+}
@@ -27,6 +27,65 @@ NativeBreakpoint::~NativeBreakpoint ()
 {
 }
 
+void
+NativeBreakpoint::SetConditions (std::vector<NativeAgentExpression> &&conditions)
+{
+    m_conditions = std::move (conditions);
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("NativeBreakpoint::%s addr = 0x%" PRIx64 " now has %" PRIu64 " conditions", __FUNCTION__, m_addr, (uint64_t)m_conditions.size ());
+}
+
+bool
+NativeBreakpoint::ConditionsSayStop (NativeProcessProtocol &process, NativeThreadProtocol &thread) const
+{
+    if (m_conditions.empty ())
+        return true;
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    for (const NativeAgentExpression &condition : m_conditions)
+    {
+        uint64_t result = 0;
+        Error error = condition.Evaluate (process, thread, result);
+        if (error.Fail ())
+        {
+            if (log)
+                log->Printf ("NativeBreakpoint::%s addr = 0x%" PRIx64 " failed to evaluate condition: %s", __FUNCTION__, m_addr, error.AsCString ());
+            return true;
+        }
+        if (result != 0)
+            return true;
+    }
+
+    if (log)
+        log->Printf ("NativeBreakpoint::%s addr = 0x%" PRIx64 " all conditions are false", __FUNCTION__, m_addr);
+    return false;
+}
+
+void
+NativeBreakpoint::SetCommands (std::vector<NativeAgentExpression> &&commands)
+{
+    m_commands = std::move (commands);
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("NativeBreakpoint::%s addr = 0x%" PRIx64 " now has %" PRIu64 " commands", __FUNCTION__, m_addr, (uint64_t)m_commands.size ());
+}
+
+void
+NativeBreakpoint::RunCommands (NativeProcessProtocol &process, NativeThreadProtocol &thread, NativeCollectSample &sample) const
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    for (const NativeAgentExpression &command : m_commands)
+    {
+        uint64_t result = 0;
+        Error error = command.Evaluate (process, thread, result, &sample);
+        if (error.Fail () && log)
+            log->Printf ("NativeBreakpoint::%s addr = 0x%" PRIx64 " failed to run command: %s", __FUNCTION__, m_addr, error.AsCString ());
+    }
+}
+
 void
 NativeBreakpoint::AddRef ()
 {
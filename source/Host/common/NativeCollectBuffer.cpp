@@ -0,0 +1,93 @@
+//===-- NativeCollectBuffer.cpp ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Host/common/NativeCollectBuffer.h"
+
+using namespace lldb_private;
+
+size_t
+NativeCollectSample::GetByteSize () const
+{
+    size_t byte_size = sizeof (*this);
+    for (const auto &reg : registers)
+        byte_size += sizeof (reg) + reg.second.size ();
+    for (const MemoryBlock &block : memory)
+        byte_size += sizeof (block) + block.bytes.size ();
+    return byte_size;
+}
+
+NativeCollectBuffer::NativeCollectBuffer (size_t capacity) :
+    m_mutex (Mutex::eMutexTypeNormal),
+    m_capacity (capacity),
+    m_byte_size (0),
+    m_next_id (0),
+    m_dropped (0),
+    m_samples ()
+{
+}
+
+NativeCollectSample
+NativeCollectBuffer::CreateSample (lldb::tid_t tid, lldb::addr_t addr)
+{
+    Mutex::Locker locker (m_mutex);
+    return NativeCollectSample (m_next_id++, tid, addr);
+}
+
+void
+NativeCollectBuffer::AddSample (NativeCollectSample &&sample)
+{
+    Mutex::Locker locker (m_mutex);
+
+    const size_t byte_size = sample.GetByteSize ();
+    if (byte_size > m_capacity)
+    {
+        ++m_dropped;
+        return;
+    }
+
+    while (m_byte_size + byte_size > m_capacity)
+    {
+        m_byte_size -= m_samples.front ().GetByteSize ();
+        m_samples.pop_front ();
+        ++m_dropped;
+    }
+
+    m_byte_size += byte_size;
+    m_samples.push_back (std::move (sample));
+}
+
+void
+NativeCollectBuffer::Drain (size_t max_bytes, std::vector<NativeCollectSample> &samples, uint64_t &dropped)
+{
+    Mutex::Locker locker (m_mutex);
+
+    dropped = m_dropped;
+    m_dropped = 0;
+
+    size_t drained_bytes = 0;
+    while (!m_samples.empty ())
+    {
+        const size_t byte_size = m_samples.front ().GetByteSize ();
+        if (drained_bytes > 0 && drained_bytes + byte_size > max_bytes)
+            break;
+        drained_bytes += byte_size;
+        m_byte_size -= byte_size;
+        samples.push_back (std::move (m_samples.front ()));
+        m_samples.pop_front ();
+    }
+}
+
+void
+NativeCollectBuffer::Clear ()
+{
+    Mutex::Locker locker (m_mutex);
+    m_samples.clear ();
+    m_byte_size = 0;
+    m_dropped = 0;
+}
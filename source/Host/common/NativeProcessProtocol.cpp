@@ -9,6 +9,8 @@
 
 #include "lldb/Host/common/NativeProcessProtocol.h"
 
+#include <algorithm>
+
 #include "lldb/lldb-enumerations.h"
 #include "lldb/Core/ArchSpec.h"
 #include "lldb/Core/Log.h"
@@ -22,6 +24,10 @@
 using namespace lldb;
 using namespace lldb_private;
 
+// The most memory the samples collected by breakpoint commands may take
+// before the oldest ones are discarded.
+static const size_t k_collect_buffer_capacity = 16 * 1024 * 1024;
+
 // -----------------------------------------------------------------------------
 // NativeProcessProtocol Members
 // -----------------------------------------------------------------------------
@@ -40,8 +46,10 @@ NativeProcessProtocol::NativeProcessProtocol (lldb::pid_t pid) :
     m_delegates (),
     m_breakpoint_list (),
     m_watchpoint_list (),
+    m_collect_buffer (k_collect_buffer_capacity),
     m_terminal_fd (-1),
-    m_stop_id (0)
+    m_stop_id (0),
+    m_non_stop (false)
 {
 }
 
@@ -57,6 +65,16 @@ NativeProcessProtocol::Interrupt ()
 #endif
 }
 
+lldb_private::Error
+NativeProcessProtocol::SetNonStopMode (bool enable)
+{
+    // Default: only all-stop mode is supported.
+    if (enable)
+        return Error ("non-stop mode is not supported");
+    m_non_stop = false;
+    return Error ();
+}
+
 lldb_private::Error
 NativeProcessProtocol::GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInfo &range_info)
 {
@@ -64,6 +82,53 @@ NativeProcessProtocol::GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegion
     return Error ("not implemented");
 }
 
+lldb_private::Error
+NativeProcessProtocol::ReadMemoryRanges (const std::vector<std::pair<lldb::addr_t, size_t> > &ranges,
+                                         void *buf,
+                                         std::vector<size_t> &bytes_read)
+{
+    // Default: read the ranges one at a time.
+    uint8_t *dst = static_cast<uint8_t *> (buf);
+    bytes_read.clear ();
+    for (const auto &range : ranges)
+    {
+        size_t range_bytes_read = 0;
+        ReadMemory (range.first, dst, range.second, range_bytes_read);
+        bytes_read.push_back (std::min (range_bytes_read, range.second));
+        dst += range.second;
+    }
+    return Error ();
+}
+
+lldb_private::Error
+NativeProcessProtocol::ReadMemoryRangesWithoutTrap (const std::vector<std::pair<lldb::addr_t, size_t> > &ranges,
+                                                    void *buf,
+                                                    std::vector<size_t> &bytes_read)
+{
+    Error error = ReadMemoryRanges (ranges, buf, bytes_read);
+    if (error.Fail ())
+        return error;
+
+    uint8_t *dst = static_cast<uint8_t *> (buf);
+    for (size_t i = 0; i < ranges.size () && i < bytes_read.size (); ++i)
+    {
+        if (bytes_read[i] > 0)
+            m_breakpoint_list.RemoveTrapsFromBuffer (ranges[i].first, dst, bytes_read[i]);
+        dst += ranges[i].second;
+    }
+    return Error ();
+}
+
+lldb_private::Error
+NativeProcessProtocol::GetLoadedSVR4Libraries (lldb::addr_t start_link_map,
+                                               lldb::addr_t prev_link_map,
+                                               lldb::addr_t &main_link_map,
+                                               std::vector<SVR4LibraryInfo> &library_list)
+{
+    // Default: not implemented.
+    return Error ("not implemented");
+}
+
 bool
 NativeProcessProtocol::GetExitStatus (ExitType *exit_type, int *status, std::string &exit_description)
 {
@@ -360,6 +425,18 @@ NativeProcessProtocol::NotifyDidExec ()
     }
 }
 
+void
+NativeProcessProtocol::NotifyThreadStopped (lldb::tid_t tid)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+    if (log)
+        log->Printf ("NativeProcessProtocol::%s - pid %" PRIu64 " tid %" PRIu64 " stopped", __FUNCTION__, GetID (), tid);
+
+    Mutex::Locker locker (m_delegates_mutex);
+    for (auto native_delegate: m_delegates)
+        native_delegate->ThreadStopped (this, tid);
+}
+
 
 Error
 NativeProcessProtocol::SetSoftwareBreakpoint (lldb::addr_t addr, uint32_t size_hint)
@@ -391,6 +468,45 @@ NativeProcessProtocol::DisableBreakpoint (lldb::addr_t addr)
     return m_breakpoint_list.DisableBreakpoint (addr);
 }
 
+Error
+NativeProcessProtocol::SetBreakpointConditions (lldb::addr_t addr, std::vector<NativeAgentExpression> &&conditions)
+{
+    NativeBreakpointSP breakpoint_sp;
+    Error error = m_breakpoint_list.GetBreakpoint (addr, breakpoint_sp);
+    if (error.Fail ())
+        return error;
+    if (!breakpoint_sp)
+        return Error ("no breakpoint at 0x%" PRIx64, addr);
+
+    breakpoint_sp->SetConditions (std::move (conditions));
+    return error;
+}
+
+Error
+NativeProcessProtocol::SetBreakpointCommands (lldb::addr_t addr, std::vector<NativeAgentExpression> &&commands)
+{
+    if (!commands.empty () && !SupportsBreakpointCommands ())
+        return Error ("breakpoint commands are not supported by this process");
+
+    NativeBreakpointSP breakpoint_sp;
+    Error error = m_breakpoint_list.GetBreakpoint (addr, breakpoint_sp);
+    if (error.Fail ())
+        return error;
+    if (!breakpoint_sp)
+        return Error ("no breakpoint at 0x%" PRIx64, addr);
+
+    breakpoint_sp->SetCommands (std::move (commands));
+    return error;
+}
+
+void
+NativeProcessProtocol::RunBreakpointCommands (NativeBreakpoint &breakpoint, NativeThreadProtocol &thread)
+{
+    NativeCollectSample sample = m_collect_buffer.CreateSample (thread.GetID (), breakpoint.GetAddress ());
+    breakpoint.RunCommands (*this, thread, sample);
+    m_collect_buffer.AddSample (std::move (sample));
+}
+
 lldb::StateType
 NativeProcessProtocol::GetState () const
 {
@@ -9,6 +9,8 @@
 
 // C Includes
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 #include "lldb/Core/ArchSpec.h"
 #include "lldb/Core/Error.h"
@@ -242,6 +244,29 @@ DYLDRendezvous::UpdateSOEntriesForAddition()
     if (m_current.map_addr == 0)
         return false;
 
+    // The dynamic linker appends new objects to the link map, so if the
+    // process can list the link map for us only ask for the entries from
+    // the last one we know about on.
+    SOEntryList entry_list;
+    bool have_entries = false;
+    if (!m_soentries.empty())
+        have_entries = ReadSOEntriesFromProcess(m_soentries.back().link_addr, m_soentries.back().prev, entry_list);
+    if (!have_entries)
+        have_entries = ReadSOEntriesFromProcess(LLDB_INVALID_ADDRESS, LLDB_INVALID_ADDRESS, entry_list);
+    if (have_entries)
+    {
+        for (const SOEntry &new_entry : entry_list)
+        {
+            pos = std::find(m_soentries.begin(), m_soentries.end(), new_entry);
+            if (pos == m_soentries.end())
+            {
+                m_soentries.push_back(new_entry);
+                m_added_soentries.push_back(new_entry);
+            }
+        }
+        return true;
+    }
+
     for (addr_t cursor = m_current.map_addr; cursor != 0; cursor = entry.next)
     {
         if (!ReadSOEntryFromMemory(cursor, entry))
@@ -314,6 +339,9 @@ DYLDRendezvous::TakeSnapshot(SOEntryList &entry_list)
     // Clear previous entries since we are about to obtain an up to date list.
     entry_list.clear();
 
+    if (ReadSOEntriesFromProcess(LLDB_INVALID_ADDRESS, LLDB_INVALID_ADDRESS, entry_list))
+        return true;
+
     for (addr_t cursor = m_current.map_addr; cursor != 0; cursor = entry.next)
     {
         if (!ReadSOEntryFromMemory(cursor, entry))
@@ -441,6 +469,58 @@ DYLDRendezvous::ReadSOEntryFromMemory(lldb::addr_t addr, SOEntry &entry)
     return true;
 }
 
+bool
+DYLDRendezvous::ReadSOEntriesFromProcess(addr_t start_link_map, addr_t prev_link_map, SOEntryList &entry_list)
+{
+    Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_DYNAMIC_LOADER));
+
+    LoadedModuleInfoList module_list;
+    if (m_process->GetLoadedModuleList(module_list, start_link_map, prev_link_map).Fail())
+        return false;
+
+    // Only SVR4 link map lists have everything an SOEntry needs.
+    std::vector<SOEntry> entries;
+    for (const LoadedModuleInfoList::LoadedModuleInfo &module : module_list.m_list)
+    {
+        SOEntry entry;
+        std::string file_path;
+        if (!module.get_link_map(entry.link_addr) ||
+            !module.get_base(entry.base_addr) ||
+            !module.get_dynamic(entry.dyn_addr))
+            return false;
+        module.get_name(file_path);
+        entry.file_spec.SetFile(file_path, false);
+
+        // If the load bias reported by the linker is incorrect then fetch the load address of the file
+        // from the proc file system.
+        if (isLoadBiasIncorrect(m_process->GetTarget(), file_path))
+        {
+            lldb::addr_t load_addr = LLDB_INVALID_ADDRESS;
+            bool is_loaded = false;
+            Error error = m_process->GetFileLoadAddress(entry.file_spec, is_loaded, load_addr);
+            if (error.Success() && is_loaded)
+                entry.base_addr = load_addr;
+        }
+
+        entry.prev = entries.empty() ? (prev_link_map == LLDB_INVALID_ADDRESS ? 0 : prev_link_map) : entries.back().link_addr;
+        if (!entries.empty())
+            entries.back().next = entry.link_addr;
+        entries.push_back(entry);
+    }
+
+    if (log)
+        log->Printf("DYLDRendezvous::%s got %" PRIu64 " link map entries from the process", __FUNCTION__, (uint64_t)entries.size());
+
+    entry_list.clear();
+    for (const SOEntry &entry : entries)
+    {
+        // Only add shared libraries and not the executable.
+        if (!SOEntryIsMainExecutable(entry))
+            entry_list.push_back(entry);
+    }
+
+    return true;
+}
 
 bool
 DYLDRendezvous::FindMetadata(const char *name, PThreadField field, uint32_t& value)
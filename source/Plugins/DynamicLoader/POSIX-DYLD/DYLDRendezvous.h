@@ -237,6 +237,14 @@ protected:
     bool
     ReadSOEntryFromMemory(lldb::addr_t addr, SOEntry &entry);
 
+    /// Reads the link map entries starting at @p start_link_map, or the
+    /// whole link map if it is LLDB_INVALID_ADDRESS, from the library list
+    /// of the process plug-in instead of from the inferior's memory.
+    ///
+    /// @returns false if the process plug-in can't list the link map.
+    bool
+    ReadSOEntriesFromProcess(lldb::addr_t start_link_map, lldb::addr_t prev_link_map, SOEntryList &entry_list);
+
     /// Updates the current set of SOEntries, the set of added entries, and the
     /// set of removed entries.
     bool
@@ -400,6 +400,8 @@ DynamicLoaderPOSIXDYLD::RefreshModules()
     {
         ModuleList new_modules;
 
+        // Resolve the breakpoints in all the new modules at once.
+        m_process->GetTarget().BeginModuleBatch();
         E = m_rendezvous.loaded_end();
         for (I = m_rendezvous.loaded_begin(); I != E; ++I)
         {
@@ -410,7 +412,7 @@ DynamicLoaderPOSIXDYLD::RefreshModules()
                 new_modules.Append(module_sp);
             }
         }
-        m_process->GetTarget().ModulesDidLoad(new_modules);
+        m_process->GetTarget().EndModuleBatch(new_modules);
     }
     
     if (m_rendezvous.ModulesDidUnload())
@@ -507,6 +509,9 @@ DynamicLoaderPOSIXDYLD::LoadAllCurrentModules()
     // that ourselves here.
     ModuleSP executable = GetTargetExecutable();
     m_loaded_modules[executable] = m_rendezvous.GetLinkMapAddress();
+
+    // Resolve the breakpoints in all the modules at once.
+    m_process->GetTarget().BeginModuleBatch();
     if (m_vdso_base != LLDB_INVALID_ADDRESS)
     {
         FileSpec file_spec("[vdso]", false);
@@ -532,7 +537,7 @@ DynamicLoaderPOSIXDYLD::LoadAllCurrentModules()
         }
     }
 
-    m_process->GetTarget().ModulesDidLoad(module_list);
+    m_process->GetTarget().EndModuleBatch(module_list);
 }
 
 addr_t
@@ -842,7 +842,9 @@ ObjectFileELF::ObjectFileELF (const lldb::ModuleSP &module_sp,
     m_dynamic_symbols(),
     m_filespec_ap(),
     m_entry_point_address(),
-    m_arch_spec()
+    m_arch_spec(),
+    m_pending_debug_relocations(),
+    m_pending_debug_relocations_mutex()
 {
     if (file)
         m_file = *file;
@@ -863,7 +865,9 @@ ObjectFileELF::ObjectFileELF (const lldb::ModuleSP &module_sp,
     m_dynamic_symbols(),
     m_filespec_ap(),
     m_entry_point_address(),
-    m_arch_spec()
+    m_arch_spec(),
+    m_pending_debug_relocations(),
+    m_pending_debug_relocations_mutex()
 {
     ::memset(&m_header, 0, sizeof(m_header));
 }
@@ -1790,6 +1794,7 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
             static ConstString g_sect_name_dwarf_debug_loc_dwo (".debug_loc.dwo");
             static ConstString g_sect_name_dwarf_debug_str_dwo (".debug_str.dwo");
             static ConstString g_sect_name_dwarf_debug_str_offsets_dwo (".debug_str_offsets.dwo");
+            static ConstString g_sect_name_gdb_index (".gdb_index");
             static ConstString g_sect_name_eh_frame (".eh_frame");
             static ConstString g_sect_name_arm_exidx (".ARM.exidx");
             static ConstString g_sect_name_arm_extab (".ARM.extab");
@@ -1824,7 +1829,7 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
             // .debug_ranges – Address ranges used in DW_AT_ranges attributes
             // .debug_str – String table used in .debug_info
             // MISSING? .gnu_debugdata - "mini debuginfo / MiniDebugInfo" section, http://sourceware.org/gdb/onlinedocs/gdb/MiniDebugInfo.html
-            // MISSING? .debug-index - http://src.chromium.org/viewvc/chrome/trunk/src/build/gdb-add-index?pathrev=144644
+            // .gdb_index - Name to compile unit index, https://sourceware.org/gdb/onlinedocs/gdb/Index-Section-Format.html
             // MISSING? .debug_types - Type descriptions from DWARF 4? See http://gcc.gnu.org/wiki/DwarfSeparateTypeInfo
             else if (name == g_sect_name_dwarf_debug_abbrev)          sect_type = eSectionTypeDWARFDebugAbbrev;
             else if (name == g_sect_name_dwarf_debug_addr)            sect_type = eSectionTypeDWARFDebugAddr;
@@ -1847,6 +1852,7 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
             else if (name == g_sect_name_dwarf_debug_loc_dwo)         sect_type = eSectionTypeDWARFDebugLoc;
             else if (name == g_sect_name_dwarf_debug_str_dwo)         sect_type = eSectionTypeDWARFDebugStr;
             else if (name == g_sect_name_dwarf_debug_str_offsets_dwo) sect_type = eSectionTypeDWARFDebugStrOffsets;
+            else if (name == g_sect_name_gdb_index)                   sect_type = eSectionTypeDWARFGdbIndex;
             else if (name == g_sect_name_eh_frame)                    sect_type = eSectionTypeEHFrame;
             else if (name == g_sect_name_arm_exidx)                   sect_type = eSectionTypeARMexidx;
             else if (name == g_sect_name_arm_extab)                   sect_type = eSectionTypeARMextab;
@@ -1906,6 +1912,20 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
             if (is_thread_specific)
                 section_sp->SetIsThreadSpecific (is_thread_specific);
             m_sections_ap->AddSection(section_sp);
+
+            // Debug sections of relocatable objects are relocated lazily, the first time
+            // their data is read (see ApplyPendingDebugRelocations).
+            if ((header.sh_type == SHT_RELA || header.sh_type == SHT_REL) &&
+                CalculateType() == eTypeObjectFile)
+            {
+                const char *section_name = name.AsCString("");
+                if (strstr(section_name, ".rela.debug") ||
+                    strstr(section_name, ".rel.debug"))
+                {
+                    // Section ID's are ones based.
+                    m_pending_debug_relocations.insert(std::make_pair(header.sh_info + 1, SectionIndex(I)));
+                }
+            }
         }
     }
 
@@ -1928,6 +1948,7 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
                 eSectionTypeDWARFDebugRanges,
                 eSectionTypeDWARFDebugStr,
                 eSectionTypeDWARFDebugStrOffsets,
+                eSectionTypeDWARFGdbIndex,
                 eSectionTypeELFSymbolTable,
             };
             SectionList *elf_section_list = m_sections_ap.get();
@@ -2658,7 +2679,7 @@ ObjectFileELF::RelocateSection(Symtab* symtab, const ELFHeader *hdr, const ELFSe
             case R_X86_64_64:
             {
                 symbol = symtab->FindSymbolByID(reloc_symbol(rel));
-                if (symbol)
+                if (symbol && ELFRelocation::RelocOffset64(rel) + sizeof(uint64_t) <= rel_section->GetFileSize())
                 {
                     addr_t value = symbol->GetAddressRef().GetFileAddress();
                     DataBufferSP& data_buffer_sp = debug_data.GetSharedDataBuffer();
@@ -2671,7 +2692,7 @@ ObjectFileELF::RelocateSection(Symtab* symtab, const ELFHeader *hdr, const ELFSe
             case R_X86_64_32S:
             {
                 symbol = symtab->FindSymbolByID(reloc_symbol(rel));
-                if (symbol)
+                if (symbol && ELFRelocation::RelocOffset32(rel) + sizeof(uint32_t) <= rel_section->GetFileSize())
                 {
                     addr_t value = symbol->GetAddressRef().GetFileAddress();
                     value += ELFRelocation::RelocAddend32(rel);
@@ -2818,25 +2839,58 @@ ObjectFileELF::GetSymtab()
         m_symtab_ap->CalculateSymbolSizes();
     }
 
-    for (SectionHeaderCollIter I = m_section_headers.begin();
-         I != m_section_headers.end(); ++I)
+    return m_symtab_ap.get();
+}
+
+void
+ObjectFileELF::ApplyPendingDebugRelocations(const Section *section)
+{
+    const user_id_t section_id = section->GetID();
     {
-        if (I->sh_type == SHT_RELA || I->sh_type == SHT_REL)
-        {
-            if (CalculateType() == eTypeObjectFile)
-            {
-                const char *section_name = I->section_name.AsCString("");
-                if (strstr(section_name, ".rela.debug") ||
-                    strstr(section_name, ".rel.debug"))
-                {
-                    const ELFSectionHeader &reloc_header = *I;
-                    user_id_t reloc_id = SectionIndex(I);
-                    RelocateDebugSections(&reloc_header, reloc_id);
-                }
-            }
-        }
+        std::lock_guard<std::recursive_mutex> guard(m_pending_debug_relocations_mutex);
+        if (m_pending_debug_relocations.find(section_id) == m_pending_debug_relocations.end())
+            return;
     }
-    return m_symtab_ap.get();
+
+    // The relocations refer to symbols, so make sure the symbol table is parsed. This has to
+    // happen before taking our lock as GetSymtab() takes the module mutex and reads sections.
+    GetSymtab();
+
+    // Keep holding the lock while relocating so other readers of the section wait until the
+    // relocations have been applied. Reading the relocation and symbol table sections below
+    // comes back here on the same thread, which is why the mutex is recursive.
+    std::lock_guard<std::recursive_mutex> guard(m_pending_debug_relocations_mutex);
+    auto range = m_pending_debug_relocations.equal_range(section_id);
+    std::vector<user_id_t> reloc_ids;
+    for (auto pos = range.first; pos != range.second; ++pos)
+        reloc_ids.push_back(pos->second);
+    m_pending_debug_relocations.erase(range.first, range.second);
+
+    if (!m_symtab_ap)
+        return;
+
+    for (user_id_t reloc_id : reloc_ids)
+    {
+        const ELFSectionHeaderInfo *reloc_header = GetSectionHeaderByIndex(reloc_id);
+        if (reloc_header)
+            RelocateDebugSections(reloc_header, reloc_id);
+    }
+}
+
+size_t
+ObjectFileELF::ReadSectionData(const Section *section, lldb::offset_t section_offset, void *dst, size_t dst_len) const
+{
+    if (section->GetObjectFile() == this)
+        const_cast<ObjectFileELF *>(this)->ApplyPendingDebugRelocations(section);
+    return ObjectFile::ReadSectionData(section, section_offset, dst, dst_len);
+}
+
+size_t
+ObjectFileELF::ReadSectionData(const Section *section, DataExtractor& section_data) const
+{
+    if (section->GetObjectFile() == this)
+        const_cast<ObjectFileELF *>(this)->ApplyPendingDebugRelocations(section);
+    return ObjectFile::ReadSectionData(section, section_data);
 }
 
 Symbol *
@@ -14,6 +14,8 @@
 #include <stdint.h>
 
 // C++ Includes
+#include <map>
+#include <mutex>
 #include <vector>
 
 // Other libraries and framework includes
@@ -200,6 +202,16 @@ public:
     std::string
     StripLinkerSymbolAnnotations(llvm::StringRef symbol_name) const override;
 
+    size_t
+    ReadSectionData(const lldb_private::Section *section,
+                    lldb::offset_t section_offset,
+                    void *dst,
+                    size_t dst_len) const override;
+
+    size_t
+    ReadSectionData(const lldb_private::Section *section,
+                    lldb_private::DataExtractor& section_data) const override;
+
 private:
     ObjectFileELF(const lldb::ModuleSP &module_sp,
                   lldb::DataBufferSP& data_sp,
@@ -268,6 +280,12 @@ private:
     /// The address class for each symbol in the elf file
     FileAddressToAddressClassMap m_address_class_map;
 
+    /// Debug sections of relocatable objects that still need to be relocated,
+    /// mapping the ID of the debug section to the ID of its relocation section.
+    /// Entries are removed once the relocations have been applied.
+    mutable std::multimap<lldb::user_id_t, lldb::user_id_t> m_pending_debug_relocations;
+    mutable std::recursive_mutex m_pending_debug_relocations_mutex;
+
     /// Returns a 1 based index of the given section header.
     size_t
     SectionIndex(const SectionHeaderCollIter &I);
@@ -351,6 +369,13 @@ private:
     unsigned
     RelocateDebugSections(const elf::ELFSectionHeader *rel_hdr, lldb::user_id_t rel_id);
 
+    /// Applies the relocations recorded for \a section, if any, the first
+    /// time its data is read. The relocations are applied in place to the
+    /// private mapping of the file, so only the pages that contain relocated
+    /// fields get copied and the rest of the section stays backed by the file.
+    void
+    ApplyPendingDebugRelocations(const lldb_private::Section *section);
+
     unsigned
     RelocateSection(lldb_private::Symtab* symtab, const elf::ELFHeader *hdr, const elf::ELFSectionHeader *rel_hdr,
                     const elf::ELFSectionHeader *symtab_hdr, const elf::ELFSectionHeader *debug_hdr,
@@ -1379,6 +1379,7 @@ ObjectFileMachO::GetAddressClass (lldb::addr_t file_addr)
                     case eSectionTypeDWARFAppleTypes:
                     case eSectionTypeDWARFAppleNamespaces:
                     case eSectionTypeDWARFAppleObjC:
+                    case eSectionTypeDWARFGdbIndex:
                         return eAddressClassDebug;
 
                     case eSectionTypeEHFrame:
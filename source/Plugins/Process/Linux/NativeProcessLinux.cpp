@@ -11,18 +11,22 @@
 
 // C Includes
 #include <errno.h>
+#include <limits.h>
 #include <string.h>
 #include <stdint.h>
 #include <unistd.h>
 
 // C++ Includes
+#include <algorithm>
 #include <fstream>
+#include <limits>
 #include <mutex>
 #include <sstream>
 #include <string>
 #include <unordered_map>
 
 // Other libraries and framework includes
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/EmulateInstruction.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Module.h"
@@ -32,6 +36,7 @@
 #include "lldb/Host/common/NativeBreakpoint.h"
 #include "lldb/Host/common/NativeRegisterContext.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Host/HostInfo.h"
 #include "lldb/Host/ThreadLauncher.h"
 #include "lldb/Target/Platform.h"
 #include "lldb/Target/Process.h"
@@ -40,6 +45,7 @@
 #include "lldb/Utility/LLDBAssert.h"
 #include "lldb/Utility/PseudoTerminal.h"
 #include "lldb/Utility/StringExtractor.h"
+#include "llvm/Support/ELF.h"
 
 #include "Plugins/Process/POSIX/ProcessPOSIXLog.h"
 #include "NativeThreadLinux.h"
@@ -76,6 +82,21 @@ using namespace llvm;
 
 // Private bits we only need internally.
 
+// Auxiliary vector entry types, see <elf.h>.
+static const uint64_t k_auxv_null = 0;
+static const uint64_t k_auxv_phdr = 3;
+static const uint64_t k_auxv_phnum = 5;
+
+// Sanity limits for walking the dynamic linker structures of the inferior.
+static const uint64_t k_max_program_headers = 1024;
+static const uint64_t k_max_dynamic_entries = 1024;
+static const size_t k_max_link_map_entries = 1 << 16;
+static const size_t k_name_chunk_size = 256;
+
+// The maximum number of ranges the kernel accepts in one process_vm_readv call
+// (UIO_MAXIOV).
+static const size_t k_max_readv_ranges = 1024;
+
 static bool ProcessVmReadvSupported()
 {
     static bool is_supported;
@@ -429,7 +450,10 @@ NativeProcessLinux::NativeProcessLinux () :
     m_supports_mem_region (eLazyBoolCalculate),
     m_mem_region_cache (),
     m_mem_region_cache_mutex(),
-    m_pending_notification_tid(LLDB_INVALID_THREAD_ID)
+    m_pending_notification_tid(LLDB_INVALID_THREAD_ID),
+    m_supports_proc_mem (eLazyBoolCalculate),
+    m_proc_mem_file (),
+    m_paused_breakpoint_addr (LLDB_INVALID_ADDRESS)
 {
 }
 
@@ -1187,6 +1211,10 @@ NativeProcessLinux::MonitorSIGTRAP(const siginfo_t &info, NativeThreadLinux &thr
         // Exec clears any pending notifications.
         m_pending_notification_tid = LLDB_INVALID_THREAD_ID;
 
+        // The open /proc/<pid>/mem refers to the address space before the exec.
+        m_proc_mem_file.Close ();
+        m_supports_proc_mem = eLazyBoolCalculate;
+
         // Remove all but the main thread here.  Linux fork creates a new process which only copies the main thread.  Mutexes are in undefined state.
         if (log)
             log->Printf ("NativeProcessLinux::%s exec received, stop tracking all but main thread", __FUNCTION__);
@@ -1208,6 +1236,9 @@ NativeProcessLinux::MonitorSIGTRAP(const siginfo_t &info, NativeThreadLinux &thr
         }
 
         m_threads.clear ();
+        m_threads_stepping_over_breakpoint.clear ();
+        m_threads_paused.clear ();
+        m_paused_breakpoint_addr = LLDB_INVALID_ADDRESS;
 
         if (main_thread_sp)
         {
@@ -1280,6 +1311,16 @@ NativeProcessLinux::MonitorSIGTRAP(const siginfo_t &info, NativeThreadLinux &thr
     case TRAP_TRACE:  // We receive this on single stepping.
     case TRAP_HWBKPT: // We receive this on watchpoint hit
     {
+        // Put back the breakpoint the thread stepped off, if its hit was not reported.
+        auto step_over_it = m_threads_stepping_over_breakpoint.find(thread.GetID());
+        const bool stepped_over_breakpoint = step_over_it != m_threads_stepping_over_breakpoint.end();
+        const bool report_step = stepped_over_breakpoint && step_over_it->second.report_step;
+        if (stepped_over_breakpoint)
+        {
+            thread.SetStoppedWithNoReason();
+            EndBreakpointStepOver(thread.GetID());
+        }
+
         // If a watchpoint was hit, report it
         uint32_t wp_index;
         Error error = thread.GetRegisterContext()->GetWatchpointHitIndex(wp_index, (uintptr_t)info.si_addr);
@@ -1294,6 +1335,17 @@ NativeProcessLinux::MonitorSIGTRAP(const siginfo_t &info, NativeThreadLinux &thr
             break;
         }
 
+        // The step off the breakpoint is not a stop to report, let the thread continue unless
+        // the process is being stopped.
+        if (stepped_over_breakpoint && !report_step)
+        {
+            if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
+                SignalIfAllThreadsStopped();
+            else
+                ResumeThread(thread, eStateRunning, LLDB_INVALID_SIGNAL_NUMBER);
+            break;
+        }
+
         // Otherwise, report step over
         MonitorTrace(thread);
         break;
@@ -1365,6 +1417,9 @@ NativeProcessLinux::MonitorBreakpoint(NativeThreadLinux &thread)
         log->Printf("NativeProcessLinux::%s() received breakpoint event, pid = %" PRIu64,
                 __FUNCTION__, thread.GetID());
 
+    // A thread single stepped by the debugger can hit a breakpoint the debugger doesn't know of.
+    const bool was_stepping = thread.GetState() == eStateStepping;
+
     // Mark the thread as stopped at breakpoint.
     thread.SetStoppedByBreakpoint();
     Error error = FixupBreakpointPCAsNeeded(thread);
@@ -1375,6 +1430,8 @@ NativeProcessLinux::MonitorBreakpoint(NativeThreadLinux &thread)
 
     if (m_threads_stepping_with_breakpoint.find(thread.GetID()) != m_threads_stepping_with_breakpoint.end())
         thread.SetStoppedByTrace();
+    else if (StepOverUnreportedBreakpoint(thread, was_stepping))
+        return;
 
     StopRunningThreads(thread.GetID());
 }
@@ -1455,16 +1512,48 @@ NativeProcessLinux::MonitorSignal(const siginfo_t &info, NativeThreadLinux &thre
             // case of an asynchronous Interrupt(), this *is* the real stop reason, so we
             // leave the signal intact if this is the thread that was chosen as the
             // triggering thread.
-            if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
+            auto paused_it = m_threads_paused.find(thread.GetID());
+            if (paused_it != m_threads_paused.end() && m_pending_notification_tid == LLDB_INVALID_THREAD_ID)
+            {
+                // The thread was paused while another one steps off a breakpoint. If that is
+                // over already, this is a late SIGSTOP of a thread that stopped for another
+                // reason first.
+                // A thread stepping off a breakpoint by now goes on with its step.
+                thread.SetStoppedWithNoReason();
+                auto step_over_it = m_threads_stepping_over_breakpoint.find(thread.GetID());
+                const bool is_stepping_over = step_over_it != m_threads_stepping_over_breakpoint.end() &&
+                                              step_over_it->second.started;
+                if (IsPausingThreads() && !is_stepping_over)
+                {
+                    paused_it->second = PausedThread{true, thread_state};
+                    StartBreakpointStepOver();
+                }
+                else
+                {
+                    m_threads_paused.erase(paused_it);
+                    ResumeThread(thread, thread_state, 0);
+                }
+            }
+            else if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
             {
                 if (m_pending_notification_tid == thread.GetID())
                     thread.SetStoppedBySignal(SIGSTOP, &info);
                 else
                     thread.SetStoppedWithNoReason();
+                EndBreakpointStepOver(thread.GetID());
+                m_threads_paused.erase(thread.GetID());
 
                 SetCurrentThreadID (thread.GetID ());
                 SignalIfAllThreadsStopped();
             }
+            else if (m_non_stop)
+            {
+                // In non-stop mode threads are only sent a SIGSTOP when they were explicitly
+                // asked to stop, so this is the stop to report.
+                thread.SetStoppedWithNoReason();
+                EndBreakpointStepOver(thread.GetID());
+                SignalThreadStopped(thread.GetID());
+            }
             else
             {
                 // We can end up here if stop was initiated by LLGS but by this time a
@@ -1508,6 +1597,7 @@ NativeProcessLinux::MonitorSignal(const siginfo_t &info, NativeThreadLinux &thre
 
     // This thread is stopped.
     thread.SetStoppedBySignal(signo, &info);
+    EndBreakpointStepOver(thread.GetID());
 
     // Send a stop to the debugger after we get all other threads to stop.
     StopRunningThreads(thread.GetID());
@@ -1715,6 +1805,23 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
 
     Mutex::Locker locker (m_threads_mutex);
 
+    // Continuing any thread means the debugger is done stepping off the breakpoint it
+    // removed, even if it doesn't put it back.
+    if (m_paused_breakpoint_addr != LLDB_INVALID_ADDRESS)
+    {
+        for (auto thread_sp : m_threads)
+        {
+            const ResumeAction *const action = resume_actions.GetActionForThread (thread_sp->GetID (), true);
+            if (action && action->state == eStateRunning && !StateIsRunningState (thread_sp->GetState ()) &&
+                !IsThreadPaused (thread_sp->GetID ()))
+            {
+                m_paused_breakpoint_addr = LLDB_INVALID_ADDRESS;
+                ResumePausedThreads ();
+                break;
+            }
+        }
+    }
+
     if (software_single_step)
     {
         for (auto thread_sp : m_threads)
@@ -1748,6 +1855,17 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
             continue;
         }
 
+        // In non-stop mode a default action also covers the threads that are still running.
+        // Paused threads are running as far as the debugger knows.
+        const bool is_paused = IsThreadPaused (thread_sp->GetID ());
+        if (m_non_stop && (StateIsRunningState (thread_sp->GetState ()) || is_paused) && action->state != eStateStopped)
+        {
+            if (log)
+                log->Printf ("NativeProcessLinux::%s pid %" PRIu64 " tid %" PRIu64 " is already running",
+                    __FUNCTION__, GetID (), thread_sp->GetID ());
+            continue;
+        }
+
         if (log)
         {
             log->Printf ("NativeProcessLinux::%s processing resume action state %s for pid %" PRIu64 " tid %" PRIu64, 
@@ -1765,8 +1883,20 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
             break;
         }
 
-        case eStateSuspended:
         case eStateStopped:
+            if (m_non_stop)
+            {
+                // Stop a running thread. It is reported once its SIGSTOP arrives.
+                if (StateIsRunningState (thread_sp->GetState ()))
+                    static_pointer_cast<NativeThreadLinux> (thread_sp)->RequestStop ();
+                else if (is_paused)
+                    StopPausedThread (thread_sp->GetID ());
+                break;
+            }
+            lldbassert(0 && "Unexpected state");
+            return Error ("NativeProcessLinux::%s (): stopping threads requires non-stop mode", __FUNCTION__);
+
+        case eStateSuspended:
             lldbassert(0 && "Unexpected state");
 
         default:
@@ -1842,6 +1972,22 @@ NativeProcessLinux::Interrupt ()
 
     Mutex::Locker locker (m_threads_mutex);
 
+    if (m_non_stop)
+    {
+        // Every running thread stops and is reported on its own. Paused threads are
+        // stopped already.
+        for (auto thread_sp : m_threads)
+        {
+            if (!thread_sp)
+                continue;
+            if (StateIsRunningState (thread_sp->GetState ()))
+                static_pointer_cast<NativeThreadLinux> (thread_sp)->RequestStop ();
+            else if (IsThreadPaused (thread_sp->GetID ()))
+                StopPausedThread (thread_sp->GetID ());
+        }
+        return Error();
+    }
+
     for (auto thread_sp : m_threads)
     {
         // The thread shouldn't be null but lets just cover that here.
@@ -1887,6 +2033,17 @@ NativeProcessLinux::Interrupt ()
     return Error();
 }
 
+Error
+NativeProcessLinux::SetNonStopMode (bool enable)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    if (log)
+        log->Printf ("NativeProcessLinux::%s pid %" PRIu64 " %s non-stop mode", __FUNCTION__, GetID (), enable ? "enabling" : "disabling");
+
+    m_non_stop = enable;
+    return Error();
+}
+
 Error
 NativeProcessLinux::Kill ()
 {
@@ -2179,49 +2336,220 @@ NativeProcessLinux::DeallocateMemory (lldb::addr_t addr)
 lldb::addr_t
 NativeProcessLinux::GetSharedLibraryInfoAddress ()
 {
-#if 1
-    // punt on this for now
-    return LLDB_INVALID_ADDRESS;
-#else
-    // Return the image info address for the exe module
-#if 1
     Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
 
-    ModuleSP module_sp;
-    Error error = GetExeModuleSP (module_sp);
-    if (error.Fail ())
+    const uint32_t addr_size = m_arch.GetAddressByteSize ();
+    const ByteOrder byte_order = m_arch.GetByteOrder ();
+
+    // Find the program headers of the executable through the auxiliary
+    // vector, which also works for position independent executables.
+    DataBufferSP auxv_sp = Host::GetAuxvData (GetID ());
+    if (!auxv_sp || addr_size == 0)
     {
-         if (log)
-            log->Warning ("NativeProcessLinux::%s failed to retrieve exe module: %s", __FUNCTION__, error.AsCString ());
+        if (log)
+            log->Printf ("NativeProcessLinux::%s failed to read the auxiliary vector", __FUNCTION__);
         return LLDB_INVALID_ADDRESS;
     }
 
-    if (module_sp == nullptr)
+    DataExtractor auxv (auxv_sp, byte_order, addr_size);
+    lldb::addr_t phdr_addr = LLDB_INVALID_ADDRESS;
+    uint64_t phnum = 0;
+    lldb::offset_t offset = 0;
+    while (auxv.ValidOffsetForDataOfSize (offset, 2 * addr_size))
     {
-         if (log)
-            log->Warning ("NativeProcessLinux::%s exe module returned was NULL", __FUNCTION__);
-         return LLDB_INVALID_ADDRESS;
+        const uint64_t type = auxv.GetAddress (&offset);
+        const uint64_t value = auxv.GetAddress (&offset);
+        if (type == k_auxv_null)
+            break;
+        if (type == k_auxv_phdr)
+            phdr_addr = value;
+        else if (type == k_auxv_phnum)
+            phnum = value;
     }
 
-    ObjectFileSP object_file_sp = module_sp->GetObjectFile ();
-    if (object_file_sp == nullptr)
+    if (phdr_addr == LLDB_INVALID_ADDRESS || phnum == 0 || phnum > k_max_program_headers)
     {
-         if (log)
-            log->Warning ("NativeProcessLinux::%s exe module returned a NULL object file", __FUNCTION__);
-         return LLDB_INVALID_ADDRESS;
+        if (log)
+            log->Printf ("NativeProcessLinux::%s no program headers in the auxiliary vector", __FUNCTION__);
+        return LLDB_INVALID_ADDRESS;
     }
 
-    return obj_file_sp->GetImageInfoAddress();
-#else
-    Target *target = &GetTarget();
-    ObjectFile *obj_file = target->GetExecutableModule()->GetObjectFile();
-    Address addr = obj_file->GetImageInfoAddress(target);
+    // Find the load bias and the PT_DYNAMIC segment.
+    const size_t phdr_size = (addr_size == 8) ? 56 : 32;
+    std::vector<uint8_t> phdr_bytes (phnum * phdr_size);
+    size_t bytes_read = 0;
+    Error error = ReadMemory (phdr_addr, phdr_bytes.data (), phdr_bytes.size (), bytes_read);
+    if (error.Fail () || bytes_read != phdr_bytes.size ())
+    {
+        if (log)
+            log->Printf ("NativeProcessLinux::%s failed to read the program headers at 0x%" PRIx64, __FUNCTION__, phdr_addr);
+        return LLDB_INVALID_ADDRESS;
+    }
+
+    DataExtractor phdrs (phdr_bytes.data (), phdr_bytes.size (), byte_order, addr_size);
+    lldb::addr_t load_bias = 0;
+    lldb::addr_t dynamic_vaddr = LLDB_INVALID_ADDRESS;
+    uint64_t dynamic_size = 0;
+    for (uint64_t i = 0; i < phnum; ++i)
+    {
+        offset = i * phdr_size;
+        const uint32_t p_type = phdrs.GetU32 (&offset);
+        if (addr_size == 8)
+            offset += 4; // p_flags comes second in Elf64_Phdr
+        phdrs.GetAddress (&offset); // p_offset
+        const lldb::addr_t p_vaddr = phdrs.GetAddress (&offset);
+        phdrs.GetAddress (&offset); // p_paddr
+        phdrs.GetAddress (&offset); // p_filesz
+        const uint64_t p_memsz = phdrs.GetAddress (&offset);
+
+        if (p_type == ELF::PT_PHDR)
+            load_bias = phdr_addr - p_vaddr;
+        else if (p_type == ELF::PT_DYNAMIC)
+        {
+            dynamic_vaddr = p_vaddr;
+            dynamic_size = p_memsz;
+        }
+    }
+
+    if (dynamic_vaddr == LLDB_INVALID_ADDRESS)
+    {
+        if (log)
+            log->Printf ("NativeProcessLinux::%s executable has no dynamic segment", __FUNCTION__);
+        return LLDB_INVALID_ADDRESS;
+    }
+
+    // Look for the entry the dynamic linker stores the r_debug pointer in.
+    const size_t dyn_size = 2 * addr_size;
+    const lldb::addr_t dynamic_addr = dynamic_vaddr + load_bias;
+    std::vector<uint8_t> dynamic_bytes (std::min<uint64_t> (dynamic_size, k_max_dynamic_entries * dyn_size));
+    error = ReadMemory (dynamic_addr, dynamic_bytes.data (), dynamic_bytes.size (), bytes_read);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("NativeProcessLinux::%s failed to read the dynamic segment at 0x%" PRIx64, __FUNCTION__, dynamic_addr);
+        return LLDB_INVALID_ADDRESS;
+    }
 
-    if (addr.IsValid())
-        return addr.GetLoadAddress(target);
+    const bool is_mips = m_arch.GetMachine () == llvm::Triple::mips ||
+                         m_arch.GetMachine () == llvm::Triple::mipsel ||
+                         m_arch.GetMachine () == llvm::Triple::mips64 ||
+                         m_arch.GetMachine () == llvm::Triple::mips64el;
+
+    DataExtractor dynamic (dynamic_bytes.data (), bytes_read, byte_order, addr_size);
+    offset = 0;
+    while (dynamic.ValidOffsetForDataOfSize (offset, dyn_size))
+    {
+        const lldb::addr_t entry_addr = dynamic_addr + offset;
+        const uint64_t d_tag = dynamic.GetAddress (&offset);
+        const uint64_t d_val = dynamic.GetAddress (&offset);
+        if (d_tag == ELF::DT_NULL)
+            break;
+
+        // The location of d_val is what the debugger reads the r_debug
+        // pointer from, just like ObjectFileELF::GetImageInfoAddress.
+        if (d_tag == ELF::DT_DEBUG)
+            return entry_addr + addr_size;
+        if (is_mips && d_tag == ELF::DT_MIPS_RLD_MAP)
+            return d_val;
+        if (is_mips && d_tag == ELF::DT_MIPS_RLD_MAP_REL)
+            return entry_addr + d_val;
+    }
+
+    if (log)
+        log->Printf ("NativeProcessLinux::%s executable has no DT_DEBUG entry", __FUNCTION__);
     return LLDB_INVALID_ADDRESS;
-#endif
-#endif // punt on this for now
+}
+
+Error
+NativeProcessLinux::GetLoadedSVR4Libraries (lldb::addr_t start_link_map,
+                                            lldb::addr_t prev_link_map,
+                                            lldb::addr_t &main_link_map,
+                                            std::vector<SVR4LibraryInfo> &library_list)
+{
+    main_link_map = LLDB_INVALID_ADDRESS;
+    library_list.clear ();
+
+    const uint32_t addr_size = m_arch.GetAddressByteSize ();
+    const ByteOrder byte_order = m_arch.GetByteOrder ();
+
+    auto read_pointer = [this, addr_size, byte_order] (lldb::addr_t addr, lldb::addr_t &value) -> Error
+    {
+        uint8_t bytes[8];
+        size_t bytes_read = 0;
+        Error error = ReadMemory (addr, bytes, addr_size, bytes_read);
+        if (error.Success () && bytes_read != addr_size)
+            error.SetErrorStringWithFormat ("failed to read pointer at 0x%" PRIx64, addr);
+        if (error.Success ())
+        {
+            DataExtractor data (bytes, addr_size, byte_order, addr_size);
+            lldb::offset_t offset = 0;
+            value = data.GetAddress (&offset);
+        }
+        return error;
+    };
+
+    const lldb::addr_t info_addr = GetSharedLibraryInfoAddress ();
+    if (info_addr == LLDB_INVALID_ADDRESS)
+        return Error ("failed to locate the dynamic linker rendezvous structure");
+
+    lldb::addr_t r_debug_addr = 0;
+    Error error = read_pointer (info_addr, r_debug_addr);
+    if (error.Fail ())
+        return error;
+    if (r_debug_addr == 0)
+        return Error ("the dynamic linker has not been initialized yet");
+
+    // struct r_debug { int r_version; struct link_map *r_map; ... }, where
+    // r_map is pointer aligned.
+    error = read_pointer (r_debug_addr + addr_size, main_link_map);
+    if (error.Fail ())
+        return error;
+
+    lldb::addr_t link_map = main_link_map;
+    if (start_link_map != LLDB_INVALID_ADDRESS)
+        link_map = start_link_map;
+
+    // struct link_map { ElfW(Addr) l_addr; char *l_name; ElfW(Dyn) *l_ld;
+    //                   struct link_map *l_next, *l_prev; }
+    for (size_t count = 0; link_map != 0; ++count)
+    {
+        if (count >= k_max_link_map_entries)
+            return Error ("link map is too long or circular");
+
+        lldb::addr_t name_addr, next, prev;
+        SVR4LibraryInfo info;
+        info.link_map = link_map;
+        if ((error = read_pointer (link_map, info.base_addr)).Fail () ||
+            (error = read_pointer (link_map + addr_size, name_addr)).Fail () ||
+            (error = read_pointer (link_map + 2 * addr_size, info.ld_addr)).Fail () ||
+            (error = read_pointer (link_map + 3 * addr_size, next)).Fail () ||
+            (error = read_pointer (link_map + 4 * addr_size, prev)).Fail ())
+            return error;
+
+        if (count == 0 && prev_link_map != LLDB_INVALID_ADDRESS && prev != prev_link_map)
+            return Error ("link map entry 0x%" PRIx64 " is no longer preceded by 0x%" PRIx64, link_map, prev_link_map);
+
+        // The name may end right before unmapped memory, so read it in
+        // aligned chunks that never cross a page boundary.
+        for (lldb::addr_t addr = name_addr; addr != 0 && info.name.size () < PATH_MAX; )
+        {
+            char chunk[k_name_chunk_size];
+            const size_t chunk_size = k_name_chunk_size - (addr % k_name_chunk_size);
+            size_t bytes_read = 0;
+            if (ReadMemory (addr, chunk, chunk_size, bytes_read).Fail () || bytes_read == 0)
+                break;
+            const size_t length = strnlen (chunk, bytes_read);
+            info.name.append (chunk, length);
+            if (length < bytes_read)
+                break;
+            addr += bytes_read;
+        }
+
+        library_list.push_back (info);
+        link_map = next;
+    }
+
+    return Error ();
 }
 
 size_t
@@ -2277,8 +2605,59 @@ NativeProcessLinux::SetBreakpoint (lldb::addr_t addr, uint32_t size, bool hardwa
 {
     if (hardware)
         return Error ("NativeProcessLinux does not support hardware breakpoints");
-    else
-        return SetSoftwareBreakpoint (addr, size);
+
+    Error error = SetSoftwareBreakpoint (addr, size);
+
+    // The debugger put back the breakpoint it stepped a thread off.
+    Mutex::Locker locker (m_threads_mutex);
+    if (addr == m_paused_breakpoint_addr)
+    {
+        m_paused_breakpoint_addr = LLDB_INVALID_ADDRESS;
+        ResumePausedThreads ();
+    }
+    return error;
+}
+
+Error
+NativeProcessLinux::RemoveBreakpoint (lldb::addr_t addr)
+{
+    // In non-stop mode the debugger steps a thread off a breakpoint by removing it, stepping
+    // the thread and setting it again. The other threads have to be kept from running past
+    // it in the meantime.
+    Mutex::Locker locker (m_threads_mutex);
+    if (m_non_stop && m_paused_breakpoint_addr == LLDB_INVALID_ADDRESS)
+    {
+        bool thread_at_breakpoint = false;
+        bool thread_running = false;
+        for (const auto &thread_sp : m_threads)
+        {
+            if (StateIsRunningState (thread_sp->GetState ()) || IsThreadPaused (thread_sp->GetID ()))
+            {
+                thread_running = true;
+                continue;
+            }
+            // Not the breakpoints used for software single stepping.
+            auto stepping_it = m_threads_stepping_with_breakpoint.find (thread_sp->GetID ());
+            if (stepping_it != m_threads_stepping_with_breakpoint.end () && stepping_it->second == addr)
+                continue;
+            NativeRegisterContextSP context_sp = thread_sp->GetRegisterContext ();
+            if (context_sp && context_sp->GetPC () == addr)
+                thread_at_breakpoint = true;
+        }
+
+        if (thread_at_breakpoint && thread_running)
+        {
+            Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+            if (log)
+                log->Printf ("NativeProcessLinux::%s pausing running threads until the breakpoint at 0x%" PRIx64 " is back",
+                        __FUNCTION__, addr);
+            m_paused_breakpoint_addr = addr;
+            PauseRunningThreads (LLDB_INVALID_THREAD_ID);
+            WaitForPausedThreads ();
+        }
+    }
+
+    return NativeProcessProtocol::RemoveBreakpoint (addr);
 }
 
 Error
@@ -2497,32 +2876,86 @@ NativeProcessLinux::GetCrashReasonForSIGBUS(const siginfo_t *info)
 Error
 NativeProcessLinux::ReadMemory (lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read)
 {
-    if (ProcessVmReadvSupported()) {
-        // The process_vm_readv path is about 50 times faster than ptrace api. We want to use
-        // this syscall if it is supported.
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    unsigned char *dst = static_cast<unsigned char*>(buf);
+    const size_t page_size = HostInfo::GetPageSize();
+
+    bytes_read = 0;
+    while (bytes_read < size)
+    {
+        const lldb::addr_t read_addr = addr + bytes_read;
+        const size_t read_size = size - bytes_read;
+        size_t chunk_bytes_read = 0;
+
+        // The process_vm_readv path is about 50 times faster than ptrace api. It stops at the
+        // first page the inferior itself can't read, so we continue from there with the slower
+        // methods instead of starting over.
+        if (ProcessVmReadvSupported())
+        {
+            struct iovec local_iov, remote_iov;
+            local_iov.iov_base = dst + bytes_read;
+            local_iov.iov_len = read_size;
+            remote_iov.iov_base = reinterpret_cast<void *>(read_addr);
+            remote_iov.iov_len = read_size;
+
+            const ssize_t result = process_vm_readv(GetID(), &local_iov, 1, &remote_iov, 1, 0);
+            chunk_bytes_read = result > 0 ? result : 0;
+
+            if (log)
+                log->Printf ("NativeProcessLinux::%s using process_vm_readv to read %zd bytes from inferior address 0x%" PRIx64": %zu bytes read%s%s",
+                        __FUNCTION__, read_size, read_addr, chunk_bytes_read,
+                        result < 0 ? ", " : "", result < 0 ? strerror(errno) : "");
+        }
+
+        if (chunk_bytes_read == 0)
+            chunk_bytes_read = ReadMemoryFromProcMem(read_addr, dst + bytes_read, read_size);
 
-        const ::pid_t pid = GetID();
+        if (chunk_bytes_read == 0)
+        {
+            // Read up to the end of the page with ptrace, so process_vm_readv gets to read the
+            // pages after it.
+            const size_t page_remaining = page_size - (read_addr % page_size);
+            Error error = ReadMemoryWithPtrace(read_addr, dst + bytes_read, std::min(read_size, page_remaining), chunk_bytes_read);
+            bytes_read += chunk_bytes_read;
+            if (error.Fail())
+                return error;
+            continue;
+        }
 
-        struct iovec local_iov, remote_iov;
-        local_iov.iov_base = buf;
-        local_iov.iov_len = size;
-        remote_iov.iov_base = reinterpret_cast<void *>(addr);
-        remote_iov.iov_len = size;
+        bytes_read += chunk_bytes_read;
+    }
 
-        bytes_read = process_vm_readv(pid, &local_iov, 1, &remote_iov, 1, 0);
-        const bool success = bytes_read == size;
+    return Error();
+}
+
+size_t
+NativeProcessLinux::ReadMemoryFromProcMem(lldb::addr_t addr, void *buf, size_t size)
+{
+    if (m_supports_proc_mem == eLazyBoolCalculate)
+    {
+        char mem_path[PATH_MAX];
+        ::snprintf(mem_path, sizeof(mem_path), "/proc/%" PRIu64 "/mem", GetID());
+        Error error = m_proc_mem_file.Open(mem_path, File::eOpenOptionRead | File::eOpenOptionCloseOnExec);
+        m_supports_proc_mem = error.Success() ? eLazyBoolYes : eLazyBoolNo;
 
         Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
         if (log)
-            log->Printf ("NativeProcessLinux::%s using process_vm_readv to read %zd bytes from inferior address 0x%" PRIx64": %s",
-                    __FUNCTION__, size, addr, success ? "Success" : strerror(errno));
-
-        if (success)
-            return Error();
-        // else
-        //     the call failed for some reason, let's retry the read using ptrace api.
+            log->Printf ("NativeProcessLinux::%s opening %s: %s", __FUNCTION__, mem_path, error.Success() ? "Success" : error.AsCString());
     }
 
+    if (m_supports_proc_mem != eLazyBoolYes || addr > static_cast<lldb::addr_t>(std::numeric_limits<off_t>::max()))
+        return 0;
+
+    // pread on /proc/<pid>/mem stops at the first page that isn't mapped.
+    off_t offset = addr;
+    size_t bytes_read = size;
+    Error error = m_proc_mem_file.Read(buf, bytes_read, offset);
+    return error.Success() ? bytes_read : 0;
+}
+
+Error
+NativeProcessLinux::ReadMemoryWithPtrace(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read)
+{
     unsigned char *dst = static_cast<unsigned char*>(buf);
     size_t remainder;
     long data;
@@ -2535,7 +2968,7 @@ NativeProcessLinux::ReadMemory (lldb::addr_t addr, void *buf, size_t size, size_
 
     for (bytes_read = 0; bytes_read < size; bytes_read += remainder)
     {
-        Error error = NativeProcessLinux::PtraceWrapper(PTRACE_PEEKDATA, GetID(), (void*)addr, nullptr, 0, &data);
+        Error error = NativeProcessLinux::PtraceWrapper(PTRACE_PEEKDATA, GetPtraceThreadID(), (void*)addr, nullptr, 0, &data);
         if (error.Fail())
         {
             if (log)
@@ -2579,6 +3012,72 @@ NativeProcessLinux::ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t s
     return m_breakpoint_list.RemoveTrapsFromBuffer(addr, buf, size);
 }
 
+Error
+NativeProcessLinux::ReadMemoryRanges (const std::vector<std::pair<lldb::addr_t, size_t> > &ranges,
+                                      void *buf,
+                                      std::vector<size_t> &bytes_read)
+{
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+
+    uint8_t *dst = static_cast<uint8_t *> (buf);
+    bytes_read.assign (ranges.size(), 0);
+
+    size_t range_idx = 0;
+    size_t dst_offset = 0;
+    while (range_idx < ranges.size())
+    {
+        // Read up to UIO_MAXIOV ranges with each process_vm_readv call. The kernel stops at the
+        // first page it can't read, so all ranges before it are complete.
+        if (ProcessVmReadvSupported())
+        {
+            std::vector<struct iovec> local_iov;
+            std::vector<struct iovec> remote_iov;
+            size_t batch_offset = dst_offset;
+            for (size_t i = range_idx; i < ranges.size() && local_iov.size() < k_max_readv_ranges; ++i)
+            {
+                struct iovec local, remote;
+                local.iov_base = dst + batch_offset;
+                remote.iov_base = reinterpret_cast<void *>(ranges[i].first);
+                local.iov_len = remote.iov_len = ranges[i].second;
+                local_iov.push_back (local);
+                remote_iov.push_back (remote);
+                batch_offset += ranges[i].second;
+            }
+
+            const ssize_t result = process_vm_readv (GetID(), local_iov.data(), local_iov.size(), remote_iov.data(), remote_iov.size(), 0);
+            size_t batch_bytes_read = result > 0 ? result : 0;
+            if (log)
+                log->Printf ("NativeProcessLinux::%s using process_vm_readv to read %zu ranges from the inferior: %zd bytes",
+                             __FUNCTION__, local_iov.size(), result);
+
+            const size_t batch_end = range_idx + local_iov.size();
+            while (range_idx < batch_end && batch_bytes_read >= ranges[range_idx].second)
+            {
+                bytes_read[range_idx] = ranges[range_idx].second;
+                batch_bytes_read -= ranges[range_idx].second;
+                dst_offset += ranges[range_idx].second;
+                ++range_idx;
+            }
+            if (range_idx == batch_end)
+                continue;
+            bytes_read[range_idx] = batch_bytes_read;
+        }
+
+        // Finish the range the kernel stopped in from where it stopped, then give
+        // process_vm_readv the ranges after it again.
+        const lldb::addr_t range_addr = ranges[range_idx].first;
+        const size_t range_size = ranges[range_idx].second;
+        size_t range_bytes_read = 0;
+        ReadMemory (range_addr + bytes_read[range_idx], dst + dst_offset + bytes_read[range_idx],
+                    range_size - bytes_read[range_idx], range_bytes_read);
+        bytes_read[range_idx] += range_bytes_read;
+        dst_offset += range_size;
+        ++range_idx;
+    }
+
+    return Error();
+}
+
 Error
 NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written)
 {
@@ -2610,7 +3109,7 @@ NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf, size_t size,
                 log->Printf ("NativeProcessLinux::%s() [%p]:0x%lx (0x%lx)", __FUNCTION__,
                         (void*)addr, *(const unsigned long*)src, data);
 
-            error = NativeProcessLinux::PtraceWrapper(PTRACE_POKEDATA, GetID(), (void*)addr, (void*)data);
+            error = NativeProcessLinux::PtraceWrapper(PTRACE_POKEDATA, GetPtraceThreadID(), (void*)addr, (void*)data);
             if (error.Fail())
             {
                 if (log)
@@ -2767,6 +3266,9 @@ NativeProcessLinux::StopTrackingThread (lldb::tid_t thread_id)
         }
     }
 
+    EndBreakpointStepOver (thread_id);
+    m_threads_paused.erase (thread_id);
+    StartBreakpointStepOver ();
     SignalIfAllThreadsStopped();
 
     return found;
@@ -3017,13 +3519,42 @@ NativeProcessLinux::StopRunningThreads(const lldb::tid_t triggering_tid)
                 __FUNCTION__, triggering_tid);
     }
 
+    if (m_non_stop)
+    {
+        // The other threads keep running. A step over waiting for this thread to pause
+        // doesn't have to wait any longer.
+        SignalThreadStopped(triggering_tid);
+        StartBreakpointStepOver();
+        return;
+    }
+
     m_pending_notification_tid = triggering_tid;
 
+    // Step overs that didn't start yet are given up, their threads are left at the breakpoint
+    // without a stop reason and hit it again once resumed.
+    for (auto it = m_threads_stepping_over_breakpoint.begin(); it != m_threads_stepping_over_breakpoint.end();)
+    {
+        if (it->second.started)
+            ++it;
+        else
+            it = m_threads_stepping_over_breakpoint.erase(it);
+    }
+
+    // Paused threads that stopped already stay stopped.
+    for (auto it = m_threads_paused.begin(); it != m_threads_paused.end();)
+    {
+        if (it->second.stopped)
+            it = m_threads_paused.erase(it);
+        else
+            ++it;
+    }
+
     // Request a stop for all the thread stops that need to be stopped
-    // and are not already known to be stopped.
+    // and are not already known to be stopped. Paused threads have a
+    // SIGSTOP on the way already.
     for (const auto &thread_sp: m_threads)
     {
-        if (StateIsRunningState(thread_sp->GetState()))
+        if (StateIsRunningState(thread_sp->GetState()) && m_threads_paused.count(thread_sp->GetID()) == 0)
             static_pointer_cast<NativeThreadLinux>(thread_sp)->RequestStop();
     }
 
@@ -3067,6 +3598,300 @@ NativeProcessLinux::SignalIfAllThreadsStopped()
     m_pending_notification_tid = LLDB_INVALID_THREAD_ID;
 }
 
+void
+NativeProcessLinux::SignalThreadStopped(lldb::tid_t tid)
+{
+    Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+
+    // Clear the temporary breakpoint used to implement software single stepping of this thread.
+    auto stepping_it = m_threads_stepping_with_breakpoint.find(tid);
+    if (stepping_it != m_threads_stepping_with_breakpoint.end())
+    {
+        Error error = RemoveBreakpoint (stepping_it->second);
+        if (error.Fail() && log)
+            log->Printf("NativeProcessLinux::%s() tid = %" PRIu64 " remove stepping breakpoint: %s",
+                    __FUNCTION__, tid, error.AsCString());
+        m_threads_stepping_with_breakpoint.erase(stepping_it);
+    }
+
+    SetCurrentThreadID(tid);
+    NotifyThreadStopped(tid);
+
+    for (const auto &thread_sp: m_threads)
+    {
+        if (StateIsRunningState(thread_sp->GetState()))
+            return; // Some threads are still running.
+    }
+    SetState(StateType::eStateStopped, true);
+}
+
+lldb::tid_t
+NativeProcessLinux::GetPtraceThreadID()
+{
+    Mutex::Locker locker (m_threads_mutex);
+    lldb::tid_t stopped_tid = LLDB_INVALID_THREAD_ID;
+    for (const auto &thread_sp: m_threads)
+    {
+        if (!StateIsStoppedState(thread_sp->GetState(), false))
+            continue;
+        if (thread_sp->GetID() == GetID())
+            return GetID();
+        if (stopped_tid == LLDB_INVALID_THREAD_ID)
+            stopped_tid = thread_sp->GetID();
+    }
+    return stopped_tid != LLDB_INVALID_THREAD_ID ? stopped_tid : GetID();
+}
+
+bool
+NativeProcessLinux::SupportsBreakpointCommands() const
+{
+    // Running commands relies on stepping the thread off the breakpoint.
+    return SupportHardwareSingleStepping();
+}
+
+bool
+NativeProcessLinux::StepOverUnreportedBreakpoint(NativeThreadLinux &thread, bool was_stepping)
+{
+    // The breakpoint has to be removed while the thread steps off it, which needs hardware
+    // single stepping.
+    if (!SupportHardwareSingleStepping())
+        return false;
+
+    NativeRegisterContextSP context_sp = thread.GetRegisterContext();
+    if (!context_sp)
+        return false;
+    const lldb::addr_t pc = context_sp->GetPC();
+
+    NativeBreakpointSP breakpoint_sp;
+    if (m_breakpoint_list.GetBreakpoint(pc, breakpoint_sp).Fail() || !breakpoint_sp ||
+        !breakpoint_sp->IsSoftwareBreakpoint())
+        return false;
+
+    Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+    if (breakpoint_sp->HasCommands())
+    {
+        // Hits of breakpoints with commands are never reported. If the process is about to
+        // stop anyway, leave the thread at the breakpoint without a stop reason, it hits the
+        // breakpoint again once resumed.
+        if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
+        {
+            thread.SetStoppedWithNoReason();
+            SignalIfAllThreadsStopped();
+            return true;
+        }
+
+        if (breakpoint_sp->ConditionsSayStop(*this, thread))
+            RunBreakpointCommands(*breakpoint_sp, thread);
+    }
+    else if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID || breakpoint_sp->ConditionsSayStop(*this, thread))
+        return false;
+
+    if (log)
+        log->Printf("NativeProcessLinux::%s() tid %" PRIu64 " not reporting breakpoint at 0x%" PRIx64 ", stepping over it",
+                __FUNCTION__, thread.GetID(), pc);
+
+    // While the breakpoint is disabled, the other threads must not run past it, so they are
+    // paused first. The thread is not reported while it waits.
+    thread.SetStoppedWithNoReason();
+    m_threads_stepping_over_breakpoint[thread.GetID()] = BreakpointStepOver{pc, was_stepping, false};
+    PauseRunningThreads(thread.GetID());
+    StartBreakpointStepOver();
+    return true;
+}
+
+void
+NativeProcessLinux::StartBreakpointStepOver()
+{
+    if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
+        return;
+
+    for (const auto &step_over: m_threads_stepping_over_breakpoint)
+    {
+        if (step_over.second.started)
+            return;
+    }
+
+    for (const auto &paused: m_threads_paused)
+    {
+        NativeThreadLinuxSP thread_sp = GetThreadByID(paused.first);
+        if (thread_sp && StateIsRunningState(thread_sp->GetState()))
+            return;
+    }
+
+    auto it = m_threads_stepping_over_breakpoint.begin();
+    if (it == m_threads_stepping_over_breakpoint.end())
+        return;
+
+    const lldb::tid_t tid = it->first;
+    NativeThreadLinuxSP thread_sp = GetThreadByID(tid);
+    if (!thread_sp)
+    {
+        EndBreakpointStepOver(tid);
+        return;
+    }
+
+    // Nothing to step over if the breakpoint was removed in the meantime.
+    NativeBreakpointSP breakpoint_sp;
+    if (m_breakpoint_list.GetBreakpoint(it->second.addr, breakpoint_sp).Fail() || !breakpoint_sp)
+    {
+        const lldb::StateType state = it->second.report_step ? eStateStepping : eStateRunning;
+        EndBreakpointStepOver(tid);
+        ResumeThread(*thread_sp, state, LLDB_INVALID_SIGNAL_NUMBER);
+        return;
+    }
+
+    Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+    Error error = m_breakpoint_list.DisableBreakpoint(it->second.addr);
+    if (error.Success())
+    {
+        it->second.started = true;
+        error = ResumeThread(*thread_sp, eStateStepping, LLDB_INVALID_SIGNAL_NUMBER);
+    }
+
+    if (error.Fail())
+    {
+        // Report the hit instead.
+        if (log)
+            log->Printf("NativeProcessLinux::%s() tid %" PRIu64 " failed to step over breakpoint: %s",
+                    __FUNCTION__, tid, error.AsCString());
+        thread_sp->SetStoppedByBreakpoint();
+        EndBreakpointStepOver(tid);
+        StopRunningThreads(tid);
+    }
+}
+
+bool
+NativeProcessLinux::EndBreakpointStepOver(lldb::tid_t tid)
+{
+    auto it = m_threads_stepping_over_breakpoint.find(tid);
+    if (it == m_threads_stepping_over_breakpoint.end())
+        return false;
+
+    // The breakpoint may have been removed in the meantime.
+    if (it->second.started)
+    {
+        Error error = m_breakpoint_list.EnableBreakpoint(it->second.addr);
+        Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+        if (error.Fail() && log)
+            log->Printf("NativeProcessLinux::%s() tid %" PRIu64 " failed to re-enable breakpoint at 0x%" PRIx64 ": %s",
+                    __FUNCTION__, tid, it->second.addr, error.AsCString());
+    }
+
+    m_threads_stepping_over_breakpoint.erase(it);
+
+    if (m_threads_stepping_over_breakpoint.empty())
+        ResumePausedThreads();
+    else
+        StartBreakpointStepOver();
+    return true;
+}
+
+void
+NativeProcessLinux::PauseRunningThreads(lldb::tid_t tid)
+{
+    for (const auto &thread_sp: m_threads)
+    {
+        if (thread_sp->GetID() == tid || !StateIsRunningState(thread_sp->GetState()))
+            continue;
+        // A thread still waiting for the SIGSTOP of an earlier pause gets no second one.
+        if (m_threads_paused.insert({thread_sp->GetID(), PausedThread{false, eStateRunning}}).second)
+            static_pointer_cast<NativeThreadLinux>(thread_sp)->RequestStop();
+    }
+}
+
+void
+NativeProcessLinux::WaitForPausedThreads()
+{
+    Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
+    while (true)
+    {
+        lldb::tid_t running_tid = LLDB_INVALID_THREAD_ID;
+        for (const auto &paused: m_threads_paused)
+        {
+            NativeThreadLinuxSP thread_sp = GetThreadByID(paused.first);
+            if (thread_sp && StateIsRunningState(thread_sp->GetState()))
+            {
+                running_tid = paused.first;
+                break;
+            }
+        }
+        if (running_tid == LLDB_INVALID_THREAD_ID)
+            return;
+
+        int status = -1;
+        ::pid_t wait_pid = waitpid(running_tid, &status, __WALL);
+        if (wait_pid == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            Error error(errno, eErrorTypePOSIX);
+            if (log)
+                log->Printf("NativeProcessLinux::%s waitpid (%" PRIu64 ", &status, __WALL) failed: %s",
+                        __FUNCTION__, running_tid, error.AsCString());
+            return;
+        }
+        MonitorWaitStatus(wait_pid, status);
+    }
+}
+
+bool
+NativeProcessLinux::IsPausingThreads() const
+{
+    return m_paused_breakpoint_addr != LLDB_INVALID_ADDRESS || !m_threads_stepping_over_breakpoint.empty();
+}
+
+bool
+NativeProcessLinux::IsThreadPaused(lldb::tid_t tid) const
+{
+    if (m_threads_paused.count(tid) != 0)
+        return true;
+    auto step_over_it = m_threads_stepping_over_breakpoint.find(tid);
+    return step_over_it != m_threads_stepping_over_breakpoint.end() && !step_over_it->second.started;
+}
+
+void
+NativeProcessLinux::StopPausedThread(lldb::tid_t tid)
+{
+    // A thread waiting to step off a breakpoint is left at it, it hits it again once resumed.
+    auto step_over_it = m_threads_stepping_over_breakpoint.find(tid);
+    if (step_over_it != m_threads_stepping_over_breakpoint.end() && !step_over_it->second.started)
+        EndBreakpointStepOver(tid);
+    m_threads_paused.erase(tid);
+    SignalThreadStopped(tid);
+}
+
+void
+NativeProcessLinux::ResumePausedThreads()
+{
+    if (IsPausingThreads())
+        return;
+
+    // The threads that stopped stay stopped if the process is stopping.
+    const bool stopping = m_pending_notification_tid != LLDB_INVALID_THREAD_ID;
+
+    Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_THREAD));
+    for (auto it = m_threads_paused.begin(); it != m_threads_paused.end();)
+    {
+        // Threads whose SIGSTOP didn't arrive yet are resumed when it does.
+        NativeThreadLinuxSP thread_sp = GetThreadByID(it->first);
+        if (thread_sp && !it->second.stopped)
+        {
+            ++it;
+            continue;
+        }
+
+        if (thread_sp && !stopping && thread_sp->GetState() == eStateStopped)
+        {
+            Error error = ResumeThread(*thread_sp, it->second.resume_state, LLDB_INVALID_SIGNAL_NUMBER);
+            if (error.Fail() && log)
+                log->Printf("NativeProcessLinux::%s failed to resume paused thread tid %" PRIu64 ": %s",
+                        __FUNCTION__, it->first, error.AsCString());
+        }
+        it = m_threads_paused.erase(it);
+    }
+}
+
 void
 NativeProcessLinux::ThreadWasCreated(NativeThreadLinux &thread)
 {
@@ -3081,6 +3906,12 @@ NativeProcessLinux::ThreadWasCreated(NativeThreadLinux &thread)
         // notification.
         thread.RequestStop();
     }
+    else if (IsPausingThreads() && StateIsRunningState(thread.GetState()))
+    {
+        // Threads created during a pause are paused as well.
+        m_threads_paused[thread.GetID()] = PausedThread{false, eStateRunning};
+        thread.RequestStop();
+    }
 }
 
 void
@@ -3108,40 +3939,47 @@ NativeProcessLinux::SigchldHandler()
             break;
         }
 
-        bool exited = false;
-        int signal = 0;
-        int exit_status = 0;
-        const char *status_cstr = nullptr;
-        if (WIFSTOPPED(status))
-        {
-            signal = WSTOPSIG(status);
-            status_cstr = "STOPPED";
-        }
-        else if (WIFEXITED(status))
-        {
-            exit_status = WEXITSTATUS(status);
-            status_cstr = "EXITED";
+        MonitorWaitStatus(wait_pid, status);
+    }
+}
+
+void
+NativeProcessLinux::MonitorWaitStatus(::pid_t wait_pid, int status)
+{
+    Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    bool exited = false;
+    int signal = 0;
+    int exit_status = 0;
+    const char *status_cstr = nullptr;
+    if (WIFSTOPPED(status))
+    {
+        signal = WSTOPSIG(status);
+        status_cstr = "STOPPED";
+    }
+    else if (WIFEXITED(status))
+    {
+        exit_status = WEXITSTATUS(status);
+        status_cstr = "EXITED";
+        exited = true;
+    }
+    else if (WIFSIGNALED(status))
+    {
+        signal = WTERMSIG(status);
+        status_cstr = "SIGNALED";
+        if (wait_pid == static_cast< ::pid_t>(GetID())) {
             exited = true;
+            exit_status = -1;
         }
-        else if (WIFSIGNALED(status))
-        {
-            signal = WTERMSIG(status);
-            status_cstr = "SIGNALED";
-            if (wait_pid == static_cast< ::pid_t>(GetID())) {
-                exited = true;
-                exit_status = -1;
-            }
-        }
-        else
-            status_cstr = "(\?\?\?)";
+    }
+    else
+        status_cstr = "(\?\?\?)";
 
-        if (log)
-            log->Printf("NativeProcessLinux::%s: waitpid (-1, &status, __WALL | __WNOTHREAD | WNOHANG)"
-                "=> pid = %" PRIi32 ", status = 0x%8.8x (%s), signal = %i, exit_state = %i",
-                __FUNCTION__, wait_pid, status, status_cstr, signal, exit_status);
+    if (log)
+        log->Printf("NativeProcessLinux::%s: waitpid => pid = %" PRIi32 ", status = 0x%8.8x (%s), signal = %i, exit_state = %i",
+            __FUNCTION__, wait_pid, status, status_cstr, signal, exit_status);
 
-        MonitorCallback (wait_pid, exited, signal, exit_status);
-    }
+    MonitorCallback (wait_pid, exited, signal, exit_status);
 }
 
 // Wrapper for ptrace to catch errors and log calls.
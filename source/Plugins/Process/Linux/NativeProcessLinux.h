@@ -17,6 +17,7 @@
 #include "lldb/Core/ArchSpec.h"
 #include "lldb/lldb-types.h"
 #include "lldb/Host/Debug.h"
+#include "lldb/Host/File.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Host/HostThread.h"
 #include "lldb/Host/Mutex.h"
@@ -74,6 +75,9 @@ namespace process_linux {
         Error
         Kill () override;
 
+        Error
+        SetNonStopMode (bool enable) override;
+
         Error
         GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInfo &range_info) override;
 
@@ -83,6 +87,11 @@ namespace process_linux {
         Error
         ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read) override;
 
+        Error
+        ReadMemoryRanges (const std::vector<std::pair<lldb::addr_t, size_t> > &ranges,
+                          void *buf,
+                          std::vector<size_t> &bytes_read) override;
+
         Error
         WriteMemory(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written) override;
 
@@ -95,6 +104,12 @@ namespace process_linux {
         lldb::addr_t
         GetSharedLibraryInfoAddress () override;
 
+        Error
+        GetLoadedSVR4Libraries (lldb::addr_t start_link_map,
+                                lldb::addr_t prev_link_map,
+                                lldb::addr_t &main_link_map,
+                                std::vector<SVR4LibraryInfo> &library_list) override;
+
         size_t
         UpdateThreads () override;
 
@@ -104,6 +119,12 @@ namespace process_linux {
         Error
         SetBreakpoint (lldb::addr_t addr, uint32_t size, bool hardware) override;
 
+        Error
+        RemoveBreakpoint (lldb::addr_t addr) override;
+
+        bool
+        SupportsBreakpointCommands () const override;
+
         void
         DoStopIDBumped (uint32_t newBumpId) override;
 
@@ -145,10 +166,43 @@ namespace process_linux {
 
         lldb::tid_t m_pending_notification_tid;
 
+        // /proc/<pid>/mem, opened on first use. It can read pages that
+        // process_vm_readv can't (e.g. ones without read permission), and
+        // much faster than ptrace.
+        LazyBool m_supports_proc_mem;
+        File m_proc_mem_file;
+
         // List of thread ids stepping with a breakpoint with the address of
         // the relevan breakpoint
         std::map<lldb::tid_t, lldb::addr_t> m_threads_stepping_with_breakpoint;
 
+        // Threads single stepping off a breakpoint whose hit is not reported, with the
+        // address of the breakpoint to re-enable once the step is done. If the thread hit
+        // the breakpoint while single stepping, the step is reported when it is done.
+        // The breakpoint is only disabled and the step started once all other threads
+        // are paused, one thread at a time.
+        struct BreakpointStepOver
+        {
+            lldb::addr_t addr;
+            bool report_step;
+            bool started;
+        };
+        std::map<lldb::tid_t, BreakpointStepOver> m_threads_stepping_over_breakpoint;
+
+        // Threads stopped so that another thread can step off a breakpoint without them
+        // running past it in the meantime. Once a thread's SIGSTOP arrived, the state it
+        // had is kept to resume it in.
+        struct PausedThread
+        {
+            bool stopped;
+            lldb::StateType resume_state;
+        };
+        std::map<lldb::tid_t, PausedThread> m_threads_paused;
+
+        // In non-stop mode, the address of the breakpoint the debugger removed to step a
+        // thread off it. The running threads are paused until it is put back.
+        lldb::addr_t m_paused_breakpoint_addr;
+
         /// @class LauchArgs
         ///
         /// @brief Simple structure to pass data to the thread responsible for
@@ -301,26 +355,98 @@ namespace process_linux {
         Error
         Detach(lldb::tid_t tid);
 
+        /// Reads memory through /proc/<pid>/mem.
+        ///
+        /// @return
+        ///     The number of bytes read from the start of the range, which
+        ///     is zero if /proc/<pid>/mem isn't available.
+        size_t
+        ReadMemoryFromProcMem(lldb::addr_t addr, void *buf, size_t size);
+
+        /// Reads memory one word at a time with PTRACE_PEEKDATA.
+        Error
+        ReadMemoryWithPtrace(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read);
 
         // This method is requests a stop on all threads which are still running. It sets up a
         // deferred delegate notification, which will fire once threads report as stopped. The
         // triggerring_tid will be set as the current thread (main stop reason).
+        // In non-stop mode only the triggering thread is stopped and it is reported right away.
         void
         StopRunningThreads(lldb::tid_t triggering_tid);
 
         // Notify the delegate if all threads have stopped.
         void SignalIfAllThreadsStopped();
 
+        // Non-stop mode: notify the delegate that the given thread stopped, and mark the
+        // process as stopped if it was the last running thread.
+        void
+        SignalThreadStopped(lldb::tid_t tid);
+
+        // The thread to use for ptrace requests that aren't specific to a thread. This is the
+        // main thread if it is stopped, or any stopped thread otherwise, as ptrace fails on
+        // running ones.
+        lldb::tid_t
+        GetPtraceThreadID();
+
+        // If the hit of the breakpoint the thread stopped at is not to be reported, because its
+        // conditions are all false or it has commands, run its commands, pause the other
+        // threads and single step the thread off the disabled breakpoint. Returns true if the
+        // hit was handled this way.
+        bool
+        StepOverUnreportedBreakpoint(NativeThreadLinux &thread, bool was_stepping);
+
+        // Disable the breakpoint of the next waiting step over and single step its thread,
+        // once no step over is in progress and the paused threads have all stopped.
+        void
+        StartBreakpointStepOver();
+
+        // Re-enable the breakpoint the thread was stepping over and go on with the next step
+        // over, or resume the paused threads. Returns false if the thread was not stepping
+        // over a breakpoint.
+        bool
+        EndBreakpointStepOver(lldb::tid_t tid);
+
         // Resume the given thread, optionally passing it the given signal. The type of resume
         // operation (continue, single-step) depends on the state parameter.
         Error
         ResumeThread(NativeThreadLinux &thread, lldb::StateType state, int signo);
 
+        // Stop all the running threads but the given one, to be resumed by
+        // ResumePausedThreads.
+        void
+        PauseRunningThreads(lldb::tid_t tid);
+
+        // Wait for the SIGSTOPs of the paused threads, handling whatever else they report
+        // first. Not for use from within the SIGCHLD handler.
+        void
+        WaitForPausedThreads();
+
+        // Returns true while some thread needs the others to stay paused.
+        bool
+        IsPausingThreads() const;
+
+        // Returns true if the thread is stopped although the debugger was not told, because it
+        // is paused or waits to step off a breakpoint.
+        bool
+        IsThreadPaused(lldb::tid_t tid) const;
+
+        // Non-stop mode: take a paused thread out of the pause and report it as stopped.
+        void
+        StopPausedThread(lldb::tid_t tid);
+
+        // Resume the paused threads once no thread needs them paused anymore.
+        void
+        ResumePausedThreads();
+
         void
         ThreadWasCreated(NativeThreadLinux &thread);
 
         void
         SigchldHandler();
+
+        // Hand a status returned by waitpid to MonitorCallback.
+        void
+        MonitorWaitStatus(::pid_t wait_pid, int status);
     };
 
 } // namespace process_linux
@@ -9,7 +9,9 @@
 
 #include "NativeRegisterContextLinux.h"
 
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/RegisterValue.h"
+#include "lldb/Host/Endian.h"
 #include "lldb/Host/common/NativeProcessProtocol.h"
 #include "lldb/Host/common/NativeThreadProtocol.h"
 #include "lldb/Host/linux/Ptrace.h"
@@ -22,9 +24,18 @@ using namespace lldb_private::process_linux;
 NativeRegisterContextLinux::NativeRegisterContextLinux(NativeThreadProtocol &native_thread,
                                                        uint32_t concrete_frame_idx,
                                                        RegisterInfoInterface *reg_info_interface_p) :
-    NativeRegisterContextRegisterInfo(native_thread, concrete_frame_idx, reg_info_interface_p)
+    NativeRegisterContextRegisterInfo(native_thread, concrete_frame_idx, reg_info_interface_p),
+    m_gpr_valid(false),
+    m_fpr_valid(false)
 {}
 
+void
+NativeRegisterContextLinux::InvalidateAllRegisters()
+{
+    m_gpr_valid = false;
+    m_fpr_valid = false;
+}
+
 lldb::ByteOrder
 NativeRegisterContextLinux::GetByteOrder() const
 {
@@ -106,18 +117,26 @@ NativeRegisterContextLinux::WriteRegisterRaw(uint32_t reg_index, const RegisterV
     if (!register_to_write_info_p)
         return Error("NativeRegisterContextLinux::%s failed to get RegisterInfo for write register index %" PRIu32, __FUNCTION__, reg_to_write);
 
+    // The single register write bypasses the register set buffers.
+    InvalidateAllRegisters();
+
     return DoWriteRegisterValue(reg_info->byte_offset, reg_info->name, reg_value);
 }
 
 Error
 NativeRegisterContextLinux::ReadGPR()
 {
+    if (m_gpr_valid)
+        return Error();
+
     void* buf = GetGPRBuffer();
     if (!buf)
         return Error("GPR buffer is NULL");
     size_t buf_size = GetGPRSize();
 
-    return DoReadGPR(buf, buf_size);
+    Error error = DoReadGPR(buf, buf_size);
+    m_gpr_valid = error.Success();
+    return error;
 }
 
 Error
@@ -128,18 +147,26 @@ NativeRegisterContextLinux::WriteGPR()
         return Error("GPR buffer is NULL");
     size_t buf_size = GetGPRSize();
 
-    return DoWriteGPR(buf, buf_size);
+    // After a successful write the buffer holds the thread's registers.
+    Error error = DoWriteGPR(buf, buf_size);
+    m_gpr_valid = error.Success();
+    return error;
 }
 
 Error
 NativeRegisterContextLinux::ReadFPR()
 {
+    if (m_fpr_valid)
+        return Error();
+
     void* buf = GetFPRBuffer();
     if (!buf)
         return Error("FPR buffer is NULL");
     size_t buf_size = GetFPRSize();
 
-    return DoReadFPR(buf, buf_size);
+    Error error = DoReadFPR(buf, buf_size);
+    m_fpr_valid = error.Success();
+    return error;
 }
 
 Error
@@ -150,7 +177,9 @@ NativeRegisterContextLinux::WriteFPR()
         return Error("FPR buffer is NULL");
     size_t buf_size = GetFPRSize();
 
-    return DoWriteFPR(buf, buf_size);
+    Error error = DoWriteFPR(buf, buf_size);
+    m_fpr_valid = error.Success();
+    return error;
 }
 
 Error
@@ -175,6 +204,24 @@ NativeRegisterContextLinux::DoReadRegisterValue(uint32_t offset,
 {
     Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_REGISTERS));
 
+    // Serve registers of the general purpose register set from the GPR buffer, which takes a
+    // single ptrace call per stop instead of one PTRACE_PEEKUSER per register.
+    const uint8_t *gpr = static_cast<const uint8_t *>(GetGPRBuffer());
+    if (gpr && (size == 1 || size == 2 || size == 4 || size == 8) && offset + size <= GetGPRSize())
+    {
+        Error error = ReadGPR();
+        if (error.Success())
+        {
+            DataExtractor gpr_data(gpr, GetGPRSize(), endian::InlHostByteOrder(), sizeof(void *));
+            lldb::offset_t data_offset = offset;
+            value.SetUInt64(gpr_data.GetMaxU64(&data_offset, size));
+
+            if (log)
+                log->Printf ("NativeRegisterContextLinux::%s() reg %s: 0x%" PRIx64 " (from GPR buffer)", __FUNCTION__, reg_name, value.GetAsUInt64());
+            return error;
+        }
+    }
+
     long data;
     Error error = NativeProcessLinux::PtraceWrapper(
             PTRACE_PEEKUSER, m_thread.GetID(), reinterpret_cast<void *>(offset), nullptr, 0, &data);
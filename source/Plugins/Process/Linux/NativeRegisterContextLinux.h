@@ -34,6 +34,11 @@ public:
                                          NativeThreadProtocol &native_thread,
                                          uint32_t concrete_frame_idx);
 
+    // Discards the GPR and FPR snapshots, so the next register access reads the register sets
+    // from the thread again. This needs to be called whenever the thread is resumed.
+    void
+    InvalidateAllRegisters();
+
 protected:
     lldb::ByteOrder
     GetByteOrder() const;
@@ -99,6 +104,13 @@ protected:
 
     virtual Error
     DoWriteFPR(void *buf, size_t buf_size);
+
+private:
+    // Whether the GPR and FPR buffers hold the current register values of the stopped thread.
+    // They are filled with a single ptrace call each on first use after a stop and then serve
+    // all register reads until the thread is resumed.
+    bool m_gpr_valid;
+    bool m_fpr_valid;
 };
 
 } // namespace process_linux
@@ -918,19 +918,13 @@ NativeRegisterContextLinux_arm64::DoReadRegisterValue(uint32_t offset,
     }
     else
     {
-        elf_gregset_t regs;
-        int regset = NT_PRSTATUS;
-        struct iovec ioVec;
-
-        ioVec.iov_base = &regs;
-        ioVec.iov_len = sizeof regs;
-        error = NativeProcessLinux::PtraceWrapper(
-                PTRACE_GETREGSET, m_thread.GetID(), &regset, &ioVec, sizeof regs);
+        // Served from the GPR buffer, which is read once per stop.
+        error = ReadGPR();
         if (error.Success())
         {
             ArchSpec arch;
             if (m_thread.GetProcess()->GetArchitecture(arch))
-                value.SetBytes((void *)(((unsigned char *)(regs)) + offset), 8, arch.GetByteOrder());
+                value.SetBytes((void *)(((unsigned char *)(m_gpr_arm64)) + offset), 8, arch.GetByteOrder());
             else
                 error.SetErrorString("failed to get architecture");
         }
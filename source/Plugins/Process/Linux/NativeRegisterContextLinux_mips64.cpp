@@ -1378,17 +1378,17 @@ NativeRegisterContextLinux_mips64::DoReadRegisterValue(uint32_t offset,
                                                        uint32_t size,
                                                        RegisterValue &value)
 {
-    GPR_linux_mips regs;
-    ::memset(&regs, 0, sizeof(GPR_linux_mips));
-
     // Clear all bits in RegisterValue before writing actual value read from ptrace to avoid garbage value in 32-bit MSB 
-    value.SetBytes((void *)(((unsigned char *)&regs) + offset), 8, GetByteOrder());
-    Error error = NativeProcessLinux::PtraceWrapper(PTRACE_GETREGS, m_thread.GetID(), NULL, &regs, sizeof regs);
+    const uint64_t zero = 0;
+    value.SetBytes(&zero, 8, GetByteOrder());
+
+    // Served from the GPR buffer, which is read once per stop.
+    Error error = ReadGPR();
     if (error.Success())
     {
         lldb_private::ArchSpec arch;
         if (m_thread.GetProcess()->GetArchitecture(arch))
-            value.SetBytes((void *)(((unsigned char *)&regs) + offset + 4 * (arch.GetMachine() == llvm::Triple::mips)), arch.GetAddressByteSize(), arch.GetByteOrder());
+            value.SetBytes((void *)(((unsigned char *)&m_gpr) + offset + 4 * (arch.GetMachine() == llvm::Triple::mips)), arch.GetAddressByteSize(), arch.GetByteOrder());
         else
             error.SetErrorString("failed to get architecture");
     }
@@ -748,7 +748,10 @@ NativeRegisterContextLinux_x86_64::ReadAllRegisterValues (lldb::DataBufferSP &da
         reg_info = GetRegisterInfoInterface().GetDynamicRegisterInfo("orig_rax");
 
     if (reg_info != nullptr)
+    {
+        InvalidateAllRegisters();
         return DoWriteRegisterValue(reg_info->byte_offset,reg_info->name,value);
+    }
 
     return error;
 }
@@ -800,9 +803,9 @@ NativeRegisterContextLinux_x86_64::WriteAllRegisterValues (const lldb::DataBuffe
         // Parse the YMM register content from the register halves.
         for (uint32_t reg = m_reg_info.first_ymm; reg <= m_reg_info.last_ymm; ++reg)
         {
-            if (!CopyYMMtoXSTATE (reg, byte_order))
+            if (!CopyXSTATEtoYMM (reg, byte_order))
             {
-                error.SetErrorStringWithFormat ("NativeRegisterContextLinux_x86_64::%s CopyYMMtoXSTATE() failed for reg num %" PRIu32, __FUNCTION__, reg);
+                error.SetErrorStringWithFormat ("NativeRegisterContextLinux_x86_64::%s CopyXSTATEtoYMM() failed for reg num %" PRIu32, __FUNCTION__, reg);
                 return error;
             }
         }
@@ -875,7 +878,7 @@ NativeRegisterContextLinux_x86_64::IsFPR(uint32_t reg_index, FPRType fpr_type) c
 }
 
 Error
-NativeRegisterContextLinux_x86_64::WriteFPR()
+NativeRegisterContextLinux_x86_64::DoWriteFPR(void *buf, size_t buf_size)
 {
     const FPRType fpr_type = GetFPRType ();
     const lldb_private::ArchSpec& target_arch = GetRegisterInfoInterface().GetTargetArchitecture();
@@ -891,7 +894,7 @@ NativeRegisterContextLinux_x86_64::WriteFPR()
             case llvm::Triple::x86:
                 return WriteRegisterSet(&m_iovec, sizeof(m_fpr.xstate.xsave), NT_PRXFPREG);
             case llvm::Triple::x86_64:
-                return NativeRegisterContextLinux::WriteFPR();
+                return NativeRegisterContextLinux::DoWriteFPR(buf, buf_size);
             default:
                 assert(false && "Unhandled target architecture.");
                 break;
@@ -1001,7 +1004,7 @@ NativeRegisterContextLinux_x86_64::GetFPRSize()
 }
 
 Error
-NativeRegisterContextLinux_x86_64::ReadFPR ()
+NativeRegisterContextLinux_x86_64::DoReadFPR (void *buf, size_t buf_size)
 {
     const FPRType fpr_type = GetFPRType ();
     const lldb_private::ArchSpec& target_arch = GetRegisterInfoInterface().GetTargetArchitecture();
@@ -1017,7 +1020,7 @@ NativeRegisterContextLinux_x86_64::ReadFPR ()
             case llvm::Triple::x86:
                 return ReadRegisterSet(&m_iovec, sizeof(m_fpr.xstate.xsave), NT_PRXFPREG);
             case llvm::Triple::x86_64:
-                return NativeRegisterContextLinux::ReadFPR();
+                return NativeRegisterContextLinux::DoReadFPR(buf, buf_size);
             default:
                 assert(false && "Unhandled target architecture.");
                 break;
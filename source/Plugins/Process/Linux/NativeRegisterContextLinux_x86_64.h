@@ -89,10 +89,10 @@ namespace process_linux {
         GetFPRSize() override;
 
         Error
-        ReadFPR() override;
+        DoReadFPR(void *buf, size_t buf_size) override;
 
         Error
-        WriteFPR() override;
+        DoWriteFPR(void *buf, size_t buf_size) override;
 
     private:
 
@@ -209,6 +209,8 @@ NativeThreadLinux::SetRunning ()
     m_stop_info.reason = StopReason::eStopReasonNone;
     m_stop_description.clear();
 
+    InvalidateRegisters ();
+
     // If watchpoints have been set, but none on this thread,
     // then this is a new thread. So set all existing watchpoints.
     if (m_watchpoint_index_map.empty())
@@ -236,6 +238,16 @@ NativeThreadLinux::SetStepping ()
     m_state = new_state;
 
     m_stop_info.reason = StopReason::eStopReasonNone;
+
+    InvalidateRegisters ();
+}
+
+void
+NativeThreadLinux::InvalidateRegisters ()
+{
+    // The register values read while the thread was stopped are stale once it runs again.
+    if (m_reg_context_sp)
+        std::static_pointer_cast<NativeRegisterContextLinux> (m_reg_context_sp)->InvalidateAllRegisters ();
 }
 
 void
@@ -102,6 +102,9 @@ namespace process_linux {
         void
         MaybeLogStateChange (lldb::StateType new_state);
 
+        void
+        InvalidateRegisters ();
+
         // ---------------------------------------------------------------------
         // Member Variables
         // ---------------------------------------------------------------------
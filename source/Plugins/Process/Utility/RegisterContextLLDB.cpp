@@ -447,84 +447,104 @@ RegisterContextLLDB::InitializeNonZerothFrame()
         return;
     }
 
-    bool resolve_tail_call_address = true; // m_current_pc can be one past the address range of the function...
-                                           // This will handle the case where the saved pc does not point to 
-                                           // a function/symbol because it is beyond the bounds of the correct
-                                           // function and there's no symbol there.  ResolveSymbolContextForAddress
-                                           // will fail to find a symbol, back up the pc by 1 and re-search.
-    const uint32_t resolve_scope = eSymbolContextFunction | eSymbolContextSymbol;
-    uint32_t resolved_scope = pc_module_sp->ResolveSymbolContextForAddress (m_current_pc,
-                                                                            resolve_scope,
-                                                                            m_sym_ctx, resolve_tail_call_address);
-
-    // We require either a symbol or function in the symbols context to be successfully
-    // filled in or this context is of no use to us.
-    if (resolve_scope & resolved_scope)
-    {
-        m_sym_ctx_valid = true;
-    }
-
-    if (m_sym_ctx.symbol)
-    {
-        UnwindLogMsg ("with pc value of 0x%" PRIx64 ", symbol name is '%s'",
-                      pc, GetSymbolOrFunctionName(m_sym_ctx).AsCString(""));
-    }
-    else if (m_sym_ctx.function)
-    {
-        UnwindLogMsg ("with pc value of 0x%" PRIx64 ", function name is '%s'",
+    // The symbol lookups below only depend on the pc and the kind of the next frame, reuse them across stops.
+    const bool above_async_frame = GetNextFrame()->m_frame_type == eTrapHandlerFrame
+                                   || GetNextFrame()->m_frame_type == eDebuggerFrame;
+    AddressRange addr_range;
+    bool decr_pc_and_recompute_addr_range = false;
+    UnwindSymbolCache::Entry cached_symbol;
+    if (process->GetUnwindSymbolCache().Lookup (pc, above_async_frame, cached_symbol))
+    {
+        m_sym_ctx = cached_symbol.sym_ctx;
+        m_sym_ctx_valid = cached_symbol.sym_ctx_valid;
+        addr_range = cached_symbol.addr_range;
+        decr_pc_and_recompute_addr_range = cached_symbol.decr_pc;
+        UnwindLogMsg ("with pc value of 0x%" PRIx64 ", cached symbol is '%s'",
                       pc, GetSymbolOrFunctionName(m_sym_ctx).AsCString(""));
     }
     else
     {
-        UnwindLogMsg ("with pc value of 0x%" PRIx64 ", no symbol/function name is known.", pc);
-    }
-
-    AddressRange addr_range;
-    if (!m_sym_ctx.GetAddressRange (resolve_scope, 0, false, addr_range))
-    {
-        m_sym_ctx_valid = false;
-    }
+        bool resolve_tail_call_address = true; // m_current_pc can be one past the address range of the function...
+                                               // This will handle the case where the saved pc does not point to 
+                                               // a function/symbol because it is beyond the bounds of the correct
+                                               // function and there's no symbol there.  ResolveSymbolContextForAddress
+                                               // will fail to find a symbol, back up the pc by 1 and re-search.
+        const uint32_t resolve_scope = eSymbolContextFunction | eSymbolContextSymbol;
+        uint32_t resolved_scope = pc_module_sp->ResolveSymbolContextForAddress (m_current_pc,
+                                                                                resolve_scope,
+                                                                                m_sym_ctx, resolve_tail_call_address);
+
+        // We require either a symbol or function in the symbols context to be successfully
+        // filled in or this context is of no use to us.
+        if (resolve_scope & resolved_scope)
+        {
+            m_sym_ctx_valid = true;
+        }
 
-    bool decr_pc_and_recompute_addr_range = false;
+        if (m_sym_ctx.symbol)
+        {
+            UnwindLogMsg ("with pc value of 0x%" PRIx64 ", symbol name is '%s'",
+                          pc, GetSymbolOrFunctionName(m_sym_ctx).AsCString(""));
+        }
+        else if (m_sym_ctx.function)
+        {
+            UnwindLogMsg ("with pc value of 0x%" PRIx64 ", function name is '%s'",
+                          pc, GetSymbolOrFunctionName(m_sym_ctx).AsCString(""));
+        }
+        else
+        {
+            UnwindLogMsg ("with pc value of 0x%" PRIx64 ", no symbol/function name is known.", pc);
+        }
 
-    // If the symbol lookup failed...
-    if (m_sym_ctx_valid == false)
-       decr_pc_and_recompute_addr_range = true;
+        if (!m_sym_ctx.GetAddressRange (resolve_scope, 0, false, addr_range))
+        {
+            m_sym_ctx_valid = false;
+        }
 
-    // Or if we're in the middle of the stack (and not "above" an asynchronous event like sigtramp),
-    // and our "current" pc is the start of a function...
-    if (m_sym_ctx_valid
-        && GetNextFrame()->m_frame_type != eTrapHandlerFrame
-        && GetNextFrame()->m_frame_type != eDebuggerFrame
-        && addr_range.GetBaseAddress().IsValid()
-        && addr_range.GetBaseAddress().GetSection() == m_current_pc.GetSection()
-        && addr_range.GetBaseAddress().GetOffset() == m_current_pc.GetOffset())
-    {
-        decr_pc_and_recompute_addr_range = true;
-    }
+        // If the symbol lookup failed...
+        if (m_sym_ctx_valid == false)
+           decr_pc_and_recompute_addr_range = true;
+
+        // Or if we're in the middle of the stack (and not "above" an asynchronous event like sigtramp),
+        // and our "current" pc is the start of a function...
+        if (m_sym_ctx_valid
+            && !above_async_frame
+            && addr_range.GetBaseAddress().IsValid()
+            && addr_range.GetBaseAddress().GetSection() == m_current_pc.GetSection()
+            && addr_range.GetBaseAddress().GetOffset() == m_current_pc.GetOffset())
+        {
+            decr_pc_and_recompute_addr_range = true;
+        }
 
-    // We need to back up the pc by 1 byte and re-search for the Symbol to handle the case where the "saved pc"
-    // value is pointing to the next function, e.g. if a function ends with a CALL instruction.
-    // FIXME this may need to be an architectural-dependent behavior; if so we'll need to add a member function
-    // to the ABI plugin and consult that.
-    if (decr_pc_and_recompute_addr_range)
-    {
-        UnwindLogMsg ("Backing up the pc value of 0x%" PRIx64 " by 1 and re-doing symbol lookup; old symbol was %s",
-                      pc, GetSymbolOrFunctionName(m_sym_ctx).AsCString(""));
-        Address temporary_pc;
-        temporary_pc.SetLoadAddress (pc - 1, &process->GetTarget());
-        m_sym_ctx.Clear (false);
-        m_sym_ctx_valid = false;
-        uint32_t resolve_scope = eSymbolContextFunction | eSymbolContextSymbol;
-        
-        ModuleSP temporary_module_sp = temporary_pc.GetModule();
-        if (temporary_module_sp &&
-            temporary_module_sp->ResolveSymbolContextForAddress (temporary_pc, resolve_scope, m_sym_ctx) & resolve_scope)
+        // We need to back up the pc by 1 byte and re-search for the Symbol to handle the case where the "saved pc"
+        // value is pointing to the next function, e.g. if a function ends with a CALL instruction.
+        // FIXME this may need to be an architectural-dependent behavior; if so we'll need to add a member function
+        // to the ABI plugin and consult that.
+        if (decr_pc_and_recompute_addr_range)
         {
-            if (m_sym_ctx.GetAddressRange (resolve_scope, 0, false,  addr_range))
-                m_sym_ctx_valid = true;
+            UnwindLogMsg ("Backing up the pc value of 0x%" PRIx64 " by 1 and re-doing symbol lookup; old symbol was %s",
+                          pc, GetSymbolOrFunctionName(m_sym_ctx).AsCString(""));
+            Address temporary_pc;
+            temporary_pc.SetLoadAddress (pc - 1, &process->GetTarget());
+            m_sym_ctx.Clear (false);
+            m_sym_ctx_valid = false;
+            uint32_t resolve_scope = eSymbolContextFunction | eSymbolContextSymbol;
+        
+            ModuleSP temporary_module_sp = temporary_pc.GetModule();
+            if (temporary_module_sp &&
+                temporary_module_sp->ResolveSymbolContextForAddress (temporary_pc, resolve_scope, m_sym_ctx) & resolve_scope)
+            {
+                if (m_sym_ctx.GetAddressRange (resolve_scope, 0, false,  addr_range))
+                    m_sym_ctx_valid = true;
+            }
+            UnwindLogMsg ("Symbol is now %s", GetSymbolOrFunctionName(m_sym_ctx).AsCString(""));
         }
-        UnwindLogMsg ("Symbol is now %s", GetSymbolOrFunctionName(m_sym_ctx).AsCString(""));
+
+        cached_symbol.sym_ctx = m_sym_ctx;
+        cached_symbol.sym_ctx_valid = m_sym_ctx_valid;
+        cached_symbol.addr_range = addr_range;
+        cached_symbol.decr_pc = decr_pc_and_recompute_addr_range;
+        process->GetUnwindSymbolCache().Insert (pc, above_async_frame, cached_symbol);
     }
 
     // If we were able to find a symbol/function, set addr_range_ptr to the bounds of that symbol/function.
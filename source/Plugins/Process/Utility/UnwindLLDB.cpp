@@ -7,6 +7,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Symbol/FuncUnwinders.h"
@@ -24,11 +25,27 @@
 using namespace lldb;
 using namespace lldb_private;
 
+// How much stack the fast unwinder reads at once. Consecutive frame
+// records are usually close together, so most frames need no read.
+static const size_t k_stack_read_size = 4096;
+
+// A frame record further away than this from its callee's is taken to
+// be garbage rather than a very large frame.
+static const addr_t k_max_fast_frame_size = 8 * 1024 * 1024;
+
+// How much stack below each CFA the full unwinder is expected to read: the
+// frame record and the callee-saved registers pushed after it.
+static const size_t k_prefetched_frame_size = 128;
+
 UnwindLLDB::UnwindLLDB (Thread &thread) :
     Unwind (thread),
     m_frames(),
     m_unwind_complete(false),
-    m_user_supplied_trap_handler_functions()
+    m_user_supplied_trap_handler_functions(),
+    m_use_fast_unwind(false),
+    m_fast_frames(),
+    m_stack_buffer(),
+    m_stack_buffer_addr(LLDB_INVALID_ADDRESS)
 {
     ProcessSP process_sp(thread.GetProcess());
     if (process_sp)
@@ -60,10 +77,10 @@ UnwindLLDB::DoGetFrameCount()
         ProcessSP process_sp (m_thread.GetProcess());
         ABI *abi = process_sp ? process_sp->GetABI().get() : NULL;
 
-        while (AddOneMoreFrame (abi))
+        while (AddNextFrame (abi))
         {
 #if DEBUG_FRAME_SPEED
-            if ((m_frames.size() % FRAME_COUNT) == 0)
+            if ((GetNumFrames() % FRAME_COUNT) == 0)
             {
                 TimeValue now(TimeValue::Now());
                 uint64_t delta_t = now - time_value;
@@ -77,7 +94,7 @@ UnwindLLDB::DoGetFrameCount()
 #endif
         }
     }
-    return m_frames.size ();
+    return GetNumFrames ();
 }
 
 bool
@@ -112,8 +129,13 @@ UnwindLLDB::AddFirstFrame ()
     first_cursor_sp->reg_ctx_lldb_sp = reg_ctx_sp;
     m_frames.push_back (first_cursor_sp);
 
+    // With the fast unwinder the full unwind plan of frame 0 is only
+    // checked if the full unwinder is needed for the next frame.
+    m_use_fast_unwind = m_thread.GetFastUnwind() && ArchitectureSupportsFastUnwind();
+
     // Update the Full Unwind Plan for this frame if not valid
-    UpdateUnwindPlanForFirstFrameIfInvalid(abi);
+    if (!m_use_fast_unwind)
+        UpdateUnwindPlanForFirstFrameIfInvalid(abi);
 
     return true;
 
@@ -414,6 +436,221 @@ UnwindLLDB::AddOneMoreFrame (ABI *abi)
     return true;
 }
 
+bool
+UnwindLLDB::AddNextFrame (ABI *abi)
+{
+    if (m_unwind_complete)
+        return false;
+
+    if (m_use_fast_unwind)
+    {
+        switch (AddFastFrame (abi))
+        {
+            case eFastUnwindAddedFrame:
+                return true;
+
+            case eFastUnwindStackEnd:
+            {
+                Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+                if (log)
+                    log->Printf ("th%d Fast unwind of this thread is complete.", m_thread.GetIndexID());
+                m_unwind_complete = true;
+                return false;
+            }
+
+            case eFastUnwindNoChain:
+                // The full unwinder can only continue from frames it found
+                // itself, so it has to redo the frames found so far.
+                UnwindFastFramesFully (abi);
+                break;
+        }
+    }
+
+    return AddOneMoreFrame (abi);
+}
+
+//----------------------------------------------------------------------
+// The fast unwinder follows the chain of frame records: the frame
+// pointer of a frame points at the caller's frame pointer, followed by
+// the return address, and the CFA is right above the record. The chain
+// is only followed from a frame whose frame pointer is consistent with
+// its CFA, and only as long as each record is above the previous one.
+//----------------------------------------------------------------------
+UnwindLLDB::FastUnwindResult
+UnwindLLDB::AddFastFrame (ABI *abi)
+{
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+
+    ProcessSP process_sp (m_thread.GetProcess());
+    if (!process_sp || m_frames.empty())
+        return eFastUnwindNoChain;
+
+    const uint32_t cur_idx = GetNumFrames();
+    if (cur_idx > 300000)
+    {
+        if (log)
+            log->Printf ("th%d Frame %d unwound too many frames, assuming unwind has gone astray, stopping.",
+                         m_thread.GetIndexID(), cur_idx);
+        return eFastUnwindStackEnd;
+    }
+
+    const addr_t addr_byte_size = process_sp->GetAddressByteSize();
+    addr_t cfa;
+    if (m_fast_frames.empty())
+    {
+        const CursorSP &cursor_sp = m_frames.back();
+        const addr_t fp = cursor_sp->reg_ctx_lldb_sp->GetFP();
+        if (fp == LLDB_INVALID_ADDRESS || fp + 2 * addr_byte_size != cursor_sp->cfa)
+            return eFastUnwindNoChain;
+        cfa = cursor_sp->cfa;
+    }
+    else
+        cfa = m_fast_frames.back().cfa;
+
+    const addr_t fp = cfa - 2 * addr_byte_size;
+    addr_t caller_fp;
+    addr_t pc;
+    if (!ReadStackAddress (fp, caller_fp) || !ReadStackAddress (fp + addr_byte_size, pc))
+    {
+        if (log)
+            log->Printf ("th%d Frame %d could not read the frame record at 0x%" PRIx64 ", switching to the full unwinder",
+                         m_thread.GetIndexID(), cur_idx, fp);
+        return eFastUnwindNoChain;
+    }
+
+    // The ABIs have the outermost frame clear the frame pointer.
+    if (caller_fp == 0 || pc == 0)
+        return eFastUnwindStackEnd;
+
+    const addr_t caller_cfa = caller_fp + 2 * addr_byte_size;
+    if (caller_fp <= fp ||
+        caller_fp - fp > k_max_fast_frame_size ||
+        (caller_fp % addr_byte_size) != 0 ||
+        (abi && (!abi->CodeAddressIsValid (pc) || !abi->CallFrameAddressIsValid (caller_cfa))))
+    {
+        if (log)
+            log->Printf ("th%d Frame %d has an invalid frame record (fp 0x%" PRIx64 ", pc 0x%" PRIx64 "), switching to the full unwinder",
+                         m_thread.GetIndexID(), cur_idx, caller_fp, pc);
+        return eFastUnwindNoChain;
+    }
+
+    FastFrame frame = { caller_cfa, pc };
+    m_fast_frames.push_back (frame);
+    return eFastUnwindAddedFrame;
+}
+
+bool
+UnwindLLDB::UnwindFastFramesFully (ABI *abi)
+{
+    const uint32_t num_frames = GetNumFrames();
+
+    // AddFirstFrame() left this to the full unwinder.
+    if (m_use_fast_unwind && m_frames.size() == 1)
+        UpdateUnwindPlanForFirstFrameIfInvalid (abi);
+
+    std::vector<FastFrame> fast_frames;
+    fast_frames.swap (m_fast_frames);
+    const uint32_t first_fast_idx = m_frames.size();
+
+    // The fast unwinder may have reached the end of the stack, the full
+    // one hasn't yet.
+    const bool unwind_complete = m_unwind_complete;
+    if (!fast_frames.empty())
+        m_unwind_complete = false;
+
+    // The fast unwinder already knows where the frames the full unwinder is
+    // about to walk are, so read their saved registers in one batch instead
+    // of one frame at a time.
+    ProcessSP process_sp (m_thread.GetProcess());
+    if (process_sp && fast_frames.size() > 1)
+    {
+        Process::MemoryRangeList ranges;
+        for (const FastFrame &fast_frame : fast_frames)
+        {
+            if (fast_frame.cfa > k_prefetched_frame_size)
+                ranges.push_back (std::make_pair (fast_frame.cfa - k_prefetched_frame_size, k_prefetched_frame_size));
+        }
+        process_sp->PrefetchMemory (ranges);
+    }
+
+    while (m_frames.size() < num_frames && AddOneMoreFrame (abi))
+        ;
+
+    if (m_frames.size() == num_frames)
+        m_unwind_complete = unwind_complete;
+
+    // The frames the fast unwinder found may already be in the thread's
+    // frame list, so if the full unwinder disagrees about any of them the
+    // list is stale. Stop trusting the fast unwinder for this stop and let
+    // the list be rebuilt from the full frames.
+    for (uint32_t idx = first_fast_idx; idx < num_frames; ++idx)
+    {
+        const FastFrame &fast_frame = fast_frames[idx - first_fast_idx];
+        if (idx >= m_frames.size() || m_frames[idx]->cfa != fast_frame.cfa || m_frames[idx]->start_pc != fast_frame.pc)
+        {
+            Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+            if (log)
+                log->Printf ("th%d Frame %d from the fast unwinder doesn't match the full unwinder's, disabling fast unwinding",
+                             m_thread.GetIndexID(), idx);
+            m_use_fast_unwind = false;
+            m_thread.DiscardStackFrameList();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+UnwindLLDB::ReadStackAddress (addr_t addr, addr_t &value)
+{
+    ProcessSP process_sp (m_thread.GetProcess());
+    if (!process_sp)
+        return false;
+
+    const uint32_t addr_byte_size = process_sp->GetAddressByteSize();
+    if (m_stack_buffer_addr == LLDB_INVALID_ADDRESS ||
+        addr < m_stack_buffer_addr ||
+        addr + addr_byte_size > m_stack_buffer_addr + m_stack_buffer.size())
+    {
+        // The chain goes up the stack, so read from "addr" upwards.
+        m_stack_buffer.resize (k_stack_read_size);
+        Error error;
+        const size_t bytes_read = process_sp->ReadMemory (addr, m_stack_buffer.data(), m_stack_buffer.size(), error);
+        m_stack_buffer.resize (bytes_read);
+        m_stack_buffer_addr = addr;
+        if (bytes_read < addr_byte_size)
+        {
+            m_stack_buffer_addr = LLDB_INVALID_ADDRESS;
+            return false;
+        }
+    }
+
+    DataExtractor data (m_stack_buffer.data(), m_stack_buffer.size(), process_sp->GetByteOrder(), addr_byte_size);
+    lldb::offset_t offset = addr - m_stack_buffer_addr;
+    value = data.GetPointer (&offset);
+    return true;
+}
+
+bool
+UnwindLLDB::ArchitectureSupportsFastUnwind ()
+{
+    // Only the architectures whose frame records are the caller's frame
+    // pointer followed by the return address, right below the CFA.
+    ProcessSP process_sp (m_thread.GetProcess());
+    if (!process_sp)
+        return false;
+
+    switch (process_sp->GetTarget().GetArchitecture().GetMachine())
+    {
+        case llvm::Triple::x86:
+        case llvm::Triple::x86_64:
+        case llvm::Triple::aarch64:
+            return true;
+        default:
+            return false;
+    }
+}
+
 bool
 UnwindLLDB::DoGetFrameInfoAtIndex (uint32_t idx, addr_t& cfa, addr_t& pc)
 {
@@ -426,7 +663,7 @@ UnwindLLDB::DoGetFrameInfoAtIndex (uint32_t idx, addr_t& cfa, addr_t& pc)
     ProcessSP process_sp (m_thread.GetProcess());
     ABI *abi = process_sp ? process_sp->GetABI().get() : NULL;
 
-    while (idx >= m_frames.size() && AddOneMoreFrame (abi))
+    while (idx >= GetNumFrames() && AddNextFrame (abi))
         ;
 
     if (idx < m_frames.size ())
@@ -435,6 +672,13 @@ UnwindLLDB::DoGetFrameInfoAtIndex (uint32_t idx, addr_t& cfa, addr_t& pc)
         pc = m_frames[idx]->start_pc;
         return true;
     }
+    if (idx < GetNumFrames ())
+    {
+        const FastFrame &fast_frame = m_fast_frames[idx - m_frames.size()];
+        cfa = fast_frame.cfa;
+        pc = fast_frame.pc;
+        return true;
+    }
     return false;
 }
 
@@ -458,6 +702,12 @@ UnwindLLDB::DoCreateRegisterContextForFrame (StackFrame *frame)
     ProcessSP process_sp (m_thread.GetProcess());
     ABI *abi = process_sp ? process_sp->GetABI().get() : NULL;
 
+    // Register contexts only exist for the frames of the full unwinder. If
+    // it disagrees with the fast unwinder, the frame asking for a context is
+    // from a stale list and mustn't get the context of a different frame.
+    if (idx >= m_frames.size() && !UnwindFastFramesFully (abi))
+        return reg_ctx_sp;
+
     while (idx >= m_frames.size())
     {
         if (!AddOneMoreFrame (abi))
@@ -70,6 +70,9 @@ protected:
         m_frames.clear();
         m_candidate_frame.reset();
         m_unwind_complete = false;
+        m_fast_frames.clear();
+        m_stack_buffer.clear();
+        m_stack_buffer_addr = LLDB_INVALID_ADDRESS;
     }
 
     uint32_t
@@ -127,6 +130,21 @@ private:
         DISALLOW_COPY_AND_ASSIGN (Cursor);
     };
 
+    // A frame found by following the frame pointer chain. Its frame record
+    // (the saved frame pointer and the return address) is right below the CFA.
+    struct FastFrame
+    {
+        lldb::addr_t cfa;
+        lldb::addr_t pc;
+    };
+
+    enum FastUnwindResult
+    {
+        eFastUnwindAddedFrame,
+        eFastUnwindStackEnd,    // The chain ended with a zero frame pointer or return address
+        eFastUnwindNoChain      // The chain is broken, the full unwinder has to take over
+    };
+
     typedef std::shared_ptr<Cursor> CursorSP;
     std::vector<CursorSP> m_frames;
     CursorSP m_candidate_frame;
@@ -136,6 +154,11 @@ private:
  
     std::vector<ConstString> m_user_supplied_trap_handler_functions;
 
+    bool m_use_fast_unwind;                 // Set from the thread's "fast-unwind" setting when frame 0 is added
+    std::vector<FastFrame> m_fast_frames;   // The frames after m_frames, found by the fast unwinder
+    std::vector<uint8_t> m_stack_buffer;    // Stack memory read in bulk by the fast unwinder
+    lldb::addr_t m_stack_buffer_addr;
+
     //-----------------------------------------------------------------
     // Check if Full UnwindPlan of First frame is valid or not.
     // If not then try Fallback UnwindPlan of the frame. If Fallback
@@ -154,6 +177,37 @@ private:
     bool
     AddFirstFrame ();
 
+    uint32_t
+    GetNumFrames () const
+    {
+        return m_frames.size() + m_fast_frames.size();
+    }
+
+    //-----------------------------------------------------------------
+    // Add the next frame, with the fast unwinder when it is enabled and
+    // the frame pointer chain is valid, or with the full unwinder.
+    //-----------------------------------------------------------------
+    bool
+    AddNextFrame (ABI *abi);
+
+    FastUnwindResult
+    AddFastFrame (ABI *abi);
+
+    //-----------------------------------------------------------------
+    // Replace the frames found by the fast unwinder with full ones, as
+    // far as the full unwinder gets. Returns false if the full frames
+    // differ from the fast ones, in which case fast unwinding is off for
+    // the rest of this stop and the thread's frame list is discarded.
+    //-----------------------------------------------------------------
+    bool
+    UnwindFastFramesFully (ABI *abi);
+
+    bool
+    ReadStackAddress (lldb::addr_t addr, lldb::addr_t &value);
+
+    bool
+    ArchitectureSupportsFastUnwind ();
+
     //------------------------------------------------------------------
     // For UnwindLLDB only
     //------------------------------------------------------------------
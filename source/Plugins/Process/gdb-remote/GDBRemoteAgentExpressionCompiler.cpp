@@ -0,0 +1,851 @@
+//===-- GDBRemoteAgentExpressionCompiler.cpp --------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "GDBRemoteAgentExpressionCompiler.h"
+
+// C Includes
+#include <ctype.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdlib.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Core/dwarf.h"
+#include "lldb/Expression/DWARFExpression.h"
+#include "lldb/Host/common/NativeAgentExpression.h"
+#include "lldb/Symbol/Block.h"
+#include "lldb/Symbol/CompileUnit.h"
+#include "lldb/Symbol/FuncUnwinders.h"
+#include "lldb/Symbol/Function.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/Type.h"
+#include "lldb/Symbol/UnwindPlan.h"
+#include "lldb/Symbol/UnwindTable.h"
+#include "lldb/Symbol/Variable.h"
+#include "lldb/Symbol/VariableList.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/Thread.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+namespace
+{
+    // The binary operators by increasing precedence, each list is null terminated.
+    const char *const g_binary_operators[][5] =
+    {
+        { "||", nullptr },
+        { "&&", nullptr },
+        { "|", nullptr },
+        { "^", nullptr },
+        { "&", nullptr },
+        { "==", "!=", nullptr },
+        { "<", ">", "<=", ">=", nullptr },
+        { "<<", ">>", nullptr },
+        { "+", "-", nullptr },
+        { "*", "/", "%", nullptr }
+    };
+    const int k_num_binary_levels = sizeof (g_binary_operators) / sizeof (g_binary_operators[0]);
+
+    const char *const g_two_char_operators[] = { "||", "&&", "==", "!=", "<=", ">=", "<<", ">>" };
+    const char *const g_one_char_operators = "|^&<>+-*/%!~()";
+}
+
+GDBRemoteAgentExpressionCompiler::GDBRemoteAgentExpressionCompiler (Process &process, const Address &address) :
+    m_process (process),
+    m_address (address),
+    m_sc (),
+    m_reg_ctx_sp (),
+    m_collecting (false),
+    m_cursor (nullptr),
+    m_token_kind (eTokenEnd),
+    m_token_text (),
+    m_token_value (0),
+    m_token_type (),
+    m_bytecode (),
+    m_error ()
+{
+    m_address.CalculateSymbolContext (&m_sc, eSymbolContextEverything);
+
+    // Register numbers are the same for all threads, any of them can map
+    // DWARF register numbers to the numbers used by the stub.
+    ThreadSP thread_sp (process.GetThreadList ().GetThreadAtIndex (0, false));
+    if (thread_sp)
+        m_reg_ctx_sp = thread_sp->GetRegisterContext ();
+}
+
+Error
+GDBRemoteAgentExpressionCompiler::Compile (const char *condition, std::vector<uint8_t> &bytecode)
+{
+    m_collecting = false;
+    if (ParseExpression (condition))
+        EmitEnd (bytecode);
+    return m_error;
+}
+
+Error
+GDBRemoteAgentExpressionCompiler::CompileCollect (const char *item, std::vector<uint8_t> &bytecode)
+{
+    // Split off the "@<size>" suffix of a memory range.
+    std::string expression (item ? item : "");
+    uint64_t byte_size = 0;
+    const size_t at_pos = expression.rfind ('@');
+    if (at_pos != std::string::npos)
+    {
+        const char *size_cstr = expression.c_str () + at_pos + 1;
+        char *end = nullptr;
+        errno = 0;
+        byte_size = ::strtoull (size_cstr, &end, 0);
+        while (end && isspace (*end))
+            ++end;
+        if (errno != 0 || end == size_cstr || *end != '\0' || byte_size == 0 || byte_size > UINT16_MAX)
+        {
+            m_error.SetErrorStringWithFormat ("invalid size '%s' in '%s'", size_cstr, item);
+            return m_error;
+        }
+        expression.erase (at_pos);
+    }
+
+    m_collecting = true;
+    if (ParseExpression (expression.c_str ()))
+    {
+        if (byte_size > 0)
+        {
+            EmitOpcode (NativeAgentExpression::eOpTrace16);
+            m_bytecode.push_back (byte_size >> 8);
+            m_bytecode.push_back (byte_size & 0xff);
+        }
+        EmitEnd (bytecode);
+    }
+    return m_error;
+}
+
+bool
+GDBRemoteAgentExpressionCompiler::ParseExpression (const char *expression)
+{
+    m_bytecode.clear ();
+    m_error.Clear ();
+    m_cursor = expression ? expression : "";
+
+    ValueType type;
+    if (!NextToken () || !ParseBinary (0, type))
+        return false;
+    if (m_token_kind != eTokenEnd)
+        return SetError ("unexpected '%s' in expression", m_token_text.c_str ());
+    return true;
+}
+
+void
+GDBRemoteAgentExpressionCompiler::EmitEnd (std::vector<uint8_t> &bytecode)
+{
+    EmitOpcode (NativeAgentExpression::eOpEnd);
+    if (m_bytecode.size () > UINT16_MAX)
+        SetError ("expression is too long");
+    else
+        bytecode.swap (m_bytecode);
+}
+
+bool
+GDBRemoteAgentExpressionCompiler::NextToken ()
+{
+    while (isspace (*m_cursor))
+        ++m_cursor;
+
+    const char *start = m_cursor;
+    m_token_text.clear ();
+    if (*m_cursor == '\0')
+    {
+        m_token_kind = eTokenEnd;
+        return true;
+    }
+
+    if (isdigit (*m_cursor))
+    {
+        const bool is_decimal = *m_cursor != '0';
+        char *end = nullptr;
+        errno = 0;
+        m_token_value = ::strtoull (m_cursor, &end, 0);
+        if (errno == ERANGE)
+            return SetError ("integer literal is too large");
+        m_cursor = end;
+
+        bool is_unsigned = false;
+        while (*m_cursor == 'u' || *m_cursor == 'U' || *m_cursor == 'l' || *m_cursor == 'L')
+        {
+            if (*m_cursor == 'u' || *m_cursor == 'U')
+                is_unsigned = true;
+            ++m_cursor;
+        }
+        m_token_text.assign (start, m_cursor - start);
+        if (isalnum (*m_cursor) || *m_cursor == '_' || *m_cursor == '.')
+            return SetError ("unsupported literal '%s'", m_token_text.c_str ());
+
+        // The first type of int, unsigned int, long and unsigned long that
+        // can represent the value, decimal literals are never unsigned
+        // without a suffix.
+        if (m_token_value <= INT32_MAX && !is_unsigned)
+            m_token_type = ValueType (4, true);
+        else if (m_token_value <= UINT32_MAX && (is_unsigned || !is_decimal))
+            m_token_type = ValueType (4, false);
+        else if (m_token_value <= INT64_MAX && !is_unsigned)
+            m_token_type = ValueType (8, true);
+        else
+            m_token_type = ValueType (8, false);
+        m_token_kind = eTokenNumber;
+        return true;
+    }
+
+    if (isalpha (*m_cursor) || *m_cursor == '_' || *m_cursor == '$')
+    {
+        m_token_kind = *m_cursor == '$' ? eTokenRegister : eTokenIdentifier;
+        if (*m_cursor == '$')
+            ++start;
+        ++m_cursor;
+        while (isalnum (*m_cursor) || *m_cursor == '_')
+            ++m_cursor;
+        m_token_text.assign (start, m_cursor - start);
+        if (m_token_text.empty ())
+            return SetError ("expected a register name after '$'");
+        return true;
+    }
+
+    m_token_kind = eTokenOperator;
+    for (const char *op : g_two_char_operators)
+    {
+        if (m_cursor[0] == op[0] && m_cursor[1] == op[1])
+        {
+            m_token_text = op;
+            m_cursor += 2;
+            return true;
+        }
+    }
+    if (::strchr (g_one_char_operators, *m_cursor))
+    {
+        m_token_text.assign (1, *m_cursor);
+        ++m_cursor;
+        return true;
+    }
+
+    return SetError ("unsupported character '%c' in expression", *m_cursor);
+}
+
+bool
+GDBRemoteAgentExpressionCompiler::IsOperator (const char *op) const
+{
+    return m_token_kind == eTokenOperator && m_token_text == op;
+}
+
+bool
+GDBRemoteAgentExpressionCompiler::ParseBinary (int level, ValueType &type)
+{
+    if (level == k_num_binary_levels)
+        return ParseUnary (type);
+
+    if (!ParseBinary (level + 1, type))
+        return false;
+
+    // && and || only evaluate their right hand side when needed, and their
+    // result is always 0 or 1.
+    if (level <= 1)
+    {
+        const bool is_or = level == 0;
+        while (IsOperator (g_binary_operators[level][0]))
+        {
+            if (!NextToken ())
+                return false;
+
+            ValueType rhs;
+            if (is_or)
+            {
+                const size_t to_true = EmitJump (NativeAgentExpression::eOpIfGoto);
+                if (!ParseBinary (level + 1, rhs))
+                    return false;
+                EmitOpcode (NativeAgentExpression::eOpLogNot);
+                EmitOpcode (NativeAgentExpression::eOpLogNot);
+                const size_t to_end = EmitJump (NativeAgentExpression::eOpGoto);
+                if (!PatchJump (to_true))
+                    return false;
+                EmitConstant (1);
+                if (!PatchJump (to_end))
+                    return false;
+            }
+            else
+            {
+                const size_t to_rhs = EmitJump (NativeAgentExpression::eOpIfGoto);
+                EmitConstant (0);
+                const size_t to_end = EmitJump (NativeAgentExpression::eOpGoto);
+                if (!PatchJump (to_rhs))
+                    return false;
+                if (!ParseBinary (level + 1, rhs))
+                    return false;
+                EmitOpcode (NativeAgentExpression::eOpLogNot);
+                EmitOpcode (NativeAgentExpression::eOpLogNot);
+                if (!PatchJump (to_end))
+                    return false;
+            }
+            type = ValueType ();
+        }
+        return true;
+    }
+
+    while (m_token_kind == eTokenOperator)
+    {
+        const char *const *op = g_binary_operators[level];
+        while (*op && m_token_text != *op)
+            ++op;
+        if (*op == nullptr)
+            break;
+
+        const std::string op_text (m_token_text);
+        ValueType rhs;
+        if (!NextToken () || !ParseBinary (level + 1, rhs))
+            return false;
+        if (!EmitBinaryOperator (op_text, type, rhs, type))
+            return false;
+    }
+    return true;
+}
+
+bool
+GDBRemoteAgentExpressionCompiler::ParseUnary (ValueType &type)
+{
+    if (m_token_kind != eTokenOperator || m_token_text == "(")
+        return ParsePrimary (type);
+
+    const std::string op (m_token_text);
+    if (!NextToken ())
+        return false;
+
+    ValueType operand;
+    if (op == "!")
+    {
+        if (!ParseUnary (operand))
+            return false;
+        EmitOpcode (NativeAgentExpression::eOpLogNot);
+        type = ValueType ();
+        return true;
+    }
+
+    if (op == "*")
+    {
+        if (!ParseUnary (operand))
+            return false;
+        if (!operand.pointee_type.IsValid ())
+            return SetError ("only pointers can be dereferenced");
+        if (!GetScalarType (operand.pointee_type, type))
+            return SetError ("only pointers to integers or pointers can be dereferenced");
+        EmitLoad (type);
+        return true;
+    }
+
+    if (op == "-" || op == "+" || op == "~")
+    {
+        // 0 - operand, the zero has to be pushed first.
+        if (op == "-")
+            EmitConstant (0);
+        if (!ParseUnary (operand))
+            return false;
+        if (operand.pointee_type.IsValid ())
+            return SetError ("unary '%s' can't be applied to a pointer", op.c_str ());
+
+        type = ValueType (std::max<uint32_t> (operand.byte_size, 4), operand.byte_size < 4 || operand.is_signed);
+        if (op == "-")
+            EmitOpcode (NativeAgentExpression::eOpSub);
+        else if (op == "~")
+            EmitOpcode (NativeAgentExpression::eOpBitNot);
+        EmitConversion (ValueType (8, true), type);
+        return true;
+    }
+
+    return SetError ("unexpected '%s' in expression", op.c_str ());
+}
+
+bool
+GDBRemoteAgentExpressionCompiler::ParsePrimary (ValueType &type)
+{
+    switch (m_token_kind)
+    {
+        case eTokenNumber:
+            EmitConstant (m_token_value);
+            type = m_token_type;
+            return NextToken ();
+
+        case eTokenRegister:
+        {
+            if (!m_reg_ctx_sp)
+                return SetError ("no registers available");
+            const RegisterInfo *reg_info = m_reg_ctx_sp->GetRegisterInfoByName (m_token_text.c_str ());
+            if (!reg_info)
+                return SetError ("no register named '%s'", m_token_text.c_str ());
+            uint32_t byte_size = 0;
+            if (!EmitRegister (eRegisterKindLLDB, reg_info->kinds[eRegisterKindLLDB], &byte_size))
+                return false;
+            type = ValueType (byte_size, false);
+            EmitConversion (ValueType (8, false), type);
+            return NextToken ();
+        }
+
+        case eTokenIdentifier:
+            if (m_token_text == "true" || m_token_text == "false")
+            {
+                EmitConstant (m_token_text == "true" ? 1 : 0);
+                type = ValueType ();
+            }
+            else if (!EmitVariable (ConstString (m_token_text.c_str ()), type))
+                return false;
+            return NextToken ();
+
+        case eTokenOperator:
+            if (m_token_text == "(")
+            {
+                if (!NextToken () || !ParseBinary (0, type))
+                    return false;
+                if (!IsOperator (")"))
+                    return SetError ("expected ')' in expression");
+                return NextToken ();
+            }
+            return SetError ("unexpected '%s' in expression", m_token_text.c_str ());
+
+        case eTokenEnd:
+            break;
+    }
+    return SetError ("unexpected end of expression");
+}
+
+bool
+GDBRemoteAgentExpressionCompiler::EmitBinaryOperator (const std::string &op, const ValueType &lhs, const ValueType &rhs, ValueType &type)
+{
+    const bool is_comparison = op == "==" || op == "!=" || op == "<" || op == ">" || op == "<=" || op == ">=";
+    if (!is_comparison && (lhs.pointee_type.IsValid () || rhs.pointee_type.IsValid ()))
+        return SetError ("pointer arithmetic is not supported");
+
+    // Operands are promoted to int, or converted to the larger of their
+    // types, which is unsigned if either of them is unsigned and they have
+    // the same size.
+    const ValueType lhs_promoted (std::max<uint32_t> (lhs.byte_size, 4), lhs.byte_size < 4 || lhs.is_signed);
+    const ValueType rhs_promoted (std::max<uint32_t> (rhs.byte_size, 4), rhs.byte_size < 4 || rhs.is_signed);
+
+    if (op == "<<" || op == ">>")
+    {
+        type = lhs_promoted;
+        if (op == "<<")
+            EmitOpcode (NativeAgentExpression::eOpLsh);
+        else
+            EmitOpcode (type.is_signed ? NativeAgentExpression::eOpRshSigned : NativeAgentExpression::eOpRshUnsigned);
+        EmitConversion (ValueType (8, true), type);
+        return true;
+    }
+
+    ValueType common;
+    if (lhs_promoted.byte_size != rhs_promoted.byte_size)
+        common = lhs_promoted.byte_size > rhs_promoted.byte_size ? lhs_promoted : rhs_promoted;
+    else
+        common = ValueType (lhs_promoted.byte_size, lhs_promoted.is_signed && rhs_promoted.is_signed);
+
+    // The right hand side is on top of the stack.
+    EmitConversion (rhs, common);
+    const size_t size_before_lhs = m_bytecode.size ();
+    EmitOpcode (NativeAgentExpression::eOpSwap);
+    const size_t size_after_swap = m_bytecode.size ();
+    EmitConversion (lhs, common);
+    if (m_bytecode.size () == size_after_swap)
+        m_bytecode.resize (size_before_lhs);
+    else
+        EmitOpcode (NativeAgentExpression::eOpSwap);
+
+    const bool is_signed = common.is_signed;
+    type = common;
+    if (op == "==" || op == "!=")
+    {
+        EmitOpcode (NativeAgentExpression::eOpEqual);
+        if (op == "!=")
+            EmitOpcode (NativeAgentExpression::eOpLogNot);
+    }
+    else if (is_comparison)
+    {
+        // a > b is b < a, a <= b is !(b < a) and a >= b is !(a < b).
+        if (op == ">" || op == "<=")
+            EmitOpcode (NativeAgentExpression::eOpSwap);
+        EmitOpcode (is_signed ? NativeAgentExpression::eOpLessSigned : NativeAgentExpression::eOpLessUnsigned);
+        if (op == "<=" || op == ">=")
+            EmitOpcode (NativeAgentExpression::eOpLogNot);
+    }
+    else if (op == "&")
+        EmitOpcode (NativeAgentExpression::eOpBitAnd);
+    else if (op == "|")
+        EmitOpcode (NativeAgentExpression::eOpBitOr);
+    else if (op == "^")
+        EmitOpcode (NativeAgentExpression::eOpBitXor);
+    else
+    {
+        if (op == "+")
+            EmitOpcode (NativeAgentExpression::eOpAdd);
+        else if (op == "-")
+            EmitOpcode (NativeAgentExpression::eOpSub);
+        else if (op == "*")
+            EmitOpcode (NativeAgentExpression::eOpMul);
+        else if (op == "/")
+            EmitOpcode (is_signed ? NativeAgentExpression::eOpDivSigned : NativeAgentExpression::eOpDivUnsigned);
+        else
+            EmitOpcode (is_signed ? NativeAgentExpression::eOpRemSigned : NativeAgentExpression::eOpRemUnsigned);
+        // The result may not fit the type anymore.
+        EmitConversion (ValueType (8, true), type);
+    }
+
+    if (is_comparison)
+        type = ValueType ();
+    return true;
+}
+
+bool
+GDBRemoteAgentExpressionCompiler::EmitVariable (const ConstString &name, ValueType &type)
+{
+    // Look for a local variable in the enclosing blocks of the function,
+    // then for a static or global variable.
+    VariableSP var_sp;
+    for (Block *block = m_sc.block; block && !var_sp; block = block->GetParent ())
+    {
+        VariableListSP variables_sp (block->GetBlockVariableList (true));
+        if (variables_sp)
+            var_sp = variables_sp->FindVariable (name);
+        // The variables of the function an inlined function was inlined
+        // into are not in scope.
+        if (block->GetInlinedFunctionInfo ())
+            break;
+    }
+    if (!var_sp && m_sc.comp_unit)
+    {
+        VariableListSP variables_sp (m_sc.comp_unit->GetVariableList (true));
+        if (variables_sp)
+            var_sp = variables_sp->FindVariable (name);
+    }
+    if (!var_sp)
+    {
+        VariableList variables;
+        if (m_sc.module_sp)
+            m_sc.module_sp->FindGlobalVariables (name, nullptr, true, 1, variables);
+        if (variables.GetSize () == 0)
+            m_process.GetTarget ().GetImages ().FindGlobalVariables (name, true, 1, variables);
+        if (variables.GetSize () > 0)
+            var_sp = variables.GetVariableAtIndex (0);
+    }
+    if (!var_sp)
+        return SetError ("no variable named '%s'", name.GetCString ());
+
+    Type *var_type = var_sp->GetType ();
+    if (!var_type || !GetScalarType (var_type->GetForwardCompilerType (), type))
+        return SetError ("variable '%s' is not an integer or a pointer", name.GetCString ());
+    if (var_sp->GetLocationIsConstantValueData ())
+        return SetError ("variable '%s' has a constant value", name.GetCString ());
+
+    SymbolContext var_sc;
+    var_sp->CalculateSymbolContext (&var_sc);
+    bool is_register = false;
+    if (!EmitLocation (var_sp->LocationExpression (), var_sc, is_register))
+        return false;
+
+    if (is_register)
+        EmitConversion (ValueType (8, false), type);
+    else
+        EmitLoad (type);
+    return true;
+}
+
+bool
+GDBRemoteAgentExpressionCompiler::EmitLocation (DWARFExpression &location, const SymbolContext &var_sc, bool &is_register)
+{
+    if (location.IsLocationList ())
+        return SetError ("variables with a location list are not supported");
+
+    DataExtractor data;
+    if (!location.GetExpressionData (data))
+        return SetError ("variable has no location");
+
+    // Only single operation locations are supported.
+    lldb::offset_t offset = 0;
+    const uint8_t op = data.GetU8 (&offset);
+    const RegisterKind reg_kind = static_cast<RegisterKind> (location.GetRegisterKind ());
+    bool success = true;
+    is_register = false;
+    if (op == DW_OP_addr)
+    {
+        const lldb::addr_t file_addr = data.GetAddress (&offset);
+        Address so_addr;
+        if (!var_sc.module_sp || !var_sc.module_sp->ResolveFileAddress (file_addr, so_addr))
+            return SetError ("failed to resolve the address of a variable");
+        const lldb::addr_t load_addr = so_addr.GetLoadAddress (&m_process.GetTarget ());
+        if (load_addr == LLDB_INVALID_ADDRESS)
+            return SetError ("variable is not loaded");
+        EmitConstant (load_addr);
+    }
+    else if (op >= DW_OP_reg0 && op <= DW_OP_reg31)
+    {
+        is_register = true;
+        success = EmitRegister (reg_kind, op - DW_OP_reg0);
+    }
+    else if (op == DW_OP_regx)
+    {
+        is_register = true;
+        success = EmitRegister (reg_kind, data.GetULEB128 (&offset));
+    }
+    else if (op >= DW_OP_breg0 && op <= DW_OP_breg31)
+    {
+        success = EmitRegister (reg_kind, op - DW_OP_breg0);
+        EmitOffset (data.GetSLEB128 (&offset));
+    }
+    else if (op == DW_OP_bregx)
+    {
+        const uint32_t reg_num = data.GetULEB128 (&offset);
+        success = EmitRegister (reg_kind, reg_num);
+        EmitOffset (data.GetSLEB128 (&offset));
+    }
+    else if (op == DW_OP_fbreg)
+    {
+        success = EmitFrameBase ();
+        EmitOffset (data.GetSLEB128 (&offset));
+    }
+    else
+        return SetError ("unsupported location opcode 0x%2.2x", op);
+
+    if (success && offset != data.GetByteSize ())
+        return SetError ("unsupported location expression");
+    return success;
+}
+
+bool
+GDBRemoteAgentExpressionCompiler::EmitFrameBase ()
+{
+    if (!m_sc.function)
+        return SetError ("no function for the frame base");
+
+    DWARFExpression &frame_base = m_sc.function->GetFrameBaseExpression ();
+    DataExtractor data;
+    if (frame_base.IsLocationList () || !frame_base.GetExpressionData (data))
+        return SetError ("unsupported frame base");
+
+    lldb::offset_t offset = 0;
+    const uint8_t op = data.GetU8 (&offset);
+    const RegisterKind reg_kind = static_cast<RegisterKind> (frame_base.GetRegisterKind ());
+    if (op >= DW_OP_reg0 && op <= DW_OP_reg31)
+        return EmitRegister (reg_kind, op - DW_OP_reg0);
+    if (op >= DW_OP_breg0 && op <= DW_OP_breg31)
+    {
+        if (!EmitRegister (reg_kind, op - DW_OP_breg0))
+            return false;
+        EmitOffset (data.GetSLEB128 (&offset));
+        return true;
+    }
+    if (op != DW_OP_call_frame_cfa)
+        return SetError ("unsupported frame base opcode 0x%2.2x", op);
+
+    // The frame base is the CFA, use the eh_frame row for the breakpoint
+    // address to find it from the registers.
+    ObjectFile *objfile = m_sc.module_sp ? m_sc.module_sp->GetObjectFile () : nullptr;
+    if (!objfile)
+        return SetError ("no object file for the frame base");
+    SymbolContext sc;
+    FuncUnwindersSP func_unwinders_sp (objfile->GetUnwindTable ().GetFuncUnwindersContainingAddress (m_address, sc));
+    if (!func_unwinders_sp)
+        return SetError ("no unwind information for the frame base");
+    const int current_offset = m_address.GetFileAddress () - func_unwinders_sp->GetFunctionStartAddress ().GetFileAddress ();
+    UnwindPlanSP unwind_plan_sp (func_unwinders_sp->GetEHFrameUnwindPlan (m_process.GetTarget (), current_offset));
+    UnwindPlan::RowSP row_sp;
+    if (unwind_plan_sp)
+        row_sp = unwind_plan_sp->GetRowForFunctionOffset (current_offset);
+    if (!row_sp || !row_sp->GetCFAValue ().IsRegisterPlusOffset ())
+        return SetError ("unsupported CFA for the frame base");
+
+    if (!EmitRegister (unwind_plan_sp->GetRegisterKind (), row_sp->GetCFAValue ().GetRegisterNumber ()))
+        return false;
+    EmitOffset (row_sp->GetCFAValue ().GetOffset ());
+    return true;
+}
+
+bool
+GDBRemoteAgentExpressionCompiler::EmitRegister (RegisterKind kind, uint32_t reg_num, uint32_t *byte_size)
+{
+    if (!m_reg_ctx_sp)
+        return SetError ("no registers available");
+
+    const uint32_t lldb_reg_num = m_reg_ctx_sp->ConvertRegisterKindToRegisterNumber (kind, reg_num);
+    const RegisterInfo *reg_info = lldb_reg_num != LLDB_INVALID_REGNUM ? m_reg_ctx_sp->GetRegisterInfoAtIndex (lldb_reg_num) : nullptr;
+    if (!reg_info)
+        return SetError ("unknown register %" PRIu32, reg_num);
+    if (reg_info->byte_size > 8)
+        return SetError ("register %s is too large", reg_info->name);
+
+    // The stub numbers registers the way it reported them.
+    uint32_t remote_reg_num = reg_info->kinds[eRegisterKindProcessPlugin];
+    if (remote_reg_num == LLDB_INVALID_REGNUM)
+        remote_reg_num = lldb_reg_num;
+    if (remote_reg_num > UINT16_MAX)
+        return SetError ("register %s can't be encoded", reg_info->name);
+
+    EmitOpcode (NativeAgentExpression::eOpReg);
+    m_bytecode.push_back (remote_reg_num >> 8);
+    m_bytecode.push_back (remote_reg_num & 0xff);
+    if (byte_size)
+        *byte_size = reg_info->byte_size;
+    return true;
+}
+
+bool
+GDBRemoteAgentExpressionCompiler::GetScalarType (const CompilerType &compiler_type, ValueType &type)
+{
+    if (!compiler_type.IsValid ())
+        return false;
+
+    const CompilerType canonical_type = compiler_type.GetCanonicalType ();
+    const uint64_t byte_size = canonical_type.GetByteSize (nullptr);
+    if (byte_size != 1 && byte_size != 2 && byte_size != 4 && byte_size != 8)
+        return false;
+
+    CompilerType pointee_type;
+    if (canonical_type.IsPointerType (&pointee_type))
+    {
+        type = ValueType (byte_size, false);
+        type.pointee_type = pointee_type;
+        return true;
+    }
+
+    bool is_signed = false;
+    if (canonical_type.IsIntegerType (is_signed))
+    {
+        type = ValueType (byte_size, is_signed);
+        return true;
+    }
+
+    const uint32_t type_info = canonical_type.GetTypeInfo ();
+    if (type_info & eTypeIsEnumeration)
+    {
+        type = ValueType (byte_size, (type_info & eTypeIsSigned) != 0);
+        return true;
+    }
+    return false;
+}
+
+void
+GDBRemoteAgentExpressionCompiler::EmitOpcode (uint8_t opcode)
+{
+    m_bytecode.push_back (opcode);
+}
+
+void
+GDBRemoteAgentExpressionCompiler::EmitConstant (uint64_t value)
+{
+    size_t byte_size = 8;
+    if (value <= UINT8_MAX)
+        byte_size = 1;
+    else if (value <= UINT16_MAX)
+        byte_size = 2;
+    else if (value <= UINT32_MAX)
+        byte_size = 4;
+
+    switch (byte_size)
+    {
+        case 1: EmitOpcode (NativeAgentExpression::eOpConst8); break;
+        case 2: EmitOpcode (NativeAgentExpression::eOpConst16); break;
+        case 4: EmitOpcode (NativeAgentExpression::eOpConst32); break;
+        default: EmitOpcode (NativeAgentExpression::eOpConst64); break;
+    }
+    for (size_t i = byte_size; i > 0; --i)
+        m_bytecode.push_back ((value >> ((i - 1) * 8)) & 0xff);
+}
+
+void
+GDBRemoteAgentExpressionCompiler::EmitOffset (int64_t offset)
+{
+    if (offset > 0)
+    {
+        EmitConstant (offset);
+        EmitOpcode (NativeAgentExpression::eOpAdd);
+    }
+    else if (offset < 0)
+    {
+        EmitConstant (0 - static_cast<uint64_t> (offset));
+        EmitOpcode (NativeAgentExpression::eOpSub);
+    }
+}
+
+void
+GDBRemoteAgentExpressionCompiler::EmitLoad (const ValueType &type)
+{
+    // Collect the memory the value is loaded from.
+    if (m_collecting)
+    {
+        EmitOpcode (NativeAgentExpression::eOpTraceQuick);
+        m_bytecode.push_back (type.byte_size);
+    }
+
+    switch (type.byte_size)
+    {
+        case 1: EmitOpcode (NativeAgentExpression::eOpRef8); break;
+        case 2: EmitOpcode (NativeAgentExpression::eOpRef16); break;
+        case 4: EmitOpcode (NativeAgentExpression::eOpRef32); break;
+        default: EmitOpcode (NativeAgentExpression::eOpRef64); break;
+    }
+    // The loaded value is zero extended.
+    EmitConversion (ValueType (8, false), type);
+}
+
+void
+GDBRemoteAgentExpressionCompiler::EmitConversion (const ValueType &from, const ValueType &to)
+{
+    // Values are kept extended to 64 bits, which only needs to be redone if
+    // the conversion truncates or changes the signedness.
+    if (to.byte_size >= 8)
+        return;
+    if (from.byte_size == to.byte_size && from.is_signed == to.is_signed)
+        return;
+    if (from.byte_size < to.byte_size && (!from.is_signed || to.is_signed))
+        return;
+
+    EmitOpcode (to.is_signed ? NativeAgentExpression::eOpExt : NativeAgentExpression::eOpZeroExt);
+    m_bytecode.push_back (to.byte_size * 8);
+}
+
+size_t
+GDBRemoteAgentExpressionCompiler::EmitJump (uint8_t opcode)
+{
+    EmitOpcode (opcode);
+    m_bytecode.push_back (0);
+    m_bytecode.push_back (0);
+    return m_bytecode.size () - 2;
+}
+
+bool
+GDBRemoteAgentExpressionCompiler::PatchJump (size_t jump_offset)
+{
+    const size_t target = m_bytecode.size ();
+    if (target > UINT16_MAX)
+        return SetError ("expression is too long");
+    m_bytecode[jump_offset] = target >> 8;
+    m_bytecode[jump_offset + 1] = target & 0xff;
+    return true;
+}
+
+bool
+GDBRemoteAgentExpressionCompiler::SetError (const char *format, ...)
+{
+    va_list args;
+    va_start (args, format);
+    m_error.SetErrorStringWithVarArg (format, args);
+    va_end (args);
+    return false;
+}
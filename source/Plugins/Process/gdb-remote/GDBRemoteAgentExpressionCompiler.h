@@ -0,0 +1,175 @@
+//===-- GDBRemoteAgentExpressionCompiler.h ----------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_GDBRemoteAgentExpressionCompiler_h_
+#define liblldb_GDBRemoteAgentExpressionCompiler_h_
+
+// C Includes
+// C++ Includes
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/Address.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Symbol/CompilerType.h"
+#include "lldb/Symbol/SymbolContext.h"
+
+namespace lldb_private {
+namespace process_gdb_remote {
+
+//----------------------------------------------------------------------
+/// @class GDBRemoteAgentExpressionCompiler
+/// @brief Compiles breakpoint conditions to agent expression bytecode.
+///
+/// Only a small C subset is supported: integer literals, scalar and
+/// pointer variables whose location is a register, a register relative
+/// or frame base relative address or a static address, $-prefixed
+/// register names, pointer dereferences and the arithmetic, bitwise,
+/// comparison and logical operators. Anything else fails to compile, in
+/// which case the condition has to be evaluated by the debugger.
+//----------------------------------------------------------------------
+class GDBRemoteAgentExpressionCompiler
+{
+public:
+    //------------------------------------------------------------------
+    /// @param[in] address
+    ///     The address of the breakpoint, which determines the variables
+    ///     that are in scope.
+    //------------------------------------------------------------------
+    GDBRemoteAgentExpressionCompiler (Process &process, const Address &address);
+
+    Error
+    Compile (const char *condition, std::vector<uint8_t> &bytecode);
+
+    //------------------------------------------------------------------
+    /// Compile a breakpoint command that collects \a item when the
+    /// breakpoint is hit.
+    ///
+    /// The registers the expression reads and the memory it loads values
+    /// from are collected. An "@<size>" suffix additionally collects
+    /// that many bytes at the address the expression evaluates to, e.g.
+    /// "$rsp@64".
+    //------------------------------------------------------------------
+    Error
+    CompileCollect (const char *item, std::vector<uint8_t> &bytecode);
+
+private:
+    // The type of a value on the agent expression stack. Values are kept
+    // sign or zero extended to 64 bits according to their type.
+    struct ValueType
+    {
+        ValueType (uint32_t size = 4, bool is_signed_value = true) :
+            byte_size (size),
+            is_signed (is_signed_value),
+            pointee_type ()
+        {
+        }
+
+        uint32_t byte_size;
+        bool is_signed;
+        CompilerType pointee_type; // Valid for pointers only
+    };
+
+    enum TokenKind
+    {
+        eTokenEnd,
+        eTokenNumber,
+        eTokenIdentifier,
+        eTokenRegister,
+        eTokenOperator
+    };
+
+    bool
+    ParseExpression (const char *expression);
+
+    void
+    EmitEnd (std::vector<uint8_t> &bytecode);
+
+    bool
+    NextToken ();
+
+    bool
+    IsOperator (const char *op) const;
+
+    bool
+    ParseBinary (int level, ValueType &type);
+
+    bool
+    ParseUnary (ValueType &type);
+
+    bool
+    ParsePrimary (ValueType &type);
+
+    bool
+    EmitBinaryOperator (const std::string &op, const ValueType &lhs, const ValueType &rhs, ValueType &type);
+
+    bool
+    EmitVariable (const ConstString &name, ValueType &type);
+
+    bool
+    EmitLocation (DWARFExpression &location, const SymbolContext &var_sc, bool &is_register);
+
+    bool
+    EmitFrameBase ();
+
+    bool
+    EmitRegister (lldb::RegisterKind kind, uint32_t reg_num, uint32_t *byte_size = nullptr);
+
+    bool
+    GetScalarType (const CompilerType &compiler_type, ValueType &type);
+
+    void
+    EmitOpcode (uint8_t opcode);
+
+    void
+    EmitConstant (uint64_t value);
+
+    void
+    EmitOffset (int64_t offset);
+
+    void
+    EmitLoad (const ValueType &type);
+
+    void
+    EmitConversion (const ValueType &from, const ValueType &to);
+
+    size_t
+    EmitJump (uint8_t opcode);
+
+    bool
+    PatchJump (size_t jump_offset);
+
+    bool
+    SetError (const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+
+    Process &m_process;
+    Address m_address;
+    SymbolContext m_sc;
+    lldb::RegisterContextSP m_reg_ctx_sp;
+    bool m_collecting;
+
+    const char *m_cursor;
+    TokenKind m_token_kind;
+    std::string m_token_text;
+    uint64_t m_token_value;
+    ValueType m_token_type;
+
+    std::vector<uint8_t> m_bytecode;
+    Error m_error;
+
+    DISALLOW_COPY_AND_ASSIGN (GDBRemoteAgentExpressionCompiler);
+};
+
+} // namespace process_gdb_remote
+} // namespace lldb_private
+
+#endif // liblldb_GDBRemoteAgentExpressionCompiler_h_
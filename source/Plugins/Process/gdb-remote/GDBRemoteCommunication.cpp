@@ -51,6 +51,10 @@
 #include <zlib.h>
 #endif
 
+#if defined (HAVE_LIBLZ4)
+#include <lz4.h>
+#endif
+
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::process_gdb_remote;
@@ -166,8 +170,11 @@ GDBRemoteCommunication::GDBRemoteCommunication(const char *comm_name,
     m_public_is_running (false),
     m_private_is_running (false),
     m_history (512),
+    m_packets_sent (0),
     m_send_acks (true),
     m_compression_type (CompressionType::None),
+    m_send_compression_type (CompressionType::None),
+    m_send_compression_minsize (384),
     m_listen_url ()
 {
 }
@@ -238,6 +245,14 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
 {
     if (IsConnected())
     {
+        std::string compressed_payload;
+        if (m_send_compression_type != CompressionType::None)
+        {
+            compressed_payload = CompressPayload (payload, payload_length);
+            payload = compressed_payload.data();
+            payload_length = compressed_payload.size();
+        }
+
         StreamString packet(0, 4, eByteOrderBig);
 
         packet.PutChar('$');
@@ -250,6 +265,7 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
         const char *packet_data = packet.GetData();
         const size_t packet_length = packet.GetSize();
         size_t bytes_written = Write (packet_data, packet_length, status, NULL);
+        ++m_packets_sent;
         if (log)
         {
             size_t binary_start_offset = 0;
@@ -307,6 +323,41 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
     return PacketResult::ErrorSendFailed;
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunication::SendNotificationPacketNoLock (const char *notify_type, const char *payload, size_t payload_length)
+{
+    if (!IsConnected())
+        return PacketResult::ErrorSendFailed;
+
+    std::string notification (notify_type);
+    notification.push_back (':');
+    notification.append (payload, payload_length);
+
+    StreamString packet(0, 4, eByteOrderBig);
+    packet.PutChar('%');
+    packet.Write (notification.data(), notification.size());
+    packet.PutChar('#');
+    packet.PutHex8(CalculcateChecksum (notification.data(), notification.size()));
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+    ConnectionStatus status = eConnectionStatusSuccess;
+    const char *packet_data = packet.GetData();
+    const size_t packet_length = packet.GetSize();
+    size_t bytes_written = Write (packet_data, packet_length, status, NULL);
+    if (log)
+        log->Printf("<%4" PRIu64 "> send notification: %.*s", (uint64_t)bytes_written, (int)packet_length, packet_data);
+
+    m_history.AddPacket (packet.GetString(), packet_length, History::ePacketTypeSend, bytes_written);
+
+    if (bytes_written != packet_length)
+    {
+        if (log)
+            log->Printf ("error: failed to send notification: %.*s", (int)packet_length, packet_data);
+        return PacketResult::ErrorSendFailed;
+    }
+    return PacketResult::Success;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunication::GetAck ()
 {
@@ -757,6 +808,21 @@ GDBRemoteCommunication::DecompressPacket ()
     }
 #endif
 
+#if defined (HAVE_LIBLZ4)
+    if (decompressed_bytes == 0
+        && decompressed_bufsize != ULONG_MAX
+        && decompressed_buffer != nullptr
+        && m_compression_type == CompressionType::LZ4)
+    {
+        const int decoded_size = LZ4_decompress_safe ((const char *) unescaped_content.data(),
+                                                      (char *) decompressed_buffer,
+                                                      (int) unescaped_content.size(),
+                                                      (int) decompressed_bufsize);
+        if (decoded_size > 0)
+            decompressed_bytes = decoded_size;
+    }
+#endif
+
     if (decompressed_bytes == 0 || decompressed_buffer == nullptr)
     {
         if (decompressed_buffer)
@@ -789,6 +855,79 @@ GDBRemoteCommunication::DecompressPacket ()
     return true;
 }
 
+std::string
+GDBRemoteCommunication::CompressPayload (const char *payload, size_t payload_length)
+{
+    // Small packets don't benefit from compression, the compression headers
+    // would likely make them bigger.
+    if (payload_length <= m_send_compression_minsize)
+        return "N" + std::string (payload, payload_length);
+
+    std::vector<uint8_t> encoded_data;
+    size_t compressed_size = 0;
+
+#if defined (HAVE_LIBZ)
+    if (m_send_compression_type == CompressionType::ZlibDeflate)
+    {
+        z_stream stream;
+        memset (&stream, 0, sizeof (z_stream));
+        stream.zalloc = Z_NULL;
+        stream.zfree = Z_NULL;
+        stream.opaque = Z_NULL;
+        if (deflateInit2 (&stream, 5, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK)
+        {
+            encoded_data.resize (deflateBound (&stream, payload_length));
+            stream.next_in = (Bytef *) payload;
+            stream.avail_in = (uInt) payload_length;
+            stream.next_out = (Bytef *) encoded_data.data();
+            stream.avail_out = (uInt) encoded_data.size();
+            if (deflate (&stream, Z_FINISH) == Z_STREAM_END)
+                compressed_size = stream.total_out;
+            deflateEnd (&stream);
+        }
+    }
+#endif
+
+#if defined (HAVE_LIBLZ4)
+    if (m_send_compression_type == CompressionType::LZ4)
+    {
+        encoded_data.resize (LZ4_compressBound (payload_length));
+        const int encoded_size = LZ4_compress_default (payload,
+                                                       (char *) encoded_data.data(),
+                                                       (int) payload_length,
+                                                       (int) encoded_data.size());
+        if (encoded_size > 0)
+            compressed_size = encoded_size;
+    }
+#endif
+
+    // Send the payload as is if it couldn't be compressed or if it didn't get any smaller.
+    if (compressed_size == 0 || compressed_size >= payload_length)
+        return "N" + std::string (payload, payload_length);
+
+    char size_str[32];
+    snprintf (size_str, sizeof (size_str), "C%" PRIu64 ":", (uint64_t) payload_length);
+
+    std::string compressed (size_str);
+    compressed.reserve (compressed.size() + compressed_size + compressed_size / 16);
+    for (size_t i = 0; i < compressed_size; ++i)
+    {
+        // Escape the characters that have a special meaning in the protocol,
+        // the same way binary data is escaped.
+        const uint8_t byte = encoded_data[i];
+        if (byte == '#' || byte == '$' || byte == '}' || byte == '*' || byte == '\0')
+        {
+            compressed.push_back (0x7d);
+            compressed.push_back (byte ^ 0x20);
+        }
+        else
+        {
+            compressed.push_back (byte);
+        }
+    }
+    return compressed;
+}
+
 GDBRemoteCommunication::PacketType
 GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, StringExtractorGDBRemote &packet)
 {
@@ -292,12 +292,15 @@ protected:
     Predicate<bool> m_public_is_running;
     Predicate<bool> m_private_is_running;
     History m_history;
+    uint32_t m_packets_sent;   // Number of packets sent, tells if anything was sent in between two points
     bool m_send_acks;
     bool m_is_platform; // Set to true if this class represents a platform,
                         // false if this class represents a debug session for
                         // a single process
     
-    CompressionType m_compression_type;
+    CompressionType m_compression_type;        // Compression of the packets we receive
+    CompressionType m_send_compression_type;   // Compression of the packets we send, requested by the remote side
+    size_t m_send_compression_minsize;         // Payloads up to this size are always sent uncompressed
 
     PacketResult
     SendPacket (const char *payload,
@@ -307,6 +310,13 @@ protected:
     SendPacketNoLock (const char *payload, 
                       size_t payload_length);
 
+    // Sends an asynchronous notification packet ("%<notify_type>:<payload>#xx").
+    // Notifications are never compressed and don't wait for an ack.
+    PacketResult
+    SendNotificationPacketNoLock (const char *notify_type,
+                                  const char *payload,
+                                  size_t payload_length);
+
     PacketResult
     ReadPacket (StringExtractorGDBRemote &response, uint32_t timeout_usec, bool sync_on_timeout);
 
@@ -338,6 +348,12 @@ protected:
     bool
     DecompressPacket ();
 
+    // Encode a packet payload for sending while m_send_compression_type is
+    // enabled. Returns either "N<payload>" when the payload is small or doesn't
+    // compress, or "C<size of payload in base10>:<escaped compressed payload>".
+    std::string
+    CompressPayload (const char *payload, size_t payload_length);
+
     Error
     StartListenThread (const char *hostname = "127.0.0.1", uint16_t port = 0);
 
@@ -22,6 +22,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/Triple.h"
 #include "lldb/Interpreter/Args.h"
+#include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/State.h"
@@ -85,6 +86,8 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient() :
     m_supports_qXfer_libraries_read (eLazyBoolCalculate),
     m_supports_qXfer_libraries_svr4_read (eLazyBoolCalculate),
     m_supports_qXfer_features_read (eLazyBoolCalculate),
+    m_supports_conditional_breakpoints (eLazyBoolCalculate),
+    m_supports_breakpoint_commands (eLazyBoolCalculate),
     m_supports_augmented_libraries_svr4_read (eLazyBoolCalculate),
     m_supports_jThreadExtendedInfo (eLazyBoolCalculate),
     m_supports_jLoadedDynamicLibrariesInfos (eLazyBoolCalculate),
@@ -102,6 +105,7 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient() :
     m_supports_QEnvironmentHexEncoded (true),
     m_supports_qSymbol (true),
     m_supports_jThreadsInfo (true),
+    m_supports_jMultiMemRead (true),
     m_curr_pid (LLDB_INVALID_PROCESS_ID),
     m_curr_tid (LLDB_INVALID_THREAD_ID),
     m_curr_tid_run (LLDB_INVALID_THREAD_ID),
@@ -112,6 +116,8 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient() :
     m_async_result (PacketResult::Success),
     m_async_response (),
     m_async_signal (-1),
+    m_prefetched_responses (),
+    m_prefetched_packets_sent (0),
     m_interrupt_sent (false),
     m_thread_id_to_used_usec_map (),
     m_host_arch(),
@@ -125,7 +131,8 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient() :
     m_gdb_server_name(),
     m_gdb_server_version(UINT32_MAX),
     m_default_packet_timeout (0),
-    m_max_packet_size (0)
+    m_max_packet_size (0),
+    m_compression_allowed (true)
 {
 }
 
@@ -238,6 +245,26 @@ GDBRemoteCommunicationClient::GetQXferFeaturesReadSupported ()
     return m_supports_qXfer_features_read == eLazyBoolYes;
 }
 
+bool
+GDBRemoteCommunicationClient::GetConditionalBreakpointsSupported ()
+{
+    if (m_supports_conditional_breakpoints == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_conditional_breakpoints == eLazyBoolYes;
+}
+
+bool
+GDBRemoteCommunicationClient::GetBreakpointCommandsSupported ()
+{
+    if (m_supports_breakpoint_commands == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_breakpoint_commands == eLazyBoolYes;
+}
+
 uint64_t
 GDBRemoteCommunicationClient::GetRemoteMaxPacketSize()
 {
@@ -337,6 +364,8 @@ GDBRemoteCommunicationClient::GetSyncThreadStateSupported ()
 void
 GDBRemoteCommunicationClient::ResetDiscoverableSettings (bool did_exec)
 {
+    m_prefetched_responses.clear();
+
     if (did_exec == false)
     {
         // Hard reset everything, this is when we first connect to a GDB server
@@ -362,6 +391,8 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings (bool did_exec)
         m_supports_qXfer_libraries_read = eLazyBoolCalculate;
         m_supports_qXfer_libraries_svr4_read = eLazyBoolCalculate;
         m_supports_qXfer_features_read = eLazyBoolCalculate;
+        m_supports_conditional_breakpoints = eLazyBoolCalculate;
+        m_supports_breakpoint_commands = eLazyBoolCalculate;
         m_supports_augmented_libraries_svr4_read = eLazyBoolCalculate;
         m_supports_qProcessInfoPID = true;
         m_supports_qfProcessInfo = true;
@@ -376,6 +407,7 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings (bool did_exec)
         m_supports_QEnvironment = true;
         m_supports_QEnvironmentHexEncoded = true;
         m_supports_qSymbol = true;
+        m_supports_jMultiMemRead = true;
         m_host_arch.Clear();
         m_os_version_major = UINT32_MAX;
         m_os_version_minor = UINT32_MAX;
@@ -395,6 +427,18 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings (bool did_exec)
     m_process_arch.Clear();
 }
 
+static void
+MakeQSupportedPacket (StreamString &packet)
+{
+    std::vector<std::string> features = {"xmlRegisters=i386,arm,mips"};
+    packet.PutCString( "qSupported" );
+    for ( uint32_t i = 0; i < features.size( ); ++i )
+    {
+        packet.PutCString( i==0 ? ":" : ";");
+        packet.PutCString( features[i].c_str( ) );
+    }
+}
+
 void
 GDBRemoteCommunicationClient::GetRemoteQSupported ()
 {
@@ -404,17 +448,12 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
     m_supports_qXfer_libraries_svr4_read = eLazyBoolNo;
     m_supports_augmented_libraries_svr4_read = eLazyBoolNo;
     m_supports_qXfer_features_read = eLazyBoolNo;
+    m_supports_conditional_breakpoints = eLazyBoolNo;
+    m_supports_breakpoint_commands = eLazyBoolNo;
     m_max_packet_size = UINT64_MAX;  // It's supposed to always be there, but if not, we assume no limit
 
-    // build the qSupported packet
-    std::vector<std::string> features = {"xmlRegisters=i386,arm,mips"};
     StreamString packet;
-    packet.PutCString( "qSupported" );
-    for ( uint32_t i = 0; i < features.size( ); ++i )
-    {
-        packet.PutCString( i==0 ? ":" : ";");
-        packet.PutCString( features[i].c_str( ) );
-    }
+    MakeQSupportedPacket (packet);
 
     StringExtractorGDBRemote response;
     if (SendPacketAndWaitForResponse(packet.GetData(),
@@ -435,6 +474,10 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
             m_supports_qXfer_libraries_read = eLazyBoolYes;
         if (::strstr (response_cstr, "qXfer:features:read+"))
             m_supports_qXfer_features_read = eLazyBoolYes;
+        if (::strstr (response_cstr, "ConditionalBreakpoints+"))
+            m_supports_conditional_breakpoints = eLazyBoolYes;
+        if (::strstr (response_cstr, "BreakpointCommands+"))
+            m_supports_breakpoint_commands = eLazyBoolYes;
 
 
         // Look for a list of compressions in the features list e.g.
@@ -634,6 +677,82 @@ GDBRemoteCommunicationClient::GetThreadsInfo()
     return object_sp;
 }
 
+StructuredData::ObjectSP
+GDBRemoteCommunicationClient::GetCollectedSamples()
+{
+    StructuredData::ObjectSP object_sp;
+
+    if (GetBreakpointCommandsSupported())
+    {
+        StringExtractorGDBRemote response;
+        if (SendPacketAndWaitForResponse("jCollectedSamples", response, false) == PacketResult::Success &&
+            !response.IsUnsupportedResponse() && !response.IsErrorResponse() && !response.Empty())
+        {
+            object_sp = StructuredData::ParseJSON (response.GetStringRef());
+        }
+    }
+    return object_sp;
+}
+
+// Read several memory ranges with one round trip.
+//  packet: "jMultiMemRead:ranges:<addr>,<size>[,<addr>,<size>]...;"
+//  reply:  "<bytes read>[,<bytes read>]...;<data>"
+// where <data> is the binary escaped bytes of all ranges one after the other.
+bool
+GDBRemoteCommunicationClient::MultiMemRead (const std::vector<std::pair<lldb::addr_t, size_t> > &ranges,
+                                            std::vector<lldb::DataBufferSP> &buffers)
+{
+    if (!m_supports_jMultiMemRead || ranges.empty())
+        return false;
+
+    StreamString packet;
+    packet.PutCString ("jMultiMemRead:ranges:");
+    for (size_t i = 0; i < ranges.size(); ++i)
+        packet.Printf ("%s%" PRIx64 ",%" PRIx64, i > 0 ? "," : "", (uint64_t)ranges[i].first, (uint64_t)ranges[i].second);
+    packet.PutChar (';');
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, true) != PacketResult::Success)
+        return false;
+
+    if (response.IsUnsupportedResponse())
+    {
+        m_supports_jMultiMemRead = false;
+        return false;
+    }
+    if (!response.IsNormalResponse())
+        return false;
+
+    // The lower level GDBRemoteCommunication packet receive layer has already
+    // de-quoted any 0x7d character escaping in the data.
+    std::vector<uint64_t> sizes;
+    while (response.GetBytesLeft() > 0 && response.PeekChar() != ';')
+    {
+        if (sizes.size() == ranges.size() || (!sizes.empty() && response.GetChar() != ','))
+            return false;
+        const uint64_t size = response.GetHexMaxU64 (false, UINT64_MAX);
+        if (size == UINT64_MAX || size > ranges[sizes.size()].second)
+            return false;
+        sizes.push_back (size);
+    }
+    if (sizes.size() != ranges.size() || response.GetChar() != ';')
+        return false;
+
+    const std::string &data = response.GetStringRef();
+    size_t data_offset = response.GetFilePos();
+    buffers.clear();
+    for (uint64_t size : sizes)
+    {
+        if (data_offset + size > data.size())
+            return false;
+        DataBufferSP buffer_sp;
+        if (size > 0)
+            buffer_sp.reset (new DataBufferHeap (data.data() + data_offset, size));
+        buffers.push_back (buffer_sp);
+        data_offset += size;
+    }
+    return true;
+}
 
 bool
 GDBRemoteCommunicationClient::GetThreadExtendedInfoSupported ()
@@ -756,6 +875,174 @@ GDBRemoteCommunicationClient::SendPacketAndWaitForResponse
                                          send_async);
 }
 
+GDBRemoteCommunicationClient::PacketResult
+GDBRemoteCommunicationClient::SendPacketsAndWaitForResponses (const std::vector<std::string> &payloads,
+                                                              std::vector<StringExtractorGDBRemote> &responses,
+                                                              bool send_async)
+{
+    // Bound the number of packets in flight so the responses the remote
+    // stub can't send yet don't stall it while we are still sending.
+    const size_t max_packets_in_flight = 16;
+
+    responses.clear();
+    responses.resize (payloads.size());
+
+    Mutex::Locker locker;
+    if (GetSendAcks() || !GetSequenceMutex (locker))
+    {
+        // Every packet has to be acked before the next one is sent, or the
+        // process is running and the packets have to be sent asynchronously.
+        for (size_t i = 0; i < payloads.size(); ++i)
+        {
+            PacketResult packet_result = SendPacketAndWaitForResponse (payloads[i].data(),
+                                                                       payloads[i].size(),
+                                                                       responses[i],
+                                                                       send_async);
+            if (packet_result != PacketResult::Success)
+            {
+                responses.resize (i);
+                responses.resize (payloads.size());
+                return packet_result;
+            }
+        }
+        return PacketResult::Success;
+    }
+
+    // Hijack the notifications like SendPacketAndWaitForResponse() does.
+    static Listener hijack_listener("lldb.NotifyHijacker");
+    HijackBroadcaster(&hijack_listener, eBroadcastBitGdbReadThreadGotNotify);
+
+    PacketResult packet_result = PacketResult::Success;
+    size_t failed_idx = payloads.size();
+    bool timed_out = false;
+    size_t num_sent = 0;
+    size_t num_received = 0;
+    while (num_received < num_sent || (failed_idx == payloads.size() && num_sent < payloads.size()))
+    {
+        if (failed_idx == payloads.size() && num_sent < payloads.size() && num_sent - num_received < max_packets_in_flight)
+        {
+            PacketResult send_result = SendPacketNoLock (payloads[num_sent].data(), payloads[num_sent].size());
+            if (send_result == PacketResult::Success)
+                ++num_sent;
+            else
+            {
+                packet_result = send_result;
+                failed_idx = num_sent;
+            }
+            continue;
+        }
+
+        // Don't sync up with the remote stub on a timeout while responses
+        // are still in flight, they would be taken for the sync response.
+        PacketResult read_result = ReadPacket (responses[num_received], GetPacketTimeoutInMicroSeconds(), false);
+        if (read_result != PacketResult::Success)
+        {
+            if (read_result == PacketResult::ErrorReplyTimeout)
+                timed_out = true;
+            if (num_received < failed_idx)
+            {
+                packet_result = read_result;
+                failed_idx = num_received;
+            }
+        }
+        ++num_received;
+    }
+
+    // A late response would be taken for the response to the next packet,
+    // so consume it or sync up once all the other responses are in.
+    if (timed_out)
+    {
+        StringExtractorGDBRemote late_response;
+        ReadPacket (late_response, GetPacketTimeoutInMicroSeconds(), true);
+    }
+
+    // The responses after a failed packet can't be trusted to match.
+    if (failed_idx < payloads.size())
+    {
+        responses.resize (failed_idx);
+        responses.resize (payloads.size());
+    }
+
+    // Remove our Hijacking listener from the broadcast.
+    RestoreBroadcaster();
+
+    // If a notification event occurred, rebroadcast since it can now be processed safely.
+    EventSP event_sp;
+    if (hijack_listener.GetNextEvent(event_sp))
+        BroadcastEvent(event_sp);
+
+    return packet_result;
+}
+
+void
+GDBRemoteCommunicationClient::PrefetchServerInfo ()
+{
+    // The qSupported response may make us send QEnableCompression, and any
+    // packet sent after the prefetch invalidates its responses. So
+    // negotiate the features first, the other responses then arrive
+    // compressed already.
+    if (m_supports_qEcho == eLazyBoolCalculate && !GetSendAcks())
+        GetRemoteQSupported ();
+
+    std::vector<std::string> payloads;
+    if (m_supports_thread_suffix == eLazyBoolCalculate)
+        payloads.push_back ("QThreadSuffixSupported");
+    if (m_supports_threads_in_stop_reply == eLazyBoolCalculate)
+        payloads.push_back ("QListThreadsInStopReply");
+    if (m_qHostInfo_is_valid == eLazyBoolCalculate)
+        payloads.push_back ("qHostInfo");
+    if (m_supports_vCont_c == eLazyBoolCalculate)
+        payloads.push_back ("vCont?");
+    if (m_attach_or_wait_reply == eLazyBoolCalculate)
+        payloads.push_back ("qVAttachOrWaitSupported");
+    if (m_qProcessInfo_is_valid == eLazyBoolCalculate)
+        payloads.push_back ("qProcessInfo");
+
+    // Nothing is gained over sending the packets when they are needed if
+    // they can't be pipelined.
+    if (payloads.size() < 2 || GetSendAcks())
+        return;
+
+    Mutex::Locker locker;
+    if (!GetSequenceMutex (locker, "failed to get the sequence mutex to prefetch the server info"))
+        return;
+
+    std::vector<StringExtractorGDBRemote> responses;
+    SendPacketsAndWaitForResponses (payloads, responses, false);
+
+    m_prefetched_responses.clear();
+    m_prefetched_packets_sent = m_packets_sent;
+    for (size_t i = 0; i < payloads.size(); ++i)
+    {
+        if (!responses[i].Empty())
+            m_prefetched_responses[payloads[i]] = responses[i];
+    }
+}
+
+bool
+GDBRemoteCommunicationClient::GetPrefetchedResponse (const char *payload,
+                                                     size_t payload_length,
+                                                     StringExtractorGDBRemote &response)
+{
+    if (m_prefetched_responses.empty())
+        return false;
+
+    // Any packet sent since the prefetch may have changed the responses.
+    if (m_prefetched_packets_sent != m_packets_sent)
+    {
+        m_prefetched_responses.clear();
+        return false;
+    }
+
+    auto pos = m_prefetched_responses.find (std::string (payload, payload_length));
+    if (pos == m_prefetched_responses.end())
+        return false;
+
+    response = pos->second;
+    m_prefetched_responses.erase (pos);
+    return true;
+}
+
 GDBRemoteCommunicationClient::PacketResult
 GDBRemoteCommunicationClient::SendPacketAndWaitForResponseNoLock (const char *payload,
                                                                   size_t payload_length,
@@ -787,7 +1074,10 @@ GDBRemoteCommunicationClient::SendPacketAndWaitForResponse
 
     if (GetSequenceMutex (locker))
     {
-        packet_result = SendPacketAndWaitForResponseNoLock (payload, payload_length, response);
+        if (GetPrefetchedResponse (payload, payload_length, response))
+            packet_result = PacketResult::Success;
+        else
+            packet_result = SendPacketAndWaitForResponseNoLock (payload, payload_length, response);
     }
     else
     {
@@ -1822,6 +2112,9 @@ GDBRemoteCommunicationClient::MaybeEnableCompression (std::vector<std::string> s
     CompressionType avail_type = CompressionType::None;
     std::string avail_name;
 
+    if (!m_compression_allowed)
+        return;
+
 #if defined (HAVE_LIBCOMPRESSION)
     // libcompression is weak linked so test if compression_decode_buffer() is available
     if (compression_decode_buffer != NULL && avail_type == CompressionType::None)
@@ -1885,6 +2178,21 @@ GDBRemoteCommunicationClient::MaybeEnableCompression (std::vector<std::string> s
     }
 #endif
 
+#if defined (HAVE_LIBLZ4)
+    if (avail_type == CompressionType::None)
+    {
+        for (auto compression : supported_compressions)
+        {
+            if (compression == "lz4")
+            {
+                avail_type = CompressionType::LZ4;
+                avail_name = compression;
+                break;
+            }
+        }
+    }
+#endif
+
 #if defined (HAVE_LIBCOMPRESSION)
     // libcompression is weak linked so test if compression_decode_buffer() is available
     if (compression_decode_buffer != NULL && avail_type == CompressionType::None)
@@ -3545,7 +3853,9 @@ GDBRemoteCommunicationClient::GetThreadStopInfo (lldb::tid_t tid, StringExtracto
 
 
 uint8_t
-GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type, bool insert,  addr_t addr, uint32_t length)
+GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type, bool insert,  addr_t addr, uint32_t length,
+                                                          const std::vector<std::vector<uint8_t>> *conditions,
+                                                          const std::vector<std::vector<uint8_t>> *commands)
 {
     Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
     if (log)
@@ -3556,19 +3866,30 @@ GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type,
     if (!SupportsGDBStoppointPacket(type))
         return UINT8_MAX;
     // Construct the breakpoint packet
-    char packet[64];
-    const int packet_len = ::snprintf (packet, 
-                                       sizeof(packet), 
-                                       "%c%i,%" PRIx64 ",%x",
-                                       insert ? 'Z' : 'z', 
-                                       type, 
-                                       addr, 
-                                       length);
-    // Check we haven't overwritten the end of the packet buffer
-    assert (packet_len + 1 < (int)sizeof(packet));
+    StreamString packet;
+    packet.Printf ("%c%i,%" PRIx64 ",%x", insert ? 'Z' : 'z', type, addr, length);
+    // Append the conditions as ";X<len>,<bytecode>" agent expressions
+    if (insert && conditions && GetConditionalBreakpointsSupported ())
+    {
+        for (const std::vector<uint8_t> &condition : *conditions)
+        {
+            packet.Printf (";X%" PRIx64 ",", (uint64_t)condition.size ());
+            packet.PutBytesAsRawHex8 (condition.data (), condition.size ());
+        }
+    }
+    // Append the commands as ";cmds:<persist>,X<len>,<bytecode>..."
+    if (insert && commands && !commands->empty () && GetBreakpointCommandsSupported ())
+    {
+        packet.PutCString (";cmds:0,");
+        for (const std::vector<uint8_t> &command : *commands)
+        {
+            packet.Printf ("X%" PRIx64 ",", (uint64_t)command.size ());
+            packet.PutBytesAsRawHex8 (command.data (), command.size ());
+        }
+    }
     StringExtractorGDBRemote response;
     // Try to send the breakpoint packet, and check that it was correctly sent
-    if (SendPacketAndWaitForResponse(packet, packet_len, response, true) == PacketResult::Success)
+    if (SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, true) == PacketResult::Success)
     {
         // Receive and OK packet when the breakpoint successfully placed
         if (response.IsOKResponse())
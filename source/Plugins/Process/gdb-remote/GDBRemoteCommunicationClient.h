@@ -52,6 +52,42 @@ public:
                                   StringExtractorGDBRemote &response,
                                   bool send_async);
 
+    //------------------------------------------------------------------
+    /// Send several packets without waiting for the response to one
+    /// packet before sending the next.
+    ///
+    /// The remote stub answers packets in the order they were received,
+    /// so the responses are matched to the packets by position. This
+    /// saves a round trip per packet for independent queries. Packets
+    /// can only be pipelined once acks are disabled, otherwise they are
+    /// sent one at a time.
+    ///
+    /// @param[out] responses
+    ///     The responses, one per payload.
+    ///
+    /// @return
+    ///     The result of the first packet that failed, in which case
+    ///     the responses from that packet on are empty.
+    //------------------------------------------------------------------
+    PacketResult
+    SendPacketsAndWaitForResponses (const std::vector<std::string> &payloads,
+                                    std::vector<StringExtractorGDBRemote> &responses,
+                                    bool send_async);
+
+    //------------------------------------------------------------------
+    /// Pipeline the queries about the remote stub and process that are
+    /// made right after connecting.
+    ///
+    /// qSupported is sent on its own first, since its response can
+    /// enable compression, which takes another packet.
+    ///
+    /// The responses are kept and returned by
+    /// SendPacketAndWaitForResponse when the corresponding packets are
+    /// sent, as long as no other packet was sent in between.
+    //------------------------------------------------------------------
+    void
+    PrefetchServerInfo ();
+
     // For packets which specify a range of output to be returned,
     // return all of the output via a series of request packets of the form
     // <prefix>0,<size>
@@ -402,11 +438,39 @@ public:
         }
     }
 
+    //------------------------------------------------------------------
+    /// Insert or remove a breakpoint or watchpoint.
+    ///
+    /// @param[in] conditions
+    ///     Agent expression bytecode for each condition of an inserted
+    ///     breakpoint, only sent if GetConditionalBreakpointsSupported ()
+    ///     returns true. The stub reports a hit of the breakpoint only if
+    ///     one of them evaluates to non-zero.
+    ///
+    /// @param[in] commands
+    ///     Agent expression bytecode run by the stub on each hit of an
+    ///     inserted breakpoint whose conditions are true, only sent if
+    ///     GetBreakpointCommandsSupported () returns true. Hits of a
+    ///     breakpoint with commands are not reported.
+    ///
+    /// @return
+    ///     Zero on success, the error code of the stub if it failed to
+    ///     insert or remove the stoppoint, or UINT8_MAX if the packet is
+    ///     not supported or no response was received.
+    //------------------------------------------------------------------
     uint8_t
     SendGDBStoppointTypePacket (GDBStoppointType type,   // Type of breakpoint or watchpoint
                                 bool insert,              // Insert or remove?
                                 lldb::addr_t addr,        // Address of breakpoint or watchpoint
-                                uint32_t length);         // Byte Size of breakpoint or watchpoint
+                                uint32_t length,          // Byte Size of breakpoint or watchpoint
+                                const std::vector<std::vector<uint8_t>> *conditions = nullptr,
+                                const std::vector<std::vector<uint8_t>> *commands = nullptr);
+
+    bool
+    GetConditionalBreakpointsSupported ();
+
+    bool
+    GetBreakpointCommandsSupported ();
 
     bool
     SetNonStopMode (const bool enable);
@@ -552,6 +616,34 @@ public:
     StructuredData::ObjectSP
     GetThreadsInfo();
 
+    //------------------------------------------------------------------
+    /// Drain the samples collected by breakpoint commands with the
+    /// jCollectedSamples packet. The stub returns a bounded number of
+    /// samples at a time, call this until no samples are returned.
+    ///
+    /// @return
+    ///     A dictionary with the "dropped" sample count and the "samples"
+    ///     array, or an empty object pointer if the stub doesn't support
+    ///     the packet.
+    //------------------------------------------------------------------
+    StructuredData::ObjectSP
+    GetCollectedSamples();
+
+    //------------------------------------------------------------------
+    /// Read several memory ranges with a single jMultiMemRead packet.
+    ///
+    /// @param[out] buffers
+    ///     One buffer per range with the bytes that could be read from
+    ///     the start of it, or an empty buffer if none could be read.
+    ///
+    /// @return
+    ///     False if the packet failed or isn't supported by the remote
+    ///     stub, in which case the ranges need to be read one by one.
+    //------------------------------------------------------------------
+    bool
+    MultiMemRead (const std::vector<std::pair<lldb::addr_t, size_t> > &ranges,
+                  std::vector<lldb::DataBufferSP> &buffers);
+
     bool
     GetThreadExtendedInfoSupported();
 
@@ -572,6 +664,15 @@ public:
     void
     ServeSymbolLookups(lldb_private::Process *process);
 
+    // Compression is only worth its cost on slow connections, so it can be
+    // turned off for debug servers that run on the local host. This needs
+    // to be set before the qSupported handshake.
+    void
+    SetCompressionAllowed (bool allowed)
+    {
+        m_compression_allowed = allowed;
+    }
+
 protected:
     LazyBool m_supports_not_sending_acks;
     LazyBool m_supports_thread_suffix;
@@ -601,6 +702,8 @@ protected:
     LazyBool m_supports_qXfer_libraries_read;
     LazyBool m_supports_qXfer_libraries_svr4_read;
     LazyBool m_supports_qXfer_features_read;
+    LazyBool m_supports_conditional_breakpoints;
+    LazyBool m_supports_breakpoint_commands;
     LazyBool m_supports_augmented_libraries_svr4_read;
     LazyBool m_supports_jThreadExtendedInfo;
     LazyBool m_supports_jLoadedDynamicLibrariesInfos;
@@ -619,7 +722,8 @@ protected:
         m_supports_QEnvironment:1,
         m_supports_QEnvironmentHexEncoded:1,
         m_supports_qSymbol:1,
-        m_supports_jThreadsInfo:1;
+        m_supports_jThreadsInfo:1,
+        m_supports_jMultiMemRead:1;
     
     lldb::pid_t m_curr_pid;
     lldb::tid_t m_curr_tid;         // Current gdb remote protocol thread index for all other operations
@@ -635,6 +739,10 @@ protected:
     PacketResult m_async_result;
     StringExtractorGDBRemote m_async_response;
     int m_async_signal; // We were asked to deliver a signal to the inferior process.
+    // Responses to the packets sent by PrefetchServerInfo(), keyed by
+    // payload, and the packet count they are valid for.
+    std::map<std::string, StringExtractorGDBRemote> m_prefetched_responses;
+    uint32_t m_prefetched_packets_sent;
     bool m_interrupt_sent;
     std::string m_partial_profile_data;
     std::map<uint64_t, uint32_t> m_thread_id_to_used_usec_map;
@@ -651,12 +759,18 @@ protected:
     uint32_t m_gdb_server_version; // from reply to qGDBServerVersion, zero if qGDBServerVersion is not supported
     uint32_t m_default_packet_timeout;
     uint64_t m_max_packet_size;  // as returned by qSupported
+    bool m_compression_allowed;  // false to never enable the compressions offered in qSupported
 
     PacketResult
     SendPacketAndWaitForResponseNoLock (const char *payload,
                                         size_t payload_length,
                                         StringExtractorGDBRemote &response);
 
+    bool
+    GetPrefetchedResponse (const char *payload,
+                           size_t payload_length,
+                           StringExtractorGDBRemote &response);
+
     bool
     GetCurrentProcessInfo (bool allow_lazy_pid = true);
 
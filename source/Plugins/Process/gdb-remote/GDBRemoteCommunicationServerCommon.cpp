@@ -67,6 +67,8 @@ GDBRemoteCommunicationServerCommon::GDBRemoteCommunicationServerCommon(const cha
 {
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_A,
                                   &GDBRemoteCommunicationServerCommon::Handle_A);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QEnableCompression,
+                                  &GDBRemoteCommunicationServerCommon::Handle_QEnableCompression);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QEnvironment,
                                   &GDBRemoteCommunicationServerCommon::Handle_QEnvironment);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QEnvironmentHexEncoded,
@@ -838,8 +840,25 @@ GDBRemoteCommunicationServerCommon::Handle_qSupported (StringExtractorGDBRemote
     response.PutCString (";qEcho+");
 #if defined(__linux__)
     response.PutCString (";qXfer:auxv:read+");
+    response.PutCString (";qXfer:features:read+");
+    response.PutCString (";qXfer:libraries-svr4:read+");
+    response.PutCString (";ConditionalBreakpoints+");
+    response.PutCString (";BreakpointCommands+");
 #endif
 
+    // Offer packet compression, the client only enables it for slow connections.
+    std::string compressions;
+#if defined(HAVE_LIBZ)
+    compressions += ",zlib-deflate";
+#endif
+#if defined(HAVE_LIBLZ4)
+    compressions += ",lz4";
+#endif
+    if (!compressions.empty())
+        response.Printf (";SupportedCompressions=%s;DefaultCompressionMinSize=%" PRIu64,
+                         compressions.c_str() + 1,
+                         (uint64_t)m_send_compression_minsize);
+
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
@@ -877,6 +896,50 @@ GDBRemoteCommunicationServerCommon::Handle_QStartNoAckMode (StringExtractorGDBRe
     return packet_result;
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerCommon::Handle_QEnableCompression (StringExtractorGDBRemote &packet)
+{
+    // QEnableCompression:type:<name>;[minsize:<base10 size>;]
+    packet.SetFilePos(::strlen ("QEnableCompression:"));
+
+    CompressionType compression_type = CompressionType::None;
+    size_t compression_minsize = m_send_compression_minsize;
+    std::string name;
+    std::string value;
+    while (packet.GetNameColonValue(name, value))
+    {
+        if (name == "type")
+        {
+#if defined(HAVE_LIBZ)
+            if (value == "zlib-deflate")
+                compression_type = CompressionType::ZlibDeflate;
+#endif
+#if defined(HAVE_LIBLZ4)
+            if (value == "lz4")
+                compression_type = CompressionType::LZ4;
+#endif
+        }
+        else if (name == "minsize")
+        {
+            bool success = false;
+            const uint64_t minsize = StringConvert::ToUInt64 (value.c_str(), 0, 10, &success);
+            if (!success)
+                return SendIllFormedResponse (packet, "QEnableCompression: invalid minsize");
+            compression_minsize = minsize;
+        }
+    }
+
+    if (compression_type == CompressionType::None)
+        return SendErrorResponse (88);
+
+    // Send the response uncompressed before enabling compression, the client
+    // only starts expecting compressed packets once it has seen the "OK".
+    PacketResult packet_result = SendOKResponse ();
+    m_send_compression_type = compression_type;
+    m_send_compression_minsize = compression_minsize;
+    return packet_result;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerCommon::Handle_QSetSTDIN (StringExtractorGDBRemote &packet)
 {
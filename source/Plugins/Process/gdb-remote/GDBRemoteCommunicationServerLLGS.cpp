@@ -18,12 +18,17 @@
 // C++ Includes
 #include <cstring>
 #include <chrono>
+#include <map>
 #include <thread>
+#include <tuple>
+#include <vector>
 
 // Other libraries and framework includes
+#include "llvm/ADT/StringRef.h"
 #include "llvm/ADT/Triple.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/RegisterValue.h"
 #include "lldb/Core/State.h"
@@ -73,6 +78,14 @@ namespace
     };
 }
 
+// The maximum number of bytes returned for all ranges of a jMultiMemRead
+// packet together.
+static const size_t k_max_multi_mem_read_size = 1024 * 1024;
+
+// The maximum accounted size of the samples returned by one jCollectedSamples
+// packet, the rest stay in the buffer for the next one.
+static const size_t k_max_collected_samples_size = 256 * 1024;
+
 //----------------------------------------------------------------------
 // GDBRemoteCommunicationServerLLGS constructor
 //----------------------------------------------------------------------
@@ -89,10 +102,14 @@ GDBRemoteCommunicationServerLLGS::GDBRemoteCommunicationServerLLGS(
     m_stdio_communication ("process.stdio"),
     m_inferior_prev_state (StateType::eStateInvalid),
     m_active_auxv_buffer_sp (),
+    m_active_libraries_svr4_buffer_sp (),
+    m_active_target_xml_buffer_sp (),
     m_saved_registers_mutex (),
     m_saved_registers_map (),
     m_next_saved_registers_id (1),
-    m_handshake_completed (false)
+    m_handshake_completed (false),
+    m_non_stop (false),
+    m_stop_notification_queue ()
 {
     assert(platform_sp);
     RegisterPacketHandlers();
@@ -133,6 +150,8 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qMemoryRegionInfoSupported,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfoSupported);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QNonStop,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_QNonStop);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qProcessInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qProcessInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qRegisterInfo,
@@ -145,16 +164,26 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_QSetDisableASLR);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QSetWorkingDir,
                                   &GDBRemoteCommunicationServerLLGS::Handle_QSetWorkingDir);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qShlibInfoAddr,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qShlibInfoAddr);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qsThreadInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qsThreadInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qThreadStopInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qThreadStopInfo);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_jCollectedSamples,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_jCollectedSamples);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_jMultiMemRead,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_jMultiMemRead);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_jThreadsInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_jThreadsInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qWatchpointSupportInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qWatchpointSupportInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qXfer_auxv_read,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qXfer_auxv_read);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qXfer_libraries_svr4_read,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qXfer_libraries_svr4_read);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qXfer_features_read,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qXfer_features_read);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_s,
                                   &GDBRemoteCommunicationServerLLGS::Handle_s);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_stop_reason,
@@ -165,6 +194,8 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_vCont);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_vCont_actions,
                                   &GDBRemoteCommunicationServerLLGS::Handle_vCont_actions);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_vStopped,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_vStopped);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_x,
                                   &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_Z,
@@ -225,6 +256,13 @@ GDBRemoteCommunicationServerLLGS::LaunchProcess ()
         return error;
     }
 
+    if (m_non_stop)
+    {
+        error = m_debugged_process_sp->SetNonStopMode (true);
+        if (error.Fail ())
+            return error;
+    }
+
     // Handle mirroring of inferior stdout/stderr over the gdb-remote protocol
     // as needed.
     // llgs local-process debugging may specify PTY paths, which will make these
@@ -291,6 +329,13 @@ GDBRemoteCommunicationServerLLGS::AttachToProcess (lldb::pid_t pid)
         return error;
     }
 
+    if (m_non_stop)
+    {
+        error = m_debugged_process_sp->SetNonStopMode (true);
+        if (error.Fail ())
+            return error;
+    }
+
     // Setup stdout/stderr mapping from inferior.
     auto terminal_fd = m_debugged_process_sp->GetTerminalFileDescriptor ();
     if (terminal_fd >= 0)
@@ -328,6 +373,14 @@ GDBRemoteCommunicationServerLLGS::InitializeDelegate (NativeProcessProtocol *pro
 
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::SendWResponse (NativeProcessProtocol *process)
+{
+    StreamGDBRemote response;
+    PrepareWResponse (process, response);
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
+void
+GDBRemoteCommunicationServerLLGS::PrepareWResponse (NativeProcessProtocol *process, StreamString &response)
 {
     assert (process && "process cannot be NULL");
     Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
@@ -343,18 +396,14 @@ GDBRemoteCommunicationServerLLGS::SendWResponse (NativeProcessProtocol *process)
         if (log)
             log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 ", failed to retrieve process exit status", __FUNCTION__, process->GetID ());
 
-        StreamGDBRemote response;
         response.PutChar ('E');
         response.PutHex8 (GDBRemoteServerError::eErrorExitStatus);
-        return SendPacketNoLock(response.GetData(), response.GetSize());
     }
     else
     {
         if (log)
             log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 ", returning exit type %d, return code %d [%s]", __FUNCTION__, process->GetID (), exit_type, return_code, exit_description.c_str ());
 
-        StreamGDBRemote response;
-
         char return_type_code;
         switch (exit_type)
         {
@@ -375,8 +424,6 @@ GDBRemoteCommunicationServerLLGS::SendWResponse (NativeProcessProtocol *process)
 
         // POSIX exit status limited to unsigned 8 bits.
         response.PutHex8 (return_code);
-
-        return SendPacketNoLock(response.GetData(), response.GetSize());
     }
 }
 
@@ -396,6 +443,23 @@ AppendHexValue (StreamString &response, const uint8_t* buf, uint32_t buf_size, b
     }
 }
 
+static void
+AppendEscapedXMLAttribute (StreamString &response, const std::string &value)
+{
+    for (char ch : value)
+    {
+        switch (ch)
+        {
+        case '&':  response.PutCString ("&amp;"); break;
+        case '<':  response.PutCString ("&lt;"); break;
+        case '>':  response.PutCString ("&gt;"); break;
+        case '"':  response.PutCString ("&quot;"); break;
+        case '\'': response.PutCString ("&apos;"); break;
+        default:   response.PutChar (ch); break;
+        }
+    }
+}
+
 static void
 WriteRegisterValueInHexFixedWidth (StreamString &response,
                                    NativeRegisterContextSP &reg_ctx_sp,
@@ -497,6 +561,86 @@ GetRegistersAsJSON(NativeThreadProtocol &thread, bool abridged)
     return register_object_sp;
 }
 
+// Inferior memory that is sent along with the stop information, keyed by address, so the
+// client can prime its memory cache and backtrace without reading the frame pointer chain
+// one frame at a time.
+typedef std::map<lldb::addr_t, std::vector<uint8_t>> ExpeditedMemoryMap;
+
+// The number of bytes starting at the PC of a thread that are expedited.
+static const size_t k_expedited_pc_bytes = 32;
+
+static void
+ReadExpeditedMemory(NativeProcessProtocol &process, NativeThreadProtocol &thread,
+                    uint32_t backtrace_limit, ExpeditedMemoryMap &memory_map)
+{
+    NativeRegisterContextSP reg_ctx_sp = thread.GetRegisterContext ();
+    if (!reg_ctx_sp)
+        return;
+
+    ArchSpec arch;
+    if (!process.GetArchitecture (arch))
+        return;
+    const uint32_t addr_size = arch.GetAddressByteSize ();
+    if (addr_size != 4 && addr_size != 8)
+        return;
+
+    // The instructions at the PC.
+    const lldb::addr_t pc = reg_ctx_sp->GetPC ();
+    if (pc != LLDB_INVALID_ADDRESS)
+    {
+        std::vector<uint8_t> bytes (k_expedited_pc_bytes);
+        size_t bytes_read = 0;
+        if (process.ReadMemoryWithoutTrap (pc, bytes.data (), bytes.size (), bytes_read).Success () && bytes_read > 0)
+        {
+            bytes.resize (bytes_read);
+            memory_map[pc].swap (bytes);
+        }
+    }
+
+    // Walk the frame pointer chain. Each frame record holds the caller's frame pointer followed
+    // by the return address.
+    lldb::addr_t fp = reg_ctx_sp->GetFP (0);
+    uint32_t frame_count = 0;
+    while (fp != 0 && fp != LLDB_INVALID_ADDRESS)
+    {
+        // Don't walk too far or store too much memory in the expedited cache.
+        if (++frame_count > backtrace_limit)
+            break;
+
+        // Make sure we don't loop on a corrupt chain.
+        if (memory_map.find (fp) != memory_map.end ())
+            break;
+
+        std::vector<uint8_t> bytes (2 * addr_size);
+        size_t bytes_read = 0;
+        if (process.ReadMemoryWithoutTrap (fp, bytes.data (), bytes.size (), bytes_read).Fail () ||
+            bytes_read != bytes.size ())
+            break;
+
+        // lldb-server debugs native processes, so the memory is in host byte order.
+        lldb::addr_t caller_fp;
+        if (addr_size == 4)
+        {
+            uint32_t caller_fp32;
+            memcpy (&caller_fp32, bytes.data (), sizeof (caller_fp32));
+            caller_fp = caller_fp32;
+        }
+        else
+        {
+            uint64_t caller_fp64;
+            memcpy (&caller_fp64, bytes.data (), sizeof (caller_fp64));
+            caller_fp = caller_fp64;
+        }
+
+        memory_map[fp].swap (bytes);
+
+        // The stack grows down, so the caller's frame record must be above this one.
+        if (caller_fp <= fp)
+            break;
+        fp = caller_fp;
+    }
+}
+
 static const char *
 GetStopReasonString(StopReason stop_reason)
 {
@@ -592,7 +736,27 @@ GetJSONThreadsInfo(NativeProcessProtocol &process, bool abridged)
             thread_obj_sp->SetObject("medata", medata_array_sp);
         }
 
-        // TODO: Expedite interesting regions of inferior memory
+        // Expedite the frame pointer chain so a backtrace of any thread doesn't need to read
+        // memory. Skipped for the abridged info that goes into stop replies to keep them small.
+        if (!abridged)
+        {
+            ExpeditedMemoryMap memory_map;
+            ReadExpeditedMemory (process, *thread_sp, 256, memory_map);
+            if (!memory_map.empty ())
+            {
+                JSONArray::SP memory_array_sp = std::make_shared<JSONArray>();
+                for (const auto &memory : memory_map)
+                {
+                    JSONObject::SP memory_obj_sp = std::make_shared<JSONObject>();
+                    memory_obj_sp->SetObject("address", std::make_shared<JSONNumber>(memory.first));
+                    StreamString bytes;
+                    AppendHexValue (bytes, memory.second.data (), memory.second.size (), false);
+                    memory_obj_sp->SetObject("bytes", std::make_shared<JSONString>(bytes.GetString()));
+                    memory_array_sp->AppendObject(memory_obj_sp);
+                }
+                thread_obj_sp->SetObject("memory", memory_array_sp);
+            }
+        }
     }
 
     return threads_array_sp;
@@ -616,11 +780,25 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     if (!thread_sp)
         return SendErrorResponse (51);
 
+    StreamString response;
+    if (!PrepareStopReplyPacketForThread (*thread_sp, response))
+        return SendErrorResponse (52);
+
+    return SendPacketNoLock (response.GetData(), response.GetSize());
+}
+
+bool
+GDBRemoteCommunicationServerLLGS::PrepareStopReplyPacketForThread (NativeThreadProtocol &thread, StreamString &response)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+
+    const lldb::tid_t tid = thread.GetID ();
+
     // Grab the reason this thread stopped.
     struct ThreadStopInfo tid_stop_info;
     std::string description;
-    if (!thread_sp->GetStopReason (tid_stop_info, description))
-        return SendErrorResponse (52);
+    if (!thread.GetStopReason (tid_stop_info, description))
+        return false;
 
     // FIXME implement register handling for exec'd inferiors.
     // if (tid_stop_info.reason == eStopReasonExec)
@@ -629,7 +807,6 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     //     InitializeRegisters(force);
     // }
 
-    StreamString response;
     // Output the T packet with the thread
     response.PutChar ('T');
     int signum = tid_stop_info.details.signal.signo;
@@ -651,7 +828,7 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     response.Printf ("thread:%" PRIx64 ";", tid);
 
     // Include the thread name if there is one.
-    const std::string thread_name = thread_sp->GetName ();
+    const std::string thread_name = thread.GetName ();
     if (!thread_name.empty ())
     {
         size_t thread_name_len = thread_name.length ();
@@ -723,7 +900,7 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     //
 
     // Grab the register context.
-    NativeRegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext ();
+    NativeRegisterContextSP reg_ctx_sp = thread.GetRegisterContext ();
     if (reg_ctx_sp)
     {
         // Expedite all registers in the first register set (i.e. should be GPRs) that are not contained in other registers.
@@ -792,7 +969,37 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
         }
     }
 
-    return SendPacketNoLock (response.GetData(), response.GetSize());
+    // Expedite the memory at the PC and the first frame records of the frame pointer chain so
+    // the common case of stepping and showing the top frames doesn't need any memory reads.
+    // Complete chains for all threads are sent in jThreadsInfo.
+    ExpeditedMemoryMap memory_map;
+    ReadExpeditedMemory (*m_debugged_process_sp, thread, 2, memory_map);
+    for (const auto &memory : memory_map)
+    {
+        response.Printf ("memory:0x%" PRIx64 "=", memory.first);
+        AppendHexValue (response, memory.second.data (), memory.second.size (), false);
+        response.PutChar (';');
+    }
+
+    return true;
+}
+
+void
+GDBRemoteCommunicationServerLLGS::QueueStopNotification (const std::string &stop_reply)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    m_stop_notification_queue.push_back (stop_reply);
+
+    // Only one notification is outstanding at a time. The client fetches the
+    // others with vStopped once it received the first one.
+    if (m_stop_notification_queue.size () > 1)
+        return;
+
+    const std::string &notification = m_stop_notification_queue.front ();
+    PacketResult result = SendNotificationPacketNoLock ("Stop", notification.data (), notification.size ());
+    if (result != PacketResult::Success && log)
+        log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to send stop notification", __FUNCTION__);
 }
 
 void
@@ -804,11 +1011,20 @@ GDBRemoteCommunicationServerLLGS::HandleInferiorState_Exited (NativeProcessProto
     if (log)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s called", __FUNCTION__);
 
-    PacketResult result = SendStopReasonForState(StateType::eStateExited);
-    if (result != PacketResult::Success)
+    if (m_non_stop)
     {
-        if (log)
-            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to send stop notification for PID %" PRIu64 ", state: eStateExited", __FUNCTION__, process->GetID ());
+        StreamString response;
+        PrepareWResponse (process, response);
+        QueueStopNotification (response.GetString ());
+    }
+    else
+    {
+        PacketResult result = SendStopReasonForState(StateType::eStateExited);
+        if (result != PacketResult::Success)
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to send stop notification for PID %" PRIu64 ", state: eStateExited", __FUNCTION__, process->GetID ());
+        }
     }
 
     // Close the pipe to the inferior terminal i/o if we launched it
@@ -828,6 +1044,10 @@ GDBRemoteCommunicationServerLLGS::HandleInferiorState_Stopped (NativeProcessProt
     if (log)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s called", __FUNCTION__);
 
+    // In non-stop mode each thread has been reported when it stopped.
+    if (m_non_stop)
+        return;
+
     // Send the stop reason unless this is the stop after the
     // launch or attach.
     switch (m_inferior_prev_state)
@@ -906,6 +1126,25 @@ GDBRemoteCommunicationServerLLGS::DidExec (NativeProcessProtocol *process)
     ClearProcessSpecificData ();
 }
 
+void
+GDBRemoteCommunicationServerLLGS::ThreadStopped (NativeProcessProtocol *process, lldb::tid_t tid)
+{
+    assert (process && "process cannot be NULL");
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+
+    NativeThreadProtocolSP thread_sp (process->GetThreadByID (tid));
+    StreamString stop_reply;
+    if (!thread_sp || !PrepareStopReplyPacketForThread (*thread_sp, stop_reply))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to prepare a stop reply for pid %" PRIu64 " tid %" PRIu64,
+                         __FUNCTION__, process->GetID (), tid);
+        return;
+    }
+
+    QueueStopNotification (stop_reply.GetString ());
+}
+
 void
 GDBRemoteCommunicationServerLLGS::DataAvailableCallback ()
 {
@@ -966,6 +1205,15 @@ GDBRemoteCommunicationServerLLGS::SendONotification (const char *buffer, uint32_
     }
 
     StreamString response;
+
+    // In non-stop mode the client isn't waiting for a reply while the process
+    // runs, so the output goes out as a %O notification.
+    if (m_non_stop)
+    {
+        response.PutBytesAsRawHex8 (buffer, len);
+        return SendNotificationPacketNoLock ("O", response.GetData (), response.GetSize ());
+    }
+
     response.PutChar ('O');
     response.PutBytesAsRawHex8 (buffer, len);
 
@@ -1011,8 +1259,12 @@ GDBRemoteCommunicationServerLLGS::StartSTDIOForwarding()
          m_process_launch_info.GetFileActionForFD(STDERR_FILENO))
         return;
 
+    // In non-stop mode the process is running again whenever a thread is
+    // resumed, the forwarding may be set up already.
+    if (m_stdio_handle_up)
+        return;
+
     Error error;
-    lldbassert(! m_stdio_handle_up);
     m_stdio_handle_up = m_mainloop.RegisterReadObject(
             m_stdio_communication.GetConnection()->GetReadObject(),
             [this] (MainLoopBase &) { SendProcessOutput(); }, error);
@@ -1296,7 +1548,10 @@ GDBRemoteCommunicationServerLLGS::Handle_c (StringExtractorGDBRemote &packet)
     if (log)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s continued process %" PRIu64, __FUNCTION__, m_debugged_process_sp->GetID ());
 
-    // No response required from continue.
+    // No response required from continue, unless in non-stop mode where the
+    // stops are sent as notifications.
+    if (m_non_stop)
+        return SendOKResponse ();
     return PacketResult::Success;
 }
 
@@ -1305,6 +1560,8 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont_actions (StringExtractorGDBRemote
 {
     StreamString response;
     response.Printf("vCont;c;C;s;S");
+    if (m_non_stop)
+        response.PutCString(";t");
 
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
@@ -1385,6 +1642,13 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
                 thread_action.state = eStateStepping;
                 break;
 
+            case 't':
+                // Stop, only valid in non-stop mode.
+                if (!m_non_stop)
+                    return SendIllFormedResponse (packet, "vCont t action requires non-stop mode");
+                thread_action.state = eStateStopped;
+                break;
+
             default:
                 return SendIllFormedResponse (packet, "Unsupported vCont action");
                 break;
@@ -1420,7 +1684,9 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
     if (log)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s continued process %" PRIu64, __FUNCTION__, m_debugged_process_sp->GetID ());
 
-    // No response required from vCont.
+    // No response required from vCont, unless in non-stop mode.
+    if (m_non_stop)
+        return SendOKResponse ();
     return PacketResult::Success;
 }
 
@@ -1455,7 +1721,80 @@ GDBRemoteCommunicationServerLLGS::Handle_stop_reason (StringExtractorGDBRemote &
     if (!m_debugged_process_sp)
         return SendErrorResponse (02);
 
-    return SendStopReasonForState (m_debugged_process_sp->GetState());
+    if (!m_non_stop)
+        return SendStopReasonForState (m_debugged_process_sp->GetState());
+
+    // In non-stop mode, report every stopped thread again: the first one
+    // as the reply and the others in response to vStopped.
+    m_stop_notification_queue.clear ();
+    if (m_debugged_process_sp->GetState () == eStateExited)
+    {
+        StreamString response;
+        PrepareWResponse (m_debugged_process_sp.get (), response);
+        m_stop_notification_queue.push_back (response.GetString ());
+    }
+    else
+    {
+        uint32_t thread_index = 0;
+        NativeThreadProtocolSP thread_sp;
+        for (thread_sp = m_debugged_process_sp->GetThreadAtIndex (thread_index); thread_sp; thread_sp = m_debugged_process_sp->GetThreadAtIndex (++thread_index))
+        {
+            StreamString stop_reply;
+            if (StateIsStoppedState (thread_sp->GetState (), false) && PrepareStopReplyPacketForThread (*thread_sp, stop_reply))
+                m_stop_notification_queue.push_back (stop_reply.GetString ());
+        }
+    }
+
+    if (m_stop_notification_queue.empty ())
+        return SendOKResponse ();
+
+    const std::string &stop_reply = m_stop_notification_queue.front ();
+    return SendPacketNoLock (stop_reply.data (), stop_reply.size ());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QNonStop (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    packet.SetFilePos (::strlen ("QNonStop:"));
+    const uint32_t enable = packet.GetU32 (UINT32_MAX);
+    if (enable > 1 || packet.GetBytesLeft () > 0)
+        return SendIllFormedResponse (packet, "QNonStop expects 0 or 1");
+
+    if (m_debugged_process_sp)
+    {
+        Error error = m_debugged_process_sp->SetNonStopMode (enable != 0);
+        if (error.Fail ())
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to %s non-stop mode: %s",
+                             __FUNCTION__, enable ? "enable" : "disable", error.AsCString ());
+            return SendErrorResponse (0x50);
+        }
+    }
+
+    m_non_stop = (enable != 0);
+    m_stop_notification_queue.clear ();
+    return SendOKResponse ();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_vStopped (StringExtractorGDBRemote &packet)
+{
+    if (!m_non_stop)
+        return SendUnimplementedResponse (packet.GetStringRef ().c_str ());
+
+    // The client acknowledged the stop reply it received last, send the
+    // next one or OK once they were all reported.
+    if (!m_stop_notification_queue.empty ())
+        m_stop_notification_queue.pop_front ();
+
+    if (m_stop_notification_queue.empty ())
+        return SendOKResponse ();
+
+    const std::string &stop_reply = m_stop_notification_queue.front ();
+    return SendPacketNoLock (stop_reply.data (), stop_reply.size ());
 }
 
 GDBRemoteCommunication::PacketResult
@@ -2067,6 +2406,77 @@ GDBRemoteCommunicationServerLLGS::Handle_memory_read(StringExtractorGDBRemote &p
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_jMultiMemRead (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // Parse out the "<addr>,<length>" pairs up to the terminating ';'.
+    packet.SetFilePos (strlen("jMultiMemRead:ranges:"));
+    std::vector<std::pair<lldb::addr_t, size_t> > ranges;
+    uint64_t total_size = 0;
+    while (packet.GetBytesLeft () > 0 && packet.PeekChar () != ';')
+    {
+        if (!ranges.empty () && packet.GetChar () != ',')
+            return SendIllFormedResponse (packet, "Comma sep missing in jMultiMemRead packet");
+
+        const lldb::addr_t read_addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+        if (read_addr == LLDB_INVALID_ADDRESS || packet.GetChar () != ',')
+            return SendIllFormedResponse (packet, "Invalid range in jMultiMemRead packet");
+
+        const uint64_t byte_count = packet.GetHexMaxU64 (false, UINT64_MAX);
+        if (byte_count == UINT64_MAX)
+            return SendIllFormedResponse (packet, "Invalid range in jMultiMemRead packet");
+
+        total_size += byte_count;
+        if (total_size > k_max_multi_mem_read_size)
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, requested more than %zu bytes", __FUNCTION__, k_max_multi_mem_read_size);
+            return SendErrorResponse (0x78);
+        }
+        ranges.push_back (std::make_pair (read_addr, static_cast<size_t> (byte_count)));
+    }
+    if (ranges.empty () || packet.GetChar () != ';')
+        return SendIllFormedResponse (packet, "Terminating ; missing in jMultiMemRead packet");
+
+    // Read all ranges into one buffer, the ranges one after the other.
+    std::string buf (total_size, '\0');
+    std::vector<size_t> bytes_read;
+    Error error = m_debugged_process_sp->ReadMemoryRangesWithoutTrap (ranges, &buf[0], bytes_read);
+    if (error.Fail () || bytes_read.size () != ranges.size ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 ": failed to read %zu ranges. Error: %s", __FUNCTION__, m_debugged_process_sp->GetID (), ranges.size (), error.AsCString ());
+        return SendErrorResponse (0x08);
+    }
+
+    // The response lists the number of bytes read for each range, followed by
+    // the bytes themselves. Ranges that could only be read partially (or not
+    // at all) contribute just the bytes that were read.
+    StreamGDBRemote response;
+    for (size_t i = 0; i < bytes_read.size (); ++i)
+        response.Printf ("%s%" PRIx64, i > 0 ? "," : "", static_cast<uint64_t> (bytes_read[i]));
+    response.PutChar (';');
+
+    size_t buf_offset = 0;
+    for (size_t i = 0; i < ranges.size (); ++i)
+    {
+        if (bytes_read[i] > 0)
+            response.PutEscapedBytes (buf.data () + buf_offset, bytes_read[i]);
+        buf_offset += ranges[i].second;
+    }
+
+    return SendPacketNoLock (response.GetData (), response.GetSize ());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_M (StringExtractorGDBRemote &packet)
 {
@@ -2293,12 +2703,65 @@ GDBRemoteCommunicationServerLLGS::Handle_Z (StringExtractorGDBRemote &packet)
     if (size == std::numeric_limits<uint32_t>::max ())
         return SendIllFormedResponse(packet, "Malformed Z packet, failed to parse size argument");
 
+    // Parse out the breakpoint conditions, a list of ";X<len>,<bytecode>" agent expressions, and
+    // the commands, ";cmds:<persist>,X<len>,<bytecode>..." agent expressions run on each hit.
+    std::vector<NativeAgentExpression> conditions;
+    std::vector<NativeAgentExpression> commands;
+    auto parse_expression = [&packet] (std::vector<NativeAgentExpression> &expressions) -> bool
+    {
+        if (packet.GetChar () != 'X')
+            return false;
+        const uint32_t length = packet.GetHexMaxU32 (false, 0);
+        if (length == 0 || packet.GetChar () != ',' || packet.GetBytesLeft () < length * 2)
+            return false;
+        std::vector<uint8_t> bytecode (length);
+        if (packet.GetHexBytes (bytecode.data (), length, 0) != length)
+            return false;
+        expressions.emplace_back (std::move (bytecode));
+        return true;
+    };
+    while (packet.GetBytesLeft () > 0)
+    {
+        if (!want_breakpoint || packet.GetChar () != ';')
+            return SendIllFormedResponse(packet, "Malformed Z packet, expecting a condition or commands after size");
+        if (packet.PeekChar () == 'X')
+        {
+            if (!parse_expression (conditions))
+                return SendIllFormedResponse(packet, "Malformed Z packet, failed to parse condition");
+            continue;
+        }
+
+        const char *cmds_prefix = "cmds:";
+        const char *rest = packet.Peek ();
+        if (!rest || ::strncmp (rest, cmds_prefix, strlen (cmds_prefix)) != 0)
+            return SendIllFormedResponse(packet, "Malformed Z packet, expecting a condition or commands after size");
+        packet.SetFilePos (packet.GetFilePos () + strlen (cmds_prefix));
+        // The persist flag asks for the commands to keep running after the debugger disconnects,
+        // which doesn't apply as breakpoints are removed on detach.
+        packet.GetHexMaxU32 (false, 0);
+        if (packet.GetChar () != ',' || packet.PeekChar () != 'X')
+            return SendIllFormedResponse(packet, "Malformed Z packet, failed to parse commands");
+        while (packet.PeekChar () == 'X')
+        {
+            if (!parse_expression (commands))
+                return SendIllFormedResponse(packet, "Malformed Z packet, failed to parse command");
+        }
+    }
+
     if (want_breakpoint)
     {
         // Try to set the breakpoint.
-        const Error error = m_debugged_process_sp->SetBreakpoint (addr, size, want_hardware);
+        Error error = m_debugged_process_sp->SetBreakpoint (addr, size, want_hardware);
         if (error.Success ())
-            return SendOKResponse ();
+        {
+            // A Z packet for an existing breakpoint replaces its conditions and commands.
+            error = m_debugged_process_sp->SetBreakpointConditions (addr, std::move (conditions));
+            if (error.Success ())
+                error = m_debugged_process_sp->SetBreakpointCommands (addr, std::move (commands));
+            if (error.Success ())
+                return SendOKResponse ();
+            m_debugged_process_sp->RemoveBreakpoint (addr);
+        }
         Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
         if (log)
             log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64
@@ -2443,8 +2906,10 @@ GDBRemoteCommunicationServerLLGS::Handle_s (StringExtractorGDBRemote &packet)
     ResumeActionList actions;
     actions.Append (action);
 
-    // All other threads stop while we're single stepping a thread.
-    actions.SetDefaultThreadActionIfNeeded(eStateStopped, 0);
+    // All other threads stop while we're single stepping a thread, unless in
+    // non-stop mode where they are left alone.
+    if (!m_non_stop)
+        actions.SetDefaultThreadActionIfNeeded(eStateStopped, 0);
     Error error = m_debugged_process_sp->Resume (actions);
     if (error.Fail ())
     {
@@ -2454,6 +2919,8 @@ GDBRemoteCommunicationServerLLGS::Handle_s (StringExtractorGDBRemote &packet)
     }
 
     // No response here - the stop or exit will come from the resulting action.
+    if (m_non_stop)
+        return SendOKResponse ();
     return PacketResult::Success;
 }
 
@@ -2505,12 +2972,317 @@ GDBRemoteCommunicationServerLLGS::Handle_qXfer_auxv_read (StringExtractorGDBRemo
         }
     }
 
-    // FIXME find out if/how I lock the stream here.
+    return SendXferReadResponse (m_active_auxv_buffer_sp, auxv_offset, auxv_length);
+#else
+    return SendUnimplementedResponse ("not implemented on this platform");
+#endif
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qXfer_libraries_svr4_read (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    // The annex is either empty or "start=<lm>;prev=<lm>" to only list the
+    // link map entries from <lm> on, which is what a client needs after the
+    // dynamic linker appended libraries to the list.
+    packet.SetFilePos (strlen("qXfer:libraries-svr4:read:"));
+    std::string annex;
+    while (packet.GetBytesLeft () > 0 && packet.PeekChar () != ':')
+        annex.push_back (packet.GetChar ());
+    if (packet.GetBytesLeft () < 1 || packet.GetChar () != ':')
+        return SendIllFormedResponse (packet, "qXfer:libraries-svr4:read: packet missing offset");
+
+    const uint64_t xfer_offset = packet.GetHexMaxU64 (false, std::numeric_limits<uint64_t>::max ());
+    if (xfer_offset == std::numeric_limits<uint64_t>::max ())
+        return SendIllFormedResponse (packet, "qXfer:libraries-svr4:read: packet missing offset");
+
+    if (packet.GetBytesLeft () < 1 || packet.GetChar () != ',')
+        return SendIllFormedResponse (packet, "qXfer:libraries-svr4:read: packet missing comma after offset");
+
+    const uint64_t xfer_length = packet.GetHexMaxU64 (false, std::numeric_limits<uint64_t>::max ());
+    if (xfer_length == std::numeric_limits<uint64_t>::max ())
+        return SendIllFormedResponse (packet, "qXfer:libraries-svr4:read: packet missing length");
+
+    // Walk the link map when the first chunk is requested, later chunks are
+    // served from the same snapshot.
+    if (xfer_offset == 0 || !m_active_libraries_svr4_buffer_sp)
+    {
+        if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+            return SendErrorResponse (0x10);
+        }
+
+        // The annex is a list of <name>=<hex address> pairs separated by ';'.
+        lldb::addr_t start_link_map = LLDB_INVALID_ADDRESS;
+        lldb::addr_t prev_link_map = LLDB_INVALID_ADDRESS;
+        llvm::StringRef annex_ref (annex);
+        while (!annex_ref.empty ())
+        {
+            llvm::StringRef name_value;
+            std::tie (name_value, annex_ref) = annex_ref.split (';');
+            llvm::StringRef name;
+            llvm::StringRef value;
+            std::tie (name, value) = name_value.split ('=');
+
+            lldb::addr_t *link_map = nullptr;
+            if (name == "start")
+                link_map = &start_link_map;
+            else if (name == "prev")
+                link_map = &prev_link_map;
+            else
+                continue;
+
+            bool success = false;
+            *link_map = StringConvert::ToUInt64 (value.str ().c_str (), LLDB_INVALID_ADDRESS, 16, &success);
+            if (!success)
+                return SendIllFormedResponse (packet, "qXfer:libraries-svr4:read: invalid link map address");
+        }
+
+        lldb::addr_t main_link_map = LLDB_INVALID_ADDRESS;
+        std::vector<NativeProcessProtocol::SVR4LibraryInfo> library_list;
+        Error error = m_debugged_process_sp->GetLoadedSVR4Libraries (start_link_map, prev_link_map, main_link_map, library_list);
+        if (error.Fail ())
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to read the link map: %s", __FUNCTION__, error.AsCString ());
+            m_active_libraries_svr4_buffer_sp.reset ();
+            return SendErrorResponse (0x11);
+        }
+
+        StreamString xml;
+        xml.PutCString ("<library-list-svr4 version=\"1.0\"");
+        if (start_link_map == LLDB_INVALID_ADDRESS)
+            xml.Printf (" main-lm=\"0x%" PRIx64 "\"", main_link_map);
+        xml.PutCString (">");
+        for (const auto &library : library_list)
+        {
+            xml.PutCString ("<library name=\"");
+            AppendEscapedXMLAttribute (xml, library.name);
+            xml.Printf ("\" lm=\"0x%" PRIx64 "\" l_addr=\"0x%" PRIx64 "\" l_ld=\"0x%" PRIx64 "\"/>",
+                        library.link_map,
+                        library.base_addr,
+                        library.ld_addr);
+        }
+        xml.PutCString ("</library-list-svr4>");
+
+        m_active_libraries_svr4_buffer_sp.reset (new DataBufferHeap (xml.GetData (), xml.GetSize ()));
+    }
+
+    return SendXferReadResponse (m_active_libraries_svr4_buffer_sp, xfer_offset, xfer_length);
+}
+
+bool
+GDBRemoteCommunicationServerLLGS::GetTargetXML (NativeRegisterContext &reg_context, StreamString &xml)
+{
+    // The register sets become groups, map each register to its set.
+    const uint32_t num_sets = reg_context.GetRegisterSetCount ();
+    std::map<uint32_t, uint32_t> reg_to_set;
+    for (uint32_t set_index = 0; set_index < num_sets; ++set_index)
+    {
+        const RegisterSet *reg_set = reg_context.GetRegisterSet (set_index);
+        if (!reg_set)
+            continue;
+        for (size_t i = 0; i < reg_set->num_registers; ++i)
+            reg_to_set.insert (std::make_pair (reg_set->registers[i], set_index));
+    }
+
+    // The register descriptions carry the same information as the
+    // qRegisterInfo responses, in the attributes debugserver uses.
+    xml.PutCString ("<?xml version=\"1.0\"?>\n<target version=\"1.0\">\n<feature name=\"org.lldb.lldb-server\">\n");
+    const uint32_t num_regs = reg_context.GetUserRegisterCount ();
+    for (uint32_t reg_index = 0; reg_index < num_regs; ++reg_index)
+    {
+        const RegisterInfo *reg_info = reg_context.GetRegisterInfoAtIndex (reg_index);
+        if (!reg_info)
+            return false;
+
+        xml.PutCString ("  <reg name=\"");
+        AppendEscapedXMLAttribute (xml, reg_info->name);
+        xml.PutChar ('"');
+        if (reg_info->alt_name && reg_info->alt_name[0])
+        {
+            xml.PutCString (" altname=\"");
+            AppendEscapedXMLAttribute (xml, reg_info->alt_name);
+            xml.PutChar ('"');
+        }
+        xml.Printf (" regnum=\"%" PRIu32 "\" offset=\"%" PRIu32 "\" bitsize=\"%" PRIu32 "\"",
+                    reg_index, reg_info->byte_offset, reg_info->byte_size * 8);
+
+        switch (reg_info->encoding)
+        {
+            case eEncodingUint:    xml.PutCString (" encoding=\"uint\""); break;
+            case eEncodingSint:    xml.PutCString (" encoding=\"sint\""); break;
+            case eEncodingIEEE754: xml.PutCString (" encoding=\"ieee754\""); break;
+            case eEncodingVector:  xml.PutCString (" encoding=\"vector\""); break;
+            default: break;
+        }
+
+        switch (reg_info->format)
+        {
+            case eFormatBinary:          xml.PutCString (" format=\"binary\""); break;
+            case eFormatDecimal:         xml.PutCString (" format=\"decimal\""); break;
+            case eFormatHex:             xml.PutCString (" format=\"hex\""); break;
+            case eFormatFloat:           xml.PutCString (" format=\"float\""); break;
+            case eFormatVectorOfSInt8:   xml.PutCString (" format=\"vector-sint8\""); break;
+            case eFormatVectorOfUInt8:   xml.PutCString (" format=\"vector-uint8\""); break;
+            case eFormatVectorOfSInt16:  xml.PutCString (" format=\"vector-sint16\""); break;
+            case eFormatVectorOfUInt16:  xml.PutCString (" format=\"vector-uint16\""); break;
+            case eFormatVectorOfSInt32:  xml.PutCString (" format=\"vector-sint32\""); break;
+            case eFormatVectorOfUInt32:  xml.PutCString (" format=\"vector-uint32\""); break;
+            case eFormatVectorOfFloat32: xml.PutCString (" format=\"vector-float32\""); break;
+            case eFormatVectorOfUInt128: xml.PutCString (" format=\"vector-uint128\""); break;
+            default: break;
+        }
+
+        auto set_pos = reg_to_set.find (reg_index);
+        if (set_pos != reg_to_set.end ())
+            xml.Printf (" group_id=\"%" PRIu32 "\"", set_pos->second);
+
+        if (reg_info->kinds[RegisterKind::eRegisterKindEHFrame] != LLDB_INVALID_REGNUM)
+            xml.Printf (" ehframe_regnum=\"%" PRIu32 "\"", reg_info->kinds[RegisterKind::eRegisterKindEHFrame]);
+
+        if (reg_info->kinds[RegisterKind::eRegisterKindDWARF] != LLDB_INVALID_REGNUM)
+            xml.Printf (" dwarf_regnum=\"%" PRIu32 "\"", reg_info->kinds[RegisterKind::eRegisterKindDWARF]);
+
+        switch (reg_info->kinds[RegisterKind::eRegisterKindGeneric])
+        {
+            case LLDB_REGNUM_GENERIC_PC:     xml.PutCString (" generic=\"pc\""); break;
+            case LLDB_REGNUM_GENERIC_SP:     xml.PutCString (" generic=\"sp\""); break;
+            case LLDB_REGNUM_GENERIC_FP:     xml.PutCString (" generic=\"fp\""); break;
+            case LLDB_REGNUM_GENERIC_RA:     xml.PutCString (" generic=\"ra\""); break;
+            case LLDB_REGNUM_GENERIC_FLAGS:  xml.PutCString (" generic=\"flags\""); break;
+            case LLDB_REGNUM_GENERIC_ARG1:   xml.PutCString (" generic=\"arg1\""); break;
+            case LLDB_REGNUM_GENERIC_ARG2:   xml.PutCString (" generic=\"arg2\""); break;
+            case LLDB_REGNUM_GENERIC_ARG3:   xml.PutCString (" generic=\"arg3\""); break;
+            case LLDB_REGNUM_GENERIC_ARG4:   xml.PutCString (" generic=\"arg4\""); break;
+            case LLDB_REGNUM_GENERIC_ARG5:   xml.PutCString (" generic=\"arg5\""); break;
+            case LLDB_REGNUM_GENERIC_ARG6:   xml.PutCString (" generic=\"arg6\""); break;
+            case LLDB_REGNUM_GENERIC_ARG7:   xml.PutCString (" generic=\"arg7\""); break;
+            case LLDB_REGNUM_GENERIC_ARG8:   xml.PutCString (" generic=\"arg8\""); break;
+            default: break;
+        }
+
+        // Register numbers in the lists are decimal, unlike in qRegisterInfo.
+        if (reg_info->value_regs && reg_info->value_regs[0] != LLDB_INVALID_REGNUM)
+        {
+            xml.PutCString (" value_regnums=\"");
+            for (const uint32_t *reg_num = reg_info->value_regs; *reg_num != LLDB_INVALID_REGNUM; ++reg_num)
+                xml.Printf ("%s%" PRIu32, reg_num == reg_info->value_regs ? "" : ",", *reg_num);
+            xml.PutChar ('"');
+        }
+
+        if (reg_info->invalidate_regs && reg_info->invalidate_regs[0] != LLDB_INVALID_REGNUM)
+        {
+            xml.PutCString (" invalidate_regnums=\"");
+            for (const uint32_t *reg_num = reg_info->invalidate_regs; *reg_num != LLDB_INVALID_REGNUM; ++reg_num)
+                xml.Printf ("%s%" PRIu32, reg_num == reg_info->invalidate_regs ? "" : ",", *reg_num);
+            xml.PutChar ('"');
+        }
+
+        xml.PutCString ("/>\n");
+    }
+    xml.PutCString ("</feature>\n");
+
+    if (num_sets > 0)
+    {
+        xml.PutCString ("<groups>\n");
+        for (uint32_t set_index = 0; set_index < num_sets; ++set_index)
+        {
+            const RegisterSet *reg_set = reg_context.GetRegisterSet (set_index);
+            if (!reg_set || !reg_set->name)
+                continue;
+            xml.Printf ("  <group id=\"%" PRIu32 "\" name=\"", set_index);
+            AppendEscapedXMLAttribute (xml, reg_set->name);
+            xml.PutCString ("\"/>\n");
+        }
+        xml.PutCString ("</groups>\n");
+    }
+    xml.PutCString ("</target>\n");
+    return true;
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qXfer_features_read (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    packet.SetFilePos (strlen("qXfer:features:read:"));
+    std::string annex;
+    while (packet.GetBytesLeft () > 0 && packet.PeekChar () != ':')
+        annex.push_back (packet.GetChar ());
+    if (packet.GetBytesLeft () < 1 || packet.GetChar () != ':')
+        return SendIllFormedResponse (packet, "qXfer:features:read: packet missing offset");
+
+    const uint64_t xfer_offset = packet.GetHexMaxU64 (false, std::numeric_limits<uint64_t>::max ());
+    if (xfer_offset == std::numeric_limits<uint64_t>::max ())
+        return SendIllFormedResponse (packet, "qXfer:features:read: packet missing offset");
+
+    if (packet.GetBytesLeft () < 1 || packet.GetChar () != ',')
+        return SendIllFormedResponse (packet, "qXfer:features:read: packet missing comma after offset");
+
+    const uint64_t xfer_length = packet.GetHexMaxU64 (false, std::numeric_limits<uint64_t>::max ());
+    if (xfer_length == std::numeric_limits<uint64_t>::max ())
+        return SendIllFormedResponse (packet, "qXfer:features:read: packet missing length");
+
+    // All the registers are described in target.xml itself.
+    if (annex.compare ("target.xml") != 0)
+        return SendErrorResponse (0x00);
+
+    if (xfer_offset == 0 || !m_active_target_xml_buffer_sp)
+    {
+        if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+            return SendErrorResponse (0x10);
+        }
+
+        NativeThreadProtocolSP thread_sp (m_debugged_process_sp->GetThreadAtIndex (0));
+        NativeRegisterContextSP reg_context_sp;
+        if (thread_sp)
+            reg_context_sp = thread_sp->GetRegisterContext ();
+        if (!reg_context_sp)
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no register context available", __FUNCTION__);
+            return SendErrorResponse (0x11);
+        }
+
+        StreamString xml;
+        if (!GetTargetXML (*reg_context_sp, xml))
+            return SendErrorResponse (0x12);
+
+        m_active_target_xml_buffer_sp.reset (new DataBufferHeap (xml.GetData (), xml.GetSize ()));
+    }
+
+    return SendXferReadResponse (m_active_target_xml_buffer_sp, xfer_offset, xfer_length);
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qShlibInfoAddr (StringExtractorGDBRemote &packet)
+{
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+        return SendErrorResponse (0x10);
+
+    const lldb::addr_t info_addr = m_debugged_process_sp->GetSharedLibraryInfoAddress ();
+    if (info_addr == LLDB_INVALID_ADDRESS)
+        return SendErrorResponse (0x11);
+
+    StreamGDBRemote response;
+    response.Printf ("%" PRIx64, info_addr);
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::SendXferReadResponse (lldb::DataBufferSP &buffer_sp, uint64_t offset, uint64_t length)
+{
     StreamGDBRemote response;
     bool done_with_buffer = false;
 
-    if (auxv_offset >= m_active_auxv_buffer_sp->GetByteSize ())
+    if (offset >= buffer_sp->GetByteSize ())
     {
         // We have nothing left to send.  Mark the buffer as complete.
         response.PutChar ('l');
@@ -2519,12 +3291,12 @@ GDBRemoteCommunicationServerLLGS::Handle_qXfer_auxv_read (StringExtractorGDBRemo
     else
     {
         // Figure out how many bytes are available starting at the given offset.
-        const uint64_t bytes_remaining = m_active_auxv_buffer_sp->GetByteSize () - auxv_offset;
+        const uint64_t bytes_remaining = buffer_sp->GetByteSize () - offset;
 
         // Figure out how many bytes we're going to read.
-        const uint64_t bytes_to_read = (auxv_length > bytes_remaining) ? bytes_remaining : auxv_length;
+        const uint64_t bytes_to_read = (length > bytes_remaining) ? bytes_remaining : length;
 
-        // Mark the response type according to whether we're reading the remainder of the auxv data.
+        // Mark the response type according to whether we're reading the remainder of the data.
         if (bytes_to_read >= bytes_remaining)
         {
             // There will be nothing left to read after this
@@ -2538,16 +3310,13 @@ GDBRemoteCommunicationServerLLGS::Handle_qXfer_auxv_read (StringExtractorGDBRemo
         }
 
         // Now write the data in encoded binary form.
-        response.PutEscapedBytes (m_active_auxv_buffer_sp->GetBytes () + auxv_offset, bytes_to_read);
+        response.PutEscapedBytes (buffer_sp->GetBytes () + offset, bytes_to_read);
     }
 
     if (done_with_buffer)
-        m_active_auxv_buffer_sp.reset ();
+        buffer_sp.reset ();
 
     return SendPacketNoLock(response.GetData(), response.GetSize());
-#else
-    return SendUnimplementedResponse ("not implemented on this platform");
-#endif
 }
 
 GDBRemoteCommunication::PacketResult
@@ -2798,6 +3567,65 @@ GDBRemoteCommunicationServerLLGS::Handle_jThreadsInfo (StringExtractorGDBRemote
     return SendPacketNoLock (escaped_response.GetData(), escaped_response.GetSize());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_jCollectedSamples (StringExtractorGDBRemote &)
+{
+    // Ensure we have a debugged process.
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+        return SendErrorResponse (0x15);
+
+    std::vector<NativeCollectSample> samples;
+    uint64_t dropped = 0;
+    m_debugged_process_sp->GetCollectBuffer ().Drain (k_max_collected_samples_size, samples, dropped);
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("GDBRemoteCommunicationServerLLGS::%s sending %" PRIu64 " samples, %" PRIu64 " dropped",
+                __FUNCTION__, (uint64_t)samples.size (), dropped);
+
+    JSONArray::SP samples_array_sp = std::make_shared<JSONArray>();
+    for (const NativeCollectSample &sample : samples)
+    {
+        JSONObject::SP sample_object_sp = std::make_shared<JSONObject>();
+        sample_object_sp->SetObject ("id", std::make_shared<JSONNumber>(sample.id));
+        sample_object_sp->SetObject ("tid", std::make_shared<JSONNumber>(sample.tid));
+        sample_object_sp->SetObject ("address", std::make_shared<JSONNumber>(sample.addr));
+
+        JSONObject::SP registers_object_sp = std::make_shared<JSONObject>();
+        for (const auto &reg : sample.registers)
+        {
+            StreamString stream;
+            stream.PutBytesAsRawHex8 (reg.second.data (), reg.second.size ());
+            registers_object_sp->SetObject (std::to_string (reg.first), std::make_shared<JSONString>(stream.GetString ()));
+        }
+        sample_object_sp->SetObject ("registers", registers_object_sp);
+
+        JSONArray::SP memory_array_sp = std::make_shared<JSONArray>();
+        for (const NativeCollectSample::MemoryBlock &block : sample.memory)
+        {
+            JSONObject::SP block_object_sp = std::make_shared<JSONObject>();
+            block_object_sp->SetObject ("address", std::make_shared<JSONNumber>(block.addr));
+            StreamString stream;
+            stream.PutBytesAsRawHex8 (block.bytes.data (), block.bytes.size ());
+            block_object_sp->SetObject ("bytes", std::make_shared<JSONString>(stream.GetString ()));
+            memory_array_sp->AppendObject (block_object_sp);
+        }
+        sample_object_sp->SetObject ("memory", memory_array_sp);
+
+        samples_array_sp->AppendObject (sample_object_sp);
+    }
+
+    JSONObject response_object;
+    response_object.SetObject ("dropped", std::make_shared<JSONNumber>(dropped));
+    response_object.SetObject ("samples", samples_array_sp);
+
+    StreamString response;
+    response_object.Write (response);
+    StreamGDBRemote escaped_response;
+    escaped_response.PutEscapedBytes (response.GetData (), response.GetSize ());
+    return SendPacketNoLock (escaped_response.GetData (), escaped_response.GetSize ());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_qWatchpointSupportInfo (StringExtractorGDBRemote &packet)
 {
@@ -2967,6 +3795,9 @@ GDBRemoteCommunicationServerLLGS::ClearProcessSpecificData ()
                      m_active_auxv_buffer_sp ? "was set" : "was not set");
     m_active_auxv_buffer_sp.reset ();
 #endif
+
+    m_active_libraries_svr4_buffer_sp.reset ();
+    m_active_target_xml_buffer_sp.reset ();
 }
 
 FileSpec
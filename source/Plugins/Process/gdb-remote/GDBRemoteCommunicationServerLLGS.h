@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <deque>
+#include <string>
 #include <unordered_map>
 
 // Other libraries and framework includes
@@ -110,9 +112,22 @@ public:
     void
     DidExec (NativeProcessProtocol *process) override;
 
+    void
+    ThreadStopped (NativeProcessProtocol *process, lldb::tid_t tid) override;
+
     Error
     InitializeConnection (std::unique_ptr<Connection> &&connection);
 
+    //------------------------------------------------------------------
+    /// Describe the registers of a register context in the target.xml
+    /// format that qXfer:features:read serves.
+    ///
+    /// @return
+    ///     False if a register has no register info.
+    //------------------------------------------------------------------
+    static bool
+    GetTargetXML (NativeRegisterContext &reg_context, StreamString &xml);
+
 protected:
     lldb::PlatformSP m_platform_sp;
     MainLoop &m_mainloop;
@@ -127,10 +142,17 @@ protected:
 
     lldb::StateType m_inferior_prev_state;
     lldb::DataBufferSP m_active_auxv_buffer_sp;
+    lldb::DataBufferSP m_active_libraries_svr4_buffer_sp;
+    lldb::DataBufferSP m_active_target_xml_buffer_sp;
     Mutex m_saved_registers_mutex;
     std::unordered_map<uint32_t, lldb::DataBufferSP> m_saved_registers_map;
     uint32_t m_next_saved_registers_id;
     bool m_handshake_completed : 1;
+    bool m_non_stop : 1;
+
+    // Non-stop mode: the stop replies that haven't been acknowledged with
+    // vStopped yet. The first one has been sent to the client.
+    std::deque<std::string> m_stop_notification_queue;
 
     PacketResult
     SendONotification (const char *buffer, uint32_t len);
@@ -138,9 +160,18 @@ protected:
     PacketResult
     SendWResponse (NativeProcessProtocol *process);
 
+    void
+    PrepareWResponse (NativeProcessProtocol *process, StreamString &response);
+
     PacketResult
     SendStopReplyPacketForThread (lldb::tid_t tid);
 
+    bool
+    PrepareStopReplyPacketForThread (NativeThreadProtocol &thread, StreamString &response);
+
+    void
+    QueueStopNotification (const std::string &stop_reply);
+
     PacketResult
     SendStopReasonForState (lldb::StateType process_state);
 
@@ -177,6 +208,12 @@ protected:
     PacketResult
     Handle_stop_reason (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_QNonStop (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_vStopped (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_qRegisterInfo (StringExtractorGDBRemote &packet);
 
@@ -226,6 +263,15 @@ protected:
     PacketResult
     Handle_qXfer_auxv_read (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_qXfer_libraries_svr4_read (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_qXfer_features_read (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_qShlibInfoAddr (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_QSaveRegisterState (StringExtractorGDBRemote &packet);
 
@@ -244,6 +290,12 @@ protected:
     PacketResult
     Handle_jThreadsInfo (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_jMultiMemRead (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_jCollectedSamples (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_qWatchpointSupportInfo (StringExtractorGDBRemote &packet);
 
@@ -287,6 +339,9 @@ private:
     void
     ClearProcessSpecificData ();
 
+    PacketResult
+    SendXferReadResponse (lldb::DataBufferSP &buffer_sp, uint64_t offset, uint64_t length);
+
     void
     RegisterPacketHandlers ();
 
@@ -25,15 +25,20 @@
 #include <map>
 #include <mutex>
 
+#include "lldb/Breakpoint/Breakpoint.h"
+#include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Breakpoint/BreakpointSite.h"
 #include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Host/ConnectionFileDescriptor.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/PluginManager.h"
+#include "lldb/Core/RegisterValue.h"
 #include "lldb/Core/State.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/StreamString.h"
@@ -72,6 +77,7 @@
 #include "Plugins/Process/Utility/StopInfoMachException.h"
 #include "Plugins/Platform/MacOSX/PlatformRemoteiOS.h"
 #include "Utility/StringExtractorGDBRemote.h"
+#include "GDBRemoteAgentExpressionCompiler.h"
 #include "GDBRemoteRegisterContext.h"
 #include "ProcessGDBRemote.h"
 #include "ProcessGDBRemoteLog.h"
@@ -173,118 +179,6 @@ namespace {
     
 } // anonymous namespace end
 
-class ProcessGDBRemote::GDBLoadedModuleInfoList
-{
-public:
-
-    class LoadedModuleInfo
-    {
-    public:
-
-        enum e_data_point
-        {
-            e_has_name      = 0,
-            e_has_base      ,
-            e_has_dynamic   ,
-            e_has_link_map  ,
-            e_num
-        };
-
-        LoadedModuleInfo ()
-        {
-            for (uint32_t i = 0; i < e_num; ++i)
-                m_has[i] = false;
-        }
-
-        void set_name (const std::string & name)
-        {
-            m_name = name;
-            m_has[e_has_name] = true;
-        }
-        bool get_name (std::string & out) const
-        {
-            out = m_name;
-            return m_has[e_has_name];
-        }
-
-        void set_base (const lldb::addr_t base)
-        {
-            m_base = base;
-            m_has[e_has_base] = true;
-        }
-        bool get_base (lldb::addr_t & out) const
-        {
-            out = m_base;
-            return m_has[e_has_base];
-        }
-
-        void set_base_is_offset (bool is_offset)
-        {
-            m_base_is_offset = is_offset;
-        }
-        bool get_base_is_offset(bool & out) const
-        {
-            out = m_base_is_offset;
-            return m_has[e_has_base];
-        }
-
-        void set_link_map (const lldb::addr_t addr)
-        {
-            m_link_map = addr;
-            m_has[e_has_link_map] = true;
-        }
-        bool get_link_map (lldb::addr_t & out) const
-        {
-            out = m_link_map;
-            return m_has[e_has_link_map];
-        }
-
-        void set_dynamic (const lldb::addr_t addr)
-        {
-            m_dynamic = addr;
-            m_has[e_has_dynamic] = true;
-        }
-        bool get_dynamic (lldb::addr_t & out) const
-        {
-            out = m_dynamic;
-            return m_has[e_has_dynamic];
-        }
-
-        bool has_info (e_data_point datum)
-        {
-            assert (datum < e_num);
-            return m_has[datum];
-        }
-
-    protected:
-
-        bool m_has[e_num];
-        std::string m_name;
-        lldb::addr_t m_link_map;
-        lldb::addr_t m_base;
-        bool m_base_is_offset;
-        lldb::addr_t m_dynamic;
-    };
-
-    GDBLoadedModuleInfoList ()
-        : m_list ()
-        , m_link_map (LLDB_INVALID_ADDRESS)
-    {}
-
-    void add (const LoadedModuleInfo & mod)
-    {
-        m_list.push_back (mod);
-    }
-
-    void clear ()
-    {
-        m_list.clear ();
-    }
-
-    std::vector<LoadedModuleInfo> m_list;
-    lldb::addr_t m_link_map;
-};
-
 // TODO Randomly assigning a port is unsafe.  We should get an unused
 // ephemeral port from the kernel and make sure we reserve it before passing
 // it to debugserver.
@@ -400,6 +294,8 @@ ProcessGDBRemote::ProcessGDBRemote(lldb::TargetSP target_sp, Listener &listener)
     m_max_memory_size (0),
     m_remote_stub_max_memory_size (0),
     m_addr_to_mmap_size (),
+    m_breakpoint_site_conditions (),
+    m_collect_actions (),
     m_thread_create_bp_sp (),
     m_waiting_for_attach (false),
     m_destroy_tried_resuming (false),
@@ -615,6 +511,13 @@ ProcessGDBRemote::BuildDynamicRegisterInfo (bool force)
     if (GetGDBServerRegisterInfo ())
         return;
     
+    // Ask for the registers in batches that are pipelined, the responses
+    // past the last register are errors that end the loop. Batches only
+    // save time once acks are disabled.
+    const uint32_t reg_info_batch_size = m_gdb_comm.GetSendAcks() ? 1 : 64;
+    std::vector<StringExtractorGDBRemote> responses;
+    uint32_t batch_start = 0;
+
     char packet[128];
     uint32_t reg_offset = 0;
     uint32_t reg_num = 0;
@@ -622,10 +525,22 @@ ProcessGDBRemote::BuildDynamicRegisterInfo (bool force)
          response_type == StringExtractorGDBRemote::eResponse; 
          ++reg_num)
     {
-        const int packet_len = ::snprintf (packet, sizeof(packet), "qRegisterInfo%x", reg_num);
-        assert (packet_len < (int)sizeof(packet));
-        StringExtractorGDBRemote response;
-        if (m_gdb_comm.SendPacketAndWaitForResponse(packet, packet_len, response, false) == GDBRemoteCommunication::PacketResult::Success)
+        if (reg_num - batch_start >= responses.size())
+        {
+            std::vector<std::string> payloads;
+            for (uint32_t i = 0; i < reg_info_batch_size; ++i)
+            {
+                const int packet_len = ::snprintf (packet, sizeof(packet), "qRegisterInfo%x", reg_num + i);
+                assert (packet_len < (int)sizeof(packet));
+                payloads.push_back (std::string (packet, packet_len));
+            }
+            batch_start = reg_num;
+            m_gdb_comm.SendPacketsAndWaitForResponses (payloads, responses, false);
+        }
+
+        // Failed packets have an empty response.
+        StringExtractorGDBRemote &response = responses[reg_num - batch_start];
+        if (!response.Empty())
         {
             response_type = response.GetResponseType();
             if (response_type == StringExtractorGDBRemote::eResponse)
@@ -1230,6 +1145,10 @@ ProcessGDBRemote::ConnectToDebugserver (const char *connect_url)
     if (GetTarget().GetNonStopModeEnabled())
         GetTarget().SetNonStopModeEnabled (m_gdb_comm.SetNonStopMode(true));
 
+    // Send the queries below, and qProcessInfo which DoConnectRemote() and
+    // DidLaunchOrAttach() need, in one go to save the round trips.
+    m_gdb_comm.PrefetchServerInfo ();
+
     m_gdb_comm.GetEchoSupported ();
     m_gdb_comm.GetThreadSuffixSupported ();
     m_gdb_comm.GetListThreadsInStopReplySupported ();
@@ -2781,6 +2700,10 @@ ProcessGDBRemote::DoDetach(bool keep_stopped)
     Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PROCESS));
     if (log)
         log->Printf ("ProcessGDBRemote::DoDetach(keep_stopped: %i)", keep_stopped);
+
+    // Collect actions are not breakpoint sites, remove their breakpoints too.
+    while (!m_collect_actions.empty())
+        ClearCollectAction (m_collect_actions.begin()->first);
  
     error = m_gdb_comm.Detach (keep_stopped);
     if (log)
@@ -3005,6 +2928,7 @@ ProcessGDBRemote::SetLastStopPacket (const StringExtractorGDBRemote &response)
 
         m_thread_list_real.Clear();
         m_thread_list.Clear();
+        m_collect_actions.clear();
         BuildDynamicRegisterInfo (true);
         m_gdb_comm.ResetDiscoverableSettings (did_exec);
     }
@@ -3051,8 +2975,8 @@ ProcessGDBRemote::GetImageInfoAddress()
     // the loaded module list can also provides a link map address
     if (addr == LLDB_INVALID_ADDRESS)
     {
-        GDBLoadedModuleInfoList list;
-        if (GetLoadedModuleList (list).Success())
+        LoadedModuleInfoList list;
+        if (GetLoadedModuleList (list, LLDB_INVALID_ADDRESS, LLDB_INVALID_ADDRESS).Success())
             addr = list.m_link_map;
     }
 
@@ -3091,6 +3015,31 @@ ProcessGDBRemote::WillPublicStop ()
 //------------------------------------------------------------------
 // Process Memory
 //------------------------------------------------------------------
+// Copy the data in the response to an 'x' or 'm' packet into BUF.
+static size_t
+GetMemoryReadResponseBytes (StringExtractorGDBRemote &response, bool binary_memory_read, void *buf, size_t size)
+{
+    if (binary_memory_read)
+    {
+        // The lower level GDBRemoteCommunication packet receive layer has already de-quoted any
+        // 0x7d character escaping that was present in the packet
+
+        size_t data_received_size = response.GetBytesLeft();
+        if (data_received_size > size)
+        {
+            // Don't write past the end of BUF if the remote debug server gave us too
+            // much data for some reason.
+            data_received_size = size;
+        }
+        memcpy (buf, response.GetStringRef().data(), data_received_size);
+        return data_received_size;
+    }
+    else
+    {
+        return response.GetHexBytes(buf, size, '\xdd');
+    }
+}
+
 size_t
 ProcessGDBRemote::DoReadMemory (addr_t addr, void *buf, size_t size, Error &error)
 {
@@ -3115,25 +3064,7 @@ ProcessGDBRemote::DoReadMemory (addr_t addr, void *buf, size_t size, Error &erro
         if (response.IsNormalResponse())
         {
             error.Clear();
-            if (binary_memory_read)
-            {
-                // The lower level GDBRemoteCommunication packet receive layer has already de-quoted any
-                // 0x7d character escaping that was present in the packet
-
-                size_t data_received_size = response.GetBytesLeft();
-                if (data_received_size > size)
-                {
-                    // Don't write past the end of BUF if the remote debug server gave us too
-                    // much data for some reason.
-                    data_received_size = size;
-                }
-                memcpy (buf, response.GetStringRef().data(), data_received_size);
-                return data_received_size;
-            }
-            else
-            {
-                return response.GetHexBytes(buf, size, '\xdd');
-            }
+            return GetMemoryReadResponseBytes (response, binary_memory_read, buf, size);
         }
         else if (response.IsErrorResponse())
             error.SetErrorStringWithFormat("memory read failed for 0x%" PRIx64, addr);
@@ -3149,6 +3080,87 @@ ProcessGDBRemote::DoReadMemory (addr_t addr, void *buf, size_t size, Error &erro
     return 0;
 }
 
+void
+ProcessGDBRemote::DoReadMemoryRanges (const MemoryRangeList &ranges, std::vector<DataBufferSP> &buffers)
+{
+    GetMaxMemorySize ();
+    buffers.clear();
+
+    // Read as many ranges with each jMultiMemRead packet as fit into the
+    // memory read size limit.
+    size_t range_idx = 0;
+    while (range_idx < ranges.size())
+    {
+        MemoryRangeList batch;
+        uint64_t batch_size = 0;
+        while (range_idx < ranges.size())
+        {
+            const size_t size = std::min<uint64_t> (ranges[range_idx].second, m_max_memory_size);
+            if (!batch.empty() && batch_size + size > m_max_memory_size)
+                break;
+            batch.push_back (std::make_pair (ranges[range_idx].first, size));
+            batch_size += size;
+            ++range_idx;
+        }
+
+        std::vector<DataBufferSP> batch_buffers;
+        if (!m_gdb_comm.MultiMemRead (batch, batch_buffers))
+        {
+            // Fall back to a memory read packet per range for the rest of
+            // the ranges.
+            MemoryRangeList remaining_ranges (ranges.begin() + buffers.size(), ranges.end());
+            ReadMemoryRangesPipelined (remaining_ranges, batch_buffers);
+            buffers.insert (buffers.end(), batch_buffers.begin(), batch_buffers.end());
+            return;
+        }
+        buffers.insert (buffers.end(), batch_buffers.begin(), batch_buffers.end());
+    }
+}
+
+void
+ProcessGDBRemote::ReadMemoryRangesPipelined (const MemoryRangeList &ranges, std::vector<DataBufferSP> &buffers)
+{
+    GetMaxMemorySize ();
+    buffers.clear();
+
+    const bool binary_memory_read = m_gdb_comm.GetxPacketSupported();
+    std::vector<std::string> payloads;
+    for (const auto &range : ranges)
+    {
+        char packet[64];
+        const int packet_len = ::snprintf(packet, sizeof(packet), "%c%" PRIx64 ",%" PRIx64,
+                                          binary_memory_read ? 'x' : 'm', (uint64_t)range.first,
+                                          std::min<uint64_t> (range.second, m_max_memory_size));
+        assert (packet_len + 1 < (int)sizeof(packet));
+        payloads.push_back (std::string (packet, packet_len));
+    }
+
+    // Failed packets leave their responses empty, which aren't normal
+    // responses, so the remaining ranges just come back empty.
+    std::vector<StringExtractorGDBRemote> responses;
+    m_gdb_comm.SendPacketsAndWaitForResponses (payloads, responses, true);
+
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        DataBufferSP buffer_sp;
+        const size_t size = std::min<uint64_t> (ranges[i].second, m_max_memory_size);
+        if (size > 0 && responses[i].IsNormalResponse())
+        {
+            std::unique_ptr<DataBufferHeap> data_buffer_heap_ap(new DataBufferHeap (size, 0));
+            const size_t bytes_read = GetMemoryReadResponseBytes (responses[i],
+                                                                  binary_memory_read,
+                                                                  data_buffer_heap_ap->GetBytes(),
+                                                                  data_buffer_heap_ap->GetByteSize());
+            if (bytes_read > 0)
+            {
+                data_buffer_heap_ap->SetByteSize (bytes_read);
+                buffer_sp.reset (data_buffer_heap_ap.release());
+            }
+        }
+        buffers.push_back (buffer_sp);
+    }
+}
+
 size_t
 ProcessGDBRemote::DoWriteMemory (addr_t addr, const void *buf, size_t size, Error &error)
 {
@@ -3333,6 +3345,13 @@ ProcessGDBRemote::EnableBreakpointSite (BreakpointSite *bp_site)
         return error;
     }
 
+    // The stub never reports hits of a breakpoint with a collect action
+    if (m_collect_actions.count(addr))
+    {
+        error.SetErrorStringWithFormat("address 0x%" PRIx64 " has a collect action", (uint64_t)addr);
+        return error;
+    }
+
     // Get the software breakpoint trap opcode size
     const size_t bp_op_size = GetSoftwareBreakpointTrapOpcode(bp_site);
 
@@ -3345,12 +3364,18 @@ ProcessGDBRemote::EnableBreakpointSite (BreakpointSite *bp_site)
     // skip over software breakpoints.
     if (m_gdb_comm.SupportsGDBStoppointPacket(eBreakpointSoftware) && (!bp_site->HardwareRequired()))
     {
+        // Let the stub filter out the hits for which the breakpoint conditions are false
+        std::vector<std::vector<uint8_t>> conditions;
+        if (m_gdb_comm.GetConditionalBreakpointsSupported())
+            GetBreakpointSiteConditions(bp_site, conditions);
+
         // Try to send off a software breakpoint packet ($Z0)
-        if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size) == 0)
+        if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size, &conditions) == 0)
         {
             // The breakpoint was placed successfully
             bp_site->SetEnabled(true);
             bp_site->SetType(BreakpointSite::eExternal);
+            m_breakpoint_site_conditions[site_id].swap(conditions);
             return error;
         }
 
@@ -3414,6 +3439,163 @@ ProcessGDBRemote::EnableBreakpointSite (BreakpointSite *bp_site)
     return EnableSoftwareBreakpoint(bp_site);
 }
 
+Error
+ProcessGDBRemote::UpdateBreakpointSiteConditions (BreakpointSite *bp_site)
+{
+    Error error;
+    assert (bp_site != NULL);
+
+    // Only breakpoints set with a Z0 packet have their conditions evaluated by the stub
+    if (!bp_site->IsEnabled() || bp_site->GetType() != BreakpointSite::eExternal || bp_site->IsHardware() ||
+        !m_gdb_comm.GetConditionalBreakpointsSupported())
+        return error;
+
+    const user_id_t site_id = bp_site->GetID();
+    std::vector<std::vector<uint8_t>> conditions;
+    GetBreakpointSiteConditions(bp_site, conditions);
+    if (m_breakpoint_site_conditions[site_id] == conditions)
+        return error;
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("ProcessGDBRemote::UpdateBreakpointSiteConditions (site_id = %" PRIu64 ") addr = 0x%8.8" PRIx64 " sending %" PRIu64 " conditions",
+                     site_id, (uint64_t)bp_site->GetLoadAddress(), (uint64_t)conditions.size());
+
+    // A Z0 packet for an inserted breakpoint replaces its conditions and adds a reference to it in
+    // the stub, which the z0 packet drops again. Removing the breakpoint first instead would let
+    // threads that are still running (in non-stop mode) run past it in between.
+    const addr_t addr = bp_site->GetLoadAddress();
+    const size_t bp_op_size = GetSoftwareBreakpointTrapOpcode (bp_site);
+    if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size, &conditions))
+    {
+        error.SetErrorStringWithFormat("failed to update the conditions of the breakpoint at 0x%" PRIx64, (uint64_t)addr);
+        return error;
+    }
+    m_breakpoint_site_conditions[site_id].swap(conditions);
+    if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, false, addr, bp_op_size))
+        error.SetErrorToGenericError();
+    return error;
+}
+
+bool
+ProcessGDBRemote::GetBreakpointSiteConditions (BreakpointSite *bp_site, std::vector<std::vector<uint8_t>> &conditions)
+{
+    conditions.clear();
+
+    // The stub can only skip a hit if none of the owners would stop, so every one of them needs
+    // a condition. Preconditions are evaluated before the condition and can't be sent.
+    const size_t num_owners = bp_site->GetNumberOfOwners();
+    for (size_t i = 0; i < num_owners; ++i)
+    {
+        BreakpointLocationSP loc_sp (bp_site->GetOwnerAtIndex(i));
+        if (!loc_sp || loc_sp->GetBreakpoint().GetPrecondition())
+            break;
+        const char *condition_text = loc_sp->GetConditionText();
+        if (condition_text == nullptr || condition_text[0] == '\0')
+            break;
+
+        GDBRemoteAgentExpressionCompiler compiler (*this, loc_sp->GetAddress());
+        std::vector<uint8_t> bytecode;
+        Error error = compiler.Compile(condition_text, bytecode);
+        if (error.Fail())
+        {
+            Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+            if (log)
+                log->Printf ("ProcessGDBRemote::%s condition \"%s\" of breakpoint %d.%d can't be evaluated by the stub: %s",
+                             __FUNCTION__, condition_text, loc_sp->GetBreakpoint().GetID(), loc_sp->GetID(), error.AsCString());
+            break;
+        }
+        conditions.push_back(std::move(bytecode));
+    }
+
+    if (num_owners == 0 || conditions.size() != num_owners)
+    {
+        conditions.clear();
+        return false;
+    }
+    return true;
+}
+
+Error
+ProcessGDBRemote::SetCollectAction (lldb::addr_t addr, const std::vector<std::string> &items)
+{
+    Error error;
+    if (!m_gdb_comm.GetBreakpointCommandsSupported())
+    {
+        error.SetErrorString("the remote stub doesn't support breakpoint commands");
+        return error;
+    }
+    if (GetBreakpointSiteList().FindByAddress(addr))
+    {
+        error.SetErrorStringWithFormat("address 0x%" PRIx64 " has a breakpoint", (uint64_t)addr);
+        return error;
+    }
+
+    Address so_addr;
+    if (!GetTarget().ResolveLoadAddress(addr, so_addr))
+        so_addr.SetRawAddress(addr);
+
+    std::vector<std::vector<uint8_t>> commands;
+    for (const std::string &item : items)
+    {
+        GDBRemoteAgentExpressionCompiler compiler (*this, so_addr);
+        std::vector<uint8_t> bytecode;
+        error = compiler.CompileCollect(item.c_str(), bytecode);
+        if (error.Fail())
+        {
+            error.SetErrorStringWithFormat("can't collect '%s': %s", item.c_str(), error.AsCString());
+            return error;
+        }
+        commands.push_back(std::move(bytecode));
+    }
+    if (commands.empty())
+    {
+        error.SetErrorString("nothing to collect");
+        return error;
+    }
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("ProcessGDBRemote::SetCollectAction addr = 0x%8.8" PRIx64 " sending %" PRIu64 " commands",
+                     (uint64_t)addr, (uint64_t)commands.size());
+
+    // A Z0 packet for an inserted breakpoint would add a reference to it in the stub, so remove
+    // the previous action first.
+    if (m_collect_actions.count(addr))
+    {
+        error = ClearCollectAction(addr);
+        if (error.Fail())
+            return error;
+    }
+
+    const uint32_t bp_op_size = GetTarget().GetArchitecture().GetMinimumOpcodeByteSize();
+    if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size, nullptr, &commands))
+    {
+        error.SetErrorStringWithFormat("failed to set a collect action at 0x%" PRIx64, (uint64_t)addr);
+        return error;
+    }
+    m_collect_actions[addr] = bp_op_size;
+    return error;
+}
+
+Error
+ProcessGDBRemote::ClearCollectAction (lldb::addr_t addr)
+{
+    Error error;
+    CollectActionMap::iterator pos = m_collect_actions.find(addr);
+    if (pos == m_collect_actions.end())
+    {
+        error.SetErrorStringWithFormat("no collect action at 0x%" PRIx64, (uint64_t)addr);
+        return error;
+    }
+
+    const uint32_t bp_op_size = pos->second;
+    m_collect_actions.erase(pos);
+    if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, false, addr, bp_op_size))
+        error.SetErrorStringWithFormat("failed to remove the collect action at 0x%" PRIx64, (uint64_t)addr);
+    return error;
+}
+
 Error
 ProcessGDBRemote::DisableBreakpointSite (BreakpointSite *bp_site)
 {
@@ -3451,6 +3633,7 @@ ProcessGDBRemote::DisableBreakpointSite (BreakpointSite *bp_site)
                 
                 if (m_gdb_comm.SendGDBStoppointTypePacket(stoppoint_type, false, addr, bp_op_size))
                 error.SetErrorToGenericError();
+                m_breakpoint_site_conditions.erase(site_id);
             }
             break;
         }
@@ -3679,6 +3862,9 @@ ProcessGDBRemote::LaunchAndConnectToDebugserver (const ProcessInfo &process_info
             return error;
         }
         
+        // The debug server runs on this host, so packet compression would only cost time.
+        m_gdb_comm.SetCompressionAllowed (false);
+
         if (m_gdb_comm.IsConnected())
         {
             // Finish the connection process by doing the handshake without connecting (send NULL URL)
@@ -3872,6 +4058,24 @@ ProcessGDBRemote::HandleNotifyPacket (StringExtractorGDBRemote &packet)
 {
     // get the packet at a string
     const std::string &pkt = packet.GetStringRef();
+
+    // %O:<hex> carries inferior output in non-stop mode
+    if (pkt.compare(0, 2, "O:") == 0)
+    {
+        StringExtractorGDBRemote output(pkt.c_str() + 2);
+        std::string inferior_stdout;
+        inferior_stdout.reserve(output.GetBytesLeft() / 2);
+
+        uint8_t ch;
+        while (output.GetHexU8Ex(ch))
+        {
+            if (ch != 0)
+                inferior_stdout.append(1, (char)ch);
+        }
+        AppendSTDOUT(inferior_stdout.c_str(), inferior_stdout.size());
+        return true;
+    }
+
     // skip %stop:
     StringExtractorGDBRemote stop_info(pkt.c_str() + 5);
 
@@ -4589,39 +4793,15 @@ ParseRegisters (XMLNode feature_node, GdbServerTargetInfo &target_info, GDBRemot
 } // namespace {}
 
 
-// query the target of gdb-remote for extended target information
-// return:  'true'  on success
-//          'false' on failure
 bool
-ProcessGDBRemote::GetGDBServerRegisterInfo ()
+ProcessGDBRemote::ParseTargetXML (const std::string &target_xml,
+                                  const std::function<bool (const std::string &include, std::string &xml)> &read_include,
+                                  GDBRemoteDynamicRegisterInfo &dyn_reg_info,
+                                  ABISP abi_sp)
 {
-    // Make sure LLDB has an XML parser it can use first
-    if (!XMLDocument::XMLEnabled())
-        return false;
-
-    // redirect libxml2's error handler since the default prints to stdout
-
-    GDBRemoteCommunicationClient & comm = m_gdb_comm;
-
-    // check that we have extended feature read support
-    if ( !comm.GetQXferFeaturesReadSupported( ) )
-        return false;
-
-    // request the target xml file
-    std::string raw;
-    lldb_private::Error lldberr;
-    if (!comm.ReadExtFeature(ConstString("features"),
-                             ConstString("target.xml"),
-                             raw,
-                             lldberr))
-    {
-        return false;
-    }
-    
-
     XMLDocument xml_document;
 
-    if (xml_document.ParseMemory(raw.c_str(), raw.size(), "target.xml"))
+    if (xml_document.ParseMemory(target_xml.c_str(), target_xml.size(), "target.xml"))
     {
         GdbServerTargetInfo target_info;
         
@@ -4629,7 +4809,7 @@ ProcessGDBRemote::GetGDBServerRegisterInfo ()
         if (target_node)
         {
             XMLNode feature_node;
-            target_node.ForEachChildElement([&target_info, this, &feature_node](const XMLNode &node) -> bool
+            target_node.ForEachChildElement([&target_info, &feature_node](const XMLNode &node) -> bool
             {
                 llvm::StringRef name = node.GetName();
                 if (name == "architecture")
@@ -4674,17 +4854,13 @@ ProcessGDBRemote::GetGDBServerRegisterInfo ()
             
             if (feature_node)
             {
-                ParseRegisters(feature_node, target_info, this->m_register_info, GetABI());
+                ParseRegisters(feature_node, target_info, dyn_reg_info, abi_sp);
             }
             
             for (const auto &include : target_info.includes)
             {
-                // request register file
                 std::string xml_data;
-                if (!comm.ReadExtFeature(ConstString("features"),
-                                         ConstString(include),
-                                         xml_data,
-                                         lldberr))
+                if (!read_include(include, xml_data))
                     continue;
 
                 XMLDocument include_xml_document;
@@ -4692,18 +4868,63 @@ ProcessGDBRemote::GetGDBServerRegisterInfo ()
                 XMLNode include_feature_node = include_xml_document.GetRootElement("feature");
                 if (include_feature_node)
                 {
-                    ParseRegisters(include_feature_node, target_info, this->m_register_info, GetABI());
+                    ParseRegisters(include_feature_node, target_info, dyn_reg_info, abi_sp);
                 }
             }
-            this->m_register_info.Finalize(GetTarget().GetArchitecture());
+            return true;
         }
     }
 
+    return false;
+}
+
+// query the target of gdb-remote for extended target information
+// return:  'true'  on success
+//          'false' on failure
+bool
+ProcessGDBRemote::GetGDBServerRegisterInfo ()
+{
+    // Make sure LLDB has an XML parser it can use first
+    if (!XMLDocument::XMLEnabled())
+        return false;
+
+    // redirect libxml2's error handler since the default prints to stdout
+
+    GDBRemoteCommunicationClient & comm = m_gdb_comm;
+
+    // check that we have extended feature read support
+    if ( !comm.GetQXferFeaturesReadSupported( ) )
+        return false;
+
+    // request the target xml file
+    std::string raw;
+    lldb_private::Error lldberr;
+    if (!comm.ReadExtFeature(ConstString("features"),
+                             ConstString("target.xml"),
+                             raw,
+                             lldberr))
+    {
+        return false;
+    }
+
+    auto read_include = [&comm, &lldberr](const std::string &include, std::string &xml_data) -> bool {
+        // request register file
+        return comm.ReadExtFeature(ConstString("features"),
+                                   ConstString(include),
+                                   xml_data,
+                                   lldberr);
+    };
+
+    if (ParseTargetXML(raw, read_include, this->m_register_info, GetABI()))
+        this->m_register_info.Finalize(GetTarget().GetArchitecture());
+
     return m_register_info.GetNumRegisters() > 0;
 }
 
 Error
-ProcessGDBRemote::GetLoadedModuleList (GDBLoadedModuleInfoList & list)
+ProcessGDBRemote::GetLoadedModuleList (LoadedModuleInfoList & list,
+                                       lldb::addr_t start_link_map,
+                                       lldb::addr_t prev_link_map)
 {
     // Make sure LLDB has an XML parser it can use first
     if (!XMLDocument::XMLEnabled())
@@ -4723,7 +4944,17 @@ ProcessGDBRemote::GetLoadedModuleList (GDBLoadedModuleInfoList & list)
         std::string raw;
         lldb_private::Error lldberr;
 
-        if (!comm.ReadExtFeature (ConstString ("libraries-svr4"), ConstString (""), raw, lldberr))
+        // ask for the entries from start_link_map on only, as described by
+        // the gdb remote protocol documentation of qXfer:libraries-svr4:read.
+        StreamString annex;
+        if (start_link_map != LLDB_INVALID_ADDRESS)
+        {
+            annex.Printf ("start=%" PRIx64, start_link_map);
+            if (prev_link_map != LLDB_INVALID_ADDRESS)
+                annex.Printf (";prev=%" PRIx64, prev_link_map);
+        }
+
+        if (!comm.ReadExtFeature (ConstString ("libraries-svr4"), ConstString (annex.GetData()), raw, lldberr))
           return Error (0, ErrorType::eErrorTypeGeneric);
 
         // parse the xml file in memory
@@ -4747,7 +4978,7 @@ ProcessGDBRemote::GetLoadedModuleList (GDBLoadedModuleInfoList & list)
 
         root_element.ForEachChildElementWithName("library", [log, &list](const XMLNode &library) -> bool {
 
-            GDBLoadedModuleInfoList::LoadedModuleInfo module;
+            LoadedModuleInfoList::LoadedModuleInfo module;
 
             library.ForEachAttribute([log, &module](const llvm::StringRef &name, const llvm::StringRef &value) -> bool {
                 
@@ -4795,7 +5026,7 @@ ProcessGDBRemote::GetLoadedModuleList (GDBLoadedModuleInfoList & list)
 
         if (log)
             log->Printf ("found %" PRId32 " modules in total", (int) list.m_list.size());
-    } else if (comm.GetQXferLibrariesReadSupported ()) {
+    } else if (comm.GetQXferLibrariesReadSupported () && start_link_map == LLDB_INVALID_ADDRESS) {
         list.clear ();
 
         // request the loaded library list
@@ -4817,7 +5048,7 @@ ProcessGDBRemote::GetLoadedModuleList (GDBLoadedModuleInfoList & list)
             return Error();
 
         root_element.ForEachChildElementWithName("library", [log, &list](const XMLNode &library) -> bool {
-            GDBLoadedModuleInfoList::LoadedModuleInfo module;
+            LoadedModuleInfoList::LoadedModuleInfo module;
 
             llvm::StringRef name = library.GetAttributeValue("name");
             module.set_name(name.str());
@@ -4884,14 +5115,17 @@ ProcessGDBRemote::LoadModules ()
     using lldb_private::process_gdb_remote::ProcessGDBRemote;
 
     // request a list of loaded libraries from GDBServer
-    GDBLoadedModuleInfoList module_list;
-    if (GetLoadedModuleList (module_list).Fail())
+    LoadedModuleInfoList module_list;
+    if (GetLoadedModuleList (module_list, LLDB_INVALID_ADDRESS, LLDB_INVALID_ADDRESS).Fail())
         return 0;
 
     // get a list of all the modules
     ModuleList new_modules;
 
-    for (GDBLoadedModuleInfoList::LoadedModuleInfo & modInfo : module_list.m_list)
+    // Resolve the breakpoints in all the new modules at once.
+    GetTarget().BeginModuleBatch();
+
+    for (LoadedModuleInfoList::LoadedModuleInfo & modInfo : module_list.m_list)
     {
         std::string  mod_name;
         lldb::addr_t mod_base;
@@ -4901,7 +5135,8 @@ ProcessGDBRemote::LoadModules ()
         valid &= modInfo.get_name (mod_name);
         valid &= modInfo.get_base (mod_base);
         valid &= modInfo.get_base_is_offset (mod_base_is_offset);
-        if (!valid)
+        // The executable has no name in an SVR4 link map.
+        if (!valid || mod_name.empty ())
             continue;
 
         // hack (cleaner way to get file name only?) (win/unix compat?)
@@ -4938,8 +5173,8 @@ ProcessGDBRemote::LoadModules ()
 
         ModuleList &loaded_modules = m_process->GetTarget().GetImages();
         loaded_modules.AppendIfNeeded (new_modules);
-        m_process->GetTarget().ModulesDidLoad (new_modules);
     }
+    GetTarget().EndModuleBatch (new_modules);
 
     return new_modules.GetSize();
 }
@@ -5293,6 +5528,265 @@ public:
     }    
 };
 
+class CommandObjectProcessGDBRemoteCollectSet : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessGDBRemoteCollectSet(CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process plugin collect set",
+                             "Make the remote stub collect registers and memory each time the code at an address runs, without stopping the process. "
+                             "Each item is an expression whose registers and the memory it loads from are collected, "
+                             "a \"@<size>\" suffix also collects <size> bytes at the address the expression evaluates to.",
+                             "process plugin collect set <address> <item> [<item> ...]",
+                             eCommandRequiresProcess | eCommandProcessMustBeLaunched | eCommandProcessMustBePaused)
+    {
+    }
+
+    ~CommandObjectProcessGDBRemoteCollectSet ()
+    {
+    }
+
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        const size_t argc = command.GetArgumentCount();
+        if (argc < 2)
+        {
+            result.AppendErrorWithFormat ("'%s' takes an address and one or more items to collect", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        Error error;
+        const lldb::addr_t addr = Args::StringToAddress (&m_exe_ctx, command.GetArgumentAtIndex(0), LLDB_INVALID_ADDRESS, &error);
+        if (addr == LLDB_INVALID_ADDRESS)
+        {
+            result.AppendErrorWithFormat ("invalid address '%s'", command.GetArgumentAtIndex(0));
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        std::vector<std::string> items;
+        for (size_t i = 1; i < argc; ++i)
+            items.push_back (command.GetArgumentAtIndex(i));
+
+        ProcessGDBRemote *process = (ProcessGDBRemote *)m_exe_ctx.GetProcessPtr();
+        error = process->SetCollectAction (addr, items);
+        if (error.Fail())
+        {
+            result.AppendError (error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+        result.SetStatus (eReturnStatusSuccessFinishNoResult);
+        return true;
+    }
+};
+
+class CommandObjectProcessGDBRemoteCollectClear : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessGDBRemoteCollectClear(CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process plugin collect clear",
+                             "Remove the collect action at an address.",
+                             "process plugin collect clear <address>",
+                             eCommandRequiresProcess | eCommandProcessMustBeLaunched | eCommandProcessMustBePaused)
+    {
+    }
+
+    ~CommandObjectProcessGDBRemoteCollectClear ()
+    {
+    }
+
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        if (command.GetArgumentCount() != 1)
+        {
+            result.AppendErrorWithFormat ("'%s' takes an address", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        Error error;
+        const lldb::addr_t addr = Args::StringToAddress (&m_exe_ctx, command.GetArgumentAtIndex(0), LLDB_INVALID_ADDRESS, &error);
+        if (addr == LLDB_INVALID_ADDRESS)
+        {
+            result.AppendErrorWithFormat ("invalid address '%s'", command.GetArgumentAtIndex(0));
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        ProcessGDBRemote *process = (ProcessGDBRemote *)m_exe_ctx.GetProcessPtr();
+        error = process->ClearCollectAction (addr);
+        if (error.Fail())
+        {
+            result.AppendError (error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+        result.SetStatus (eReturnStatusSuccessFinishNoResult);
+        return true;
+    }
+};
+
+class CommandObjectProcessGDBRemoteCollectDrain : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessGDBRemoteCollectDrain(CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process plugin collect drain",
+                             "Print and remove the samples collected by the remote stub.",
+                             "process plugin collect drain",
+                             eCommandRequiresProcess | eCommandProcessMustBeLaunched)
+    {
+    }
+
+    ~CommandObjectProcessGDBRemoteCollectDrain ()
+    {
+    }
+
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        if (command.GetArgumentCount() != 0)
+        {
+            result.AppendErrorWithFormat ("'%s' takes no arguments", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        ProcessGDBRemote *process = (ProcessGDBRemote *)m_exe_ctx.GetProcessPtr();
+        Thread *thread = m_exe_ctx.GetThreadPtr();
+        RegisterContextSP reg_ctx_sp (thread ? thread->GetRegisterContext() : RegisterContextSP());
+        const ByteOrder byte_order = process->GetByteOrder();
+        Stream &strm = result.GetOutputStream();
+
+        uint64_t num_samples = 0;
+        uint64_t num_dropped = 0;
+        // The stub returns a bounded number of samples for each packet.
+        while (true)
+        {
+            StructuredData::ObjectSP object_sp = process->GetGDBRemote().GetCollectedSamples();
+            StructuredData::Dictionary *dict = object_sp ? object_sp->GetAsDictionary() : nullptr;
+            if (!dict)
+            {
+                result.AppendError ("failed to read the collected samples");
+                result.SetStatus (eReturnStatusFailed);
+                return false;
+            }
+
+            uint64_t dropped = 0;
+            if (dict->GetValueForKeyAsInteger ("dropped", dropped))
+                num_dropped += dropped;
+
+            StructuredData::Array *samples = nullptr;
+            if (!dict->GetValueForKeyAsArray ("samples", samples) || samples->GetSize() == 0)
+                break;
+
+            samples->ForEach ([&](StructuredData::Object *object) -> bool
+            {
+                StructuredData::Dictionary *sample = object->GetAsDictionary();
+                if (!sample)
+                    return true;
+                ++num_samples;
+
+                uint64_t id = 0, tid = 0, addr = 0;
+                sample->GetValueForKeyAsInteger ("id", id);
+                sample->GetValueForKeyAsInteger ("tid", tid);
+                sample->GetValueForKeyAsInteger ("address", addr);
+                strm.Printf ("sample %" PRIu64 ": tid = 0x%4.4" PRIx64 ", address = 0x%" PRIx64 "\n", id, tid, addr);
+
+                StructuredData::Dictionary *registers = nullptr;
+                if (sample->GetValueForKeyAsDictionary ("registers", registers))
+                {
+                    registers->ForEach ([&](ConstString key, StructuredData::Object *value) -> bool
+                    {
+                        const uint32_t reg_num = StringConvert::ToUInt32 (key.GetCString(), LLDB_INVALID_REGNUM, 10);
+                        const RegisterInfo *reg_info = nullptr;
+                        if (reg_ctx_sp && reg_num != LLDB_INVALID_REGNUM)
+                        {
+                            const uint32_t reg_index = reg_ctx_sp->ConvertRegisterKindToRegisterNumber (eRegisterKindProcessPlugin, reg_num);
+                            if (reg_index != LLDB_INVALID_REGNUM)
+                                reg_info = reg_ctx_sp->GetRegisterInfoAtIndex (reg_index);
+                        }
+                        StructuredData::String *hex = value->GetAsString();
+                        if (!reg_info || !hex)
+                            return true;
+
+                        StringExtractor extractor (hex->GetValue().c_str());
+                        std::vector<uint8_t> bytes (hex->GetValue().size() / 2);
+                        bytes.resize (extractor.GetHexBytes (bytes.data(), bytes.size(), 0));
+                        RegisterValue reg_value;
+                        Error error;
+                        reg_value.SetFromMemoryData (reg_info, bytes.data(), bytes.size(), byte_order, error);
+                        if (error.Success())
+                        {
+                            strm.PutCString ("    ");
+                            reg_value.Dump (&strm, reg_info, true, false, eFormatDefault);
+                            strm.EOL();
+                        }
+                        return true;
+                    });
+                }
+
+                StructuredData::Array *memory = nullptr;
+                if (sample->GetValueForKeyAsArray ("memory", memory))
+                {
+                    memory->ForEach ([&](StructuredData::Object *block_object) -> bool
+                    {
+                        StructuredData::Dictionary *block = block_object->GetAsDictionary();
+                        uint64_t block_addr = 0;
+                        std::string hex;
+                        if (!block || !block->GetValueForKeyAsInteger ("address", block_addr) ||
+                            !block->GetValueForKeyAsString ("bytes", hex))
+                            return true;
+
+                        StringExtractor extractor (hex.c_str());
+                        std::vector<uint8_t> bytes (hex.size() / 2);
+                        bytes.resize (extractor.GetHexBytes (bytes.data(), bytes.size(), 0));
+                        if (bytes.empty())
+                        {
+                            strm.Printf ("    0x%" PRIx64 ": <unreadable>\n", block_addr);
+                            return true;
+                        }
+                        DataExtractor data (bytes.data(), bytes.size(), byte_order, process->GetAddressByteSize());
+                        StreamString block_strm;
+                        data.Dump (&block_strm, 0, eFormatBytesWithASCII, 1, bytes.size(), 16, block_addr, 0, 0);
+                        strm.Printf ("    %s\n", block_strm.GetString().c_str());
+                        return true;
+                    });
+                }
+                return true;
+            });
+        }
+
+        strm.Printf ("%" PRIu64 " samples, %" PRIu64 " dropped\n", num_samples, num_dropped);
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
+class CommandObjectProcessGDBRemoteCollect : public CommandObjectMultiword
+{
+public:
+    CommandObjectProcessGDBRemoteCollect(CommandInterpreter &interpreter) :
+        CommandObjectMultiword (interpreter,
+                                "process plugin collect",
+                                "Commands that collect data in the remote stub without stopping the process.",
+                                NULL)
+    {
+        LoadSubCommand ("set", CommandObjectSP (new CommandObjectProcessGDBRemoteCollectSet (interpreter)));
+        LoadSubCommand ("clear", CommandObjectSP (new CommandObjectProcessGDBRemoteCollectClear (interpreter)));
+        LoadSubCommand ("drain", CommandObjectSP (new CommandObjectProcessGDBRemoteCollectDrain (interpreter)));
+    }
+
+    ~CommandObjectProcessGDBRemoteCollect ()
+    {
+    }
+};
+
 class CommandObjectMultiwordProcessGDBRemote : public CommandObjectMultiword
 {
 public:
@@ -5303,6 +5797,7 @@ public:
                                 "process plugin <subcommand> [<subcommand-options>]")
     {
         LoadSubCommand ("packet", CommandObjectSP (new CommandObjectProcessGDBRemotePacket    (interpreter)));
+        LoadSubCommand ("collect", CommandObjectSP (new CommandObjectProcessGDBRemoteCollect   (interpreter)));
     }
 
     ~CommandObjectMultiwordProcessGDBRemote ()
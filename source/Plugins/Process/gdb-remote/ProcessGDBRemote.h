@@ -13,6 +13,7 @@
 // C Includes
 // C++ Includes
 #include <atomic>
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -68,6 +69,20 @@ public:
     static const char *
     GetPluginDescriptionStatic();
 
+    //------------------------------------------------------------------
+    /// Add the registers a target.xml document describes to a register
+    /// info, reading the documents it includes with read_include. The
+    /// register info is not finalized.
+    ///
+    /// @return
+    ///     False if the document has no target element.
+    //------------------------------------------------------------------
+    static bool
+    ParseTargetXML (const std::string &target_xml,
+                    const std::function<bool (const std::string &include, std::string &xml)> &read_include,
+                    GDBRemoteDynamicRegisterInfo &dyn_reg_info,
+                    lldb::ABISP abi_sp);
+
     //------------------------------------------------------------------
     // Check if a given Process
     //------------------------------------------------------------------
@@ -168,6 +183,9 @@ public:
     size_t
     DoReadMemory (lldb::addr_t addr, void *buf, size_t size, Error &error) override;
 
+    void
+    DoReadMemoryRanges (const MemoryRangeList &ranges, std::vector<lldb::DataBufferSP> &buffers) override;
+
     size_t
     DoWriteMemory (lldb::addr_t addr, const void *buf, size_t size, Error &error) override;
 
@@ -195,6 +213,24 @@ public:
     Error
     DisableBreakpointSite (BreakpointSite *bp_site) override;
 
+    Error
+    UpdateBreakpointSiteConditions (BreakpointSite *bp_site) override;
+
+    //------------------------------------------------------------------
+    /// Make the stub collect registers and memory each time the code at
+    /// \a addr runs, without stopping the process. The samples are
+    /// read with GDBRemoteCommunicationClient::GetCollectedSamples ().
+    ///
+    /// @param[in] items
+    ///     The expressions to collect, see
+    ///     GDBRemoteAgentExpressionCompiler::CompileCollect ().
+    //------------------------------------------------------------------
+    Error
+    SetCollectAction (lldb::addr_t addr, const std::vector<std::string> &items);
+
+    Error
+    ClearCollectAction (lldb::addr_t addr);
+
     //----------------------------------------------------------------------
     // Process Watchpoints
     //----------------------------------------------------------------------
@@ -247,6 +283,12 @@ public:
     size_t
     LoadModules() override;
 
+    // Query remote GDBServer for a detailed loaded library list
+    Error
+    GetLoadedModuleList (LoadedModuleInfoList &list,
+                         lldb::addr_t start_link_map,
+                         lldb::addr_t prev_link_map) override;
+
     Error
     GetFileLoadAddress(const FileSpec& file, bool& is_loaded, lldb::addr_t& load_addr) override;
 
@@ -261,8 +303,6 @@ protected:
     friend class GDBRemoteCommunicationClient;
     friend class GDBRemoteRegisterContext;
 
-    class GDBLoadedModuleInfoList;
-
     //------------------------------------------------------------------
     /// Broadcaster event bits definitions.
     //------------------------------------------------------------------
@@ -287,6 +327,8 @@ protected:
     typedef std::vector< std::pair<lldb::tid_t,int> > tid_sig_collection;
     typedef std::map<lldb::addr_t, lldb::addr_t> MMapMap;
     typedef std::map<uint32_t, std::string> ExpeditedRegisterMap;
+    typedef std::map<lldb::break_id_t, std::vector<std::vector<uint8_t>>> BreakpointConditionsMap;
+    typedef std::map<lldb::addr_t, uint32_t> CollectActionMap;
     tid_collection m_thread_ids; // Thread IDs for all threads. This list gets updated after stopping
     std::vector<lldb::addr_t> m_thread_pcs; // PC values for all the threads.
     StructuredData::ObjectSP m_jstopinfo_sp; // Stop info only for any threads that have valid stop infos
@@ -298,6 +340,8 @@ protected:
     uint64_t m_max_memory_size;       // The maximum number of bytes to read/write when reading and writing memory
     uint64_t m_remote_stub_max_memory_size;    // The maximum memory size the remote gdb stub can handle
     MMapMap m_addr_to_mmap_size;
+    BreakpointConditionsMap m_breakpoint_site_conditions; // The conditions sent with the Z0 packet of each breakpoint site
+    CollectActionMap m_collect_actions; // The size of the breakpoint inserted for each collect action, keyed by address
     lldb::BreakpointSP m_thread_create_bp_sp;
     bool m_waiting_for_attach;
     bool m_destroy_tried_resuming;
@@ -381,6 +425,17 @@ protected:
     void
     GetMaxMemorySize();
 
+    //------------------------------------------------------------------
+    /// Compile the conditions of the owners of a breakpoint site so the
+    /// stub can evaluate them.
+    ///
+    /// @return
+    ///     true if every owner has a condition and all of them compiled.
+    ///     The stub has to report every hit of the site otherwise.
+    //------------------------------------------------------------------
+    bool
+    GetBreakpointSiteConditions (BreakpointSite *bp_site, std::vector<std::vector<uint8_t>> &conditions);
+
     bool
     CalculateThreadStopInfo (ThreadGDBRemote *thread);
 
@@ -459,13 +514,14 @@ protected:
     bool
     GetGDBServerRegisterInfo ();
 
-    // Query remote GDBServer for a detailed loaded library list
-    Error
-    GetLoadedModuleList (GDBLoadedModuleInfoList &);
-
     lldb::ModuleSP
     LoadModuleAtAddress (const FileSpec &file, lldb::addr_t base_addr, bool value_is_offset);
 
+    // Read each range with its own memory read packet, with the packets
+    // pipelined. Used when the remote stub lacks jMultiMemRead.
+    void
+    ReadMemoryRangesPipelined (const MemoryRangeList &ranges, std::vector<lldb::DataBufferSP> &buffers);
+
 private:
     //------------------------------------------------------------------
     // For ProcessGDBRemote only
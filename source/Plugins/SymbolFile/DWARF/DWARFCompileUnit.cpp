@@ -43,6 +43,7 @@ DWARFCompileUnit::DWARFCompileUnit(SymbolFileDWARF* dwarf2Data) :
     m_abbrevs       (NULL),
     m_user_data     (NULL),
     m_die_array     (),
+    m_far_siblings  (),
     m_func_aranges_ap (),
     m_base_addr     (0),
     m_offset        (DW_INVALID_OFFSET),
@@ -74,6 +75,7 @@ DWARFCompileUnit::Clear()
     m_addr_size     = DWARFCompileUnit::GetDefaultAddressSize();
     m_base_addr     = 0;
     m_die_array.clear();
+    m_far_siblings.clear();
     m_func_aranges_ap.reset();
     m_user_data     = NULL;
     m_producer      = eProducerInvalid;
@@ -138,12 +140,29 @@ DWARFCompileUnit::ClearDIEs(bool keep_compile_unit_die)
         m_die_array.swap(tmp_array);
         if (keep_compile_unit_die)
             m_die_array.push_back(tmp_array.front());
+
+        std::vector<std::pair<uint32_t, uint32_t> > tmp_far_siblings;
+        m_far_siblings.swap(tmp_far_siblings);
     }
 
     if (m_dwo_symbol_file)
         m_dwo_symbol_file->GetCompileUnit()->ClearDIEs(keep_compile_unit_die);
 }
 
+const DWARFDebugInfoEntry*
+DWARFCompileUnit::GetFarSibling (const DWARFDebugInfoEntry *die) const
+{
+    if (m_die_array.empty() || die < &m_die_array.front() || die > &m_die_array.back())
+        return NULL;
+
+    const uint32_t die_idx = die - &m_die_array.front();
+    std::vector<std::pair<uint32_t, uint32_t> >::const_iterator pos =
+        std::lower_bound (m_far_siblings.begin(), m_far_siblings.end(), std::make_pair(die_idx, 0u));
+    if (pos == m_far_siblings.end() || pos->first != die_idx)
+        return NULL;
+    return &m_die_array[pos->second];
+}
+
 //----------------------------------------------------------------------
 // ParseCompileUnitDIEsIfNeeded
 //
@@ -231,8 +250,13 @@ DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
             {
                 die.SetParentIndex(m_die_array.size() - die_index_stack[depth-1]);
 
-                if (die_index_stack.back())
-                    m_die_array[die_index_stack.back()].SetSiblingIndex(m_die_array.size()-die_index_stack.back());
+                const uint32_t prev_sibling_idx = die_index_stack.back();
+                if (prev_sibling_idx)
+                {
+                    const uint32_t sibling_idx = m_die_array.size();
+                    if (!m_die_array[prev_sibling_idx].SetSiblingIndex(sibling_idx - prev_sibling_idx))
+                        m_far_siblings.push_back(std::make_pair(prev_sibling_idx, sibling_idx));
+                }
                 
                 // Only push the DIE if it isn't a NULL DIE
                     m_die_array.push_back(die);
@@ -286,6 +310,10 @@ DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
         DWARFDebugInfoEntry::collection exact_size_die_array (m_die_array.begin(), m_die_array.end());
         exact_size_die_array.swap (m_die_array);
     }
+
+    // Nested subtrees finish before the ones around them, so the far
+    // siblings were found out of DIE order.
+    std::sort (m_far_siblings.begin(), m_far_siblings.end());
     Log *verbose_log (LogChannelDWARF::GetLogIfAll (DWARF_LOG_DEBUG_INFO | DWARF_LOG_VERBOSE));
     if (verbose_log)
     {
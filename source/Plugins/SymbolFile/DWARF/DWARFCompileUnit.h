@@ -56,6 +56,13 @@ public:
     dw_addr_t   GetAddrBase() const { return m_addr_base; }
     void        SetAddrBase(dw_addr_t addr_base, dw_offset_t base_obj_offset);
     void        ClearDIEs(bool keep_compile_unit_die);
+
+    //------------------------------------------------------------------
+    // The sibling of a DIE in our DIE array whose subtree is too large
+    // for DWARFDebugInfoEntry to store the distance to its sibling.
+    //------------------------------------------------------------------
+    const DWARFDebugInfoEntry*
+                GetFarSibling (const DWARFDebugInfoEntry *die) const;
     void        BuildAddressRangeTable (SymbolFileDWARF* dwarf2Data,
                                         DWARFDebugAranges* debug_aranges);
 
@@ -204,6 +211,7 @@ protected:
     const DWARFAbbreviationDeclarationSet *m_abbrevs;
     void *              m_user_data;
     DWARFDebugInfoEntry::collection m_die_array;    // The compile unit debug information entry item
+    std::vector<std::pair<uint32_t, uint32_t> > m_far_siblings; // DIE and sibling indexes in m_die_array for siblings too far away for the DIE to store, sorted by DIE index
     std::unique_ptr<DWARFDebugAranges> m_func_aranges_ap;   // A table similar to the .debug_aranges table, but this one points to the exact DW_TAG_subprogram DIEs
     dw_addr_t           m_base_addr;
     dw_offset_t         m_offset;
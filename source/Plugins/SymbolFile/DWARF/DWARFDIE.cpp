@@ -76,7 +76,7 @@ DWARFDIE
 DWARFDIE::GetSibling () const
 {
     if (IsValid())
-        return DWARFDIE(m_cu, m_die->GetSibling());
+        return DWARFDIE(m_cu, m_die->GetSibling(m_cu));
     else
         return DWARFDIE();
 }
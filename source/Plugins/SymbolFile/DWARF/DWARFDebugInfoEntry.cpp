@@ -33,6 +33,8 @@ using namespace lldb_private;
 using namespace std;
 extern int g_verbose;
 
+static_assert (sizeof(DWARFDebugInfoEntry) == 12, "DWARFDebugInfoEntry should stay packed, compile units keep arrays of them resident");
+
 bool
 DWARFDebugInfoEntry::FastExtract
 (
@@ -45,18 +47,15 @@ DWARFDebugInfoEntry::FastExtract
     m_offset = *offset_ptr;
     m_parent_idx = 0;
     m_sibling_idx = 0;
-    m_empty_children = false;
     const uint64_t abbr_idx = debug_info_data.GetULEB128 (offset_ptr);
-    assert (abbr_idx < (1 << DIE_ABBR_IDX_BITSIZE));
-    m_abbr_idx = abbr_idx;
     
     //assert (fixed_form_sizes);  // For best performance this should be specified!
     
-    if (m_abbr_idx)
+    if (abbr_idx)
     {
         lldb::offset_t offset = *offset_ptr;
 
-        const DWARFAbbreviationDeclaration *abbrevDecl = cu->GetAbbreviations()->GetAbbreviationDeclaration(m_abbr_idx);
+        const DWARFAbbreviationDeclaration *abbrevDecl = cu->GetAbbreviations()->GetAbbreviationDeclaration(abbr_idx);
         
         if (abbrevDecl == NULL)
         {
@@ -214,8 +213,6 @@ DWARFDebugInfoEntry::Extract
         m_offset = offset;
 
         const uint64_t abbr_idx = debug_info_data.GetULEB128(&offset);
-        assert (abbr_idx < (1 << DIE_ABBR_IDX_BITSIZE));
-        m_abbr_idx = abbr_idx;
         if (abbr_idx)
         {
             const DWARFAbbreviationDeclaration *abbrevDecl = cu->GetAbbreviations()->GetAbbreviationDeclaration(abbr_idx);
@@ -635,7 +632,7 @@ DWARFDebugInfoEntry::Dump
 
         s.Printf("\n0x%8.8x: ", m_offset);
         s.Indent();
-        if (abbrCode != m_abbr_idx)
+        if ((abbrCode == 0) != IsNULL())
         {
             s.Printf( "error: DWARF has been modified\n");
         }
@@ -643,7 +640,11 @@ DWARFDebugInfoEntry::Dump
         {
             const DWARFAbbreviationDeclaration* abbrevDecl = cu->GetAbbreviations()->GetAbbreviationDeclaration (abbrCode);
 
-            if (abbrevDecl)
+            if (abbrevDecl && abbrevDecl->Tag() != m_tag)
+            {
+                s.Printf( "error: DWARF has been modified\n");
+            }
+            else if (abbrevDecl)
             {
                 s.PutCString(DW_TAG_value_to_name(abbrevDecl->Tag()));
                 s.Printf( " [%u] %c\n", abbrCode, abbrevDecl->HasChildren() ? '*':' ');
@@ -668,7 +669,7 @@ DWARFDebugInfoEntry::Dump
                     while (child)
                     {
                         child->Dump(dwarf2Data, cu, s, recurse_depth-1);
-                        child = child->GetSibling();
+                        child = child->GetSibling(cu);
                     }
                     s.IndentLess();
                 }
@@ -1499,14 +1500,14 @@ DWARFDebugInfoEntry::AppendTypeName
 }
 
 bool
-DWARFDebugInfoEntry::Contains (const DWARFDebugInfoEntry *die) const
+DWARFDebugInfoEntry::Contains (const DWARFCompileUnit *cu, const DWARFDebugInfoEntry *die) const
 {
     if (die)
     {
         const dw_offset_t die_offset = die->GetOffset();
         if (die_offset > GetOffset())
         {
-            const DWARFDebugInfoEntry *sibling = GetSibling();
+            const DWARFDebugInfoEntry *sibling = GetSibling(cu);
             assert (sibling); // TODO: take this out
             if (sibling)
                 return die_offset < sibling->GetOffset();
@@ -1544,7 +1545,7 @@ DWARFDebugInfoEntry::BuildAddressRangeTable
         while (child)
         {
             child->BuildAddressRangeTable(dwarf2Data, cu, debug_aranges);
-            child = child->GetSibling();
+            child = child->GetSibling(cu);
         }
     }
 }
@@ -1582,7 +1583,7 @@ DWARFDebugInfoEntry::BuildFunctionAddressRangeTable
         while (child)
         {
             child->BuildFunctionAddressRangeTable(dwarf2Data, cu, debug_aranges);
-            child = child->GetSibling();
+            child = child->GetSibling(cu);
         }
     }
 }
@@ -1958,7 +1959,7 @@ DWARFDebugInfoEntry::LookupAddress
             {
                 if (child->LookupAddress(address, dwarf2Data, cu, function_die, block_die))
                     return true;
-                child = child->GetSibling();
+                child = child->GetSibling(cu);
             }
         }
     }
@@ -1975,30 +1976,40 @@ DWARFDebugInfoEntry::GetAbbreviationDeclarationPtr (SymbolFileDWARF* dwarf2Data,
         offset = GetOffset();
 
         const DWARFAbbreviationDeclarationSet *abbrev_set = cu->GetAbbreviations();
-        if (abbrev_set)
+        if (abbrev_set && !IsNULL())
         {
-            const DWARFAbbreviationDeclaration* abbrev_decl = abbrev_set->GetAbbreviationDeclaration (m_abbr_idx);
-            if (abbrev_decl)
-            {
-                // Make sure the abbreviation code still matches. If it doesn't and
-                // the DWARF data was mmap'ed, the backing file might have been modified
-                // which is bad news.
-                const uint64_t abbrev_code = dwarf2Data->get_debug_info_data().GetULEB128 (&offset);
-            
-                if (abbrev_decl->Code() == abbrev_code)
-                    return abbrev_decl;
-                
-                dwarf2Data->GetObjectFile()->GetModule()->ReportErrorIfModifyDetected ("0x%8.8x: the DWARF debug information has been modified (abbrev code was %u, and is now %u)", 
-                                                                                       GetOffset(),
-                                                                                       (uint32_t)abbrev_decl->Code(),
-                                                                                       (uint32_t)abbrev_code);
-            }
+            // The abbreviation code isn't stored in the DIE, so read it again.
+            const uint64_t abbrev_code = dwarf2Data->get_debug_info_data().GetULEB128 (&offset);
+            const DWARFAbbreviationDeclaration* abbrev_decl = abbrev_set->GetAbbreviationDeclaration (abbrev_code);
+
+            // Make sure the tag still matches. If it doesn't and the DWARF
+            // data was mmap'ed, the backing file might have been modified
+            // which is bad news.
+            if (abbrev_decl && abbrev_decl->Tag() == m_tag)
+                return abbrev_decl;
+
+            dwarf2Data->GetObjectFile()->GetModule()->ReportErrorIfModifyDetected ("0x%8.8x: the DWARF debug information has been modified (tag was %s, and is now %s)",
+                                                                                   GetOffset(),
+                                                                                   DW_TAG_value_to_name (m_tag),
+                                                                                   abbrev_decl ? DW_TAG_value_to_name (abbrev_decl->Tag()) : "invalid");
         }
     }
     offset = DW_INVALID_OFFSET;
     return NULL;
 }
 
+//----------------------------------------------------------------------
+// GetFarSibling
+//
+// Called when the distance to our sibling didn't fit in m_sibling_idx.
+// The compile unit keeps those siblings in a side table.
+//----------------------------------------------------------------------
+const DWARFDebugInfoEntry*
+DWARFDebugInfoEntry::GetFarSibling (const DWARFCompileUnit* cu) const
+{
+    return cu ? cu->GetFarSibling(this) : NULL;
+}
+
 
 bool
 DWARFDebugInfoEntry::OffsetLessThan (const DWARFDebugInfoEntry& a, const DWARFDebugInfoEntry& b)
@@ -2007,7 +2018,7 @@ DWARFDebugInfoEntry::OffsetLessThan (const DWARFDebugInfoEntry& a, const DWARFDe
 }
 
 void
-DWARFDebugInfoEntry::DumpDIECollection (Stream &strm, DWARFDebugInfoEntry::collection &die_collection)
+DWARFDebugInfoEntry::DumpDIECollection (Stream &strm, const DWARFCompileUnit *cu, DWARFDebugInfoEntry::collection &die_collection)
 {
     DWARFDebugInfoEntry::const_iterator pos;
     DWARFDebugInfoEntry::const_iterator end = die_collection.end();
@@ -2017,7 +2028,7 @@ DWARFDebugInfoEntry::DumpDIECollection (Stream &strm, DWARFDebugInfoEntry::colle
     {
         const DWARFDebugInfoEntry& die_ref = *pos;
         const DWARFDebugInfoEntry* p = die_ref.GetParent();
-        const DWARFDebugInfoEntry* s = die_ref.GetSibling();
+        const DWARFDebugInfoEntry* s = die_ref.GetSibling(cu);
         const DWARFDebugInfoEntry* c = die_ref.GetFirstChild();
         strm.Printf("%.8x: %.8x %.8x %.8x 0x%4.4x %s%s\n", 
                     die_ref.GetOffset(),
@@ -43,8 +43,8 @@ typedef UInt32ToDIEMMap::const_iterator                     UInt32ToDIEMMapConst
 
 class DWARFDeclContext;
 
-#define DIE_SIBLING_IDX_BITSIZE 31
-#define DIE_ABBR_IDX_BITSIZE 15
+#define DIE_SIBLING_IDX_BITSIZE 14
+#define DIE_SIBLING_IDX_FAR     ((1u << DIE_SIBLING_IDX_BITSIZE) - 1)
 
 class DWARFDebugInfoEntry
 {
@@ -62,7 +62,6 @@ public:
                     m_parent_idx    (0),
                     m_sibling_idx   (0),
                     m_empty_children(false),
-                    m_abbr_idx      (0),
                     m_has_children  (false),
                     m_tag           (0)
                 {
@@ -74,12 +73,11 @@ public:
                     m_parent_idx     = 0;
                     m_sibling_idx    = 0;
                     m_empty_children = false;
-                    m_abbr_idx       = 0;
                     m_has_children   = false;
                     m_tag            = 0;
                 }
 
-    bool        Contains (const DWARFDebugInfoEntry *die) const;
+    bool        Contains (const DWARFCompileUnit *cu, const DWARFDebugInfoEntry *die) const;
 
     void        BuildAddressRangeTable(
                     SymbolFileDWARF* dwarf2Data,
@@ -267,7 +265,9 @@ public:
     bool
     IsNULL() const 
     {
-        return m_abbr_idx == 0; 
+        // Abbreviation declarations always have a non-zero tag, so only
+        // NULL entries (abbreviation code zero) have a zero tag.
+        return m_tag == 0; 
     }
 
     dw_offset_t
@@ -300,8 +300,15 @@ public:
     const   DWARFDebugInfoEntry*    GetParent()     const   { return m_parent_idx > 0 ? this - m_parent_idx : NULL;  }
             // We know we are kept in a vector of contiguous entries, so we know
             // our sibling will be some index after "this".
-            DWARFDebugInfoEntry*    GetSibling()            { return m_sibling_idx > 0 ? this + m_sibling_idx : NULL;  }
-    const   DWARFDebugInfoEntry*    GetSibling()    const   { return m_sibling_idx > 0 ? this + m_sibling_idx : NULL;  }
+            // Siblings that are too far away to fit in m_sibling_idx are kept
+            // in a table in the compile unit "cu" whose DIE array we are in.
+            DWARFDebugInfoEntry*    GetSibling(const DWARFCompileUnit* cu)          { return const_cast<DWARFDebugInfoEntry*>(static_cast<const DWARFDebugInfoEntry*>(this)->GetSibling(cu)); }
+    const   DWARFDebugInfoEntry*    GetSibling(const DWARFCompileUnit* cu)  const
+                                    {
+                                        if (m_sibling_idx == DIE_SIBLING_IDX_FAR)
+                                            return GetFarSibling(cu);
+                                        return m_sibling_idx > 0 ? this + m_sibling_idx : NULL;
+                                    }
             // We know we are kept in a vector of contiguous entries, so we know
             // we don't need to store our child pointer, if we have a child it will
             // be the next entry in the list...
@@ -327,36 +334,13 @@ public:
                                                              DWARFCompileUnit* cu, 
                                                              const DWARFAttributes& attributes) const;
 
-    void        
-    SetParent (DWARFDebugInfoEntry* parent)     
-    {
-        if (parent)
-        {
-            // We know we are kept in a vector of contiguous entries, so we know
-            // our parent will be some index behind "this".
-            m_parent_idx = this - parent;
-        }
-        else        
-            m_parent_idx = 0;
-    }
-    void
-    SetSibling (DWARFDebugInfoEntry* sibling)
-    {
-        if (sibling)
-        {
-            // We know we are kept in a vector of contiguous entries, so we know
-            // our sibling will be some index after "this".
-            m_sibling_idx = sibling - this;
-            sibling->SetParent(GetParent()); 
-        }
-        else        
-            m_sibling_idx = 0;
-    }
-
-    void
+    // Returns false if "idx" is too large to be stored, the compile unit
+    // then has to keep the sibling in its table of far siblings.
+    bool
     SetSiblingIndex (uint32_t idx)
     {
-        m_sibling_idx = idx;
+        m_sibling_idx = idx < DIE_SIBLING_IDX_FAR ? idx : DIE_SIBLING_IDX_FAR;
+        return idx < DIE_SIBLING_IDX_FAR;
     }
     
     void
@@ -379,6 +363,7 @@ public:
 
     static void
     DumpDIECollection (lldb_private::Stream &strm,
+                       const DWARFCompileUnit *cu,
                        DWARFDebugInfoEntry::collection &die_collection);
 
 protected:
@@ -389,11 +374,17 @@ protected:
                                   dw_offset_t* end_attr_offset_ptr = nullptr,
                                   bool check_specification_or_abstract_origin = false) const;
 
+    const DWARFDebugInfoEntry*
+    GetFarSibling (const DWARFCompileUnit* cu) const;
+
+    // Every extracted DIE of a compile unit is kept resident in
+    // DWARFCompileUnit::m_die_array, so this is packed into 12 bytes, down
+    // from 16. The abbreviation code isn't stored: it is re-read from the
+    // .debug_info when the attributes are needed.
     dw_offset_t m_offset;           // Offset within the .debug_info of the start of this entry
     uint32_t    m_parent_idx;       // How many to subtract from "this" to get the parent. If zero this die has no parent
-    uint32_t    m_sibling_idx:31,   // How many to add to "this" to get the sibling.
-                m_empty_children:1; // If a DIE says it had children, yet it just contained a NULL tag, this will be set.
-    uint32_t    m_abbr_idx:DIE_ABBR_IDX_BITSIZE,
+    uint32_t    m_sibling_idx:DIE_SIBLING_IDX_BITSIZE, // How many to add to "this" to get the sibling, DIE_SIBLING_IDX_FAR if it doesn't fit
+                m_empty_children:1, // If a DIE says it had children, yet it just contained a NULL tag, this will be set.
                 m_has_children:1,   // Set to 1 if this DIE has children
                 m_tag:16;           // A copy of the DW_TAG value so we don't have to go through the compile unit abbrev table
 };
@@ -0,0 +1,174 @@
+//===-- DWARFGdbIndex.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DWARFGdbIndex.h"
+
+#include <ctype.h>
+
+#include "lldb/Core/Timer.h"
+#include "Plugins/Language/CPlusPlus/CPlusPlusLanguage.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// Version 5 changed the hash function, version 7 added symbol attributes
+// to the CU vectors and version 8 only changed how gdb handles the index.
+static const uint32_t kMinSupportedVersion = 5;
+static const uint32_t kMaxSupportedVersion = 8;
+static const uint32_t kHeaderSize = 6 * sizeof(uint32_t);
+static const uint32_t kCUIndexMask = 0x00ffffffu;
+
+DWARFGdbIndex::DWARFGdbIndex (const DataExtractor &data) :
+    m_data (data),
+    m_version (0),
+    m_cu_list_offset (0),
+    m_num_cus (0),
+    m_symbol_table_offset (0),
+    m_num_symbol_slots (0),
+    m_constant_pool_offset (0),
+    m_base_name_map_once (),
+    m_base_name_map ()
+{
+    // The index is always little endian, regardless of the target.
+    m_data.SetByteOrder (eByteOrderLittle);
+    if (!m_data.ValidOffsetForDataOfSize (0, kHeaderSize))
+        return;
+
+    lldb::offset_t offset = 0;
+    const uint32_t version = m_data.GetU32 (&offset);
+    const uint32_t cu_list_offset = m_data.GetU32 (&offset);
+    const uint32_t types_cu_list_offset = m_data.GetU32 (&offset);
+    m_data.GetU32 (&offset); // address area offset
+    const uint32_t symbol_table_offset = m_data.GetU32 (&offset);
+    const uint32_t constant_pool_offset = m_data.GetU32 (&offset);
+
+    if (version < kMinSupportedVersion || version > kMaxSupportedVersion)
+        return;
+    if (cu_list_offset < kHeaderSize ||
+        types_cu_list_offset < cu_list_offset ||
+        constant_pool_offset < symbol_table_offset ||
+        constant_pool_offset > m_data.GetByteSize ())
+        return;
+
+    // The symbol table is an open addressed hash table whose size is a
+    // power of two.
+    const uint32_t num_symbol_slots = (constant_pool_offset - symbol_table_offset) / (2 * sizeof(uint32_t));
+    if (num_symbol_slots == 0 || (num_symbol_slots & (num_symbol_slots - 1)) != 0)
+        return;
+
+    m_cu_list_offset = cu_list_offset;
+    m_num_cus = (types_cu_list_offset - cu_list_offset) / (2 * sizeof(uint64_t));
+    m_symbol_table_offset = symbol_table_offset;
+    m_num_symbol_slots = num_symbol_slots;
+    m_constant_pool_offset = constant_pool_offset;
+    m_version = version;
+}
+
+uint32_t
+DWARFGdbIndex::HashName (const char *name) const
+{
+    // This is mapped_index_string_hash from gdb/dwarf2read.c.
+    uint32_t r = 0;
+    for (const unsigned char *s = (const unsigned char *)name; *s; ++s)
+    {
+        unsigned char c = *s;
+        if (m_version >= 5)
+            c = tolower (c);
+        r = r * 67 + c - 113;
+    }
+    return r;
+}
+
+void
+DWARFGdbIndex::AppendCompileUnits (uint32_t cu_vector_offset, std::vector<dw_offset_t> &cu_offsets) const
+{
+    lldb::offset_t offset = m_constant_pool_offset + cu_vector_offset;
+    const uint32_t num_entries = m_data.GetU32 (&offset);
+    if (!m_data.ValidOffsetForDataOfSize (offset, num_entries * sizeof(uint32_t)))
+        return;
+
+    for (uint32_t i = 0; i < num_entries; ++i)
+    {
+        // The upper bits hold the symbol kind and static flag (version 7
+        // and later). Indexes past the CU list refer to type units, which
+        // aren't supported.
+        const uint32_t cu_index = m_data.GetU32 (&offset) & kCUIndexMask;
+        if (cu_index >= m_num_cus)
+            continue;
+        lldb::offset_t cu_entry_offset = m_cu_list_offset + cu_index * 2 * sizeof(uint64_t);
+        const uint64_t cu_offset = m_data.GetU64 (&cu_entry_offset);
+        if (cu_offset < DW_INVALID_OFFSET)
+            cu_offsets.push_back (cu_offset);
+    }
+}
+
+void
+DWARFGdbIndex::BuildBaseNameMap ()
+{
+    Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+
+    lldb::offset_t offset = m_symbol_table_offset;
+    for (uint32_t slot = 0; slot < m_num_symbol_slots; ++slot)
+    {
+        const uint32_t name_offset = m_data.GetU32 (&offset);
+        const uint32_t cu_vector_offset = m_data.GetU32 (&offset);
+        if (name_offset == 0 && cu_vector_offset == 0)
+            continue;
+
+        lldb::offset_t name_data_offset = m_constant_pool_offset + name_offset;
+        const char *name = m_data.GetCStr (&name_data_offset);
+        if (name == nullptr)
+            continue;
+
+        llvm::StringRef context;
+        llvm::StringRef basename;
+        if (CPlusPlusLanguage::ExtractContextAndIdentifier (name, context, basename) && !context.empty ())
+            m_base_name_map.Append (ConstString (basename).GetCString (), cu_vector_offset);
+    }
+    m_base_name_map.Sort ();
+}
+
+size_t
+DWARFGdbIndex::FindCompileUnits (const ConstString &name, std::vector<dw_offset_t> &cu_offsets)
+{
+    const char *name_cstr = name.GetCString ();
+    if (!IsValid () || name_cstr == nullptr)
+        return 0;
+
+    const size_t initial_size = cu_offsets.size ();
+    const uint32_t hash = HashName (name_cstr);
+    const uint32_t mask = m_num_symbol_slots - 1;
+    const uint32_t step = ((hash * 17) & mask) | 1;
+    uint32_t slot = hash & mask;
+    for (uint32_t probes = 0; probes < m_num_symbol_slots; ++probes)
+    {
+        lldb::offset_t offset = m_symbol_table_offset + slot * 2 * sizeof(uint32_t);
+        const uint32_t name_offset = m_data.GetU32 (&offset);
+        const uint32_t cu_vector_offset = m_data.GetU32 (&offset);
+        if (name_offset == 0 && cu_vector_offset == 0)
+            break;
+
+        lldb::offset_t name_data_offset = m_constant_pool_offset + name_offset;
+        const char *slot_name = m_data.GetCStr (&name_data_offset);
+        if (slot_name && strcmp (slot_name, name_cstr) == 0)
+        {
+            AppendCompileUnits (cu_vector_offset, cu_offsets);
+            break;
+        }
+        slot = (slot + step) & mask;
+    }
+
+    std::call_once (m_base_name_map_once, [this]() { BuildBaseNameMap (); });
+    std::vector<uint32_t> cu_vector_offsets;
+    m_base_name_map.GetValues (name_cstr, cu_vector_offsets);
+    for (uint32_t cu_vector_offset : cu_vector_offsets)
+        AppendCompileUnits (cu_vector_offset, cu_offsets);
+
+    return cu_offsets.size () - initial_size;
+}
@@ -0,0 +1,81 @@
+//===-- DWARFGdbIndex.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SymbolFileDWARF_DWARFGdbIndex_h_
+#define SymbolFileDWARF_DWARFGdbIndex_h_
+
+#include <mutex>
+#include <vector>
+
+#include "lldb/lldb-defines.h"
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/UniqueCStringMap.h"
+#include "lldb/Core/dwarf.h"
+
+//----------------------------------------------------------------------
+// Reader for the .gdb_index accelerator section emitted by linkers with
+// --gdb-index (and by gdb-add-index). The index maps qualified names to
+// the compile units that define them, but not to DIEs, so it is used to
+// pick the compile units that need to be indexed for a lookup instead
+// of indexing the whole .debug_info.
+//
+// See https://sourceware.org/gdb/onlinedocs/gdb/Index-Section-Format.html
+//----------------------------------------------------------------------
+class DWARFGdbIndex
+{
+public:
+    DWARFGdbIndex (const lldb_private::DataExtractor &data);
+
+    bool
+    IsValid () const
+    {
+        return m_version != 0;
+    }
+
+    //------------------------------------------------------------------
+    /// Append the .debug_info offsets of the compile units that contain
+    /// a symbol named \a name. \a name can either be fully qualified, as
+    /// stored in the index, or just the base name of a qualified entry.
+    ///
+    /// @return
+    ///     The number of compile unit offsets appended, which may
+    ///     contain duplicates.
+    //------------------------------------------------------------------
+    size_t
+    FindCompileUnits (const lldb_private::ConstString &name,
+                      std::vector<dw_offset_t> &cu_offsets);
+
+protected:
+    uint32_t
+    HashName (const char *name) const;
+
+    void
+    AppendCompileUnits (uint32_t cu_vector_offset,
+                        std::vector<dw_offset_t> &cu_offsets) const;
+
+    void
+    BuildBaseNameMap ();
+
+    lldb_private::DataExtractor m_data;
+    uint32_t m_version;
+    uint32_t m_cu_list_offset;
+    uint32_t m_num_cus;
+    uint32_t m_symbol_table_offset;
+    uint32_t m_num_symbol_slots;
+    uint32_t m_constant_pool_offset;
+
+    // Maps the base name of every qualified entry to its CU vector offset
+    // in the constant pool. Built on first use, since the index itself
+    // only stores qualified names.
+    std::once_flag m_base_name_map_once;
+    lldb_private::UniqueCStringMap<uint32_t> m_base_name_map;
+};
+
+#endif  // SymbolFileDWARF_DWARFGdbIndex_h_
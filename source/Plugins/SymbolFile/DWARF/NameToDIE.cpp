@@ -9,6 +9,7 @@
 
 #include "NameToDIE.h"
 #include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/RegularExpression.h"
@@ -29,6 +30,12 @@ NameToDIE::Finalize()
     m_map.SizeToFit ();
 }
 
+void
+NameToDIE::Clear()
+{
+    m_map.Clear();
+}
+
 void
 NameToDIE::Insert (const ConstString& name, const DIERef& die_ref)
 {
@@ -94,3 +101,69 @@ NameToDIE::Append (const NameToDIE& other)
                      other.m_map.GetValueAtIndexUnchecked (i));
     }
 }
+
+void
+NameToDIE::Merge (NameToDIE& other)
+{
+    other.m_map.Sort ();
+    m_map.Merge (other.m_map);
+}
+
+void
+NameToDIE::Encode (Stream &strm) const
+{
+    // Entries are sorted by name pointer, so all DIEs for a name are
+    // adjacent. Each name is written once followed by the DIEs for it.
+    const uint32_t size = m_map.GetSize();
+    uint32_t num_names = 0;
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        if (i == 0 || m_map.GetCStringAtIndexUnchecked(i) != m_map.GetCStringAtIndexUnchecked(i - 1))
+            ++num_names;
+    }
+
+    strm.PutHex32(num_names);
+    uint32_t i = 0;
+    while (i < size)
+    {
+        const char *cstr = m_map.GetCStringAtIndexUnchecked(i);
+        uint32_t end = i + 1;
+        while (end < size && m_map.GetCStringAtIndexUnchecked(end) == cstr)
+            ++end;
+
+        strm.Write(cstr, strlen(cstr) + 1);
+        strm.PutHex32(end - i);
+        for (; i < end; ++i)
+        {
+            const DIERef& die_ref = m_map.GetValueRefAtIndexUnchecked(i);
+            strm.PutHex32(die_ref.cu_offset);
+            strm.PutHex32(die_ref.die_offset);
+        }
+    }
+}
+
+bool
+NameToDIE::Decode (const DataExtractor &data, lldb::offset_t *offset_ptr)
+{
+    if (!data.ValidOffsetForDataOfSize(*offset_ptr, sizeof(uint32_t)))
+        return false;
+    const uint32_t num_names = data.GetU32(offset_ptr);
+    for (uint32_t name_idx = 0; name_idx < num_names; ++name_idx)
+    {
+        const char *cstr = data.GetCStr(offset_ptr);
+        if (cstr == nullptr || !data.ValidOffsetForDataOfSize(*offset_ptr, sizeof(uint32_t)))
+            return false;
+        const uint32_t num_dies = data.GetU32(offset_ptr);
+        if (!data.ValidOffsetForDataOfSize(*offset_ptr, num_dies * 2 * sizeof(uint32_t)))
+            return false;
+
+        ConstString name(cstr);
+        for (uint32_t i = 0; i < num_dies; ++i)
+        {
+            const dw_offset_t cu_offset = data.GetU32(offset_ptr);
+            const dw_offset_t die_offset = data.GetU32(offset_ptr);
+            m_map.Append(name.GetCString(), DIERef(cu_offset, die_offset));
+        }
+    }
+    return true;
+}
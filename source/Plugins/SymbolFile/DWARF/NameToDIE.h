@@ -40,9 +40,19 @@ public:
     void
     Append (const NameToDIE& other);
 
+    //------------------------------------------------------------------
+    /// Sort the entries of \a other and merge them into this finalized
+    /// map, which stays finalized.
+    //------------------------------------------------------------------
+    void
+    Merge (NameToDIE& other);
+
     void
     Finalize();
 
+    void
+    Clear();
+
     size_t
     Find (const lldb_private::ConstString &name, DIEArray &info_array) const;
     
@@ -55,6 +65,23 @@ public:
     void
     ForEach (std::function <bool(const char *name, const DIERef& die_ref)> const &callback) const;
 
+    //------------------------------------------------------------------
+    /// Serialize a finalized map into \a strm, which must be a binary
+    /// stream, so it can be read back with NameToDIE::Decode().
+    //------------------------------------------------------------------
+    void
+    Encode (lldb_private::Stream &strm) const;
+
+    //------------------------------------------------------------------
+    /// Append the entries written by NameToDIE::Encode() at
+    /// \a offset_ptr in \a data. The map must be finalized afterwards.
+    ///
+    /// @return
+    ///     False if the encoded data is truncated or malformed.
+    //------------------------------------------------------------------
+    bool
+    Decode (const lldb_private::DataExtractor &data, lldb::offset_t *offset_ptr);
+
 protected:
     lldb_private::UniqueCStringMap<DIERef> m_map;
 };
@@ -10,6 +10,7 @@
 #include "SymbolFileDWARF.h"
 
 // Other libraries and framework includes
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Casting.h"
 
 #include "lldb/Core/ArchSpec.h"
@@ -27,6 +28,7 @@
 
 #include "Plugins/ExpressionParser/Clang/ClangModulesDeclVendor.h"
 
+#include "lldb/Host/Endian.h"
 #include "lldb/Host/FileSystem.h"
 #include "lldb/Host/Host.h"
 
@@ -52,6 +54,7 @@
 #include "lldb/Target/Language.h"
 
 #include "lldb/Utility/TaskPool.h"
+#include "Utility/IndexCache.h"
 
 #include "DWARFASTParser.h"
 #include "DWARFCompileUnit.h"
@@ -65,6 +68,7 @@
 #include "DWARFDeclContext.h"
 #include "DWARFDIECollection.h"
 #include "DWARFFormValue.h"
+#include "DWARFGdbIndex.h"
 #include "LogChannelDWARF.h"
 #include "SymbolFileDWARFDwo.h"
 #include "SymbolFileDWARFDebugMap.h"
@@ -452,6 +456,7 @@ SymbolFileDWARF::SymbolFileDWARF(ObjectFile* objfile) :
     m_apple_types_ap (),
     m_apple_namespaces_ap (),
     m_apple_objc_ap (),
+    m_gdb_index_ap (),
     m_function_basename_index(),
     m_function_fullname_index(),
     m_function_method_index(),
@@ -460,6 +465,7 @@ SymbolFileDWARF::SymbolFileDWARF(ObjectFile* objfile) :
     m_global_index(),
     m_type_index(),
     m_namespace_index(),
+    m_gdb_indexed_cus(),
     m_indexed (false),
     m_using_apple_tables (false),
     m_fetched_external_modules (false),
@@ -567,6 +573,19 @@ SymbolFileDWARF::InitializeObject()
         else
             m_apple_objc_ap.reset();
     }
+
+    // The Apple tables are preferred when both kinds of accelerator
+    // tables are present.
+    if (!m_using_apple_tables)
+    {
+        get_gdb_index_data();
+        if (m_data_gdb_index.m_data.GetByteSize() > 0)
+        {
+            m_gdb_index_ap.reset (new DWARFGdbIndex (m_data_gdb_index.m_data));
+            if (!m_gdb_index_ap->IsValid())
+                m_gdb_index_ap.reset();
+        }
+    }
 }
 
 bool
@@ -765,6 +784,12 @@ SymbolFileDWARF::get_apple_objc_data()
     return GetCachedSectionData (eSectionTypeDWARFAppleObjC, m_data_apple_objc);
 }
 
+const DWARFDataExtractor&
+SymbolFileDWARF::get_gdb_index_data()
+{
+    return GetCachedSectionData (eSectionTypeDWARFGdbIndex, m_data_gdb_index);
+}
+
 
 DWARFDebugAbbrev*
 SymbolFileDWARF::DebugAbbrev()
@@ -2075,6 +2100,28 @@ SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line,
     return sc_list.GetSize() - prev_size;
 }
 
+bool
+SymbolFileDWARF::GetFunctionNames (std::unordered_set<const char *> &names)
+{
+    // The accelerator tables and the .gdb_index can already be searched
+    // by name without building the full index.
+    if (m_using_apple_tables || (m_gdb_index_ap && !m_indexed))
+        return false;
+
+    Index ();
+
+    auto add_name = [&names](const char *name, const DIERef &die_ref) -> bool
+    {
+        names.insert (name);
+        return true;
+    };
+    m_function_basename_index.ForEach (add_name);
+    m_function_fullname_index.ForEach (add_name);
+    m_function_method_index.ForEach (add_name);
+    m_function_selector_index.ForEach (add_name);
+    return true;
+}
+
 void
 SymbolFileDWARF::Index ()
 {
@@ -2085,80 +2132,31 @@ SymbolFileDWARF::Index ()
                         "SymbolFileDWARF::Index (%s)",
                         GetObjectFile()->GetFileSpec().GetFilename().AsCString("<Unknown>"));
 
+    // Drop anything that was indexed on demand for .gdb_index lookups so
+    // the full index doesn't end up with duplicate entries.
+    if (!m_gdb_indexed_cus.empty())
+    {
+        m_function_basename_index.Clear();
+        m_function_fullname_index.Clear();
+        m_function_method_index.Clear();
+        m_function_selector_index.Clear();
+        m_objc_class_selectors_index.Clear();
+        m_global_index.Clear();
+        m_type_index.Clear();
+        m_namespace_index.Clear();
+        m_gdb_indexed_cus.clear();
+    }
+
+    if (LoadIndexCache())
+        return;
+
     DWARFDebugInfo* debug_info = DebugInfo();
     if (debug_info)
     {
-        const uint32_t num_compile_units = GetNumCompileUnits();
-        std::vector<NameToDIE> function_basename_index(num_compile_units);
-        std::vector<NameToDIE> function_fullname_index(num_compile_units);
-        std::vector<NameToDIE> function_method_index(num_compile_units);
-        std::vector<NameToDIE> function_selector_index(num_compile_units);
-        std::vector<NameToDIE> objc_class_selectors_index(num_compile_units);
-        std::vector<NameToDIE> global_index(num_compile_units);
-        std::vector<NameToDIE> type_index(num_compile_units);
-        std::vector<NameToDIE> namespace_index(num_compile_units);
-        
-        auto parser_fn = [this,
-                          debug_info,
-                          &function_basename_index,
-                          &function_fullname_index,
-                          &function_method_index,
-                          &function_selector_index,
-                          &objc_class_selectors_index,
-                          &global_index,
-                          &type_index,
-                          &namespace_index](uint32_t cu_idx)
-        {
-            DWARFCompileUnit* dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
-            bool clear_dies = dwarf_cu->ExtractDIEsIfNeeded(false) > 1;
-
-            dwarf_cu->Index(function_basename_index[cu_idx],
-                            function_fullname_index[cu_idx],
-                            function_method_index[cu_idx],
-                            function_selector_index[cu_idx],
-                            objc_class_selectors_index[cu_idx],
-                            global_index[cu_idx],
-                            type_index[cu_idx],
-                            namespace_index[cu_idx]);
-
-            // Keep memory down by clearing DIEs if this generate function
-            // caused them to be parsed
-            if (clear_dies)
-                dwarf_cu->ClearDIEs(true);
-
-            return cu_idx;
-        };
-
-        TaskRunner<uint32_t> task_runner;
-        for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
-            task_runner.AddTask(parser_fn, cu_idx);
-
-        while (true)
-        {
-            std::future<uint32_t> f = task_runner.WaitForNextCompletedTask();
-            if (!f.valid())
-                break;
-            uint32_t cu_idx = f.get();
-
-            m_function_basename_index.Append(function_basename_index[cu_idx]);
-            m_function_fullname_index.Append(function_fullname_index[cu_idx]);
-            m_function_method_index.Append(function_method_index[cu_idx]);
-            m_function_selector_index.Append(function_selector_index[cu_idx]);
-            m_objc_class_selectors_index.Append(objc_class_selectors_index[cu_idx]);
-            m_global_index.Append(global_index[cu_idx]);
-            m_type_index.Append(type_index[cu_idx]);
-            m_namespace_index.Append(namespace_index[cu_idx]);
-        }
-
-        TaskPool::RunTasks(
-            [&]() { m_function_basename_index.Finalize(); },
-            [&]() { m_function_fullname_index.Finalize(); },
-            [&]() { m_function_method_index.Finalize(); },
-            [&]() { m_function_selector_index.Finalize(); },
-            [&]() { m_objc_class_selectors_index.Finalize(); },
-            [&]() { m_global_index.Finalize(); },
-            [&]() { m_type_index.Finalize(); },
-            [&]() { m_namespace_index.Finalize(); });
+        std::vector<uint32_t> cu_indexes(GetNumCompileUnits());
+        for (uint32_t cu_idx = 0; cu_idx < cu_indexes.size(); ++cu_idx)
+            cu_indexes[cu_idx] = cu_idx;
+        IndexCompileUnits(cu_indexes, false);
 
 #if defined (ENABLE_DEBUG_PRINTF)
         StreamFile s(stdout, false);
@@ -2173,6 +2171,253 @@ SymbolFileDWARF::Index ()
         s.Printf("\nTypes:\n");                 m_type_index.Dump (&s);
         s.Printf("\nNamespaces:\n")             m_namespace_index.Dump (&s);
 #endif
+
+        SaveIndexCache();
+    }
+}
+
+//----------------------------------------------------------------------
+// Index the DIEs of the compile units in "cu_indexes" in parallel and
+// merge the results into the name indexes, which are kept finalized.
+// Unless "keep_dies" is set, DIEs that were extracted only for indexing
+// are cleared again to keep memory down.
+//----------------------------------------------------------------------
+void
+SymbolFileDWARF::IndexCompileUnits (const std::vector<uint32_t> &cu_indexes, bool keep_dies)
+{
+    DWARFDebugInfo* debug_info = DebugInfo();
+    if (debug_info == nullptr || cu_indexes.empty())
+        return;
+
+    const size_t num_compile_units = cu_indexes.size();
+    std::vector<NameToDIE> function_basename_index(num_compile_units);
+    std::vector<NameToDIE> function_fullname_index(num_compile_units);
+    std::vector<NameToDIE> function_method_index(num_compile_units);
+    std::vector<NameToDIE> function_selector_index(num_compile_units);
+    std::vector<NameToDIE> objc_class_selectors_index(num_compile_units);
+    std::vector<NameToDIE> global_index(num_compile_units);
+    std::vector<NameToDIE> type_index(num_compile_units);
+    std::vector<NameToDIE> namespace_index(num_compile_units);
+
+    auto parser_fn = [debug_info,
+                      keep_dies,
+                      &cu_indexes,
+                      &function_basename_index,
+                      &function_fullname_index,
+                      &function_method_index,
+                      &function_selector_index,
+                      &objc_class_selectors_index,
+                      &global_index,
+                      &type_index,
+                      &namespace_index](size_t idx)
+    {
+        DWARFCompileUnit* dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_indexes[idx]);
+        bool clear_dies = dwarf_cu->ExtractDIEsIfNeeded(false) > 1 && !keep_dies;
+
+        dwarf_cu->Index(function_basename_index[idx],
+                        function_fullname_index[idx],
+                        function_method_index[idx],
+                        function_selector_index[idx],
+                        objc_class_selectors_index[idx],
+                        global_index[idx],
+                        type_index[idx],
+                        namespace_index[idx]);
+
+        // Keep memory down by clearing DIEs if this generate function
+        // caused them to be parsed
+        if (clear_dies)
+            dwarf_cu->ClearDIEs(true);
+    };
+
+    TaskMapOverInt(0, num_compile_units, parser_fn);
+
+    // Merge in compile unit order so the resulting indexes don't depend on
+    // the order the tasks happened to finish in. Only the new entries get
+    // sorted, the indexes are already finalized when compile units are
+    // indexed on demand for .gdb_index lookups.
+    NameToDIE *indexes[] = { &m_function_basename_index,
+                             &m_function_fullname_index,
+                             &m_function_method_index,
+                             &m_function_selector_index,
+                             &m_objc_class_selectors_index,
+                             &m_global_index,
+                             &m_type_index,
+                             &m_namespace_index };
+    std::vector<NameToDIE> *cu_indexes_by_kind[] = { &function_basename_index,
+                                                     &function_fullname_index,
+                                                     &function_method_index,
+                                                     &function_selector_index,
+                                                     &objc_class_selectors_index,
+                                                     &global_index,
+                                                     &type_index,
+                                                     &namespace_index };
+    auto merge_fn = [&indexes, &cu_indexes_by_kind](size_t kind)
+    {
+        NameToDIE new_entries;
+        for (const NameToDIE &cu_index : *cu_indexes_by_kind[kind])
+            new_entries.Append(cu_index);
+        indexes[kind]->Merge(new_entries);
+    };
+
+    TaskMapOverInt(0, llvm::array_lengthof(indexes), merge_fn);
+}
+
+//----------------------------------------------------------------------
+// When the module has a .gdb_index section, index only the compile
+// units the .gdb_index says define "name" instead of all of them.
+// Returns false if the whole .debug_info needs to be indexed instead.
+//----------------------------------------------------------------------
+bool
+SymbolFileDWARF::IndexCompileUnitsForName (const ConstString &name)
+{
+    if (!m_gdb_index_ap || !name)
+        return false;
+
+    // The index only contains source level names, so linkage names
+    // can't be looked up through it.
+    const char *name_cstr = name.GetCString();
+    if (name_cstr[0] == '_' && name_cstr[1] == 'Z')
+        return false;
+
+    DWARFDebugInfo* debug_info = DebugInfo();
+    if (debug_info == nullptr)
+        return false;
+
+    if (m_gdb_indexed_cus.empty())
+        m_gdb_indexed_cus.resize(GetNumCompileUnits(), false);
+
+    std::vector<dw_offset_t> cu_offsets;
+    m_gdb_index_ap->FindCompileUnits(name, cu_offsets);
+
+    std::vector<uint32_t> cu_indexes;
+    for (dw_offset_t cu_offset : cu_offsets)
+    {
+        uint32_t cu_idx = UINT32_MAX;
+        if (debug_info->GetCompileUnit(cu_offset, &cu_idx) &&
+            cu_idx < m_gdb_indexed_cus.size() &&
+            !m_gdb_indexed_cus[cu_idx])
+        {
+            m_gdb_indexed_cus[cu_idx] = true;
+            cu_indexes.push_back(cu_idx);
+        }
+    }
+
+    if (!cu_indexes.empty())
+    {
+        Timer scoped_timer (__PRETTY_FUNCTION__,
+                            "SymbolFileDWARF::IndexCompileUnitsForName (%s, \"%s\") indexing %" PRIu64 " compile units",
+                            GetObjectFile()->GetFileSpec().GetFilename().AsCString("<Unknown>"),
+                            name_cstr,
+                            (uint64_t)cu_indexes.size());
+        // The lookup that triggered this resolves DIEs from these compile
+        // units right away, so keep their DIEs around.
+        IndexCompileUnits(cu_indexes, true);
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------
+// The finalized name indexes can be stored in the on-disk index cache
+// keyed by module UUID. The entry signature is the modification time of
+// the object file the DWARF came from, and the payload records the
+// compile unit count and .debug_info size as a further sanity check.
+//----------------------------------------------------------------------
+bool
+SymbolFileDWARF::LoadIndexCache ()
+{
+    const FileSpec cache_root (IndexCache::GetCacheRoot());
+    if (!cache_root)
+        return false;
+
+    UUID uuid;
+    std::string entry_name;
+    uint64_t signature = 0;
+    if (!IndexCache::GetEntryForObjectFile("dwarf-index", GetObjectFile(), uuid, entry_name, signature))
+        return false;
+
+    DataExtractor data;
+    if (!IndexCache::Get(cache_root, uuid, entry_name.c_str(), signature, data))
+        return false;
+
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "SymbolFileDWARF::LoadIndexCache (%s)",
+                        GetObjectFile()->GetFileSpec().GetFilename().AsCString("<Unknown>"));
+
+    lldb::offset_t offset = 0;
+    if (data.GetU32(&offset) != GetNumCompileUnits() ||
+        data.GetU64(&offset) != get_debug_info_data().GetByteSize())
+        return false;
+
+    NameToDIE *indexes[] = { &m_function_basename_index,
+                             &m_function_fullname_index,
+                             &m_function_method_index,
+                             &m_function_selector_index,
+                             &m_objc_class_selectors_index,
+                             &m_global_index,
+                             &m_type_index,
+                             &m_namespace_index };
+    for (NameToDIE *index : indexes)
+    {
+        if (!index->Decode(data, &offset))
+        {
+            for (NameToDIE *partial_index : indexes)
+                *partial_index = NameToDIE();
+
+            Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO));
+            if (log)
+                GetObjectFile()->GetModule()->LogMessage(log, "ignoring malformed DWARF index cache entry \"%s\"",
+                                                         entry_name.c_str());
+            return false;
+        }
+    }
+
+    // The maps are sorted by ConstString pointer value, which differs from
+    // session to session, so they need to be sorted again.
+    TaskPool::RunTasks(
+        [&]() { m_function_basename_index.Finalize(); },
+        [&]() { m_function_fullname_index.Finalize(); },
+        [&]() { m_function_method_index.Finalize(); },
+        [&]() { m_function_selector_index.Finalize(); },
+        [&]() { m_objc_class_selectors_index.Finalize(); },
+        [&]() { m_global_index.Finalize(); },
+        [&]() { m_type_index.Finalize(); },
+        [&]() { m_namespace_index.Finalize(); });
+    return true;
+}
+
+void
+SymbolFileDWARF::SaveIndexCache ()
+{
+    const FileSpec cache_root (IndexCache::GetCacheRoot());
+    if (!cache_root)
+        return;
+
+    UUID uuid;
+    std::string entry_name;
+    uint64_t signature = 0;
+    if (!IndexCache::GetEntryForObjectFile("dwarf-index", GetObjectFile(), uuid, entry_name, signature))
+        return;
+
+    StreamString strm (Stream::eBinary, sizeof(void *), endian::InlHostByteOrder());
+    strm.PutHex32(GetNumCompileUnits());
+    strm.PutHex64(get_debug_info_data().GetByteSize());
+    m_function_basename_index.Encode(strm);
+    m_function_fullname_index.Encode(strm);
+    m_function_method_index.Encode(strm);
+    m_function_selector_index.Encode(strm);
+    m_objc_class_selectors_index.Encode(strm);
+    m_global_index.Encode(strm);
+    m_type_index.Encode(strm);
+    m_namespace_index.Encode(strm);
+
+    Error error = IndexCache::Put(cache_root, uuid, entry_name.c_str(), signature,
+                                  strm.GetData(), strm.GetSize());
+    if (error.Fail())
+    {
+        Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO));
+        if (log)
+            GetObjectFile()->GetModule()->LogMessage(log, "failed to write DWARF index cache entry \"%s\": %s",
+                                                     entry_name.c_str(), error.AsCString());
     }
 }
 
@@ -2247,7 +2492,7 @@ SymbolFileDWARF::FindGlobalVariables (const ConstString &name, const CompilerDec
     else
     {
         // Index the DWARF if we haven't already
-        if (!m_indexed)
+        if (!m_indexed && !IndexCompileUnitsForName (name))
             Index ();
 
         m_global_index.Find (name, die_offsets);
@@ -2766,7 +3011,7 @@ SymbolFileDWARF::FindFunctions (const ConstString &name,
     {
 
         // Index the DWARF if we haven't already
-        if (!m_indexed)
+        if (!m_indexed && !IndexCompileUnitsForName (name))
             Index ();
 
         if (name_type_mask & eFunctionNameTypeFull)
@@ -2976,7 +3221,7 @@ SymbolFileDWARF::FindTypes (const SymbolContext& sc,
     }
     else
     {
-        if (!m_indexed)
+        if (!m_indexed && !IndexCompileUnitsForName (name))
             Index ();
 
         m_type_index.Find (name, die_offsets);
@@ -3095,7 +3340,7 @@ SymbolFileDWARF::FindTypes (const std::vector<CompilerContext> &context,
     }
     else
     {
-        if (!m_indexed)
+        if (!m_indexed && !IndexCompileUnitsForName (name))
             Index ();
 
         m_type_index.Find (name, die_offsets);
@@ -3621,7 +3866,7 @@ SymbolFileDWARF::FindDefinitionTypeForDWARFDeclContext (const DWARFDeclContext &
             }
             else
             {
-                if (!m_indexed)
+                if (!m_indexed && !IndexCompileUnitsForName (type_name))
                     Index ();
                 
                 m_type_index.Find (type_name, die_offsets);
@@ -57,6 +57,7 @@ class DWARFDebugRanges;
 class DWARFDeclContext;
 class DWARFDIECollection;
 class DWARFFormValue;
+class DWARFGdbIndex;
 class SymbolFileDWARFDebugMap;
 
 #define DIE_IS_BEING_PARSED ((lldb_private::Type*)1)
@@ -208,6 +209,9 @@ public:
                    bool append,
                    lldb_private::SymbolContextList& sc_list) override;
 
+    bool
+    GetFunctionNames (std::unordered_set<const char *> &names) override;
+
     uint32_t
     FindTypes (const lldb_private::SymbolContext& sc,
                const lldb_private::ConstString &name,
@@ -262,6 +266,7 @@ public:
     const lldb_private::DWARFDataExtractor&     get_apple_types_data ();
     const lldb_private::DWARFDataExtractor&     get_apple_namespaces_data ();
     const lldb_private::DWARFDataExtractor&     get_apple_objc_data ();
+    const lldb_private::DWARFDataExtractor&     get_gdb_index_data ();
 
 
     DWARFDebugAbbrev*
@@ -456,6 +461,18 @@ protected:
 
     void
     Index();
+
+    void
+    IndexCompileUnits(const std::vector<uint32_t> &cu_indexes, bool keep_dies);
+
+    bool
+    IndexCompileUnitsForName(const lldb_private::ConstString &name);
+
+    bool
+    LoadIndexCache();
+
+    void
+    SaveIndexCache();
     
     void
     DumpIndexes();
@@ -548,6 +565,7 @@ protected:
     DWARFDataSegment                      m_data_apple_types;
     DWARFDataSegment                      m_data_apple_namespaces;
     DWARFDataSegment                      m_data_apple_objc;
+    DWARFDataSegment                      m_data_gdb_index;
 
     // The unique pointer items below are generated on demand if and when someone accesses
     // them through a non const version of this class.
@@ -558,6 +576,7 @@ protected:
     std::unique_ptr<DWARFMappedHash::MemoryTable> m_apple_types_ap;
     std::unique_ptr<DWARFMappedHash::MemoryTable> m_apple_namespaces_ap;
     std::unique_ptr<DWARFMappedHash::MemoryTable> m_apple_objc_ap;
+    std::unique_ptr<DWARFGdbIndex>        m_gdb_index_ap;
     std::unique_ptr<GlobalVariableMap>  m_global_aranges_ap;
 
     typedef std::unordered_map<lldb::offset_t, lldb_private::DebugMacrosSP> DebugMacrosMap;
@@ -572,6 +591,7 @@ protected:
     NameToDIE                           m_global_index;             // Global and static variables
     NameToDIE                           m_type_index;               // All type DIE offsets
     NameToDIE                           m_namespace_index;          // All type DIE offsets
+    std::vector<bool>                   m_gdb_indexed_cus;          // Compile units already indexed because .gdb_index pointed at them
     bool                                m_indexed:1,
                                         m_using_apple_tables:1,
                                         m_fetched_external_modules:1;
@@ -104,6 +104,13 @@ public:
              uint32_t type_mask,
              lldb_private::TypeList &type_list) override;
 
+    bool
+    GetFunctionNames(std::unordered_set<const char *> &names) override
+    {
+        // Functions are only found through the symbol table.
+        return true;
+    }
+
     //------------------------------------------------------------------
     // PluginInterface protocol
     //------------------------------------------------------------------
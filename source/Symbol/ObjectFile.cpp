@@ -372,6 +372,7 @@ ObjectFile::GetAddressClass (addr_t file_addr)
                     case eSectionTypeDWARFAppleTypes:
                     case eSectionTypeDWARFAppleNamespaces:
                     case eSectionTypeDWARFAppleObjC:
+                    case eSectionTypeDWARFGdbIndex:
                         return eAddressClassDebug;
                     case eSectionTypeEHFrame:
                     case eSectionTypeARMexidx:
@@ -356,6 +356,20 @@ SymbolVendor::FindFunctions(const RegularExpression& regex, bool include_inlines
     return 0;
 }
 
+bool
+SymbolVendor::GetFunctionNames(std::unordered_set<const char *> &names)
+{
+    ModuleSP module_sp(GetModule());
+    if (module_sp)
+    {
+        lldb_private::Mutex::Locker locker(module_sp->GetMutex());
+        if (m_sym_file_ap.get())
+            return m_sym_file_ap->GetFunctionNames(names);
+    }
+    // Without a symbol file there are no functions to find.
+    return true;
+}
+
 
 size_t
 SymbolVendor::FindTypes (const SymbolContext& sc, const ConstString &name, const CompilerDeclContext *parent_decl_ctx, bool append, size_t max_matches, TypeMap& types)
@@ -10,23 +10,29 @@
 #include <map>
 #include <set>
 
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Core/Stream.h"
+#include "lldb/Core/StreamString.h"
 #include "lldb/Core/Timer.h"
+#include "lldb/Core/UUID.h"
+#include "lldb/Host/Endian.h"
+#include "lldb/Host/TimeValue.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/Symtab.h"
+#include "lldb/Utility/TaskPool.h"
 #include "Plugins/Language/ObjC/ObjCLanguage.h"
 #include "Plugins/Language/CPlusPlus/CPlusPlusLanguage.h"
+#include "Utility/IndexCache.h"
 
 using namespace lldb;
 using namespace lldb_private;
 
-
-
 Symtab::Symtab(ObjectFile *objfile) :
     m_objfile (objfile),
     m_symbols (),
@@ -260,13 +266,17 @@ Symtab::SymbolAtIndex(size_t idx) const
 // InitNameIndexes
 //----------------------------------------------------------------------
 void
-Symtab::InitNameIndexes()
+Symtab::InitNameIndexes (size_t chunk_size)
 {
     // Protected function, no need to lock mutex...
     if (!m_name_indexes_computed)
     {
         m_name_indexes_computed = true;
         Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+        // Seed the mangled counterparts of the symbol names from the on-disk
+        // cache so the symbols below don't have to be demangled again
+        const bool demangled_names_cached = LoadDemangledNameCache();
+
         // Create the name index vector to be able to quickly search by name
         const size_t num_symbols = m_symbols.size();
 #if 1
@@ -291,125 +301,74 @@ Symtab::InitNameIndexes()
         m_name_to_index.Reserve (actual_count);
 #endif
 
-        NameToIndexMap::Entry entry;
+        // Demangle and classify the symbols in parallel, in chunks of
+        // consecutive symbols. Each chunk records its results in symbol
+        // order, so merging the chunks in order below gives the same
+        // entries, in the same order, as indexing the symbols serially.
+        if (chunk_size == 0)
+            chunk_size = 1;
+        const size_t num_chunks = (num_symbols + chunk_size - 1) / chunk_size;
+        std::vector<NameIndexChunk> chunks(num_chunks);
+        TaskMapOverInt(0, num_chunks, [this, num_symbols, chunk_size, &chunks](size_t chunk_idx)
+        {
+            const uint32_t begin = chunk_idx * chunk_size;
+            const uint32_t end = std::min<size_t>(begin + chunk_size, num_symbols);
+            IndexSymbolNames (begin, end, chunks[chunk_idx]);
+        });
+
+        // The "const char *" keys in "class_contexts" must come from a
+        // ConstString::GetCString(). Each context maps to the index of the
+        // first symbol that identified it as a class.
+        std::map<const char *, uint32_t> class_contexts;
+        for (const NameIndexChunk &chunk : chunks)
+        {
+            for (const auto &pos : chunk.class_contexts)
+            {
+                auto inserted = class_contexts.insert(pos);
+                if (!inserted.second && pos.second < inserted.first->second)
+                    inserted.first->second = pos.second;
+            }
+        }
 
-        // The "const char *" in "class_contexts" must come from a ConstString::GetCString()
-        std::set<const char *> class_contexts;
         UniqueCStringMap<uint32_t> mangled_name_to_index;
         std::vector<const char *> symbol_contexts(num_symbols, nullptr);
-
-        for (entry.value = 0; entry.value<num_symbols; ++entry.value)
+        for (const NameIndexChunk &chunk : chunks)
         {
-            const Symbol *symbol = &m_symbols[entry.value];
-
-            // Don't let trampolines get into the lookup by name map
-            // If we ever need the trampoline symbols to be searchable by name
-            // we can remove this and then possibly add a new bool to any of the
-            // Symtab functions that lookup symbols by name to indicate if they
-            // want trampolines.
-            if (symbol->IsTrampoline())
-                continue;
-
-            const Mangled &mangled = symbol->GetMangled();
-            entry.cstring = mangled.GetMangledName().GetCString();
-            if (entry.cstring && entry.cstring[0])
-            {
+            for (const NameToIndexMap::Entry &entry : chunk.names)
                 m_name_to_index.Append (entry);
-
-                if (symbol->ContainsLinkerAnnotations()) {
-                    // If the symbol has linker annotations, also add the version without the
-                    // annotations.
-                    entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(entry.cstring)).GetCString();
-                    m_name_to_index.Append (entry);
-                }
-                
-                const SymbolType symbol_type = symbol->GetType();
-                if (symbol_type == eSymbolTypeCode || symbol_type == eSymbolTypeResolver)
+            for (const NameToIndexMap::Entry &entry : chunk.selectors)
+                m_selector_to_index.Append (entry);
+            for (const NameToIndexMap::Entry &entry : chunk.basenames)
+                m_basename_to_index.Append (entry);
+            for (const NameIndexChunk::CxxMethodEntry &method : chunk.methods)
+            {
+                if (method.context == nullptr)
                 {
-                    if (entry.cstring[0] == '_' && entry.cstring[1] == 'Z' &&
-                        (entry.cstring[2] != 'T' && // avoid virtual table, VTT structure, typeinfo structure, and typeinfo name
-                         entry.cstring[2] != 'G' && // avoid guard variables
-                         entry.cstring[2] != 'Z'))  // named local entities (if we eventually handle eSymbolTypeData, we will want this back)
-                    {
-                        CPlusPlusLanguage::MethodName cxx_method (mangled.GetDemangledName(lldb::eLanguageTypeC_plus_plus));
-                        entry.cstring = ConstString(cxx_method.GetBasename()).GetCString();
-                        if (entry.cstring && entry.cstring[0])
-                        {
-                            // ConstString objects permanently store the string in the pool so calling
-                            // GetCString() on the value gets us a const char * that will never go away
-                            const char *const_context = ConstString(cxx_method.GetContext()).GetCString();
-
-                            if (entry.cstring[0] == '~' || !cxx_method.GetQualifiers().empty())
-                            {
-                                // The first character of the demangled basename is '~' which
-                                // means we have a class destructor. We can use this information
-                                // to help us know what is a class and what isn't.
-                                if (class_contexts.find(const_context) == class_contexts.end())
-                                    class_contexts.insert(const_context);
-                                m_method_to_index.Append (entry);
-                            }
-                            else
-                            {
-                                if (const_context && const_context[0])
-                                {
-                                    if (class_contexts.find(const_context) != class_contexts.end())
-                                    {
-                                        // The current decl context is in our "class_contexts" which means
-                                        // this is a method on a class
-                                        m_method_to_index.Append (entry);
-                                    }
-                                    else
-                                    {
-                                        // We don't know if this is a function basename or a method,
-                                        // so put it into a temporary collection so once we are done
-                                        // we can look in class_contexts to see if each entry is a class
-                                        // or just a function and will put any remaining items into
-                                        // m_method_to_index or m_basename_to_index as needed
-                                        mangled_name_to_index.Append (entry);
-                                        symbol_contexts[entry.value] = const_context;
-                                    }
-                                }
-                                else
-                                {
-                                    // No context for this function so this has to be a basename
-                                    m_basename_to_index.Append(entry);
-                                }
-                            }
-                        }
-                    }
+                    m_method_to_index.Append (method.entry);
+                    continue;
                 }
-            }
-            
-            entry.cstring = mangled.GetDemangledName(symbol->GetLanguage()).GetCString();
-            if (entry.cstring && entry.cstring[0]) {
-                m_name_to_index.Append (entry);
 
-                if (symbol->ContainsLinkerAnnotations()) {
-                    // If the symbol has linker annotations, also add the version without the
-                    // annotations.
-                    entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(entry.cstring)).GetCString();
-                    m_name_to_index.Append (entry);
+                auto pos = class_contexts.find(method.context);
+                if (pos != class_contexts.end() && pos->second < method.entry.value)
+                {
+                    // An earlier symbol already told us the context is a class
+                    // which means this is a method on a class
+                    m_method_to_index.Append (method.entry);
                 }
-            }
-                
-            // If the demangled name turns out to be an ObjC name, and
-            // is a category name, add the version without categories to the index too.
-            ObjCLanguage::MethodName objc_method (entry.cstring, true);
-            if (objc_method.IsValid(true))
-            {
-                entry.cstring = objc_method.GetSelector().GetCString();
-                m_selector_to_index.Append (entry);
-                
-                ConstString objc_method_no_category (objc_method.GetFullNameWithoutCategory(true));
-                if (objc_method_no_category)
+                else
                 {
-                    entry.cstring = objc_method_no_category.GetCString();
-                    m_name_to_index.Append (entry);
+                    // We don't know if this is a function basename or a method,
+                    // so put it into a temporary collection so once we are done
+                    // we can look in class_contexts to see if each entry is a class
+                    // or just a function and will put any remaining items into
+                    // m_method_to_index or m_basename_to_index as needed
+                    mangled_name_to_index.Append (method.entry);
+                    symbol_contexts[method.entry.value] = method.context;
                 }
             }
-                                                        
         }
-        
+
+        NameToIndexMap::Entry entry;
         size_t count;
         if (!mangled_name_to_index.IsEmpty())
         {
@@ -441,6 +400,9 @@ Symtab::InitNameIndexes()
         m_basename_to_index.SizeToFit();
         m_method_to_index.Sort();
         m_method_to_index.SizeToFit();
+
+        if (!demangled_names_cached)
+            SaveDemangledNameCache();
     
 //        static StreamFile a ("/tmp/a.txt");
 //
@@ -465,6 +427,187 @@ Symtab::InitNameIndexes()
     }
 }
 
+//----------------------------------------------------------------------
+// LoadDemangledNameCache
+//
+// The cache holds the mangled and demangled names of all symbols that
+// were demangled the last time the name indexes of this module were
+// built. Loading it sets the mangled counterpart of each mangled name
+// in the string pool, which Mangled::GetDemangledName() checks before
+// running the demangler.
+//----------------------------------------------------------------------
+bool
+Symtab::LoadDemangledNameCache ()
+{
+    const FileSpec cache_root (IndexCache::GetCacheRoot());
+    if (!cache_root)
+        return false;
+
+    UUID uuid;
+    std::string entry_name;
+    uint64_t signature = 0;
+    if (!IndexCache::GetEntryForObjectFile("demangled-names", m_objfile, uuid, entry_name, signature))
+        return false;
+
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "Symtab::LoadDemangledNameCache (%s)",
+                        m_objfile->GetFileSpec().GetFilename().AsCString("<Unknown>"));
+
+    // Names read before a malformed part of the entry are still valid, only
+    // the rest of the symbols will be demangled.
+    IndexCache::DemangledNameList names;
+    const bool success = IndexCache::GetDemangledNames(cache_root, uuid, entry_name.c_str(), signature,
+                                                       m_symbols.size(), names);
+    for (const auto &name : names)
+    {
+        ConstString demangled;
+        demangled.SetCStringWithMangledCounterpart(name.second.GetCString(), name.first);
+    }
+    return success;
+}
+
+void
+Symtab::SaveDemangledNameCache ()
+{
+    const FileSpec cache_root (IndexCache::GetCacheRoot());
+    if (!cache_root)
+        return;
+
+    UUID uuid;
+    std::string entry_name;
+    uint64_t signature = 0;
+    if (!IndexCache::GetEntryForObjectFile("demangled-names", m_objfile, uuid, entry_name, signature))
+        return;
+
+    // Only store names that were actually demangled, the mangled counterpart
+    // isn't set for names that aren't mangled or failed to demangle.
+    IndexCache::DemangledNameList names;
+    for (const Symbol &symbol : m_symbols)
+    {
+        const ConstString &mangled = symbol.GetMangled().GetMangledName();
+        ConstString demangled;
+        if (mangled && mangled.GetMangledCounterpart(demangled))
+            names.push_back(std::make_pair(mangled, demangled));
+    }
+
+    Error error = IndexCache::PutDemangledNames(cache_root, uuid, entry_name.c_str(), signature,
+                                                m_symbols.size(), names);
+    if (error.Fail())
+    {
+        Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+        if (log)
+            log->Printf("Symtab::%s failed to write demangled name cache entry \"%s\": %s",
+                        __FUNCTION__, entry_name.c_str(), error.AsCString());
+    }
+}
+
+//----------------------------------------------------------------------
+// IndexSymbolNames
+//
+// Demangle and classify the names of the symbols in [begin, end) for
+// InitNameIndexes(). This only reads the symbol table and the string
+// pool, so it can run for different chunks concurrently.
+//----------------------------------------------------------------------
+void
+Symtab::IndexSymbolNames (uint32_t begin, uint32_t end, NameIndexChunk &chunk)
+{
+    NameToIndexMap::Entry entry;
+
+    for (entry.value = begin; entry.value<end; ++entry.value)
+    {
+        const Symbol *symbol = &m_symbols[entry.value];
+
+        // Don't let trampolines get into the lookup by name map
+        // If we ever need the trampoline symbols to be searchable by name
+        // we can remove this and then possibly add a new bool to any of the
+        // Symtab functions that lookup symbols by name to indicate if they
+        // want trampolines.
+        if (symbol->IsTrampoline())
+            continue;
+
+        const Mangled &mangled = symbol->GetMangled();
+        entry.cstring = mangled.GetMangledName().GetCString();
+        if (entry.cstring && entry.cstring[0])
+        {
+            chunk.names.push_back (entry);
+
+            if (symbol->ContainsLinkerAnnotations()) {
+                // If the symbol has linker annotations, also add the version without the
+                // annotations.
+                entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(entry.cstring)).GetCString();
+                chunk.names.push_back (entry);
+            }
+
+            const SymbolType symbol_type = symbol->GetType();
+            if (symbol_type == eSymbolTypeCode || symbol_type == eSymbolTypeResolver)
+            {
+                if (entry.cstring[0] == '_' && entry.cstring[1] == 'Z' &&
+                    (entry.cstring[2] != 'T' && // avoid virtual table, VTT structure, typeinfo structure, and typeinfo name
+                     entry.cstring[2] != 'G' && // avoid guard variables
+                     entry.cstring[2] != 'Z'))  // named local entities (if we eventually handle eSymbolTypeData, we will want this back)
+                {
+                    CPlusPlusLanguage::MethodName cxx_method (mangled.GetDemangledName(lldb::eLanguageTypeC_plus_plus));
+                    entry.cstring = ConstString(cxx_method.GetBasename()).GetCString();
+                    if (entry.cstring && entry.cstring[0])
+                    {
+                        // ConstString objects permanently store the string in the pool so calling
+                        // GetCString() on the value gets us a const char * that will never go away
+                        const char *const_context = ConstString(cxx_method.GetContext()).GetCString();
+
+                        if (entry.cstring[0] == '~' || !cxx_method.GetQualifiers().empty())
+                        {
+                            // The first character of the demangled basename is '~' which
+                            // means we have a class destructor. We can use this information
+                            // to help us know what is a class and what isn't.
+                            chunk.class_contexts.insert(std::make_pair(const_context, entry.value));
+                            chunk.methods.push_back (NameIndexChunk::CxxMethodEntry{entry, nullptr});
+                        }
+                        else if (const_context && const_context[0])
+                        {
+                            // Whether this is a method depends on the class contexts
+                            // found in all chunks, let InitNameIndexes() decide.
+                            chunk.methods.push_back (NameIndexChunk::CxxMethodEntry{entry, const_context});
+                        }
+                        else
+                        {
+                            // No context for this function so this has to be a basename
+                            chunk.basenames.push_back (entry);
+                        }
+                    }
+                }
+            }
+        }
+
+        entry.cstring = mangled.GetDemangledName(symbol->GetLanguage()).GetCString();
+        if (entry.cstring && entry.cstring[0]) {
+            chunk.names.push_back (entry);
+
+            if (symbol->ContainsLinkerAnnotations()) {
+                // If the symbol has linker annotations, also add the version without the
+                // annotations.
+                entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(entry.cstring)).GetCString();
+                chunk.names.push_back (entry);
+            }
+        }
+
+        // If the demangled name turns out to be an ObjC name, and
+        // is a category name, add the version without categories to the index too.
+        ObjCLanguage::MethodName objc_method (entry.cstring, true);
+        if (objc_method.IsValid(true))
+        {
+            entry.cstring = objc_method.GetSelector().GetCString();
+            chunk.selectors.push_back (entry);
+
+            ConstString objc_method_no_category (objc_method.GetFullNameWithoutCategory(true));
+            if (objc_method_no_category)
+            {
+                entry.cstring = objc_method_no_category.GetCString();
+                chunk.names.push_back (entry);
+            }
+        }
+    }
+}
+
 void
 Symtab::AppendSymbolNamesToMap (const IndexCollection &indexes,
                                 bool add_demangled,
@@ -1199,6 +1342,27 @@ Symtab::FindFunctionSymbols (const ConstString &name,
     return count;
 }
 
+//----------------------------------------------------------------------
+// Add every name FindFunctionSymbols() can match to "names". This is a
+// superset since the names of non-code symbols are added as well.
+//----------------------------------------------------------------------
+void
+Symtab::AppendFunctionSymbolNames (std::unordered_set<const char *> &names)
+{
+    Mutex::Locker locker (m_mutex);
+
+    if (!m_name_indexes_computed)
+        InitNameIndexes();
+
+    const NameToIndexMap *maps[] = { &m_name_to_index, &m_basename_to_index, &m_method_to_index, &m_selector_to_index };
+    for (const NameToIndexMap *map : maps)
+    {
+        const size_t num_names = map->GetSize();
+        for (size_t i = 0; i < num_names; ++i)
+            names.insert (map->GetCStringAtIndexUnchecked (i));
+    }
+}
+
 
 const Symbol *
 Symtab::GetParent (Symbol *child_symbol) const
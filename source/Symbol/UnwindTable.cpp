@@ -11,6 +11,8 @@
 
 #include <stdio.h>
 
+#include <algorithm>
+
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Symbol/ObjectFile.h"
@@ -94,17 +96,18 @@ UnwindTable::GetFuncUnwindersContainingAddress (const Address& addr, SymbolConte
 
     // There is an UnwindTable per object file, so we can safely use file handles
     addr_t file_addr = addr.GetFileAddress();
-    iterator end = m_unwinds.end ();
-    iterator insert_pos = end;
-    if (!m_unwinds.empty())
-    {
-        insert_pos = m_unwinds.lower_bound (file_addr);
-        iterator pos = insert_pos;
-        if ((pos == m_unwinds.end ()) || (pos != m_unwinds.begin() && pos->second->GetFunctionStartAddress() != addr))
-            --pos;
 
-        if (pos->second->ContainsAddress (addr))
-            return pos->second;
+    // Find the last function that starts at or before the address.
+    iterator pos = std::upper_bound (m_unwinds.begin(), m_unwinds.end(), file_addr,
+                                     [](addr_t lhs, const collection_entry &rhs) -> bool
+                                     {
+                                         return lhs < rhs.first;
+                                     });
+    if (pos != m_unwinds.begin())
+    {
+        iterator prev_pos = pos - 1;
+        if (prev_pos->second->ContainsAddress (addr))
+            return prev_pos->second;
     }
 
     AddressRange range;
@@ -117,8 +120,28 @@ UnwindTable::GetFuncUnwindersContainingAddress (const Address& addr, SymbolConte
         }
     }
 
+    // The function's start address isn't necessarily "file_addr", so find
+    // its own place to keep the entries sorted.
+    const addr_t func_file_addr = range.GetBaseAddress().GetFileAddress();
+    iterator insert_pos = std::lower_bound (m_unwinds.begin(), m_unwinds.end(), func_file_addr,
+                                            [](const collection_entry &lhs, addr_t rhs) -> bool
+                                            {
+                                                return lhs.first < rhs;
+                                            });
+
+    // There is at most one entry per start address. If the function already
+    // has one, use it when it covers the address, or else replace it with the
+    // new range.
+    if (insert_pos != m_unwinds.end() && insert_pos->first == func_file_addr)
+    {
+        if (insert_pos->second->ContainsAddress (addr))
+            return insert_pos->second;
+        insert_pos->second.reset (new FuncUnwinders(*this, range));
+        return insert_pos->second;
+    }
+
     FuncUnwindersSP func_unwinder_sp(new FuncUnwinders(*this, range));
-    m_unwinds.insert (insert_pos, std::make_pair(range.GetBaseAddress().GetFileAddress(), func_unwinder_sp));
+    m_unwinds.insert (insert_pos, std::make_pair(func_file_addr, func_unwinder_sp));
 //    StreamFile s(stdout, false);
 //    Dump (s);
     return func_unwinder_sp;
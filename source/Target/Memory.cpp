@@ -11,6 +11,7 @@
 // C Includes
 #include <inttypes.h>
 // C++ Includes
+#include <set>
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/DataBufferHeap.h"
@@ -53,6 +54,76 @@ MemoryCache::Clear(bool clear_invalid_ranges)
     m_L2_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
 }
 
+void
+MemoryCache::Prefetch (const std::vector<std::pair<addr_t, size_t> > &ranges)
+{
+    Mutex::Locker locker(m_mutex);
+
+    const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+    if (cache_line_byte_size == 0)
+        return;
+
+    // Gather the cache lines and large ranges we don't have yet.
+    std::set<addr_t> missing_lines;
+    Process::MemoryRangeList large_ranges;
+    for (const auto &range : ranges)
+    {
+        if (range.second == 0)
+            continue;
+
+        if (!m_L1_cache.empty())
+        {
+            AddrRange read_range(range.first, range.second);
+            BlockMap::iterator pos = m_L1_cache.upper_bound(range.first);
+            if (pos != m_L1_cache.begin ())
+                --pos;
+            AddrRange chunk_range(pos->first, pos->second->GetByteSize());
+            if (chunk_range.Contains(read_range))
+                continue;
+        }
+
+        if (range.second > cache_line_byte_size)
+        {
+            large_ranges.push_back(range);
+            continue;
+        }
+
+        const addr_t first_line = range.first - (range.first % cache_line_byte_size);
+        const addr_t last_addr = range.first + range.second - 1;
+        const addr_t last_line = last_addr - (last_addr % cache_line_byte_size);
+        for (addr_t line = first_line; line <= last_line; line += cache_line_byte_size)
+        {
+            if (m_L2_cache.find(line) == m_L2_cache.end() && !m_invalid_ranges.FindEntryThatContains(line))
+                missing_lines.insert(line);
+        }
+    }
+
+    Process::MemoryRangeList read_ranges;
+    for (addr_t line : missing_lines)
+        read_ranges.push_back(std::make_pair(line, (size_t)cache_line_byte_size));
+    read_ranges.insert(read_ranges.end(), large_ranges.begin(), large_ranges.end());
+    if (read_ranges.empty())
+        return;
+
+    std::vector<DataBufferSP> buffers;
+    m_process.ReadMemoryRangesFromInferior(read_ranges, buffers);
+
+    for (size_t i = 0; i < read_ranges.size(); ++i)
+    {
+        if (!buffers[i] || buffers[i]->GetByteSize() == 0)
+            continue;
+        if (i < missing_lines.size())
+        {
+            // Leave partially readable lines to Read(), which knows how to
+            // cap the read at the end of them.
+            if (buffers[i]->GetByteSize() == cache_line_byte_size)
+                m_L2_cache[read_ranges[i].first] = buffers[i];
+        }
+        else
+            AddL1CacheData(read_ranges[i].first, buffers[i]);
+    }
+}
+
 void
 MemoryCache::AddL1CacheData(lldb::addr_t addr, const void *src, size_t src_len)
 {
@@ -201,6 +272,12 @@ MemoryCache::Read (addr_t addr,
         addr_t curr_addr = addr - (addr % cache_line_byte_size);
         addr_t cache_offset = addr - curr_addr;
 
+        // If the read straddles two cache lines, fetch whichever of them
+        // are missing together, which saves a round trip for remote
+        // processes.
+        if (cache_offset + dst_len > cache_line_byte_size)
+            Prefetch (std::vector<std::pair<addr_t, size_t> > (1, std::make_pair (addr, dst_len)));
+
         while (bytes_left > 0)
         {
             if (m_invalid_ranges.FindEntryThatContains(curr_addr))
@@ -77,13 +77,15 @@ namespace {
     {
         { "use-module-cache"      , OptionValue::eTypeBoolean , true,  true, nullptr, nullptr, "Use module cache." },
         { "module-cache-directory", OptionValue::eTypeFileSpec, true,  0 ,   nullptr, nullptr, "Root directory for cached modules." },
+        { "use-index-cache"       , OptionValue::eTypeBoolean , true,  false, nullptr, nullptr, "Cache symbol indexes for modules on disk, under the module cache directory, and reuse them in later sessions." },
         {  nullptr                , OptionValue::eTypeInvalid , false, 0,    nullptr, nullptr, nullptr }
     };
 
     enum
     {
         ePropertyUseModuleCache,
-        ePropertyModuleCacheDirectory
+        ePropertyModuleCacheDirectory,
+        ePropertyUseIndexCache
     };
 
 }  // namespace
@@ -141,6 +143,20 @@ PlatformProperties::SetModuleCacheDirectory (const FileSpec& dir_spec)
     return m_collection_sp->SetPropertyAtIndexAsFileSpec (nullptr, ePropertyModuleCacheDirectory, dir_spec);
 }
 
+bool
+PlatformProperties::GetUseIndexCache () const
+{
+    const auto idx = ePropertyUseIndexCache;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (
+        nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+PlatformProperties::SetUseIndexCache (bool use_index_cache)
+{
+    return m_collection_sp->SetPropertyAtIndexAsBoolean (nullptr, ePropertyUseIndexCache, use_index_cache);
+}
+
 //------------------------------------------------------------------
 /// Get the native host platform plug-in. 
 ///
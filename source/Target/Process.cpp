@@ -14,6 +14,7 @@
 #include "lldb/Target/Process.h"
 #include "lldb/Breakpoint/StoppointCallbackContext.h"
 #include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/Event.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Log.h"
@@ -755,6 +756,7 @@ Process::Process(lldb::TargetSP target_sp, Listener &listener, const UnixSignals
     m_iohandler_sync (0),
     m_memory_cache (*this),
     m_allocated_memory_cache (*this),
+    m_unwind_symbol_cache (),
     m_should_detach (false),
     m_next_event_action_ap(),
     m_public_run_lock (),
@@ -887,6 +889,7 @@ Process::Finalize()
     m_image_tokens.clear();
     m_memory_cache.Clear();
     m_allocated_memory_cache.Clear();
+    m_unwind_symbol_cache.Clear();
     m_language_runtimes.clear();
     m_instrumentation_runtimes.clear();
     m_next_event_action_ap.reset();
@@ -2081,6 +2084,7 @@ Process::CreateBreakpointSite (const BreakpointLocationSP &owner, bool use_hardw
         {
             bp_site_sp->AddOwner (owner);
             owner->SetBreakpointSite (bp_site_sp);
+            UpdateBreakpointSiteConditions (bp_site_sp.get());
             return bp_site_sp->GetID();
         }
         else
@@ -2124,6 +2128,8 @@ Process::RemoveOwnerFromBreakpointSite (lldb::user_id_t owner_id, lldb::user_id_
             DisableBreakpointSite (bp_site_sp.get());
         m_breakpoint_site_list.RemoveByAddress(bp_site_sp->GetLoadAddress());
     }
+    else if (IsAlive())
+        UpdateBreakpointSiteConditions (bp_site_sp.get());
 }
 
 size_t
@@ -2535,6 +2541,56 @@ Process::ReadMemoryFromInferior (addr_t addr, void *buf, size_t size, Error &err
     return bytes_read;
 }
 
+void
+Process::DoReadMemoryRanges (const MemoryRangeList &ranges, std::vector<DataBufferSP> &buffers)
+{
+    buffers.clear();
+    for (const auto &range : ranges)
+    {
+        DataBufferSP buffer_sp;
+        if (range.second > 0)
+        {
+            std::unique_ptr<DataBufferHeap> data_buffer_heap_ap(new DataBufferHeap (range.second, 0));
+            Error error;
+            const size_t bytes_read = DoReadMemory (range.first,
+                                                    data_buffer_heap_ap->GetBytes(),
+                                                    data_buffer_heap_ap->GetByteSize(),
+                                                    error);
+            if (bytes_read > 0)
+            {
+                data_buffer_heap_ap->SetByteSize (bytes_read);
+                buffer_sp.reset (data_buffer_heap_ap.release());
+            }
+        }
+        buffers.push_back (buffer_sp);
+    }
+}
+
+void
+Process::ReadMemoryRangesFromInferior (const MemoryRangeList &ranges, std::vector<DataBufferSP> &buffers)
+{
+    DoReadMemoryRanges (ranges, buffers);
+    buffers.resize (ranges.size());
+
+    // Replace any software breakpoint opcodes that fall into the ranges back
+    // into the buffers before we return
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        DataBufferSP &buffer_sp = buffers[i];
+        if (buffer_sp && buffer_sp->GetByteSize() > ranges[i].second)
+            buffer_sp.reset();
+        if (buffer_sp && buffer_sp->GetByteSize() > 0)
+            RemoveBreakpointOpcodesFromBuffer (ranges[i].first, buffer_sp->GetByteSize(), buffer_sp->GetBytes());
+    }
+}
+
+void
+Process::PrefetchMemory (const MemoryRangeList &ranges)
+{
+    if (!GetDisableMemoryCache())
+        m_memory_cache.Prefetch (ranges);
+}
+
 uint64_t
 Process::ReadUnsignedIntegerFromMemory (lldb::addr_t vm_addr, size_t integer_byte_size, uint64_t fail_value, Error &error)
 {
@@ -6312,6 +6368,7 @@ Process::DidExec ()
     m_instrumentation_runtimes.clear();
     m_thread_list.DiscardThreadPlans();
     m_memory_cache.Clear(true);
+    m_unwind_symbol_cache.Clear();
     m_stop_info_override_callback = NULL;
     DoDidExec();
     CompleteAttach ();
@@ -6361,6 +6418,10 @@ Process::ResolveIndirectFunction(const Address *address, Error &error)
 void
 Process::ModulesDidLoad (ModuleList &module_list)
 {
+    // Addresses that used to be in no module, or in a module at a
+    // different address, may now resolve differently.
+    m_unwind_symbol_cache.Clear();
+
     SystemRuntime *sys_runtime = GetSystemRuntime();
     if (sys_runtime)
     {
@@ -89,7 +89,9 @@ Target::Target(Debugger &debugger, const ArchSpec &target_arch, const lldb::Plat
     m_stop_hook_next_id (0),
     m_valid (true),
     m_suppress_stop_hooks (false),
-    m_is_dummy_target(is_dummy_target)
+    m_is_dummy_target(is_dummy_target),
+    m_module_batch_depth (0),
+    m_batched_modules ()
 
 {
     SetEventName (eBroadcastBitBreakpointChanged, "breakpoint-changed");
@@ -1358,9 +1360,18 @@ Target::ModuleAdded (const ModuleList& module_list, const ModuleSP &module_sp)
     // A module is being added to this target for the first time
     if (m_valid)
     {
+        LoadScriptingResourceForModule(module_sp, this);
+
+        // A dynamic loader is adding several modules, they all get their
+        // breakpoints resolved when it is done.
+        if (m_module_batch_depth > 0)
+        {
+            m_batched_modules.AppendIfNeeded(module_sp);
+            return;
+        }
+
         ModuleList my_module_list;
         my_module_list.Append(module_sp);
-        LoadScriptingResourceForModule(module_sp, this);
         ModulesDidLoad (my_module_list);
     }
 }
@@ -1416,6 +1427,10 @@ Target::SymbolsDidLoad (ModuleList &module_list)
                 ObjCLanguageRuntime *objc_runtime = (ObjCLanguageRuntime*)runtime;
                 objc_runtime->SymbolsDidLoad(module_list);
             }
+
+            // The cached symbol contexts point into the symbol files that
+            // were just replaced.
+            m_process_sp->GetUnwindSymbolCache().Clear();
         }
         
         m_breakpoint_list.UpdateBreakpoints (module_list, true, false);
@@ -1424,12 +1439,35 @@ Target::SymbolsDidLoad (ModuleList &module_list)
     }
 }
 
+void
+Target::BeginModuleBatch ()
+{
+    ++m_module_batch_depth;
+}
+
+void
+Target::EndModuleBatch (ModuleList &module_list)
+{
+    // An enclosing batch reports these modules along with its own.
+    if (--m_module_batch_depth > 0)
+    {
+        m_batched_modules.AppendIfNeeded(module_list);
+        return;
+    }
+
+    module_list.AppendIfNeeded(m_batched_modules);
+    m_batched_modules.Clear();
+    ModulesDidLoad (module_list);
+}
+
 void
 Target::ModulesDidUnload (ModuleList &module_list, bool delete_locations)
 {
     if (m_valid && module_list.GetSize())
     {
         UnloadModuleSections (module_list);
+        if (m_process_sp)
+            m_process_sp->GetUnwindSymbolCache().Clear();
         m_breakpoint_list.UpdateBreakpoints (module_list, false, delete_locations);
         m_internal_breakpoint_list.UpdateBreakpoints (module_list, false, delete_locations);
         BroadcastEvent (eBroadcastBitModulesUnloaded, new TargetEventData (this->shared_from_this(), module_list));
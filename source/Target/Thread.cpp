@@ -73,6 +73,8 @@ g_properties[] =
     { "step-avoid-regexp",  OptionValue::eTypeRegex  , true , 0, "^std::", nullptr, "A regular expression defining functions step-in won't stop in." },
     { "step-avoid-libraries",  OptionValue::eTypeFileSpecList  , true , 0, nullptr, nullptr, "A list of libraries that source stepping won't stop in." },
     { "trace-thread",       OptionValue::eTypeBoolean, false, false, nullptr, nullptr, "If true, this thread will single-step and log execution." },
+    { "fast-unwind",        OptionValue::eTypeBoolean, true, false, nullptr, nullptr, "If true, backtraces follow the frame pointer chain wherever it is valid instead of consulting the unwind "
+                                                                                    "information of every frame. This is much faster, but the callers of functions that don't set up a frame pointer can be missed." },
     {  nullptr               , OptionValue::eTypeInvalid, false, 0    , nullptr, nullptr, nullptr  }
 };
 
@@ -81,7 +83,8 @@ enum {
     ePropertyStepOutAvoidsNoDebug,
     ePropertyStepAvoidRegex,
     ePropertyStepAvoidLibraries,
-    ePropertyEnableThreadTrace
+    ePropertyEnableThreadTrace,
+    ePropertyFastUnwind
 };
 
 class ThreadOptionValueProperties : public OptionValueProperties
@@ -157,6 +160,13 @@ ThreadProperties::GetTraceEnabledState() const
     return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
 }
 
+bool
+ThreadProperties::GetFastUnwind() const
+{
+    const uint32_t idx = ePropertyFastUnwind;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
 bool
 ThreadProperties::GetStepInAvoidsNoDebug() const
 {
@@ -1850,6 +1860,13 @@ Thread::ClearStackFrames ()
     m_extended_info_fetched = false;
 }
 
+void
+Thread::DiscardStackFrameList ()
+{
+    Mutex::Locker locker(m_frame_mutex);
+    m_curr_frames_sp.reset();
+}
+
 lldb::StackFrameSP
 Thread::GetFrameWithConcreteFrameIndex (uint32_t unwind_idx)
 {
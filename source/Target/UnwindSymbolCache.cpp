@@ -0,0 +1,54 @@
+//===-- UnwindSymbolCache.cpp -----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Target/UnwindSymbolCache.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// Each entry holds on to its module, don't let a long session with many
+// distinct return addresses grow the cache without bound.
+static const size_t g_max_entries = 8192;
+
+UnwindSymbolCache::UnwindSymbolCache () :
+    m_mutex (Mutex::eMutexTypeNormal),
+    m_entries ()
+{
+}
+
+UnwindSymbolCache::~UnwindSymbolCache ()
+{
+}
+
+bool
+UnwindSymbolCache::Lookup (addr_t pc, bool above_async_frame, Entry &entry)
+{
+    Mutex::Locker locker (m_mutex);
+    collection::const_iterator pos = m_entries.find (Key (pc, above_async_frame));
+    if (pos == m_entries.end())
+        return false;
+    entry = pos->second;
+    return true;
+}
+
+void
+UnwindSymbolCache::Insert (addr_t pc, bool above_async_frame, const Entry &entry)
+{
+    Mutex::Locker locker (m_mutex);
+    if (m_entries.size() >= g_max_entries)
+        m_entries.clear();
+    m_entries[Key (pc, above_async_frame)] = entry;
+}
+
+void
+UnwindSymbolCache::Clear ()
+{
+    Mutex::Locker locker (m_mutex);
+    m_entries.clear();
+}
@@ -105,6 +105,8 @@ lldb_private::GetSectionTypeAsCString(lldb::SectionType sect_type)
             return "apple-namespaces";
         case eSectionTypeDWARFAppleObjC:
             return "apple-objc";
+        case eSectionTypeDWARFGdbIndex:
+            return "gdb-index";
         case eSectionTypeEHFrame:
             return "eh-frame";
         case eSectionTypeARMexidx:
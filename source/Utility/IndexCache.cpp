@@ -0,0 +1,282 @@
+//===-- IndexCache.cpp ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "IndexCache.h"
+
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/FastDemangle.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Core/UUID.h"
+#include "lldb/Host/Endian.h"
+#include "lldb/Host/File.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Host/TimeValue.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Target/Platform.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+
+const char* kIndexSubdir = ".index";
+const char* kTempFileModel = "%%%%%%%%.temp";
+
+const uint32_t kIndexCacheMagic = 0x6c696478; // 'lidx'
+const uint32_t kIndexCacheVersion = 1;
+const size_t kIndexCacheHeaderSize = 2 * sizeof(uint32_t) + sizeof(uint64_t);
+
+// The version of the PutDemangledNames() entry layout
+const uint32_t kDemangledNamesVersion = 1;
+
+// Mix "value" into "signature" with 64-bit FNV-1a
+uint64_t
+MixSignature (uint64_t signature, uint32_t value)
+{
+    for (size_t i = 0; i < sizeof(value); ++i)
+    {
+        signature ^= (value >> (i * 8)) & 0xff;
+        signature *= 0x100000001b3ull;
+    }
+    return signature;
+}
+
+FileSpec
+GetEntryDirectory (const FileSpec &root_dir_spec, const UUID &uuid)
+{
+    FileSpec dir_spec (root_dir_spec);
+    dir_spec.AppendPathComponent (kIndexSubdir);
+    dir_spec.AppendPathComponent (uuid.GetAsString ().c_str ());
+    return dir_spec;
+}
+
+Error
+MakeDirectories (const FileSpec &dir_spec)
+{
+    if (dir_spec.Exists ())
+    {
+        if (!dir_spec.IsDirectory ())
+            return Error ("Invalid existing path");
+        return Error ();
+    }
+    return FileSystem::MakeDirectory (dir_spec, eFilePermissionsDirectoryDefault);
+}
+
+}  // namespace
+
+FileSpec
+IndexCache::GetCacheRoot ()
+{
+    auto platform_properties = Platform::GetGlobalPlatformProperties ();
+    if (!platform_properties->GetUseIndexCache ())
+        return FileSpec ();
+    return platform_properties->GetModuleCacheDirectory ();
+}
+
+bool
+IndexCache::Get (const FileSpec &root_dir_spec,
+                 const UUID &uuid,
+                 const char *name,
+                 uint64_t signature,
+                 DataExtractor &data)
+{
+    if (!root_dir_spec || !uuid.IsValid ())
+        return false;
+
+    FileSpec entry_spec = GetEntryDirectory (root_dir_spec, uuid);
+    entry_spec.AppendPathComponent (name);
+    if (!entry_spec.Exists ())
+        return false;
+
+    DataBufferSP data_sp (entry_spec.MemoryMapFileContents ());
+    if (!data_sp || data_sp->GetByteSize () < kIndexCacheHeaderSize)
+        return false;
+
+    DataExtractor header (data_sp, endian::InlHostByteOrder (), sizeof(void *));
+    lldb::offset_t offset = 0;
+    if (header.GetU32 (&offset) != kIndexCacheMagic ||
+        header.GetU32 (&offset) != kIndexCacheVersion ||
+        header.GetU64 (&offset) != signature)
+    {
+        Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_MODULES));
+        if (log)
+            log->Printf ("IndexCache::%s ignoring stale entry %s", __FUNCTION__, entry_spec.GetPath ().c_str ());
+        return false;
+    }
+
+    data.SetByteOrder (endian::InlHostByteOrder ());
+    data.SetAddressByteSize (sizeof(void *));
+    return data.SetData (data_sp, offset, data_sp->GetByteSize () - offset) > 0;
+}
+
+Error
+IndexCache::Put (const FileSpec &root_dir_spec,
+                 const UUID &uuid,
+                 const char *name,
+                 uint64_t signature,
+                 const void *data,
+                 size_t data_len)
+{
+    if (!root_dir_spec || !uuid.IsValid ())
+        return Error ("Invalid index cache root or module UUID");
+
+    FileSpec index_dir_spec (root_dir_spec);
+    index_dir_spec.AppendPathComponent (kIndexSubdir);
+    Error error = MakeDirectories (root_dir_spec);
+    if (error.Success ())
+        error = MakeDirectories (index_dir_spec);
+    const FileSpec entry_dir_spec = GetEntryDirectory (root_dir_spec, uuid);
+    if (error.Success ())
+        error = MakeDirectories (entry_dir_spec);
+    if (error.Fail ())
+        return error;
+
+    // Write into a uniquely named temporary file first and rename it into
+    // place so concurrent debug sessions never observe a partial entry.
+    FileSpec temp_model_spec (entry_dir_spec);
+    temp_model_spec.AppendPathComponent (kTempFileModel);
+    int temp_fd = -1;
+    llvm::SmallString<128> temp_path;
+    auto err_code = llvm::sys::fs::createUniqueFile (temp_model_spec.GetPath ().c_str (), temp_fd, temp_path);
+    if (err_code)
+        return Error ("Failed to create temporary file in %s: %s",
+                      entry_dir_spec.GetPath ().c_str (), err_code.message ().c_str ());
+    llvm::FileRemover temp_file_remover (temp_path.c_str ());
+
+    File temp_file (temp_fd, true);
+    uint8_t header[kIndexCacheHeaderSize];
+    ::memcpy (header, &kIndexCacheMagic, sizeof(uint32_t));
+    ::memcpy (header + 4, &kIndexCacheVersion, sizeof(uint32_t));
+    ::memcpy (header + 8, &signature, sizeof(uint64_t));
+
+    size_t num_bytes = sizeof(header);
+    error = temp_file.Write (header, num_bytes);
+    if (error.Success () && num_bytes == sizeof(header))
+    {
+        num_bytes = data_len;
+        error = temp_file.Write (data, num_bytes);
+    }
+    if (error.Success () && num_bytes != data_len)
+        error.SetErrorString ("Short write to index cache file");
+    temp_file.Close ();
+    if (error.Fail ())
+        return error;
+
+    FileSpec entry_spec (entry_dir_spec);
+    entry_spec.AppendPathComponent (name);
+    err_code = llvm::sys::fs::rename (temp_path.c_str (), entry_spec.GetPath ().c_str ());
+    if (err_code)
+        return Error ("Failed to rename file %s to %s: %s",
+                      temp_path.c_str (), entry_spec.GetPath ().c_str (), err_code.message ().c_str ());
+
+    temp_file_remover.releaseFile ();
+    return Error ();
+}
+
+bool
+IndexCache::GetEntryForFile (const char *prefix,
+                             const FileSpec &file_spec,
+                             lldb::offset_t file_offset,
+                             std::string &entry_name,
+                             uint64_t &signature)
+{
+    const TimeValue mod_time (file_spec.GetModificationTime ());
+    if (!mod_time.IsValid ())
+        return false;
+
+    StreamString strm;
+    strm.Printf ("%s-%s", prefix, file_spec.GetFilename ().AsCString ("<unknown>"));
+    if (file_offset != 0)
+        strm.Printf ("-0x%" PRIx64, (uint64_t)file_offset);
+    entry_name = strm.GetString ();
+    signature = mod_time.GetAsNanoSecondsSinceJan1_1970 ();
+    return true;
+}
+
+bool
+IndexCache::GetEntryForObjectFile (const char *prefix,
+                                   ObjectFile *objfile,
+                                   UUID &uuid,
+                                   std::string &entry_name,
+                                   uint64_t &signature)
+{
+    if (objfile == nullptr)
+        return false;
+    ModuleSP module_sp (objfile->GetModule ());
+    if (!module_sp)
+        return false;
+    uuid = module_sp->GetUUID ();
+    if (!uuid.IsValid ())
+        return false;
+    return GetEntryForFile (prefix, objfile->GetFileSpec (), objfile->GetFileOffset (), entry_name, signature);
+}
+
+uint64_t
+IndexCache::GetDemangledNamesSignature (uint64_t signature)
+{
+    return MixSignature (MixSignature (signature, kDemangledNamesVersion), FastDemangleVersion);
+}
+
+Error
+IndexCache::PutDemangledNames (const FileSpec &root_dir_spec,
+                               const UUID &uuid,
+                               const char *name,
+                               uint64_t signature,
+                               uint32_t num_symbols,
+                               const DemangledNameList &names)
+{
+    StreamString strm (Stream::eBinary, sizeof(void *), endian::InlHostByteOrder ());
+    strm.PutHex32 (num_symbols);
+    strm.PutHex32 (names.size ());
+    for (const auto &pair : names)
+    {
+        strm.Write (pair.first.GetCString (), pair.first.GetLength () + 1);
+        strm.Write (pair.second.GetCString (), pair.second.GetLength () + 1);
+    }
+    return Put (root_dir_spec, uuid, name, GetDemangledNamesSignature (signature), strm.GetData (), strm.GetSize ());
+}
+
+bool
+IndexCache::GetDemangledNames (const FileSpec &root_dir_spec,
+                               const UUID &uuid,
+                               const char *name,
+                               uint64_t signature,
+                               uint32_t num_symbols,
+                               DemangledNameList &names)
+{
+    DataExtractor data;
+    if (!Get (root_dir_spec, uuid, name, GetDemangledNamesSignature (signature), data))
+        return false;
+
+    lldb::offset_t offset = 0;
+    if (data.GetU32 (&offset) != num_symbols)
+        return false;
+
+    const uint32_t num_names = data.GetU32 (&offset);
+    for (uint32_t i = 0; i < num_names; ++i)
+    {
+        const char *mangled_cstr = data.GetCStr (&offset);
+        const char *demangled_cstr = data.GetCStr (&offset);
+        if (mangled_cstr == nullptr || demangled_cstr == nullptr)
+        {
+            Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_MODULES));
+            if (log)
+                log->Printf ("IndexCache::%s ignoring malformed entry \"%s\"", __FUNCTION__, name);
+            return false;
+        }
+        names.push_back (std::make_pair (ConstString (mangled_cstr), ConstString (demangled_cstr)));
+    }
+    return true;
+}
@@ -0,0 +1,154 @@
+//===-- IndexCache.h --------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef utility_IndexCache_h_
+#define utility_IndexCache_h_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lldb/lldb-types.h"
+#include "lldb/lldb-forward.h"
+
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Host/FileSpec.h"
+
+namespace lldb_private {
+
+class DataExtractor;
+class ObjectFile;
+class UUID;
+
+//----------------------------------------------------------------------
+/// @class IndexCache IndexCache.h "Utility/IndexCache.h"
+/// @brief An on-disk cache for data derived from a module.
+///
+/// Stores blobs that are expensive to compute from a module (name
+/// indexes, demangled names, ...) so that later debug sessions on the
+/// same binary can map them back in instead of recomputing them.
+/// Entries live next to the module cache and are keyed by module UUID:
+///  - /${CACHE_ROOT}/.index/${UUID}/${ENTRY_NAME}
+///
+/// Every entry starts with a small header holding a caller supplied
+/// signature (typically derived from the modification time of the file
+/// the data was computed from). An entry whose signature doesn't match
+/// is treated as missing and is overwritten by the next Put().
+//----------------------------------------------------------------------
+
+class IndexCache
+{
+public:
+    //------------------------------------------------------------------
+    /// Get the cache root directory, or an invalid FileSpec if the
+    /// index cache is disabled in the platform settings.
+    //------------------------------------------------------------------
+    static FileSpec
+    GetCacheRoot ();
+
+    //------------------------------------------------------------------
+    /// Memory map the entry \a name for the module with \a uuid.
+    ///
+    /// @param[out] data
+    ///     On success, set to the entry's payload (without the header).
+    ///
+    /// @return
+    ///     True if a valid entry with a matching \a signature was found.
+    //------------------------------------------------------------------
+    static bool
+    Get (const FileSpec &root_dir_spec,
+         const UUID &uuid,
+         const char *name,
+         uint64_t signature,
+         DataExtractor &data);
+
+    //------------------------------------------------------------------
+    /// Atomically write \a data_len bytes from \a data as the entry
+    /// \a name for the module with \a uuid.
+    //------------------------------------------------------------------
+    static Error
+    Put (const FileSpec &root_dir_spec,
+         const UUID &uuid,
+         const char *name,
+         uint64_t signature,
+         const void *data,
+         size_t data_len);
+
+    //------------------------------------------------------------------
+    /// Get the entry name and signature for data of kind \a prefix that
+    /// is derived from the file \a file_spec, or from the object at
+    /// \a file_offset within it. The signature is the modification time
+    /// of the file.
+    ///
+    /// @return
+    ///     False if the modification time of the file is unknown, in
+    ///     which case the data can't be cached.
+    //------------------------------------------------------------------
+    static bool
+    GetEntryForFile (const char *prefix,
+                     const FileSpec &file_spec,
+                     lldb::offset_t file_offset,
+                     std::string &entry_name,
+                     uint64_t &signature);
+
+    //------------------------------------------------------------------
+    /// Like GetEntryForFile(), for data derived from \a objfile. Also
+    /// returns the UUID of its module, which must be valid.
+    //------------------------------------------------------------------
+    static bool
+    GetEntryForObjectFile (const char *prefix,
+                           ObjectFile *objfile,
+                           UUID &uuid,
+                           std::string &entry_name,
+                           uint64_t &signature);
+
+    typedef std::vector<std::pair<ConstString, ConstString>> DemangledNameList;
+
+    //------------------------------------------------------------------
+    /// Get the signature the entries of PutDemangledNames() are stored
+    /// with, which is \a signature combined with the version of their
+    /// layout and the FastDemangleVersion. Entries written by another
+    /// version are treated as stale.
+    //------------------------------------------------------------------
+    static uint64_t
+    GetDemangledNamesSignature (uint64_t signature);
+
+    //------------------------------------------------------------------
+    /// Store the (mangled, demangled) name pairs of a symbol table with
+    /// \a num_symbols symbols as the entry \a name.
+    //------------------------------------------------------------------
+    static Error
+    PutDemangledNames (const FileSpec &root_dir_spec,
+                       const UUID &uuid,
+                       const char *name,
+                       uint64_t signature,
+                       uint32_t num_symbols,
+                       const DemangledNameList &names);
+
+    //------------------------------------------------------------------
+    /// Read back the names stored by PutDemangledNames().
+    ///
+    /// @return
+    ///     False if there is no valid entry for a symbol table with
+    ///     \a num_symbols symbols. \a names may then still have been
+    ///     given the names before a malformed part of the entry.
+    //------------------------------------------------------------------
+    static bool
+    GetDemangledNames (const FileSpec &root_dir_spec,
+                       const UUID &uuid,
+                       const char *name,
+                       uint64_t signature,
+                       uint32_t num_symbols,
+                       DemangledNameList &names);
+};
+
+} // namespace lldb_private
+
+#endif  // utility_IndexCache_h_
@@ -88,6 +88,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
         switch (packet_cstr[1])
         {
         case 'E':
+            if (PACKET_STARTS_WITH ("QEnableCompression:"))     return eServerPacketType_QEnableCompression;
             if (PACKET_STARTS_WITH ("QEnvironment:"))           return eServerPacketType_QEnvironment;
             if (PACKET_STARTS_WITH ("QEnvironmentHexEncoded:")) return eServerPacketType_QEnvironmentHexEncoded;
             break;
@@ -113,6 +114,10 @@ StringExtractorGDBRemote::GetServerPacketType () const
             if (PACKET_MATCHES("QListThreadsInStopReply"))        return eServerPacketType_QListThreadsInStopReply;
             break;
 
+        case 'N':
+            if (PACKET_STARTS_WITH ("QNonStop:"))                 return eServerPacketType_QNonStop;
+            break;
+
         case 'R':
             if (PACKET_STARTS_WITH ("QRestoreRegisterState:"))    return eServerPacketType_QRestoreRegisterState;
             break;
@@ -220,11 +225,15 @@ StringExtractorGDBRemote::GetServerPacketType () const
 
         case 'X':
             if (PACKET_STARTS_WITH ("qXfer:auxv:read::"))       return eServerPacketType_qXfer_auxv_read;
+            if (PACKET_STARTS_WITH ("qXfer:features:read:"))    return eServerPacketType_qXfer_features_read;
+            if (PACKET_STARTS_WITH ("qXfer:libraries-svr4:read:")) return eServerPacketType_qXfer_libraries_svr4_read;
             break;
         }
         break;
 
     case 'j':
+        if (PACKET_MATCHES("jCollectedSamples"))                return eServerPacketType_jCollectedSamples;
+        if (PACKET_STARTS_WITH("jMultiMemRead:ranges:"))        return eServerPacketType_jMultiMemRead;
         if (PACKET_MATCHES("jSignalsInfo"))                     return eServerPacketType_jSignalsInfo;
         if (PACKET_MATCHES("jThreadsInfo"))                     return eServerPacketType_jThreadsInfo;
 
@@ -251,6 +260,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
               if (PACKET_STARTS_WITH ("vAttachName;"))          return eServerPacketType_vAttachName;
               if (PACKET_STARTS_WITH("vCont;"))                 return eServerPacketType_vCont;
               if (PACKET_MATCHES ("vCont?"))                    return eServerPacketType_vCont_actions;
+              if (PACKET_MATCHES ("vStopped"))                  return eServerPacketType_vStopped;
             }
             break;
       case '_':
@@ -64,6 +64,7 @@ public:
         eServerPacketType_qGetWorkingDir,
         eServerPacketType_qFileLoadAddress,
         eServerPacketType_QEnvironment,
+        eServerPacketType_QEnableCompression,
         eServerPacketType_QLaunchArch,
         eServerPacketType_QSetDisableASLR,
         eServerPacketType_QSetDetachOnError,
@@ -89,6 +90,7 @@ public:
       // debug server packages
         eServerPacketType_QEnvironmentHexEncoded,
         eServerPacketType_QListThreadsInStopReply,
+        eServerPacketType_QNonStop,
         eServerPacketType_QRestoreRegisterState,
         eServerPacketType_QSaveRegisterState,
         eServerPacketType_QSetLogging,
@@ -98,6 +100,8 @@ public:
         eServerPacketType_QSyncThreadState,
         eServerPacketType_QThreadSuffixSupported,
 
+        eServerPacketType_jCollectedSamples,
+        eServerPacketType_jMultiMemRead,
         eServerPacketType_jThreadsInfo,
         eServerPacketType_qsThreadInfo,
         eServerPacketType_qfThreadInfo,
@@ -119,6 +123,8 @@ public:
         eServerPacketType_qWatchpointSupportInfo,
         eServerPacketType_qWatchpointSupportInfoSupported,
         eServerPacketType_qXfer_auxv_read,
+        eServerPacketType_qXfer_features_read,
+        eServerPacketType_qXfer_libraries_svr4_read,
 
         eServerPacketType_jSignalsInfo,
 
@@ -128,6 +134,7 @@ public:
         eServerPacketType_vAttachName,
         eServerPacketType_vCont,
         eServerPacketType_vCont_actions, // vCont?
+        eServerPacketType_vStopped,
 
         eServerPacketType_stop_reason, // '?'
 
@@ -9,6 +9,14 @@
 
 #include "lldb/Utility/TaskPool.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+
+#include "llvm/Support/Compiler.h"
+
 namespace
 {
     class TaskPoolImpl
@@ -20,24 +28,103 @@ namespace
         void
         AddTask(std::function<void()>&& task_fn);
 
+        bool
+        RunPendingSubtask();
+
+        uint32_t
+        GetThreadCount();
+
+        bool
+        SetThreadCount(uint32_t thread_count);
+
     private:
+        // A queued task along with the task (or non-worker thread) that added it. A thread waiting
+        // for a task only ever runs tasks its current task added, running anything else could
+        // acquire locks in a different order than the waiter already holds them.
+        struct Task
+        {
+            std::function<void()> m_fn;
+            uint64_t              m_id;
+            uint64_t              m_owner_id;
+        };
+
+        // The tasks of a single worker thread. The owning worker pushes and pops at the front so it
+        // keeps working on the most recently added (and most likely cache hot) tasks, while other
+        // threads steal the oldest tasks from the back.
+        struct WorkerQueue
+        {
+            std::deque<Task> m_tasks;
+            std::mutex       m_mutex;
+        };
+
         TaskPoolImpl();
 
+        void
+        StartWorkers();
+
+        WorkerQueue&
+        GetCurrentQueue();
+
+        bool
+        PopTask(WorkerQueue* worker_queue, Task& task);
+
+        static bool
+        PopFront(WorkerQueue& queue, Task& task);
+
+        static bool
+        PopBack(WorkerQueue& queue, Task& task);
+
+        static bool
+        PopSubtask(WorkerQueue& queue, uint64_t owner_id, Task& task);
+
+        static void
+        RunTask(Task& task);
+
         static void
-        Worker(TaskPoolImpl* pool);
+        Worker(TaskPoolImpl* pool, WorkerQueue* worker_queue);
 
-        std::queue<std::function<void()>> m_tasks;
-        std::mutex                        m_tasks_mutex;
-        uint32_t                          m_thread_count;
+        std::once_flag                            m_start_flag;
+        std::mutex                                m_config_mutex;
+        uint32_t                                  m_requested_thread_count; // 0 means use the default
+        bool                                      m_started;
+        std::vector<std::unique_ptr<WorkerQueue>> m_worker_queues;          // Immutable once started
+        WorkerQueue                               m_shared_queue;           // Tasks added by non-worker threads
+        std::atomic<uint32_t>                     m_steal_index;
+
+        // Idle workers sleep on m_cv until m_num_queued is non-zero. m_num_queued is only increased
+        // while holding m_sleep_mutex so a wakeup can't be missed, and before the task is queued so
+        // it can't be decremented below zero by a thread that pops the task right away.
+        std::atomic<uint32_t>                     m_num_queued;
+        std::mutex                                m_sleep_mutex;
+        std::condition_variable                   m_cv;
     };
 
+    // The queue of the worker thread running on this thread, or nullptr for other threads.
+    LLVM_THREAD_LOCAL void *g_current_worker_queue = nullptr;
+
+    // The id of the task running on this thread, or the id of the thread itself if it isn't
+    // running a task. Zero until the thread first adds or waits for a task.
+    LLVM_THREAD_LOCAL uint64_t g_current_task_id = 0;
+
+    std::atomic<uint64_t> g_next_task_id(1);
+
+    uint64_t
+    GetCurrentTaskID()
+    {
+        if (g_current_task_id == 0)
+            g_current_task_id = g_next_task_id++;
+        return g_current_task_id;
+    }
+
 } // end of anonymous namespace
 
 TaskPoolImpl&
 TaskPoolImpl::GetInstance()
 {
-    static TaskPoolImpl g_task_pool_impl;
-    return g_task_pool_impl;
+    // The worker threads are never joined, so the pool is intentionally leaked to keep it alive
+    // until the very end of the process.
+    static TaskPoolImpl *g_task_pool_impl = new TaskPoolImpl();
+    return *g_task_pool_impl;
 }
 
 void
@@ -46,43 +133,238 @@ TaskPool::AddTaskImpl(std::function<void()>&& task_fn)
     TaskPoolImpl::GetInstance().AddTask(std::move(task_fn));
 }
 
+bool
+TaskPool::RunPendingTask()
+{
+    return TaskPoolImpl::GetInstance().RunPendingSubtask();
+}
+
+uint32_t
+TaskPool::GetThreadCount()
+{
+    return TaskPoolImpl::GetInstance().GetThreadCount();
+}
+
+bool
+TaskPool::SetThreadCount(uint32_t thread_count)
+{
+    return TaskPoolImpl::GetInstance().SetThreadCount(thread_count);
+}
+
 TaskPoolImpl::TaskPoolImpl() :
-    m_thread_count(0)
+    m_start_flag(),
+    m_config_mutex(),
+    m_requested_thread_count(0),
+    m_started(false),
+    m_worker_queues(),
+    m_shared_queue(),
+    m_steal_index(0),
+    m_num_queued(0),
+    m_sleep_mutex(),
+    m_cv()
+{
+}
+
+uint32_t
+TaskPoolImpl::GetThreadCount()
+{
+    std::lock_guard<std::mutex> guard(m_config_mutex);
+    if (m_started)
+        return m_worker_queues.size();
+
+    if (m_requested_thread_count > 0)
+        return m_requested_thread_count;
+
+    if (const char *env_thread_count = ::getenv("LLDB_TASK_POOL_THREADS"))
+    {
+        const unsigned long thread_count = ::strtoul(env_thread_count, nullptr, 0);
+        if (thread_count > 0)
+            return std::min<unsigned long>(thread_count, UINT16_MAX);
+    }
+
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+bool
+TaskPoolImpl::SetThreadCount(uint32_t thread_count)
+{
+    std::lock_guard<std::mutex> guard(m_config_mutex);
+    if (m_started)
+        return false;
+    m_requested_thread_count = thread_count;
+    return true;
+}
+
+void
+TaskPoolImpl::StartWorkers()
+{
+    const uint32_t thread_count = GetThreadCount();
+
+    std::lock_guard<std::mutex> guard(m_config_mutex);
+    for (uint32_t i = 0; i < thread_count; ++i)
+        m_worker_queues.emplace_back(new WorkerQueue());
+    for (auto& worker_queue : m_worker_queues)
+        std::thread(Worker, this, worker_queue.get()).detach();
+    m_started = true;
+}
+
+TaskPoolImpl::WorkerQueue&
+TaskPoolImpl::GetCurrentQueue()
 {
+    WorkerQueue* queue = static_cast<WorkerQueue*>(g_current_worker_queue);
+    return queue ? *queue : m_shared_queue;
 }
 
 void
 TaskPoolImpl::AddTask(std::function<void()>&& task_fn)
 {
-    static const uint32_t max_threads = std::thread::hardware_concurrency();
+    std::call_once(m_start_flag, [this]() { StartWorkers(); });
+
+    Task task;
+    task.m_fn = std::move(task_fn);
+    task.m_id = g_next_task_id++;
+    task.m_owner_id = GetCurrentTaskID();
 
-    std::unique_lock<std::mutex> lock(m_tasks_mutex);
-    m_tasks.emplace(std::move(task_fn));
-    if (m_thread_count < max_threads)
     {
-        m_thread_count++;
-        lock.unlock();
+        std::lock_guard<std::mutex> guard(m_sleep_mutex);
+        ++m_num_queued;
+    }
+
+    WorkerQueue& queue = GetCurrentQueue();
+    {
+        std::lock_guard<std::mutex> guard(queue.m_mutex);
+        queue.m_tasks.emplace_front(std::move(task));
+    }
+    m_cv.notify_one();
+}
+
+bool
+TaskPoolImpl::PopFront(WorkerQueue& queue, Task& task)
+{
+    std::lock_guard<std::mutex> guard(queue.m_mutex);
+    if (queue.m_tasks.empty())
+        return false;
+    task = std::move(queue.m_tasks.front());
+    queue.m_tasks.pop_front();
+    return true;
+}
+
+bool
+TaskPoolImpl::PopBack(WorkerQueue& queue, Task& task)
+{
+    std::lock_guard<std::mutex> guard(queue.m_mutex);
+    if (queue.m_tasks.empty())
+        return false;
+    task = std::move(queue.m_tasks.back());
+    queue.m_tasks.pop_back();
+    return true;
+}
 
-        std::thread (Worker, this).detach();
+bool
+TaskPoolImpl::PopSubtask(WorkerQueue& queue, uint64_t owner_id, Task& task)
+{
+    // Subtasks are added at the front, so the most recent ones are found first.
+    std::lock_guard<std::mutex> guard(queue.m_mutex);
+    for (auto pos = queue.m_tasks.begin(), end = queue.m_tasks.end(); pos != end; ++pos)
+    {
+        if (pos->m_owner_id == owner_id)
+        {
+            task = std::move(*pos);
+            queue.m_tasks.erase(pos);
+            return true;
+        }
     }
+    return false;
 }
 
 void
-TaskPoolImpl::Worker(TaskPoolImpl* pool)
+TaskPoolImpl::RunTask(Task& task)
 {
-    while (true)
+    const uint64_t saved_task_id = g_current_task_id;
+    g_current_task_id = task.m_id;
+    task.m_fn();
+    g_current_task_id = saved_task_id;
+}
+
+bool
+TaskPoolImpl::PopTask(WorkerQueue* worker_queue, Task& task)
+{
+    if (m_num_queued == 0)
+        return false;
+
+    bool found = (worker_queue && PopFront(*worker_queue, task)) || PopBack(m_shared_queue, task);
+    if (!found)
     {
-        std::unique_lock<std::mutex> lock(pool->m_tasks_mutex);
-        if (pool->m_tasks.empty())
+        // Steal from the other workers, starting at a different worker each time to spread the
+        // contention.
+        const size_t num_workers = m_worker_queues.size();
+        const size_t start = m_steal_index++;
+        for (size_t i = 0; i < num_workers && !found; ++i)
         {
-            pool->m_thread_count--;
-            break;
+            WorkerQueue* victim = m_worker_queues[(start + i) % num_workers].get();
+            if (victim != worker_queue)
+                found = PopBack(*victim, task);
         }
+    }
+
+    if (found)
+        --m_num_queued;
+    return found;
+}
+
+bool
+TaskPoolImpl::RunPendingSubtask()
+{
+    // Subtasks that haven't been stolen by other workers are still in the queue they were added to.
+    Task task;
+    if (m_num_queued == 0 || !PopSubtask(GetCurrentQueue(), GetCurrentTaskID(), task))
+        return false;
+    --m_num_queued;
+    RunTask(task);
+    return true;
+}
 
-        std::function<void()> f = pool->m_tasks.front();
-        pool->m_tasks.pop();
-        lock.unlock();
+void
+TaskPoolImpl::Worker(TaskPoolImpl* pool, WorkerQueue* worker_queue)
+{
+    g_current_worker_queue = worker_queue;
+    while (true)
+    {
+        Task task;
+        if (pool->PopTask(worker_queue, task))
+        {
+            RunTask(task);
+            continue;
+        }
 
-        f();
+        std::unique_lock<std::mutex> lock(pool->m_sleep_mutex);
+        pool->m_cv.wait(lock, [pool]() { return pool->m_num_queued > 0; });
     }
 }
+
+void
+TaskMapOverInt(size_t begin, size_t end, std::function<void(size_t)> const &func)
+{
+    if (begin >= end)
+        return;
+
+    std::atomic<size_t> next_index(begin);
+    auto wrapper = [&next_index, end, &func]()
+    {
+        while (true)
+        {
+            const size_t i = next_index++;
+            if (i >= end)
+                break;
+            func(i);
+        }
+    };
+
+    const size_t num_tasks = std::min<size_t>(end - begin, TaskPool::GetThreadCount());
+    std::vector<std::future<void>> futures;
+    futures.reserve(num_tasks);
+    for (size_t i = 0; i < num_tasks; ++i)
+        futures.push_back(TaskPool::AddTask(wrapper));
+    for (auto& f : futures)
+        TaskPool::WaitForFuture(f);
+}
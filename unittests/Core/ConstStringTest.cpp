@@ -0,0 +1,81 @@
+//===-- ConstStringTest.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lldb/Core/ConstString.h"
+
+using namespace lldb_private;
+
+TEST(ConstStringTest, Length)
+{
+    ConstString foo("foo");
+    EXPECT_EQ(3u, foo.GetLength());
+    EXPECT_EQ(foo, ConstString(std::string("foobar").c_str(), 3));
+    EXPECT_EQ(0u, ConstString("").GetLength());
+    EXPECT_EQ(0u, ConstString().GetLength());
+}
+
+TEST(ConstStringTest, MangledCounterpart)
+{
+    ConstString mangled("_Z3foov");
+    ConstString demangled;
+    demangled.SetCStringWithMangledCounterpart("foo()", mangled);
+    EXPECT_EQ(ConstString("foo()"), demangled);
+
+    ConstString counterpart;
+    EXPECT_TRUE(mangled.GetMangledCounterpart(counterpart));
+    EXPECT_EQ(demangled, counterpart);
+    EXPECT_TRUE(demangled.GetMangledCounterpart(counterpart));
+    EXPECT_EQ(mangled, counterpart);
+
+    EXPECT_FALSE(ConstString("no counterpart").GetMangledCounterpart(counterpart));
+}
+
+TEST(ConstStringTest, ConcurrentInsertion)
+{
+    const size_t num_threads = 8;
+    const size_t num_strings = 1000;
+    std::vector<std::vector<const char *>> results(num_threads);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([t, &results]()
+        {
+            // Look every string up twice so the second round can be served
+            // from the thread's cache.
+            for (size_t round = 0; round < 2; ++round)
+            {
+                for (size_t i = 0; i < num_strings; ++i)
+                {
+                    std::string str = "ConcurrentInsertion" + std::to_string(i);
+                    ConstString const_str(str.c_str());
+                    EXPECT_EQ(str.size(), const_str.GetLength());
+                    if (round == 0)
+                        results[t].push_back(const_str.GetCString());
+                    else
+                        EXPECT_EQ(results[t][i], const_str.GetCString());
+                }
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    for (size_t t = 1; t < num_threads; ++t)
+        EXPECT_EQ(results[0], results[t]);
+
+    ConstString::PoolStatistics stats = ConstString::GetPoolStatistics();
+    EXPECT_GE(stats.pool_lookups, stats.pool_insertions);
+    EXPECT_GE(stats.pool_insertions, num_strings);
+}
@@ -0,0 +1,116 @@
+//===-- FastDemangleTest.cpp ------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <string>
+
+#include "lldb/Core/FastDemangle.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    // Returns the fast demangling, or "<fallback>" when FastDemangle defers
+    // to the full demangler.
+    std::string
+    Demangle(const char *mangled_name)
+    {
+        char *demangled = FastDemangle(mangled_name);
+        if (!demangled)
+            return "<fallback>";
+        std::string result(demangled);
+        free(demangled);
+        return result;
+    }
+}
+
+TEST(FastDemangleTest, TemplatesAndSubstitutions)
+{
+    EXPECT_EQ("foo(std::vector<int, std::allocator<int> >)", Demangle("_Z3fooSt6vectorIiSaIiEE"));
+    EXPECT_EQ("foo(std::vector<int, std::allocator<int> >, std::vector<int, std::allocator<int> >)",
+              Demangle("_Z3fooSt6vectorIiSaIiEES1_"));
+    EXPECT_EQ("std::basic_string<char, std::char_traits<char>, std::allocator<char> >::basic_string()",
+              Demangle("_ZNSsC1Ev"));
+    EXPECT_EQ("std::allocator<char>::~allocator()", Demangle("_ZNSaIcED1Ev"));
+    EXPECT_EQ("llvm::BlockFrequency::operator>>=(unsigned int)", Demangle("_ZN4llvm14BlockFrequencyrSEj"));
+}
+
+TEST(FastDemangleTest, ReferenceCollapsing)
+{
+    EXPECT_EQ("void f<int&>(int&)", Demangle("_Z1fIRiEvOT_"));
+    EXPECT_EQ("void f<int&&>(int&&)", Demangle("_Z1fIOiEvOT_"));
+}
+
+TEST(FastDemangleTest, FunctionAndArrayTypes)
+{
+    EXPECT_EQ("f(void (*)(int))", Demangle("_Z1fPFviE"));
+    EXPECT_EQ("f(void (*)(int), void (*)(int))", Demangle("_Z1fPFviES0_"));
+    EXPECT_EQ("f(int const (&) [4])", Demangle("_Z1fRA4_Ki"));
+    EXPECT_EQ("f(void (A::*)(int) const)", Demangle("_Z1fM1AKFviE"));
+    EXPECT_EQ("f(std::function<void (int const&)>)", Demangle("_Z1fSt8functionIFvRKiEE"));
+
+    // Substitutions for the function type inside a function pointer, and
+    // pointers to substituted function pointers have no contiguous
+    // demangling to reuse
+    EXPECT_EQ("<fallback>", Demangle("_Z1fPFviES_"));
+    EXPECT_EQ("<fallback>", Demangle("_Z1fPFviEPS0_"));
+}
+
+TEST(FastDemangleTest, LambdasAndAbiTags)
+{
+    EXPECT_EQ("main::'lambda'(int)::operator()(int) const", Demangle("_ZZ4mainENKUliE_clEi"));
+    EXPECT_EQ("main::'lambda0'(int)::operator()(int) const", Demangle("_ZZ4mainENKUliE0_clEi"));
+    EXPECT_EQ("foo[abi:cxx11]()", Demangle("_Z3fooB5cxx11v"));
+    EXPECT_EQ("std::ios_base::failure[abi:cxx11]::what() const", Demangle("_ZNKSt8ios_base7failureB5cxx114whatEv"));
+}
+
+TEST(FastDemangleTest, ParameterPacks)
+{
+    EXPECT_EQ("void f<int, char>(int const&, char const&)", Demangle("_Z1fIJicEEvDpRKT_"));
+    EXPECT_EQ("void f<>()", Demangle("_Z1fIJEEvDpT_"));
+    EXPECT_EQ("std::tuple<int, char>::tuple()", Demangle("_ZNSt5tupleIJicEEC1Ev"));
+}
+
+TEST(FastDemangleTest, LocalNames)
+{
+    EXPECT_EQ("main::x", Demangle("_ZZ4mainE1x"));
+    EXPECT_EQ("Foo<int>::bar()::x", Demangle("_ZZN3FooIiE3barEvE1x"));
+
+    // The full demangler leaves out the return type of function templates
+    // that are the scope of a local name, and the substitutions following
+    // the local name have to be numbered to match
+    EXPECT_EQ("<fallback>", Demangle("_ZZNSt8__detail18__to_chars_10_implIjEEvPcjT_E8__digits"));
+    EXPECT_EQ("<fallback>", Demangle("_ZZN5clang4ento14CheckerManager6getTagINS0_3mpi10MPICheckerEEEPvvE3tag"));
+    EXPECT_EQ("<fallback>", Demangle("_ZSt13__adjust_heapIPN4llvm3cfg6UpdateIPNS0_10BasicBlockEEElS5_N9__gnu_cxx5__ops15_Iter_comp_iterIZNS1_15LegalizeUpdatesIS4_EEvNS0_8ArrayRefINS2_IT_EEEERNS0_15SmallVectorImplISD_EEbbEUlRKS5_SJ_E_EEEvSC_T0_SM_T1_T2_"));
+    EXPECT_EQ("<fallback>", Demangle("_ZSt16__insertion_sortIPN4llvm3cfg6UpdateIPNS0_10BasicBlockEEEN9__gnu_cxx5__ops15_Iter_comp_iterIZNS1_15LegalizeUpdatesIS4_EEvNS0_8ArrayRefINS2_IT_EEEERNS0_15SmallVectorImplISD_EEbbEUlRKS5_SJ_E_EEEvSC_SC_T0_"));
+    EXPECT_EQ("<fallback>", Demangle("_ZSt16__introsort_loopIPN4llvm3cfg6UpdateIPNS0_10BasicBlockEEElN9__gnu_cxx5__ops15_Iter_comp_iterIZNS1_15LegalizeUpdatesIS4_EEvNS0_8ArrayRefINS2_IT_EEEERNS0_15SmallVectorImplISD_EEbbEUlRKS5_SJ_E_EEEvSC_SC_T0_T1_"));
+    EXPECT_EQ("<fallback>", Demangle("_ZSt21__unguarded_partitionIPN4llvm3cfg6UpdateIPNS0_10BasicBlockEEEN9__gnu_cxx5__ops15_Iter_comp_iterIZNS1_15LegalizeUpdatesIS4_EEvNS0_8ArrayRefINS2_IT_EEEERNS0_15SmallVectorImplISD_EEbbEUlRKS5_SJ_E_EEESC_SC_SC_SC_T0_"));
+    EXPECT_EQ("<fallback>", Demangle("_ZN4llvm25ComputeMappedEditDistanceIcZNS_19ComputeEditDistanceIcEEjNS_8ArrayRefIT_EES4_bjEUlRKcE_EEjS4_S4_T0_bj"));
+    EXPECT_EQ("<fallback>", Demangle("_ZTIZN5clang7tooling24newFrontendActionFactoryINS_13EmitObjActionEEESt10unique_ptrINS0_21FrontendActionFactoryESt14default_deleteIS4_EEvE27SimpleFrontendActionFactory"));
+
+    // Default argument scopes
+    EXPECT_EQ("<fallback>", Demangle("_ZTSZNK5clang15LocationContext9printJsonERN4llvm11raw_ostreamEPKcjbSt8functionIFvPKS0_EEEd_UlS8_E_"));
+    EXPECT_EQ("<fallback>", Demangle("_ZZ1fiEd_NKUlvE_clEv"));
+}
+
+TEST(FastDemangleTest, ExternalNamesInExpressions)
+{
+    EXPECT_EQ("<fallback>", Demangle("_ZN5clang25LazyGenerationalUpdatePtrIPKNS_4DeclEPS1_XadL_ZNS_17ExternalASTSource19CompleteRedeclChainES3_EEE9makeValueERKNS_10ASTContextES4_"));
+    EXPECT_EQ("<fallback>", Demangle("_ZZN5clang12ast_matchers8internal15MemoizedMatcherINS1_7MatcherINS_4DeclEEEXadL_ZNS0_26isInstantiated_getInstanceEvEEE11getInstanceEvE8Instance"));
+}
+
+TEST(FastDemangleTest, Malformed)
+{
+    EXPECT_EQ("<fallback>", Demangle("_Z1fIJic"));
+    EXPECT_EQ("<fallback>", Demangle("_Z1fPFvi"));
+    EXPECT_EQ("<fallback>", Demangle("_ZZ4mainENKUli"));
+    EXPECT_EQ("<fallback>", Demangle("_Z3fooB"));
+}
@@ -0,0 +1,517 @@
+//===-- NativeAgentExpressionTest.cpp ---------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/RegisterValue.h"
+#include "lldb/Host/common/NativeAgentExpression.h"
+#include "lldb/Host/common/NativeCollectBuffer.h"
+#include "lldb/Host/common/NativeProcessProtocol.h"
+#include "lldb/Host/common/NativeRegisterContext.h"
+#include "lldb/Host/common/NativeThreadProtocol.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    typedef NativeAgentExpression AX;
+
+    const addr_t k_memory_addr = 0x1000;
+    const uint8_t k_memory[] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 };
+
+    // Register 0 is a 64-bit general purpose register and register 1 a
+    // 128-bit vector register that doesn't fit on the stack.
+    const uint64_t k_gpr_value = 0x123456789abcdef0ull;
+    const uint8_t k_vector_value[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+    RegisterInfo g_register_infos[] =
+    {
+        { "gpr", nullptr, 8, 0, eEncodingUint, eFormatHex,
+          { LLDB_INVALID_REGNUM, LLDB_INVALID_REGNUM, LLDB_INVALID_REGNUM, LLDB_INVALID_REGNUM, 0 }, nullptr, nullptr },
+        { "vec", nullptr, 16, 8, eEncodingVector, eFormatVectorOfUInt8,
+          { LLDB_INVALID_REGNUM, LLDB_INVALID_REGNUM, LLDB_INVALID_REGNUM, LLDB_INVALID_REGNUM, 1 }, nullptr, nullptr }
+    };
+    const uint32_t k_num_registers = sizeof (g_register_infos) / sizeof (g_register_infos[0]);
+
+    class FakeRegisterContext : public NativeRegisterContext
+    {
+    public:
+        FakeRegisterContext (NativeThreadProtocol &thread) :
+            NativeRegisterContext (thread, 0)
+        {
+        }
+
+        uint32_t GetRegisterCount () const override { return k_num_registers; }
+        uint32_t GetUserRegisterCount () const override { return k_num_registers; }
+        uint32_t GetRegisterSetCount () const override { return 0; }
+        const RegisterSet *GetRegisterSet (uint32_t set_index) const override { return nullptr; }
+
+        const RegisterInfo *
+        GetRegisterInfoAtIndex (uint32_t reg) const override
+        {
+            return reg < k_num_registers ? &g_register_infos[reg] : nullptr;
+        }
+
+        Error
+        ReadRegister (const RegisterInfo *reg_info, RegisterValue &reg_value) override
+        {
+            if (reg_info == &g_register_infos[0])
+                reg_value.SetUInt64 (k_gpr_value);
+            else
+                reg_value.SetBytes (k_vector_value, sizeof (k_vector_value), eByteOrderLittle);
+            return Error ();
+        }
+
+        Error WriteRegister (const RegisterInfo *, const RegisterValue &) override { return Error ("read only"); }
+        Error ReadAllRegisterValues (DataBufferSP &) override { return Error ("not supported"); }
+        Error WriteAllRegisterValues (const DataBufferSP &) override { return Error ("not supported"); }
+    };
+
+    class FakeThread : public NativeThreadProtocol
+    {
+    public:
+        FakeThread (NativeProcessProtocol *process) :
+            NativeThreadProtocol (process, 1)
+        {
+        }
+
+        std::string GetName () override { return "fake"; }
+        StateType GetState () override { return eStateStopped; }
+        bool GetStopReason (ThreadStopInfo &, std::string &) override { return false; }
+        Error SetWatchpoint (addr_t, size_t, uint32_t, bool) override { return Error ("not supported"); }
+        Error RemoveWatchpoint (addr_t) override { return Error ("not supported"); }
+
+        NativeRegisterContextSP
+        GetRegisterContext () override
+        {
+            if (!m_reg_context_sp)
+                m_reg_context_sp.reset (new FakeRegisterContext (*this));
+            return m_reg_context_sp;
+        }
+
+    private:
+        NativeRegisterContextSP m_reg_context_sp;
+    };
+
+    // A little endian process whose only readable memory is k_memory.
+    class FakeProcess : public NativeProcessProtocol
+    {
+    public:
+        FakeProcess () :
+            NativeProcessProtocol (1)
+        {
+        }
+
+        Error
+        ReadMemoryWithoutTrap (addr_t addr, void *buf, size_t size, size_t &bytes_read) override
+        {
+            bytes_read = 0;
+            if (addr < k_memory_addr || addr >= k_memory_addr + sizeof (k_memory))
+                return Error ("unreadable address 0x%" PRIx64, addr);
+            bytes_read = std::min<size_t> (size, k_memory_addr + sizeof (k_memory) - addr);
+            ::memcpy (buf, k_memory + (addr - k_memory_addr), bytes_read);
+            return Error ();
+        }
+
+        Error
+        ReadMemory (addr_t addr, void *buf, size_t size, size_t &bytes_read) override
+        {
+            return ReadMemoryWithoutTrap (addr, buf, size, bytes_read);
+        }
+
+        bool
+        GetArchitecture (ArchSpec &arch) const override
+        {
+            arch.SetTriple ("x86_64-pc-linux");
+            return true;
+        }
+
+        Error Resume (const ResumeActionList &) override { return Error ("not supported"); }
+        Error Halt () override { return Error ("not supported"); }
+        Error Detach () override { return Error ("not supported"); }
+        Error Signal (int) override { return Error ("not supported"); }
+        Error Kill () override { return Error ("not supported"); }
+        Error WriteMemory (addr_t, const void *, size_t, size_t &) override { return Error ("not supported"); }
+        Error AllocateMemory (size_t, uint32_t, addr_t &) override { return Error ("not supported"); }
+        Error DeallocateMemory (addr_t) override { return Error ("not supported"); }
+        addr_t GetSharedLibraryInfoAddress () override { return LLDB_INVALID_ADDRESS; }
+        size_t UpdateThreads () override { return 1; }
+        Error SetBreakpoint (addr_t, uint32_t, bool) override { return Error ("not supported"); }
+        Error GetLoadedModuleFileSpec (const char *, FileSpec &) override { return Error ("not supported"); }
+        Error GetFileLoadAddress (const llvm::StringRef &, addr_t &) override { return Error ("not supported"); }
+
+    protected:
+        Error
+        GetSoftwareBreakpointTrapOpcode (size_t, size_t &, const uint8_t *&) override
+        {
+            return Error ("not supported");
+        }
+    };
+
+    class NativeAgentExpressionTest : public ::testing::Test
+    {
+    public:
+        NativeAgentExpressionTest () :
+            m_process_sp (new FakeProcess ()),
+            m_thread (new FakeThread (m_process_sp.get ()))
+        {
+        }
+
+    protected:
+        Error
+        Evaluate (std::vector<uint8_t> bytecode, uint64_t &result, NativeCollectSample *sample = nullptr)
+        {
+            NativeAgentExpression expression (std::move (bytecode));
+            return expression.Evaluate (*m_process_sp, *m_thread, result, sample);
+        }
+
+        // Evaluate an expression that is expected to succeed.
+        uint64_t
+        Evaluate (std::vector<uint8_t> bytecode)
+        {
+            uint64_t result = 0;
+            Error error = Evaluate (std::move (bytecode), result);
+            EXPECT_TRUE (error.Success ()) << error.AsCString ();
+            return result;
+        }
+
+        // Evaluate an expression that is expected to succeed, recording what it collects.
+        uint64_t
+        Collect (std::vector<uint8_t> bytecode, NativeCollectSample &sample)
+        {
+            uint64_t result = 0;
+            Error error = Evaluate (std::move (bytecode), result, &sample);
+            EXPECT_TRUE (error.Success ()) << error.AsCString ();
+            return result;
+        }
+
+        // Evaluate an expression that is expected to fail and return the error.
+        std::string
+        EvaluateError (std::vector<uint8_t> bytecode, NativeCollectSample *sample = nullptr)
+        {
+            uint64_t result = 0;
+            Error error = Evaluate (std::move (bytecode), result, sample);
+            EXPECT_TRUE (error.Fail ());
+            return error.AsCString ("");
+        }
+
+        // Threads refer to their process through a weak pointer.
+        std::shared_ptr<FakeProcess> m_process_sp;
+        std::shared_ptr<FakeThread> m_thread;
+    };
+}
+
+TEST_F (NativeAgentExpressionTest, Constants)
+{
+    // Immediates are big endian.
+    EXPECT_EQ (0x12u, Evaluate ({ AX::eOpConst8, 0x12, AX::eOpEnd }));
+    EXPECT_EQ (0x1234u, Evaluate ({ AX::eOpConst16, 0x12, 0x34, AX::eOpEnd }));
+    EXPECT_EQ (0x12345678u, Evaluate ({ AX::eOpConst32, 0x12, 0x34, 0x56, 0x78, AX::eOpEnd }));
+    EXPECT_EQ (0x123456789abcdef0ull,
+               Evaluate ({ AX::eOpConst64, 0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc, 0xde, 0xf0, AX::eOpEnd }));
+}
+
+TEST_F (NativeAgentExpressionTest, Arithmetic)
+{
+    EXPECT_EQ (12u, Evaluate ({ AX::eOpConst8, 7, AX::eOpConst8, 5, AX::eOpAdd, AX::eOpEnd }));
+    EXPECT_EQ (2u, Evaluate ({ AX::eOpConst8, 7, AX::eOpConst8, 5, AX::eOpSub, AX::eOpEnd }));
+    EXPECT_EQ (uint64_t (-2), Evaluate ({ AX::eOpConst8, 5, AX::eOpConst8, 7, AX::eOpSub, AX::eOpEnd }));
+    EXPECT_EQ (35u, Evaluate ({ AX::eOpConst8, 7, AX::eOpConst8, 5, AX::eOpMul, AX::eOpEnd }));
+    EXPECT_EQ (1u, Evaluate ({ AX::eOpConst8, 7, AX::eOpConst8, 5, AX::eOpDivUnsigned, AX::eOpEnd }));
+    EXPECT_EQ (2u, Evaluate ({ AX::eOpConst8, 7, AX::eOpConst8, 5, AX::eOpRemUnsigned, AX::eOpEnd }));
+
+    // -7 / 2 and -7 % 2 truncate towards zero.
+    EXPECT_EQ (uint64_t (-3),
+               Evaluate ({ AX::eOpConst8, 0xf9, AX::eOpExt, 8, AX::eOpConst8, 2, AX::eOpDivSigned, AX::eOpEnd }));
+    EXPECT_EQ (uint64_t (-1),
+               Evaluate ({ AX::eOpConst8, 0xf9, AX::eOpExt, 8, AX::eOpConst8, 2, AX::eOpRemSigned, AX::eOpEnd }));
+
+    // INT64_MIN / -1 wraps instead of trapping.
+    EXPECT_EQ (0x8000000000000000ull,
+               Evaluate ({ AX::eOpConst64, 0x80, 0, 0, 0, 0, 0, 0, 0,
+                           AX::eOpConst8, 0xff, AX::eOpExt, 8, AX::eOpDivSigned, AX::eOpEnd }));
+    EXPECT_EQ (0u,
+               Evaluate ({ AX::eOpConst64, 0x80, 0, 0, 0, 0, 0, 0, 0,
+                           AX::eOpConst8, 0xff, AX::eOpExt, 8, AX::eOpRemSigned, AX::eOpEnd }));
+}
+
+TEST_F (NativeAgentExpressionTest, BitsAndShifts)
+{
+    EXPECT_EQ (0x0cu, Evaluate ({ AX::eOpConst8, 0x3c, AX::eOpConst8, 0x0f, AX::eOpBitAnd, AX::eOpEnd }));
+    EXPECT_EQ (0x3fu, Evaluate ({ AX::eOpConst8, 0x3c, AX::eOpConst8, 0x0f, AX::eOpBitOr, AX::eOpEnd }));
+    EXPECT_EQ (0x33u, Evaluate ({ AX::eOpConst8, 0x3c, AX::eOpConst8, 0x0f, AX::eOpBitXor, AX::eOpEnd }));
+    EXPECT_EQ (~0ull, Evaluate ({ AX::eOpConst8, 0, AX::eOpBitNot, AX::eOpEnd }));
+    EXPECT_EQ (1u, Evaluate ({ AX::eOpConst8, 0, AX::eOpLogNot, AX::eOpEnd }));
+    EXPECT_EQ (0u, Evaluate ({ AX::eOpConst8, 5, AX::eOpLogNot, AX::eOpEnd }));
+
+    EXPECT_EQ (0x100u, Evaluate ({ AX::eOpConst8, 1, AX::eOpConst8, 8, AX::eOpLsh, AX::eOpEnd }));
+    EXPECT_EQ (0x0fu, Evaluate ({ AX::eOpConst8, 0xf0, AX::eOpConst8, 4, AX::eOpRshUnsigned, AX::eOpEnd }));
+    EXPECT_EQ (uint64_t (-1),
+               Evaluate ({ AX::eOpConst8, 0xf0, AX::eOpExt, 8, AX::eOpConst8, 4, AX::eOpRshSigned, AX::eOpEnd }));
+
+    // Shifting by the width or more doesn't depend on the host.
+    EXPECT_EQ (0u, Evaluate ({ AX::eOpConst8, 1, AX::eOpConst8, 64, AX::eOpLsh, AX::eOpEnd }));
+    EXPECT_EQ (0u, Evaluate ({ AX::eOpConst8, 0x80, AX::eOpConst8, 200, AX::eOpRshUnsigned, AX::eOpEnd }));
+    EXPECT_EQ (uint64_t (-1),
+               Evaluate ({ AX::eOpConst8, 0x80, AX::eOpExt, 8, AX::eOpConst8, 200, AX::eOpRshSigned, AX::eOpEnd }));
+}
+
+TEST_F (NativeAgentExpressionTest, Comparisons)
+{
+    EXPECT_EQ (1u, Evaluate ({ AX::eOpConst8, 5, AX::eOpConst8, 5, AX::eOpEqual, AX::eOpEnd }));
+    EXPECT_EQ (0u, Evaluate ({ AX::eOpConst8, 5, AX::eOpConst8, 6, AX::eOpEqual, AX::eOpEnd }));
+
+    // -1 < 1 is only true when the operands are signed.
+    EXPECT_EQ (1u,
+               Evaluate ({ AX::eOpConst8, 0xff, AX::eOpExt, 8, AX::eOpConst8, 1, AX::eOpLessSigned, AX::eOpEnd }));
+    EXPECT_EQ (0u,
+               Evaluate ({ AX::eOpConst8, 0xff, AX::eOpExt, 8, AX::eOpConst8, 1, AX::eOpLessUnsigned, AX::eOpEnd }));
+}
+
+TEST_F (NativeAgentExpressionTest, Extensions)
+{
+    EXPECT_EQ (uint64_t (-2), Evaluate ({ AX::eOpConst8, 0xfe, AX::eOpExt, 8, AX::eOpEnd }));
+    EXPECT_EQ (0x7eu, Evaluate ({ AX::eOpConst8, 0x7e, AX::eOpExt, 8, AX::eOpEnd }));
+    EXPECT_EQ (0xffffffffffff8000ull, Evaluate ({ AX::eOpConst16, 0x80, 0x00, AX::eOpExt, 16, AX::eOpEnd }));
+    EXPECT_EQ (0xcdu, Evaluate ({ AX::eOpConst16, 0xab, 0xcd, AX::eOpZeroExt, 8, AX::eOpEnd }));
+    EXPECT_EQ (0xffffffffu,
+               Evaluate ({ AX::eOpConst8, 0xff, AX::eOpExt, 8, AX::eOpZeroExt, 32, AX::eOpEnd }));
+
+    // A width of 0 or 64 leaves the value alone.
+    EXPECT_EQ (0xfeu, Evaluate ({ AX::eOpConst8, 0xfe, AX::eOpExt, 0, AX::eOpEnd }));
+    EXPECT_EQ (uint64_t (-2), Evaluate ({ AX::eOpConst8, 0xfe, AX::eOpExt, 8, AX::eOpZeroExt, 64, AX::eOpEnd }));
+}
+
+TEST_F (NativeAgentExpressionTest, StackOperations)
+{
+    EXPECT_EQ (10u, Evaluate ({ AX::eOpConst8, 5, AX::eOpDup, AX::eOpAdd, AX::eOpEnd }));
+    EXPECT_EQ (1u, Evaluate ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpPop, AX::eOpEnd }));
+    EXPECT_EQ (1u, Evaluate ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpSwap, AX::eOpEnd }));
+    EXPECT_EQ (1u, Evaluate ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpSwap, AX::eOpSub, AX::eOpEnd }));
+
+    // pick 0 is dup, pick 2 copies the third entry.
+    EXPECT_EQ (3u, Evaluate ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpConst8, 3, AX::eOpPick, 0, AX::eOpEnd }));
+    EXPECT_EQ (1u, Evaluate ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpConst8, 3, AX::eOpPick, 2, AX::eOpEnd }));
+
+    // a b c => c a b.
+    EXPECT_EQ (2u, Evaluate ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpConst8, 3, AX::eOpRot, AX::eOpEnd }));
+    EXPECT_EQ (1u, Evaluate ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpConst8, 3, AX::eOpRot,
+                               AX::eOpPop, AX::eOpEnd }));
+    EXPECT_EQ (3u, Evaluate ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpConst8, 3, AX::eOpRot,
+                               AX::eOpPop, AX::eOpPop, AX::eOpEnd }));
+}
+
+TEST_F (NativeAgentExpressionTest, Jumps)
+{
+    // if_goto pops its operand and jumps when it is non-zero.
+    const std::vector<uint8_t> select =
+    {
+        AX::eOpIfGoto, 0, 8,        // 0
+        AX::eOpConst8, 20,          // 3
+        AX::eOpGoto, 0, 10,         // 5
+        AX::eOpConst8, 10,          // 8
+        AX::eOpEnd                  // 10
+    };
+    std::vector<uint8_t> bytecode = { AX::eOpConst8, 0 };
+    bytecode.insert (bytecode.end (), select.begin (), select.end ());
+    // Jump targets are offsets from the start, so shift them past the constant.
+    bytecode[4] += 2;
+    bytecode[9] += 2;
+    EXPECT_EQ (20u, Evaluate (bytecode));
+    bytecode[1] = 1;
+    EXPECT_EQ (10u, Evaluate (bytecode));
+
+    // A backward jump: count down from 3, summing the counter.
+    EXPECT_EQ (6u, Evaluate ({ AX::eOpConst8, 0,            // 0: sum
+                               AX::eOpConst8, 3,            // 2: counter
+                               AX::eOpDup,                  // 4
+                               AX::eOpLogNot,               // 5
+                               AX::eOpIfGoto, 0, 21,        // 6
+                               AX::eOpSwap,                 // 9
+                               AX::eOpPick, 1,              // 10
+                               AX::eOpAdd,                  // 12
+                               AX::eOpSwap,                 // 13
+                               AX::eOpConst8, 1,            // 14
+                               AX::eOpSub,                  // 16
+                               AX::eOpGoto, 0, 4,           // 17
+                               AX::eOpEnd,                  // 20
+                               AX::eOpPop,                  // 21
+                               AX::eOpEnd }));              // 22
+}
+
+TEST_F (NativeAgentExpressionTest, MemoryLoads)
+{
+    // The process is little endian.
+    EXPECT_EQ (0x11u, Evaluate ({ AX::eOpConst16, 0x10, 0x00, AX::eOpRef8, AX::eOpEnd }));
+    EXPECT_EQ (0x2211u, Evaluate ({ AX::eOpConst16, 0x10, 0x00, AX::eOpRef16, AX::eOpEnd }));
+    EXPECT_EQ (0x55443322u, Evaluate ({ AX::eOpConst16, 0x10, 0x01, AX::eOpRef32, AX::eOpEnd }));
+    EXPECT_EQ (0x8877665544332211ull, Evaluate ({ AX::eOpConst16, 0x10, 0x00, AX::eOpRef64, AX::eOpEnd }));
+
+    EXPECT_EQ ("unreadable address 0x2000",
+               EvaluateError ({ AX::eOpConst16, 0x20, 0x00, AX::eOpRef8, AX::eOpEnd }));
+    EXPECT_EQ ("failed to read 8 bytes at 0x1004",
+               EvaluateError ({ AX::eOpConst16, 0x10, 0x04, AX::eOpRef64, AX::eOpEnd }));
+}
+
+TEST_F (NativeAgentExpressionTest, Registers)
+{
+    EXPECT_EQ (k_gpr_value, Evaluate ({ AX::eOpReg, 0, 0, AX::eOpEnd }));
+    EXPECT_EQ ("invalid register 2 in agent expression", EvaluateError ({ AX::eOpReg, 0, 2, AX::eOpEnd }));
+    EXPECT_EQ ("register vec can't be used in an agent expression",
+               EvaluateError ({ AX::eOpReg, 0, 1, AX::eOpEnd }));
+}
+
+TEST_F (NativeAgentExpressionTest, MalformedBytecode)
+{
+    EXPECT_EQ ("agent expression ran past its end", EvaluateError ({}));
+    EXPECT_EQ ("agent expression ran past its end", EvaluateError ({ AX::eOpConst8, 1 }));
+    EXPECT_EQ ("truncated agent expression", EvaluateError ({ AX::eOpConst16, 1 }));
+    EXPECT_EQ ("truncated agent expression", EvaluateError ({ AX::eOpConst8, 1, AX::eOpExt }));
+    EXPECT_EQ ("truncated agent expression", EvaluateError ({ AX::eOpGoto, 0 }));
+    EXPECT_EQ ("truncated agent expression", EvaluateError ({ AX::eOpReg, 0 }));
+    EXPECT_EQ ("agent expression jump target 256 out of range", EvaluateError ({ AX::eOpGoto, 1, 0, AX::eOpEnd }));
+    EXPECT_EQ ("unsupported agent expression opcode 0xff at offset 2",
+               EvaluateError ({ AX::eOpConst8, 1, 0xff, AX::eOpEnd }));
+
+    // A jump that isn't taken isn't checked.
+    EXPECT_EQ (1u, Evaluate ({ AX::eOpConst8, 1, AX::eOpConst8, 0, AX::eOpIfGoto, 1, 0, AX::eOpEnd }));
+}
+
+TEST_F (NativeAgentExpressionTest, StackBounds)
+{
+    EXPECT_EQ ("agent expression stack underflow at offset 0", EvaluateError ({ AX::eOpEnd }));
+    EXPECT_EQ ("agent expression stack underflow at offset 2", EvaluateError ({ AX::eOpConst8, 1, AX::eOpAdd }));
+    EXPECT_EQ ("agent expression stack underflow at offset 4",
+               EvaluateError ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpRot }));
+    EXPECT_EQ ("agent expression stack underflow at offset 2",
+               EvaluateError ({ AX::eOpConst8, 1, AX::eOpPick, 1, AX::eOpEnd }));
+
+    // Pushing in a loop stops at the stack limit rather than growing forever.
+    const std::string error = EvaluateError ({ AX::eOpConst8, 1, AX::eOpDup, AX::eOpGoto, 0, 2 });
+    EXPECT_EQ (0u, error.find ("agent expression stack overflow at offset ")) << error;
+}
+
+TEST_F (NativeAgentExpressionTest, InstructionLimit)
+{
+    EXPECT_EQ ("agent expression exceeded the instruction limit", EvaluateError ({ AX::eOpGoto, 0, 0 }));
+    EXPECT_EQ ("agent expression exceeded the instruction limit",
+               EvaluateError ({ AX::eOpConst8, 1, AX::eOpDup, AX::eOpPop, AX::eOpGoto, 0, 2 }));
+}
+
+TEST_F (NativeAgentExpressionTest, DivisionByZero)
+{
+    EXPECT_EQ ("agent expression division by zero at offset 4",
+               EvaluateError ({ AX::eOpConst8, 1, AX::eOpConst8, 0, AX::eOpDivSigned, AX::eOpEnd }));
+    EXPECT_EQ ("agent expression division by zero at offset 4",
+               EvaluateError ({ AX::eOpConst8, 1, AX::eOpConst8, 0, AX::eOpDivUnsigned, AX::eOpEnd }));
+    EXPECT_EQ ("agent expression division by zero at offset 4",
+               EvaluateError ({ AX::eOpConst8, 1, AX::eOpConst8, 0, AX::eOpRemSigned, AX::eOpEnd }));
+    EXPECT_EQ ("agent expression division by zero at offset 4",
+               EvaluateError ({ AX::eOpConst8, 1, AX::eOpConst8, 0, AX::eOpRemUnsigned, AX::eOpEnd }));
+}
+
+TEST_F (NativeAgentExpressionTest, TraceQuick)
+{
+    // The address stays on the stack.
+    NativeCollectSample sample (0, 1, 0);
+    EXPECT_EQ (0x1000u, Collect ({ AX::eOpConst16, 0x10, 0x00, AX::eOpTraceQuick, 4, AX::eOpEnd }, sample));
+    ASSERT_EQ (1u, sample.memory.size ());
+    EXPECT_EQ (0x1000u, sample.memory[0].addr);
+    EXPECT_EQ (std::vector<uint8_t> ({ 0x11, 0x22, 0x33, 0x44 }), sample.memory[0].bytes);
+    EXPECT_TRUE (sample.registers.empty ());
+}
+
+TEST_F (NativeAgentExpressionTest, Trace16)
+{
+    NativeCollectSample sample (0, 1, 0);
+    EXPECT_EQ (0x1002u, Collect ({ AX::eOpConst16, 0x10, 0x02, AX::eOpTrace16, 0, 3, AX::eOpEnd }, sample));
+    ASSERT_EQ (1u, sample.memory.size ());
+    EXPECT_EQ (0x1002u, sample.memory[0].addr);
+    EXPECT_EQ (std::vector<uint8_t> ({ 0x33, 0x44, 0x55 }), sample.memory[0].bytes);
+}
+
+TEST_F (NativeAgentExpressionTest, Trace)
+{
+    // trace pops both the address and the size.
+    NativeCollectSample sample (0, 1, 0);
+    EXPECT_EQ (7u, Collect ({ AX::eOpConst8, 7, AX::eOpConst16, 0x10, 0x00, AX::eOpConst8, 2, AX::eOpTrace, AX::eOpEnd },
+                            sample));
+    ASSERT_EQ (1u, sample.memory.size ());
+    EXPECT_EQ (0x1000u, sample.memory[0].addr);
+    EXPECT_EQ (std::vector<uint8_t> ({ 0x11, 0x22 }), sample.memory[0].bytes);
+
+    EXPECT_EQ ("agent expression stack underflow at offset 2",
+               EvaluateError ({ AX::eOpConst8, 2, AX::eOpTrace, AX::eOpEnd }, &sample));
+}
+
+TEST_F (NativeAgentExpressionTest, TracePartialMemory)
+{
+    // What is readable is kept, the rest of the block is dropped.
+    NativeCollectSample sample (0, 1, 0);
+    Collect ({ AX::eOpConst16, 0x10, 0x06, AX::eOpTraceQuick, 8, AX::eOpEnd }, sample);
+    Collect ({ AX::eOpConst16, 0x20, 0x00, AX::eOpTraceQuick, 8, AX::eOpEnd }, sample);
+    ASSERT_EQ (2u, sample.memory.size ());
+    EXPECT_EQ (0x1006u, sample.memory[0].addr);
+    EXPECT_EQ (std::vector<uint8_t> ({ 0x77, 0x88 }), sample.memory[0].bytes);
+    EXPECT_EQ (0x2000u, sample.memory[1].addr);
+    EXPECT_TRUE (sample.memory[1].bytes.empty ());
+
+    // Nothing to collect.
+    Collect ({ AX::eOpConst16, 0x10, 0x00, AX::eOpTraceQuick, 0, AX::eOpEnd }, sample);
+    EXPECT_EQ (2u, sample.memory.size ());
+}
+
+TEST_F (NativeAgentExpressionTest, TraceWithoutSample)
+{
+    // Conditions only pop the operands, so the size isn't checked either.
+    EXPECT_EQ (0x1000u, Evaluate ({ AX::eOpConst16, 0x10, 0x00, AX::eOpTraceQuick, 4, AX::eOpEnd }));
+    EXPECT_EQ (7u, Evaluate ({ AX::eOpConst8, 7, AX::eOpConst8, 1, AX::eOpConst32, 0x00, 0x01, 0x00, 0x01, AX::eOpTrace,
+                               AX::eOpEnd }));
+}
+
+TEST_F (NativeAgentExpressionTest, TraceBounds)
+{
+    NativeCollectSample sample (0, 1, 0);
+    EXPECT_EQ ("agent expression collects too much memory at 0x1000",
+               EvaluateError ({ AX::eOpConst16, 0x10, 0x00, AX::eOpConst32, 0x00, 0x01, 0x00, 0x01, AX::eOpTrace,
+                                AX::eOpEnd }, &sample));
+    EXPECT_TRUE (sample.memory.empty ());
+
+    // 65536 bytes is the limit, which only the trace opcode can go past.
+    EXPECT_EQ (0x2000u, Collect ({ AX::eOpConst16, 0x20, 0x00, AX::eOpTrace16, 0xff, 0xff, AX::eOpEnd }, sample));
+    EXPECT_EQ (1u, sample.memory.size ());
+
+    EXPECT_EQ ("truncated agent expression", EvaluateError ({ AX::eOpConst8, 1, AX::eOpTraceQuick }, &sample));
+    EXPECT_EQ ("truncated agent expression", EvaluateError ({ AX::eOpConst8, 1, AX::eOpTrace16, 0 }, &sample));
+    EXPECT_EQ ("agent expression stack underflow at offset 0",
+               EvaluateError ({ AX::eOpTraceQuick, 4, AX::eOpEnd }, &sample));
+}
+
+TEST_F (NativeAgentExpressionTest, CollectRegisters)
+{
+    NativeCollectSample sample (0, 1, 0);
+    // Reading a register twice records it once.
+    EXPECT_EQ (k_gpr_value, Collect ({ AX::eOpReg, 0, 0, AX::eOpReg, 0, 0, AX::eOpPop, AX::eOpEnd }, sample));
+
+    // A register that doesn't fit on the stack can still be collected, 0
+    // is pushed in its place.
+    EXPECT_EQ (0u, Collect ({ AX::eOpReg, 0, 1, AX::eOpEnd }, sample));
+
+    ASSERT_EQ (2u, sample.registers.size ());
+    std::vector<uint8_t> gpr_bytes (sizeof (k_gpr_value));
+    ::memcpy (gpr_bytes.data (), &k_gpr_value, sizeof (k_gpr_value));
+    EXPECT_EQ (gpr_bytes, sample.registers[0]);
+    EXPECT_EQ (std::vector<uint8_t> (k_vector_value, k_vector_value + sizeof (k_vector_value)), sample.registers[1]);
+    EXPECT_TRUE (sample.memory.empty ());
+}
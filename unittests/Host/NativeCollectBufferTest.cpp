@@ -0,0 +1,181 @@
+//===-- NativeCollectBufferTest.cpp -----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Host/common/NativeCollectBuffer.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    const lldb::tid_t k_tid = 1;
+    const lldb::addr_t k_breakpoint_addr = 0x1000;
+
+    // Create the sample for the next hit, with a memory block of the given size.
+    NativeCollectSample
+    CreateSample (NativeCollectBuffer &buffer, size_t block_size = 16)
+    {
+        NativeCollectSample sample = buffer.CreateSample (k_tid, k_breakpoint_addr);
+        NativeCollectSample::MemoryBlock block;
+        block.addr = 0x2000;
+        block.bytes.resize (block_size);
+        sample.memory.push_back (block);
+        return sample;
+    }
+
+    // The accounted size of the samples CreateSample() makes by default.
+    size_t
+    GetSampleSize ()
+    {
+        NativeCollectBuffer buffer (0);
+        return CreateSample (buffer).GetByteSize ();
+    }
+
+    std::vector<uint64_t>
+    Drain (NativeCollectBuffer &buffer, size_t max_bytes, uint64_t &dropped)
+    {
+        std::vector<NativeCollectSample> samples;
+        buffer.Drain (max_bytes, samples, dropped);
+        std::vector<uint64_t> ids;
+        for (const NativeCollectSample &sample : samples)
+            ids.push_back (sample.id);
+        return ids;
+    }
+
+    class NativeCollectBufferTest: public ::testing::Test
+    {
+    };
+}
+
+TEST_F (NativeCollectBufferTest, SampleSize)
+{
+    NativeCollectBuffer buffer (1024);
+    NativeCollectSample sample = buffer.CreateSample (k_tid, k_breakpoint_addr);
+    const size_t empty_size = sample.GetByteSize ();
+    EXPECT_EQ (sizeof (NativeCollectSample), empty_size);
+
+    // The collected bytes count, along with the bookkeeping.
+    sample.registers[0].resize (8);
+    const size_t register_size = sample.GetByteSize ();
+    EXPECT_LT (empty_size + 8, register_size);
+
+    NativeCollectSample::MemoryBlock block;
+    block.addr = 0x2000;
+    block.bytes.resize (100);
+    sample.memory.push_back (block);
+    EXPECT_LT (register_size + 100, sample.GetByteSize ());
+}
+
+TEST_F (NativeCollectBufferTest, Ids)
+{
+    // Ids are reserved when the sample is created, so a sample that is
+    // never added leaves a gap.
+    NativeCollectBuffer buffer (16 * GetSampleSize ());
+    buffer.AddSample (CreateSample (buffer));
+    CreateSample (buffer);
+    buffer.AddSample (CreateSample (buffer));
+
+    uint64_t dropped = 1;
+    EXPECT_EQ (std::vector<uint64_t> ({ 0, 2 }), Drain (buffer, 16 * GetSampleSize (), dropped));
+    EXPECT_EQ (0u, dropped);
+
+    // Clearing the buffer doesn't reuse ids.
+    buffer.AddSample (CreateSample (buffer));
+    buffer.Clear ();
+    buffer.AddSample (CreateSample (buffer));
+    EXPECT_EQ (std::vector<uint64_t> ({ 4 }), Drain (buffer, 16 * GetSampleSize (), dropped));
+}
+
+TEST_F (NativeCollectBufferTest, EvictsOldestSamples)
+{
+    const size_t sample_size = GetSampleSize ();
+    NativeCollectBuffer buffer (3 * sample_size);
+    for (int i = 0; i < 5; ++i)
+        buffer.AddSample (CreateSample (buffer));
+
+    uint64_t dropped = 0;
+    EXPECT_EQ (std::vector<uint64_t> ({ 2, 3, 4 }), Drain (buffer, 3 * sample_size, dropped));
+    EXPECT_EQ (2u, dropped);
+
+    // The count of dropped samples is only reported once.
+    EXPECT_TRUE (Drain (buffer, 3 * sample_size, dropped).empty ());
+    EXPECT_EQ (0u, dropped);
+
+    // A larger sample evicts as many small ones as it needs room for.
+    for (int i = 0; i < 3; ++i)
+        buffer.AddSample (CreateSample (buffer));
+    NativeCollectSample large_sample = CreateSample (buffer, 0);
+    large_sample.memory[0].bytes.resize (2 * sample_size - large_sample.GetByteSize ());
+    ASSERT_EQ (2 * sample_size, large_sample.GetByteSize ());
+    buffer.AddSample (std::move (large_sample));
+    EXPECT_EQ (std::vector<uint64_t> ({ 7, 8 }), Drain (buffer, 3 * sample_size, dropped));
+    EXPECT_EQ (2u, dropped);
+}
+
+TEST_F (NativeCollectBufferTest, DropsOversizedSamples)
+{
+    const size_t sample_size = GetSampleSize ();
+    NativeCollectBuffer buffer (2 * sample_size);
+    buffer.AddSample (CreateSample (buffer));
+    buffer.AddSample (CreateSample (buffer, 4 * sample_size));
+
+    // The sample that can never fit doesn't evict the others.
+    uint64_t dropped = 0;
+    EXPECT_EQ (std::vector<uint64_t> ({ 0 }), Drain (buffer, 2 * sample_size, dropped));
+    EXPECT_EQ (1u, dropped);
+}
+
+TEST_F (NativeCollectBufferTest, DrainBounds)
+{
+    const size_t sample_size = GetSampleSize ();
+    NativeCollectBuffer buffer (16 * sample_size);
+    for (int i = 0; i < 5; ++i)
+        buffer.AddSample (CreateSample (buffer));
+
+    // Only whole samples are drained, as many as fit.
+    uint64_t dropped = 0;
+    EXPECT_EQ (std::vector<uint64_t> ({ 0, 1 }), Drain (buffer, 2 * sample_size, dropped));
+    EXPECT_EQ (std::vector<uint64_t> ({ 2, 3 }), Drain (buffer, 3 * sample_size - 1, dropped));
+
+    // At least one sample is drained even if it is larger than the limit.
+    EXPECT_EQ (std::vector<uint64_t> ({ 4 }), Drain (buffer, 1, dropped));
+    EXPECT_TRUE (Drain (buffer, 1, dropped).empty ());
+    EXPECT_TRUE (Drain (buffer, 16 * sample_size, dropped).empty ());
+    EXPECT_EQ (0u, dropped);
+}
+
+TEST_F (NativeCollectBufferTest, DrainMakesRoom)
+{
+    const size_t sample_size = GetSampleSize ();
+    NativeCollectBuffer buffer (3 * sample_size);
+    for (int i = 0; i < 3; ++i)
+        buffer.AddSample (CreateSample (buffer));
+
+    uint64_t dropped = 0;
+    EXPECT_EQ (std::vector<uint64_t> ({ 0, 1 }), Drain (buffer, 2 * sample_size, dropped));
+    buffer.AddSample (CreateSample (buffer));
+    buffer.AddSample (CreateSample (buffer));
+    EXPECT_EQ (std::vector<uint64_t> ({ 2, 3, 4 }), Drain (buffer, 3 * sample_size, dropped));
+    EXPECT_EQ (0u, dropped);
+}
+
+TEST_F (NativeCollectBufferTest, Clear)
+{
+    const size_t sample_size = GetSampleSize ();
+    NativeCollectBuffer buffer (sample_size);
+    buffer.AddSample (CreateSample (buffer));
+    buffer.AddSample (CreateSample (buffer));
+    buffer.Clear ();
+
+    // Both the samples and the count of dropped ones are gone.
+    uint64_t dropped = 1;
+    EXPECT_TRUE (Drain (buffer, sample_size, dropped).empty ());
+    EXPECT_EQ (0u, dropped);
+}
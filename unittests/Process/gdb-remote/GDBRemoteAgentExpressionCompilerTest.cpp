@@ -0,0 +1,242 @@
+//===-- GDBRemoteAgentExpressionCompilerTest.cpp ----------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/Debugger.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Host/common/NativeAgentExpression.h"
+#include "lldb/Target/Platform.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/TargetList.h"
+
+#include "Plugins/Platform/Linux/PlatformLinux.h"
+#include "Plugins/Process/gdb-remote/GDBRemoteAgentExpressionCompiler.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+namespace
+{
+    typedef NativeAgentExpression AX;
+
+    // A process without threads or memory. Conditions that only use
+    // literals and operators compile without either.
+    class TestProcess : public Process
+    {
+    public:
+        TestProcess (TargetSP target_sp, Listener &listener) :
+            Process (target_sp, listener)
+        {
+        }
+
+        bool CanDebug (TargetSP, bool) override { return true; }
+        Error DoDestroy () override { return Error (); }
+        void RefreshStateAfterStop () override {}
+        bool UpdateThreadList (ThreadList &, ThreadList &) override { return false; }
+        ConstString GetPluginName () override { return ConstString ("test"); }
+        uint32_t GetPluginVersion () override { return 1; }
+
+        size_t
+        DoReadMemory (addr_t, void *, size_t, Error &error) override
+        {
+            error.SetErrorString ("no memory");
+            return 0;
+        }
+    };
+
+    class GDBRemoteAgentExpressionCompilerTest : public ::testing::Test
+    {
+    public:
+        static void
+        SetUpTestCase ()
+        {
+            HostInfo::Initialize ();
+            ArchSpec arch ("x86_64-pc-linux");
+            Platform::SetHostPlatform (platform_linux::PlatformLinux::CreateInstance (true, &arch));
+        }
+
+        void
+        SetUp () override
+        {
+            m_debugger_sp = Debugger::CreateInstance ();
+            PlatformSP platform_sp;
+            m_debugger_sp->GetTargetList ().CreateTarget (*m_debugger_sp, nullptr, ArchSpec ("x86_64-pc-linux"),
+                                                          false, platform_sp, m_target_sp);
+            ASSERT_TRUE (m_target_sp.get ());
+            m_process_sp.reset (new TestProcess (m_target_sp, m_debugger_sp->GetListener ()));
+        }
+
+        void
+        TearDown () override
+        {
+            m_process_sp->Finalize ();
+            m_process_sp.reset ();
+            m_target_sp.reset ();
+            Debugger::Destroy (m_debugger_sp);
+        }
+
+    protected:
+        // Compile a condition that is expected to compile.
+        std::vector<uint8_t>
+        Compile (const char *condition)
+        {
+            std::vector<uint8_t> bytecode;
+            GDBRemoteAgentExpressionCompiler compiler (*m_process_sp, Address ());
+            Error error = compiler.Compile (condition, bytecode);
+            EXPECT_TRUE (error.Success ()) << condition << ": " << error.AsCString ();
+            return bytecode;
+        }
+
+        std::vector<uint8_t>
+        CompileCollect (const char *item)
+        {
+            std::vector<uint8_t> bytecode;
+            GDBRemoteAgentExpressionCompiler compiler (*m_process_sp, Address ());
+            Error error = compiler.CompileCollect (item, bytecode);
+            EXPECT_TRUE (error.Success ()) << item << ": " << error.AsCString ();
+            return bytecode;
+        }
+
+        // Compile a condition that is expected to fail, the bytecode must be
+        // left alone.
+        std::string
+        CompileError (const char *condition, bool collect = false)
+        {
+            std::vector<uint8_t> bytecode;
+            GDBRemoteAgentExpressionCompiler compiler (*m_process_sp, Address ());
+            Error error = collect ? compiler.CompileCollect (condition, bytecode) : compiler.Compile (condition, bytecode);
+            EXPECT_TRUE (error.Fail ()) << condition;
+            EXPECT_TRUE (bytecode.empty ()) << condition;
+            return error.AsCString ("");
+        }
+
+        DebuggerSP m_debugger_sp;
+        TargetSP m_target_sp;
+        ProcessSP m_process_sp;
+    };
+}
+
+TEST_F (GDBRemoteAgentExpressionCompilerTest, Literals)
+{
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 1, AX::eOpEnd }), Compile ("1"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 1, AX::eOpEnd }), Compile ("true"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 0, AX::eOpEnd }), Compile ("false"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst16, 0x12, 0x34, AX::eOpEnd }), Compile ("0x1234"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst64, 0, 0, 0, 1, 0, 0, 0, 0, AX::eOpEnd }), Compile ("0x100000000"));
+
+    // A hex literal that doesn't fit int is unsigned int, a decimal one is
+    // long, which changes how the negation is truncated.
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 0, AX::eOpConst32, 0xff, 0xff, 0xff, 0xff, AX::eOpSub,
+                                       AX::eOpZeroExt, 32, AX::eOpEnd }),
+               Compile ("-0xffffffff"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 0, AX::eOpConst32, 0xff, 0xff, 0xff, 0xff, AX::eOpSub,
+                                       AX::eOpEnd }),
+               Compile ("-4294967295"));
+}
+
+TEST_F (GDBRemoteAgentExpressionCompilerTest, Arithmetic)
+{
+    // int results are sign extended from 32 bits.
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpAdd, AX::eOpExt, 32, AX::eOpEnd }),
+               Compile ("1 + 2"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpAdd, AX::eOpExt, 32,
+                                       AX::eOpConst8, 3, AX::eOpMul, AX::eOpExt, 32, AX::eOpEnd }),
+               Compile ("(1 + 2) * 3"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpConst8, 3, AX::eOpMul, AX::eOpExt, 32,
+                                       AX::eOpAdd, AX::eOpExt, 32, AX::eOpEnd }),
+               Compile ("1 + 2 * 3"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 0, AX::eOpBitNot, AX::eOpExt, 32, AX::eOpEnd }), Compile ("~0"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 5, AX::eOpLogNot, AX::eOpEnd }), Compile ("!5"));
+
+    // The signed operand is converted to unsigned int, which picks the
+    // unsigned operation.
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 5, AX::eOpConst8, 3, AX::eOpSwap, AX::eOpZeroExt, 32, AX::eOpSwap,
+                                       AX::eOpRemUnsigned, AX::eOpZeroExt, 32, AX::eOpEnd }),
+               Compile ("5 % 3u"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 5, AX::eOpConst8, 3, AX::eOpDivSigned, AX::eOpExt, 32, AX::eOpEnd }),
+               Compile ("5 / 3"));
+}
+
+TEST_F (GDBRemoteAgentExpressionCompilerTest, Comparisons)
+{
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpEqual, AX::eOpEnd }), Compile ("1 == 2"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpEqual, AX::eOpLogNot, AX::eOpEnd }),
+               Compile ("1 != 2"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpLessSigned, AX::eOpEnd }),
+               Compile ("1 < 2"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpSwap, AX::eOpLessSigned, AX::eOpEnd }),
+               Compile ("1 > 2"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpSwap, AX::eOpLessSigned, AX::eOpLogNot,
+                                       AX::eOpEnd }),
+               Compile ("1 <= 2"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 1, AX::eOpConst8, 2, AX::eOpLessSigned, AX::eOpLogNot, AX::eOpEnd }),
+               Compile ("1 >= 2"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 3, AX::eOpConst8, 4, AX::eOpSwap, AX::eOpZeroExt, 32, AX::eOpSwap,
+                                       AX::eOpLessUnsigned, AX::eOpEnd }),
+               Compile ("3 < 4u"));
+}
+
+TEST_F (GDBRemoteAgentExpressionCompilerTest, LogicalOperators)
+{
+    // The right hand side is skipped once the result is known.
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 1,          // 0
+                                       AX::eOpIfGoto, 0, 10,      // 2
+                                       AX::eOpConst8, 0,          // 5
+                                       AX::eOpGoto, 0, 14,        // 7
+                                       AX::eOpConst8, 0,          // 10
+                                       AX::eOpLogNot,             // 12
+                                       AX::eOpLogNot,             // 13
+                                       AX::eOpEnd }),             // 14
+               Compile ("1 && 0"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 1,          // 0
+                                       AX::eOpIfGoto, 0, 12,      // 2
+                                       AX::eOpConst8, 0,          // 5
+                                       AX::eOpLogNot,             // 7
+                                       AX::eOpLogNot,             // 8
+                                       AX::eOpGoto, 0, 14,        // 9
+                                       AX::eOpConst8, 1,          // 12
+                                       AX::eOpEnd }),             // 14
+               Compile ("1 || 0"));
+}
+
+TEST_F (GDBRemoteAgentExpressionCompilerTest, Collect)
+{
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 16, AX::eOpEnd }), CompileCollect ("16"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 16, AX::eOpTrace16, 0, 4, AX::eOpEnd }), CompileCollect ("16@4"));
+    EXPECT_EQ (std::vector<uint8_t> ({ AX::eOpConst8, 16, AX::eOpTrace16, 1, 0, AX::eOpEnd }), CompileCollect ("16 @ 0x100"));
+
+    EXPECT_EQ ("invalid size '0' in '16@0'", CompileError ("16@0", true));
+    EXPECT_EQ ("invalid size '65536' in '16@65536'", CompileError ("16@65536", true));
+    EXPECT_EQ ("invalid size 'x' in '16@x'", CompileError ("16@x", true));
+    EXPECT_EQ ("invalid size '' in '16@'", CompileError ("16@", true));
+    EXPECT_EQ ("unexpected end of expression", CompileError ("@4", true));
+}
+
+TEST_F (GDBRemoteAgentExpressionCompilerTest, Errors)
+{
+    EXPECT_EQ ("unexpected end of expression", CompileError (""));
+    EXPECT_EQ ("unexpected end of expression", CompileError ("1 +"));
+    EXPECT_EQ ("expected ')' in expression", CompileError ("(1"));
+    EXPECT_EQ ("unexpected '2' in expression", CompileError ("1 2"));
+    EXPECT_EQ ("unexpected ')' in expression", CompileError (")"));
+    EXPECT_EQ ("unsupported character '=' in expression", CompileError ("1 = 2"));
+    EXPECT_EQ ("unsupported literal '1'", CompileError ("1.5"));
+    EXPECT_EQ ("integer literal is too large", CompileError ("99999999999999999999"));
+    EXPECT_EQ ("only pointers can be dereferenced", CompileError ("*1"));
+    EXPECT_EQ ("expected a register name after '$'", CompileError ("$"));
+
+    // The process has no threads to get register numbers from, and no
+    // modules to find variables in.
+    EXPECT_EQ ("no registers available", CompileError ("$rax == 1"));
+    EXPECT_EQ ("no variable named 'foo'", CompileError ("foo == 1"));
+}
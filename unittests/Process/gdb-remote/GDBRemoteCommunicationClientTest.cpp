@@ -0,0 +1,374 @@
+//===-- GDBRemoteCommunicationClientTest.cpp --------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(_MSC_VER) && (_HAS_EXCEPTIONS == 0)
+// Workaround for MSVC standard library bug, which fails to include <thread> when
+// exceptions are disabled.
+#include <eh.h>
+#endif
+
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "lldb/Host/ConnectionFileDescriptor.h"
+#include "lldb/Host/common/TCPSocket.h"
+
+#include "Plugins/Process/gdb-remote/GDBRemoteCommunicationClient.h"
+#include "Utility/StringExtractorGDBRemote.h"
+
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+namespace
+{
+    typedef GDBRemoteCommunication::PacketResult PacketResult;
+
+    // Packets are pipelined only once acks are disabled.
+    class TestClient : public GDBRemoteCommunicationClient
+    {
+    public:
+        TestClient ()
+        {
+            m_send_acks = false;
+        }
+    };
+
+    // The remote end, which the tests script packet by packet.
+    class MockServer : public GDBRemoteCommunication
+    {
+    public:
+        MockServer () :
+            GDBRemoteCommunication ("gdb-remote.server", "gdb-remote.server.rx_packet")
+        {
+            m_send_acks = false;
+        }
+
+        bool
+        GetThreadSuffixSupported () override
+        {
+            return false;
+        }
+
+        std::string
+        GetPacket ()
+        {
+            StringExtractorGDBRemote packet;
+            if (ReadPacket (packet, 10 * TimeValue::MicroSecPerSec, false) != PacketResult::Success)
+                return "<no packet>";
+            return packet.GetStringRef ();
+        }
+
+        void
+        Reply (const std::string &payload)
+        {
+            EXPECT_EQ (PacketResult::Success, SendPacketNoLock (payload.data (), payload.size ()));
+        }
+    };
+
+    class GDBRemoteCommunicationClientTest : public ::testing::Test
+    {
+    public:
+        void
+        SetUp () override
+        {
+#if defined(_MSC_VER)
+            WSADATA data;
+            ::WSAStartup (MAKEWORD (2, 2), &data);
+#endif
+            Error error;
+            TCPSocket listen_socket (false, error);
+            ASSERT_TRUE (error.Success ());
+            error = listen_socket.Listen ("127.0.0.1:0", 5);
+            ASSERT_TRUE (error.Success ());
+
+            Socket *accept_socket = nullptr;
+            Error accept_error;
+            std::thread accept_thread ([&] ()
+            {
+                accept_error = listen_socket.Accept ("127.0.0.1:0", false, accept_socket);
+            });
+
+            std::unique_ptr<TCPSocket> connect_socket_up (new TCPSocket (false, error));
+            error = connect_socket_up->Connect ("127.0.0.1:" + std::to_string (listen_socket.GetLocalPortNumber ()));
+            accept_thread.join ();
+            ASSERT_TRUE (error.Success ());
+            ASSERT_TRUE (accept_error.Success ());
+
+            m_client.SetConnection (new ConnectionFileDescriptor (connect_socket_up.release ()));
+            m_server.SetConnection (new ConnectionFileDescriptor (accept_socket));
+        }
+
+        void
+        TearDown () override
+        {
+            m_client.Disconnect ();
+            m_server.Disconnect ();
+#if defined(_MSC_VER)
+            ::WSACleanup ();
+#endif
+        }
+
+    protected:
+        std::vector<std::string>
+        GetResponses (const std::vector<StringExtractorGDBRemote> &responses)
+        {
+            std::vector<std::string> strings;
+            for (const StringExtractorGDBRemote &response : responses)
+                strings.push_back (response.GetStringRef ());
+            return strings;
+        }
+
+        TestClient m_client;
+        MockServer m_server;
+    };
+}
+
+TEST_F (GDBRemoteCommunicationClientTest, PipelinedResponsesKeepTheirOrder)
+{
+    m_client.SetPacketTimeout (10);
+
+    const size_t num_packets = 40;
+    std::vector<std::string> payloads;
+    std::vector<std::string> expected_responses;
+    for (size_t i = 0; i < num_packets; ++i)
+    {
+        payloads.push_back ("qTest:" + std::to_string (i));
+        expected_responses.push_back ("R" + std::to_string (i));
+    }
+
+    // The server only answers once it got 16 packets, which a client waiting
+    // for each response would never send.
+    std::vector<std::string> received;
+    std::thread server_thread ([&] ()
+    {
+        for (size_t i = 0; i < 16; ++i)
+            received.push_back (m_server.GetPacket ());
+        for (size_t i = 0; i < num_packets; ++i)
+        {
+            if (i + 16 < num_packets)
+                received.push_back (m_server.GetPacket ());
+            m_server.Reply ("R" + received[i].substr (strlen ("qTest:")));
+        }
+    });
+
+    std::vector<StringExtractorGDBRemote> responses;
+    EXPECT_EQ (PacketResult::Success, m_client.SendPacketsAndWaitForResponses (payloads, responses, false));
+    server_thread.join ();
+
+    EXPECT_EQ (payloads, received);
+    EXPECT_EQ (expected_responses, GetResponses (responses));
+}
+
+TEST_F (GDBRemoteCommunicationClientTest, LateResponseIsConsumed)
+{
+    m_client.SetPacketTimeout (2);
+
+    // The responses to the second and third packet come after the client gave
+    // up on the second one, the next packet still gets its own response.
+    std::vector<std::string> received;
+    std::thread server_thread ([&] ()
+    {
+        for (size_t i = 0; i < 3; ++i)
+            received.push_back (m_server.GetPacket ());
+        m_server.Reply ("a");
+        std::this_thread::sleep_for (std::chrono::seconds (3));
+        m_server.Reply ("b");
+        m_server.Reply ("c");
+        received.push_back (m_server.GetPacket ());
+        m_server.Reply ("next");
+    });
+
+    std::vector<StringExtractorGDBRemote> responses;
+    EXPECT_EQ (PacketResult::ErrorReplyTimeout,
+               m_client.SendPacketsAndWaitForResponses ({ "qA", "qB", "qC" }, responses, false));
+    EXPECT_EQ (std::vector<std::string> ({ "a", "", "" }), GetResponses (responses));
+
+    StringExtractorGDBRemote response;
+    EXPECT_EQ (PacketResult::Success, m_client.SendPacketAndWaitForResponse ("qNext", response, false));
+    EXPECT_EQ ("next", response.GetStringRef ());
+    server_thread.join ();
+    EXPECT_EQ (std::vector<std::string> ({ "qA", "qB", "qC", "qNext" }), received);
+}
+
+TEST_F (GDBRemoteCommunicationClientTest, LostResponseResyncs)
+{
+    m_client.SetPacketTimeout (2);
+
+    // The response to the second packet never comes, so the third response
+    // arrives in its place. The client syncs up with a qC packet before the
+    // next packet.
+    std::vector<std::string> received;
+    std::thread server_thread ([&] ()
+    {
+        for (size_t i = 0; i < 3; ++i)
+            received.push_back (m_server.GetPacket ());
+        m_server.Reply ("a");
+        std::this_thread::sleep_for (std::chrono::seconds (3));
+        m_server.Reply ("c");
+        received.push_back (m_server.GetPacket ());
+        m_server.Reply ("QC1");
+        received.push_back (m_server.GetPacket ());
+        m_server.Reply ("next");
+    });
+
+    std::vector<StringExtractorGDBRemote> responses;
+    EXPECT_EQ (PacketResult::ErrorReplyTimeout,
+               m_client.SendPacketsAndWaitForResponses ({ "qA", "qB", "qD" }, responses, false));
+    EXPECT_EQ (std::vector<std::string> ({ "a", "", "" }), GetResponses (responses));
+
+    StringExtractorGDBRemote response;
+    EXPECT_EQ (PacketResult::Success, m_client.SendPacketAndWaitForResponse ("qNext", response, false));
+    EXPECT_EQ ("next", response.GetStringRef ());
+    server_thread.join ();
+    EXPECT_EQ (std::vector<std::string> ({ "qA", "qB", "qD", "qC", "qNext" }), received);
+}
+
+TEST_F (GDBRemoteCommunicationClientTest, ErrorRepliesAreResponses)
+{
+    m_client.SetPacketTimeout (10);
+
+    // Error replies are responses like any other, only a packet that got no
+    // response fails the batch.
+    std::thread server_thread ([&] ()
+    {
+        for (size_t i = 0; i < 3; ++i)
+            m_server.GetPacket ();
+        m_server.Reply ("a");
+        m_server.Reply ("E01");
+        m_server.Reply ("");
+    });
+
+    std::vector<StringExtractorGDBRemote> responses;
+    EXPECT_EQ (PacketResult::Success,
+               m_client.SendPacketsAndWaitForResponses ({ "qA", "qB", "qC" }, responses, false));
+    server_thread.join ();
+    EXPECT_EQ (std::vector<std::string> ({ "a", "E01", "" }), GetResponses (responses));
+}
+
+namespace
+{
+    // The packets PrefetchServerInfo() pipelines after qSupported.
+    const std::vector<std::string> g_prefetched_payloads = { "QThreadSuffixSupported",
+                                                             "QListThreadsInStopReply",
+                                                             "qHostInfo",
+                                                             "vCont?",
+                                                             "qVAttachOrWaitSupported",
+                                                             "qProcessInfo" };
+
+    // Answers qSupported with "qsupported_response", refuses to enable
+    // compression and answers any other packet with "R:<packet>", until
+    // it gets "qDone".
+    void
+    ServePackets (MockServer &server, const std::string &qsupported_response, std::vector<std::string> &received)
+    {
+        for (std::string packet = server.GetPacket (); packet != "<no packet>"; packet = server.GetPacket ())
+        {
+            received.push_back (packet);
+            if (packet == "qDone")
+            {
+                server.Reply ("OK");
+                break;
+            }
+            if (packet.find ("qSupported") == 0)
+                server.Reply (qsupported_response);
+            else if (packet.find ("QEnableCompression") == 0)
+                server.Reply ("E01");
+            else
+                server.Reply ("R:" + packet);
+        }
+    }
+}
+
+TEST_F (GDBRemoteCommunicationClientTest, PrefetchedResponsesAreUsed)
+{
+    m_client.SetPacketTimeout (10);
+
+    std::vector<std::string> received;
+    std::thread server_thread ([&] ()
+    {
+        ServePackets (m_server, "PacketSize=1000", received);
+    });
+
+    m_client.PrefetchServerInfo ();
+
+    // Each prefetched packet gets its response without being sent again.
+    StringExtractorGDBRemote response;
+    for (const std::string &payload : g_prefetched_payloads)
+    {
+        EXPECT_EQ (PacketResult::Success, m_client.SendPacketAndWaitForResponse (payload.c_str (), response, false));
+        EXPECT_EQ ("R:" + payload, response.GetStringRef ());
+    }
+    EXPECT_EQ (PacketResult::Success, m_client.SendPacketAndWaitForResponse ("qDone", response, false));
+    server_thread.join ();
+
+    ASSERT_EQ (g_prefetched_payloads.size () + 2, received.size ());
+    EXPECT_EQ (0u, received.front ().find ("qSupported"));
+    EXPECT_EQ (g_prefetched_payloads, std::vector<std::string> (received.begin () + 1, received.end () - 1));
+}
+
+TEST_F (GDBRemoteCommunicationClientTest, PrefetchedResponsesInvalidatedBySend)
+{
+    m_client.SetPacketTimeout (10);
+
+    std::vector<std::string> received;
+    std::thread server_thread ([&] ()
+    {
+        ServePackets (m_server, "PacketSize=1000", received);
+    });
+
+    m_client.PrefetchServerInfo ();
+
+    // Any other packet may change what the server would answer, so the
+    // prefetched responses are dropped and the packets are sent again.
+    StringExtractorGDBRemote response;
+    EXPECT_EQ (PacketResult::Success, m_client.SendPacketAndWaitForResponse ("QOther", response, false));
+    EXPECT_EQ ("R:QOther", response.GetStringRef ());
+    EXPECT_EQ (PacketResult::Success, m_client.SendPacketAndWaitForResponse ("qHostInfo", response, false));
+    EXPECT_EQ ("R:qHostInfo", response.GetStringRef ());
+    EXPECT_EQ (PacketResult::Success, m_client.SendPacketAndWaitForResponse ("qDone", response, false));
+    server_thread.join ();
+
+    ASSERT_LE (3u, received.size ());
+    EXPECT_EQ (std::vector<std::string> ({ "QOther", "qHostInfo", "qDone" }),
+               std::vector<std::string> (received.end () - 3, received.end ()));
+}
+
+TEST_F (GDBRemoteCommunicationClientTest, PrefetchAfterCompressionNegotiation)
+{
+    m_client.SetPacketTimeout (10);
+
+    // Offering compression makes the client send QEnableCompression when
+    // it was built with a decompressor. That has to happen before the
+    // prefetch, or it would throw the prefetched responses away.
+    std::vector<std::string> received;
+    std::thread server_thread ([&] ()
+    {
+        ServePackets (m_server, "PacketSize=1000;qXfer:features:read+;SupportedCompressions=zlib-deflate,lz4", received);
+    });
+
+    m_client.PrefetchServerInfo ();
+
+    StringExtractorGDBRemote response;
+    for (const std::string &payload : g_prefetched_payloads)
+    {
+        EXPECT_EQ (PacketResult::Success, m_client.SendPacketAndWaitForResponse (payload.c_str (), response, false));
+        EXPECT_EQ ("R:" + payload, response.GetStringRef ());
+    }
+    EXPECT_EQ (PacketResult::Success, m_client.SendPacketAndWaitForResponse ("qDone", response, false));
+    server_thread.join ();
+
+    ASSERT_LE (g_prefetched_payloads.size () + 2, received.size ());
+    EXPECT_EQ (0u, received.front ().find ("qSupported"));
+    size_t first_prefetched = 1;
+    while (first_prefetched < received.size () && received[first_prefetched].find ("QEnableCompression") == 0)
+        ++first_prefetched;
+    EXPECT_EQ (g_prefetched_payloads, std::vector<std::string> (received.begin () + first_prefetched, received.end () - 1));
+}
@@ -0,0 +1,310 @@
+//===-- GDBRemoteTargetXMLTest.cpp ------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Host/XML.h"
+#include "lldb/Host/common/NativeProcessProtocol.h"
+#include "lldb/Host/common/NativeRegisterContext.h"
+#include "lldb/Host/common/NativeThreadProtocol.h"
+
+#include "Plugins/Process/gdb-remote/GDBRemoteCommunicationServerLLGS.h"
+#include "Plugins/Process/gdb-remote/ProcessGDBRemote.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+namespace
+{
+    const uint32_t k_eax_value_regs[] = { 0, LLDB_INVALID_REGNUM };
+    const uint32_t k_eax_invalidate_regs[] = { 0, LLDB_INVALID_REGNUM };
+
+    // Registers with every attribute target.xml carries, a register that is
+    // a part of another one and a register that is in no set.
+    RegisterInfo g_register_infos[] =
+    {
+        { "rax", nullptr, 8, 0, eEncodingUint, eFormatHex,
+          { 0, 0, LLDB_INVALID_REGNUM, LLDB_INVALID_REGNUM, 0 }, nullptr, nullptr },
+        { "rip", "pc", 8, 8, eEncodingUint, eFormatHex,
+          { 16, 16, LLDB_REGNUM_GENERIC_PC, LLDB_INVALID_REGNUM, 1 }, nullptr, nullptr },
+        { "rflags", "flags", 4, 16, eEncodingUint, eFormatBinary,
+          { LLDB_INVALID_REGNUM, LLDB_INVALID_REGNUM, LLDB_REGNUM_GENERIC_FLAGS, LLDB_INVALID_REGNUM, 2 }, nullptr, nullptr },
+        { "eax", nullptr, 4, 0, eEncodingSint, eFormatDecimal,
+          { LLDB_INVALID_REGNUM, LLDB_INVALID_REGNUM, LLDB_INVALID_REGNUM, LLDB_INVALID_REGNUM, 3 },
+          const_cast<uint32_t *> (k_eax_value_regs), const_cast<uint32_t *> (k_eax_invalidate_regs) },
+        { "xmm0", nullptr, 16, 20, eEncodingVector, eFormatVectorOfUInt8,
+          { 17, 17, LLDB_INVALID_REGNUM, LLDB_INVALID_REGNUM, 4 }, nullptr, nullptr },
+        { "st0", nullptr, 10, 36, eEncodingIEEE754, eFormatFloat,
+          { 33, 33, LLDB_INVALID_REGNUM, LLDB_INVALID_REGNUM, 5 }, nullptr, nullptr }
+    };
+    const uint32_t k_num_registers = sizeof (g_register_infos) / sizeof (g_register_infos[0]);
+
+    const uint32_t k_gpr_regs[] = { 0, 1, 2, 3 };
+    const uint32_t k_vector_regs[] = { 4 };
+    const RegisterSet g_register_sets[] =
+    {
+        { "General Purpose Registers", "gpr", sizeof (k_gpr_regs) / sizeof (k_gpr_regs[0]), k_gpr_regs },
+        { "<Vector> & \"Float\" Registers", "vec", sizeof (k_vector_regs) / sizeof (k_vector_regs[0]), k_vector_regs }
+    };
+    const uint32_t k_num_register_sets = sizeof (g_register_sets) / sizeof (g_register_sets[0]);
+
+    class FakeRegisterContext : public NativeRegisterContext
+    {
+    public:
+        FakeRegisterContext (NativeThreadProtocol &thread) :
+            NativeRegisterContext (thread, 0)
+        {
+        }
+
+        uint32_t GetRegisterCount () const override { return k_num_registers; }
+        uint32_t GetUserRegisterCount () const override { return k_num_registers; }
+        uint32_t GetRegisterSetCount () const override { return k_num_register_sets; }
+
+        const RegisterSet *
+        GetRegisterSet (uint32_t set_index) const override
+        {
+            return set_index < k_num_register_sets ? &g_register_sets[set_index] : nullptr;
+        }
+
+        const RegisterInfo *
+        GetRegisterInfoAtIndex (uint32_t reg) const override
+        {
+            return reg < k_num_registers ? &g_register_infos[reg] : nullptr;
+        }
+
+        Error ReadRegister (const RegisterInfo *, RegisterValue &) override { return Error ("not supported"); }
+        Error WriteRegister (const RegisterInfo *, const RegisterValue &) override { return Error ("not supported"); }
+        Error ReadAllRegisterValues (DataBufferSP &) override { return Error ("not supported"); }
+        Error WriteAllRegisterValues (const DataBufferSP &) override { return Error ("not supported"); }
+    };
+
+    class FakeThread : public NativeThreadProtocol
+    {
+    public:
+        FakeThread (NativeProcessProtocol *process) :
+            NativeThreadProtocol (process, 1)
+        {
+        }
+
+        std::string GetName () override { return "fake"; }
+        StateType GetState () override { return eStateStopped; }
+        bool GetStopReason (ThreadStopInfo &, std::string &) override { return false; }
+        Error SetWatchpoint (addr_t, size_t, uint32_t, bool) override { return Error ("not supported"); }
+        Error RemoveWatchpoint (addr_t) override { return Error ("not supported"); }
+        NativeRegisterContextSP GetRegisterContext () override { return NativeRegisterContextSP (); }
+    };
+
+    class FakeProcess : public NativeProcessProtocol
+    {
+    public:
+        FakeProcess () :
+            NativeProcessProtocol (1)
+        {
+        }
+
+        Error Resume (const ResumeActionList &) override { return Error ("not supported"); }
+        Error Halt () override { return Error ("not supported"); }
+        Error Detach () override { return Error ("not supported"); }
+        Error Signal (int) override { return Error ("not supported"); }
+        Error Kill () override { return Error ("not supported"); }
+        Error ReadMemory (addr_t, void *, size_t, size_t &) override { return Error ("not supported"); }
+        Error ReadMemoryWithoutTrap (addr_t, void *, size_t, size_t &) override { return Error ("not supported"); }
+        Error WriteMemory (addr_t, const void *, size_t, size_t &) override { return Error ("not supported"); }
+        Error AllocateMemory (size_t, uint32_t, addr_t &) override { return Error ("not supported"); }
+        Error DeallocateMemory (addr_t) override { return Error ("not supported"); }
+        addr_t GetSharedLibraryInfoAddress () override { return LLDB_INVALID_ADDRESS; }
+        size_t UpdateThreads () override { return 1; }
+        bool GetArchitecture (ArchSpec &) const override { return false; }
+        Error SetBreakpoint (addr_t, uint32_t, bool) override { return Error ("not supported"); }
+        Error GetLoadedModuleFileSpec (const char *, FileSpec &) override { return Error ("not supported"); }
+        Error GetFileLoadAddress (const llvm::StringRef &, addr_t &) override { return Error ("not supported"); }
+
+    protected:
+        Error
+        GetSoftwareBreakpointTrapOpcode (size_t, size_t &, const uint8_t *&) override
+        {
+            return Error ("not supported");
+        }
+    };
+
+    std::vector<uint32_t>
+    GetRegNums (const uint32_t *reg_nums)
+    {
+        std::vector<uint32_t> result;
+        for (; reg_nums && *reg_nums != LLDB_INVALID_REGNUM; ++reg_nums)
+            result.push_back (*reg_nums);
+        return result;
+    }
+
+    std::string
+    GetString (const char *cstr)
+    {
+        return cstr ? cstr : "<null>";
+    }
+
+    bool
+    NoIncludes (const std::string &, std::string &)
+    {
+        return false;
+    }
+
+    class GDBRemoteTargetXMLTest : public ::testing::Test
+    {
+    public:
+        GDBRemoteTargetXMLTest () :
+            m_process_sp (new FakeProcess ()),
+            m_thread (m_process_sp.get ()),
+            m_reg_context (m_thread),
+            m_arch ("x86_64-pc-linux")
+        {
+        }
+
+    protected:
+        // Add the registers the way the qRegisterInfo responses do.
+        void
+        AddRegisters (GDBRemoteDynamicRegisterInfo &dyn_reg_info)
+        {
+            for (uint32_t reg = 0; reg < k_num_registers; ++reg)
+            {
+                RegisterInfo reg_info = g_register_infos[reg];
+                reg_info.kinds[eRegisterKindProcessPlugin] = reg;
+                reg_info.kinds[eRegisterKindLLDB] = reg;
+                ConstString reg_name (reg_info.name);
+                ConstString alt_name (reg_info.alt_name);
+                ConstString set_name;
+                for (uint32_t set = 0; set < k_num_register_sets; ++set)
+                {
+                    const RegisterSet &reg_set = g_register_sets[set];
+                    if (std::find (reg_set.registers, reg_set.registers + reg_set.num_registers, reg) != reg_set.registers + reg_set.num_registers)
+                        set_name.SetCString (reg_set.name);
+                }
+                dyn_reg_info.AddRegister (reg_info, reg_name, alt_name, set_name);
+            }
+        }
+
+        void
+        ExpectEqual (const GDBRemoteDynamicRegisterInfo &expected, const GDBRemoteDynamicRegisterInfo &actual)
+        {
+            ASSERT_EQ (expected.GetNumRegisters (), actual.GetNumRegisters ());
+            EXPECT_EQ (expected.GetRegisterDataByteSize (), actual.GetRegisterDataByteSize ());
+            for (uint32_t reg = 0; reg < expected.GetNumRegisters (); ++reg)
+            {
+                const RegisterInfo *expected_info = expected.GetRegisterInfoAtIndex (reg);
+                const RegisterInfo *actual_info = actual.GetRegisterInfoAtIndex (reg);
+                ASSERT_TRUE (expected_info && actual_info);
+                SCOPED_TRACE (GetString (expected_info->name));
+                EXPECT_EQ (GetString (expected_info->name), GetString (actual_info->name));
+                EXPECT_EQ (GetString (expected_info->alt_name), GetString (actual_info->alt_name));
+                EXPECT_EQ (expected_info->byte_size, actual_info->byte_size);
+                EXPECT_EQ (expected_info->byte_offset, actual_info->byte_offset);
+                EXPECT_EQ (expected_info->encoding, actual_info->encoding);
+                EXPECT_EQ (expected_info->format, actual_info->format);
+                for (uint32_t kind = 0; kind < kNumRegisterKinds; ++kind)
+                    EXPECT_EQ (expected_info->kinds[kind], actual_info->kinds[kind]) << "kind " << kind;
+                EXPECT_EQ (GetRegNums (expected_info->value_regs), GetRegNums (actual_info->value_regs));
+                EXPECT_EQ (GetRegNums (expected_info->invalidate_regs), GetRegNums (actual_info->invalidate_regs));
+            }
+
+            ASSERT_EQ (expected.GetNumRegisterSets (), actual.GetNumRegisterSets ());
+            for (uint32_t set = 0; set < expected.GetNumRegisterSets (); ++set)
+            {
+                const RegisterSet *expected_set = expected.GetRegisterSet (set);
+                const RegisterSet *actual_set = actual.GetRegisterSet (set);
+                ASSERT_TRUE (expected_set && actual_set);
+                EXPECT_EQ (GetString (expected_set->name), GetString (actual_set->name));
+                EXPECT_EQ (std::vector<uint32_t> (expected_set->registers, expected_set->registers + expected_set->num_registers),
+                           std::vector<uint32_t> (actual_set->registers, actual_set->registers + actual_set->num_registers));
+            }
+        }
+
+        std::shared_ptr<FakeProcess> m_process_sp;
+        FakeThread m_thread;
+        FakeRegisterContext m_reg_context;
+        ArchSpec m_arch;
+    };
+}
+
+TEST_F (GDBRemoteTargetXMLTest, RoundTrip)
+{
+    if (!XMLDocument::XMLEnabled ())
+        return;
+
+    StreamString xml;
+    ASSERT_TRUE (GDBRemoteCommunicationServerLLGS::GetTargetXML (m_reg_context, xml));
+
+    GDBRemoteDynamicRegisterInfo xml_info;
+    ASSERT_TRUE (ProcessGDBRemote::ParseTargetXML (xml.GetString (), NoIncludes, xml_info, ABISP ()));
+    xml_info.Finalize (m_arch);
+
+    GDBRemoteDynamicRegisterInfo reg_info;
+    AddRegisters (reg_info);
+    reg_info.Finalize (m_arch);
+
+    ExpectEqual (reg_info, xml_info);
+}
+
+TEST_F (GDBRemoteTargetXMLTest, Includes)
+{
+    if (!XMLDocument::XMLEnabled ())
+        return;
+
+    // The registers can come from the documents target.xml includes, the
+    // groups stay in target.xml itself.
+    StreamString xml;
+    ASSERT_TRUE (GDBRemoteCommunicationServerLLGS::GetTargetXML (m_reg_context, xml));
+    std::string target_xml = xml.GetString ();
+    const std::string target_start = "<target version=\"1.0\">";
+    target_xml.replace (target_xml.find (target_start), target_start.size (),
+                        "<target version=\"1.0\" xmlns:xi=\"http://www.w3.org/2001/XInclude\">");
+    const size_t feature_start = target_xml.find ("<feature");
+    const size_t feature_end = target_xml.find ("</feature>\n") + strlen ("</feature>\n");
+    ASSERT_NE (std::string::npos, feature_start);
+    const std::string feature_xml = target_xml.substr (feature_start, feature_end - feature_start);
+    target_xml.replace (feature_start, feature_end - feature_start,
+                        "<xi:include href=\"missing.xml\"/>\n<xi:include href=\"registers.xml\"/>\n");
+
+    std::vector<std::string> requested;
+    auto read_include = [&requested, &feature_xml](const std::string &include, std::string &include_xml) -> bool {
+        requested.push_back (include);
+        if (include != "registers.xml")
+            return false;
+        include_xml = "<?xml version=\"1.0\"?>\n" + feature_xml;
+        return true;
+    };
+
+    GDBRemoteDynamicRegisterInfo xml_info;
+    ASSERT_TRUE (ProcessGDBRemote::ParseTargetXML (target_xml, read_include, xml_info, ABISP ()));
+    xml_info.Finalize (m_arch);
+    EXPECT_EQ (std::vector<std::string> ({ "missing.xml", "registers.xml" }), requested);
+
+    GDBRemoteDynamicRegisterInfo reg_info;
+    AddRegisters (reg_info);
+    reg_info.Finalize (m_arch);
+
+    ExpectEqual (reg_info, xml_info);
+}
+
+TEST_F (GDBRemoteTargetXMLTest, NoTarget)
+{
+    if (!XMLDocument::XMLEnabled ())
+        return;
+
+    GDBRemoteDynamicRegisterInfo xml_info;
+    EXPECT_FALSE (ProcessGDBRemote::ParseTargetXML ("<?xml version=\"1.0\"?>\n<feature/>\n", NoIncludes, xml_info, ABISP ()));
+    EXPECT_FALSE (ProcessGDBRemote::ParseTargetXML ("not xml", NoIncludes, xml_info, ABISP ()));
+    EXPECT_EQ (0u, xml_info.GetNumRegisters ());
+}
@@ -0,0 +1,214 @@
+//===-- SymtabTest.cpp ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include "lldb/Core/ConstString.h"
+#include "lldb/Symbol/Symtab.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    // Gives the test access to the name indexes of a symbol table.
+    class TestSymtab : public Symtab
+    {
+    public:
+        using Symtab::kNameIndexChunkSize;
+        using Symtab::InitNameIndexes;
+
+        TestSymtab() : Symtab(nullptr) {}
+
+        const NameToIndexMap &
+        GetNameIndex() const { return m_name_to_index; }
+
+        const NameToIndexMap &
+        GetBasenameIndex() const { return m_basename_to_index; }
+
+        const NameToIndexMap &
+        GetMethodIndex() const { return m_method_to_index; }
+
+        const NameToIndexMap &
+        GetSelectorIndex() const { return m_selector_to_index; }
+    };
+
+    std::string
+    LengthPrefixed(const std::string &name)
+    {
+        return std::to_string(name.size()) + name;
+    }
+
+    // "context::basename()", optionally const
+    std::string
+    MangleMethod(const std::string &context, const std::string &basename, bool is_const = false)
+    {
+        return "_ZN" + std::string(is_const ? "K" : "") + LengthPrefixed(context) + LengthPrefixed(basename) + "Ev";
+    }
+
+    // "context::~context()"
+    std::string
+    MangleDestructor(const std::string &context)
+    {
+        return "_ZN" + LengthPrefixed(context) + "D1Ev";
+    }
+
+    void
+    AddCodeSymbol(Symtab &symtab, const std::string &name, bool name_is_mangled)
+    {
+        const uint32_t id = symtab.GetNumSymbols();
+        symtab.AddSymbol(Symbol(id, name.c_str(), name_is_mangled, eSymbolTypeCode,
+                                true,       // external
+                                false,      // is_debug
+                                false,      // is_trampoline
+                                false,      // is_artificial
+                                SectionSP(),
+                                0x1000 + id * 0x10,
+                                0x10,
+                                true,       // size_is_valid
+                                false,      // contains_linker_annotations
+                                0));
+    }
+
+    // Fill "symtab" with C++ and ObjC names spread over several index chunks.
+    void
+    AddSymbols(Symtab &symtab, uint32_t num_symbols)
+    {
+        // The first chunk has a method whose context is only proven to be a
+        // class by a destructor in a later chunk, and a destructor proving
+        // the context of a method in a later chunk.
+        AddCodeSymbol(symtab, MangleMethod("LateClass", "method"), true);
+        AddCodeSymbol(symtab, MangleDestructor("EarlyClass"), true);
+
+        for (uint32_t i = symtab.GetNumSymbols(); i < num_symbols; ++i)
+        {
+            // Scatter the classes so each one shows up in every chunk
+            const uint32_t class_idx = (i * 7919) % 499;
+            const std::string class_name = "Class" + std::to_string(class_idx);
+            const std::string suffix = std::to_string(i);
+            if (i == num_symbols / 2)
+            {
+                AddCodeSymbol(symtab, MangleDestructor("LateClass"), true);
+                continue;
+            }
+            if (i == num_symbols - 1)
+            {
+                AddCodeSymbol(symtab, MangleMethod("EarlyClass", "method"), true);
+                continue;
+            }
+            switch (i % 6)
+            {
+            case 0:
+                AddCodeSymbol(symtab, MangleMethod(class_name, "method" + suffix), true);
+                break;
+            case 1:
+                // Only some classes are proven to be classes, the others
+                // might as well be namespaces
+                if (class_idx % 3 == 0)
+                    AddCodeSymbol(symtab, MangleDestructor(class_name), true);
+                else if (class_idx % 3 == 1)
+                    AddCodeSymbol(symtab, MangleMethod(class_name, "getter" + suffix, true), true);
+                else
+                    AddCodeSymbol(symtab, MangleMethod("ns", "function" + suffix), true);
+                break;
+            case 2:
+                AddCodeSymbol(symtab, "_Z" + LengthPrefixed("function" + suffix) + "v", true);
+                break;
+            case 3:
+                AddCodeSymbol(symtab, "-[" + class_name + " selector" + suffix + ":]", false);
+                break;
+            case 4:
+                AddCodeSymbol(symtab, "+[" + class_name + "(Category) selector" + suffix + "]", false);
+                break;
+            case 5:
+                AddCodeSymbol(symtab, "c_function" + suffix, false);
+                break;
+            }
+        }
+    }
+
+    void
+    ExpectSameIndex(const Symtab::NameToIndexMap &expected, const Symtab::NameToIndexMap &actual, const char *index_name)
+    {
+        SCOPED_TRACE(index_name);
+        ASSERT_EQ(expected.GetSize(), actual.GetSize());
+        for (size_t i = 0; i < expected.GetSize(); ++i)
+        {
+            uint32_t expected_value = UINT32_MAX;
+            uint32_t actual_value = UINT32_MAX;
+            EXPECT_TRUE(expected.GetValueAtIndex(i, expected_value));
+            EXPECT_TRUE(actual.GetValueAtIndex(i, actual_value));
+            EXPECT_EQ(expected.GetCStringAtIndex(i), actual.GetCStringAtIndex(i)) << "at index " << i;
+            EXPECT_EQ(expected_value, actual_value) << "at index " << i;
+        }
+    }
+
+    bool
+    IndexContains(const Symtab::NameToIndexMap &index, const char *name, uint32_t symbol_idx)
+    {
+        const char *cstr = ConstString(name).GetCString();
+        for (size_t i = 0; i < index.GetSize(); ++i)
+        {
+            uint32_t value;
+            if (index.GetCStringAtIndex(i) == cstr && index.GetValueAtIndex(i, value) && value == symbol_idx)
+                return true;
+        }
+        return false;
+    }
+}
+
+TEST(SymtabTest, ChunkedNameIndexesMatchSingleChunk)
+{
+    const uint32_t num_symbols = 3 * TestSymtab::kNameIndexChunkSize + 123;
+
+    TestSymtab chunked;
+    AddSymbols(chunked, num_symbols);
+    chunked.InitNameIndexes();
+
+    TestSymtab single;
+    AddSymbols(single, num_symbols);
+    single.InitNameIndexes(num_symbols);
+
+    ASSERT_EQ(num_symbols, chunked.GetNumSymbols());
+    EXPECT_LT(0u, chunked.GetSelectorIndex().GetSize());
+    EXPECT_LT(0u, chunked.GetMethodIndex().GetSize());
+
+    ExpectSameIndex(single.GetNameIndex(), chunked.GetNameIndex(), "name index");
+    ExpectSameIndex(single.GetBasenameIndex(), chunked.GetBasenameIndex(), "basename index");
+    ExpectSameIndex(single.GetMethodIndex(), chunked.GetMethodIndex(), "method index");
+    ExpectSameIndex(single.GetSelectorIndex(), chunked.GetSelectorIndex(), "selector index");
+}
+
+TEST(SymtabTest, ClassContextFromLaterChunk)
+{
+    const uint32_t num_symbols = 2 * TestSymtab::kNameIndexChunkSize + 1;
+
+    TestSymtab symtab;
+    AddSymbols(symtab, num_symbols);
+    symtab.InitNameIndexes();
+
+    // "LateClass::method()" comes before the destructor that proves
+    // "LateClass" is a class, so it is only a method once all chunks are
+    // merged.
+    EXPECT_TRUE(IndexContains(symtab.GetMethodIndex(), "method", 0));
+    EXPECT_FALSE(IndexContains(symtab.GetBasenameIndex(), "method", 0));
+
+    // "EarlyClass::method()" is in the last chunk, after the destructor.
+    EXPECT_TRUE(IndexContains(symtab.GetMethodIndex(), "method", num_symbols - 1));
+    EXPECT_FALSE(IndexContains(symtab.GetBasenameIndex(), "method", num_symbols - 1));
+
+    // Nothing proves "ns" is a class, so its functions go in both indexes.
+    const uint32_t ns_function_idx = 7;
+    ASSERT_EQ(2u, ((ns_function_idx * 7919) % 499) % 3);
+    const std::string ns_function = "function" + std::to_string(ns_function_idx);
+    EXPECT_TRUE(IndexContains(symtab.GetMethodIndex(), ns_function.c_str(), ns_function_idx));
+    EXPECT_TRUE(IndexContains(symtab.GetBasenameIndex(), ns_function.c_str(), ns_function_idx));
+}
@@ -0,0 +1,181 @@
+//===-- UnwindTableTest.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/Section.h"
+#include "lldb/Symbol/FuncUnwinders.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/Symbol.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Symbol/UnwindTable.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    // An object file without sections, and so without any unwind
+    // information, that only provides an UnwindTable.
+    class TestObjectFile : public ObjectFile
+    {
+    public:
+        TestObjectFile() : ObjectFile(ModuleSP(), nullptr, 0, 0, DataBufferSP(), 0) {}
+
+        ConstString GetPluginName() override { return ConstString("test"); }
+        uint32_t GetPluginVersion() override { return 1; }
+        void Dump(Stream *s) override {}
+        uint32_t GetAddressByteSize() const override { return 8; }
+        uint32_t GetDependentModules(FileSpecList &file_list) override { return 0; }
+        bool IsExecutable() const override { return false; }
+        bool GetArchitecture(ArchSpec &arch) override { return false; }
+        void CreateSections(SectionList &unified_section_list) override {}
+        Symtab *GetSymtab() override { return nullptr; }
+        bool IsStripped() override { return false; }
+        bool GetUUID(UUID *uuid) override { return false; }
+        ByteOrder GetByteOrder() const override { return eByteOrderLittle; }
+        bool ParseHeader() override { return true; }
+        Type CalculateType() override { return eTypeInvalid; }
+        Strata CalculateStrata() override { return eStrataInvalid; }
+    };
+
+    class UnwindTableTest : public ::testing::Test
+    {
+    public:
+        void
+        SetUp() override
+        {
+            m_text_sp.reset(new Section(ModuleSP(), &m_objfile, 1, ConstString(".text"), eSectionTypeCode,
+                                        0x1000, 0x1000, 0x1000, 0x1000, 0, 0));
+        }
+
+    protected:
+        // Look up "file_addr" as if it were in a function of "func_size"
+        // bytes starting at "func_addr".
+        FuncUnwindersSP
+        Lookup(addr_t file_addr, addr_t func_addr, addr_t func_size)
+        {
+            Symbol symbol(0, "func", false, eSymbolTypeCode, true, false, false, false,
+                          m_text_sp, func_addr - m_text_sp->GetFileAddress(), func_size, true, false, 0);
+            SymbolContext sc;
+            sc.symbol = &symbol;
+            return m_objfile.GetUnwindTable().GetFuncUnwindersContainingAddress(GetAddress(file_addr), sc);
+        }
+
+        // Look up "file_addr" without a symbol context, which only finds
+        // the functions that already have an entry.
+        FuncUnwindersSP
+        LookupCached(addr_t file_addr)
+        {
+            SymbolContext sc;
+            return m_objfile.GetUnwindTable().GetFuncUnwindersContainingAddress(GetAddress(file_addr), sc);
+        }
+
+        Address
+        GetAddress(addr_t file_addr)
+        {
+            return Address(m_text_sp, file_addr - m_text_sp->GetFileAddress());
+        }
+
+        TestObjectFile m_objfile;
+        SectionSP m_text_sp;
+    };
+}
+
+TEST_F(UnwindTableTest, RepeatedLookups)
+{
+    EXPECT_FALSE(LookupCached(0x1100));
+
+    FuncUnwindersSP func_sp = Lookup(0x1100, 0x1100, 0x100);
+    ASSERT_TRUE(func_sp);
+    EXPECT_EQ(0x1100u, func_sp->GetFunctionStartAddress().GetFileAddress());
+
+    // Any address in the function gets the same entry, with or without a
+    // symbol context.
+    EXPECT_EQ(func_sp, Lookup(0x1100, 0x1100, 0x100));
+    EXPECT_EQ(func_sp, Lookup(0x11ff, 0x1100, 0x100));
+    EXPECT_EQ(func_sp, LookupCached(0x1100));
+    EXPECT_EQ(func_sp, LookupCached(0x1180));
+    EXPECT_EQ(func_sp, LookupCached(0x11ff));
+
+    // Before the first and after the last entry
+    EXPECT_FALSE(LookupCached(0x10ff));
+    EXPECT_FALSE(LookupCached(0x1200));
+}
+
+TEST_F(UnwindTableTest, InsertPosition)
+{
+    // Add the functions out of address order, including before the first
+    // and after the last entry.
+    FuncUnwindersSP middle_sp = Lookup(0x1480, 0x1400, 0x100);
+    FuncUnwindersSP last_sp = Lookup(0x1800, 0x1800, 0x100);
+    FuncUnwindersSP first_sp = Lookup(0x1010, 0x1000, 0x100);
+    FuncUnwindersSP second_sp = Lookup(0x1200, 0x1200, 0x100);
+    FuncUnwindersSP third_sp = Lookup(0x1600, 0x1600, 0x100);
+    ASSERT_TRUE(first_sp && second_sp && middle_sp && third_sp && last_sp);
+
+    // Every entry is found again, so they are kept sorted.
+    EXPECT_EQ(first_sp, LookupCached(0x1000));
+    EXPECT_EQ(first_sp, LookupCached(0x10ff));
+    EXPECT_EQ(second_sp, LookupCached(0x1200));
+    EXPECT_EQ(middle_sp, LookupCached(0x1400));
+    EXPECT_EQ(third_sp, LookupCached(0x16ff));
+    EXPECT_EQ(last_sp, LookupCached(0x1800));
+    EXPECT_EQ(last_sp, LookupCached(0x18ff));
+
+    // Gaps between the functions and after the last one
+    EXPECT_FALSE(LookupCached(0x1100));
+    EXPECT_FALSE(LookupCached(0x1300));
+    EXPECT_FALSE(LookupCached(0x1900));
+    EXPECT_FALSE(LookupCached(0x1fff));
+}
+
+TEST_F(UnwindTableTest, OverlappingFunctions)
+{
+    // "outer" covers all of "inner", which starts later.
+    FuncUnwindersSP outer_sp = Lookup(0x1100, 0x1100, 0x400);
+    FuncUnwindersSP inner_sp = Lookup(0x1200, 0x1200, 0x100);
+    ASSERT_TRUE(outer_sp && inner_sp);
+    EXPECT_NE(outer_sp, inner_sp);
+
+    // The entry starting closest before the address wins where both match
+    EXPECT_EQ(outer_sp, LookupCached(0x11ff));
+    EXPECT_EQ(inner_sp, LookupCached(0x1200));
+    EXPECT_EQ(inner_sp, LookupCached(0x12ff));
+
+    // Past the end of "inner" the closest entry doesn't match. The symbol
+    // context finds "outer" again instead of adding another entry for it.
+    EXPECT_EQ(outer_sp, Lookup(0x1300, 0x1100, 0x400));
+    EXPECT_EQ(outer_sp, Lookup(0x14ff, 0x1100, 0x400));
+    EXPECT_FALSE(LookupCached(0x1500));
+}
+
+TEST_F(UnwindTableTest, ReplaceSameStart)
+{
+    // The symbol for the function grew, e.g. because better symbols were
+    // loaded. The entry that doesn't cover the address is replaced.
+    FuncUnwindersSP small_sp = Lookup(0x1100, 0x1100, 0x80);
+    ASSERT_TRUE(small_sp);
+    EXPECT_FALSE(LookupCached(0x1180));
+
+    FuncUnwindersSP large_sp = Lookup(0x1180, 0x1100, 0x100);
+    ASSERT_TRUE(large_sp);
+    EXPECT_NE(small_sp, large_sp);
+    EXPECT_EQ(0x1100u, large_sp->GetFunctionStartAddress().GetFileAddress());
+
+    // There is still a single entry for the start address.
+    EXPECT_EQ(large_sp, LookupCached(0x1100));
+    EXPECT_EQ(large_sp, LookupCached(0x11ff));
+
+    // A smaller symbol for an address the entry covers doesn't replace it.
+    EXPECT_EQ(large_sp, Lookup(0x1100, 0x1100, 0x80));
+    EXPECT_EQ(large_sp, LookupCached(0x11ff));
+}
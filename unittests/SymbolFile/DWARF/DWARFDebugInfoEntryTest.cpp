@@ -0,0 +1,81 @@
+//===-- DWARFDebugInfoEntryTest.cpp -----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "Plugins/SymbolFile/DWARF/DWARFDebugInfoEntry.h"
+
+namespace
+{
+    // Link "dies[child]" into the tree the way DWARFCompileUnit::ExtractDIEsIfNeeded()
+    // does, as the next child of "dies[parent]" after "dies[prev_sibling]".
+    // Returns false if the sibling is too far away for the DIE to store.
+    bool
+    AddChild(DWARFDebugInfoEntry::collection &dies, uint32_t parent, uint32_t prev_sibling, uint32_t child)
+    {
+        dies[child].SetParentIndex(child - parent);
+        if (prev_sibling)
+            return dies[prev_sibling].SetSiblingIndex(child - prev_sibling);
+        return true;
+    }
+}
+
+TEST(DWARFDebugInfoEntryTest, Size)
+{
+    EXPECT_EQ(12u, sizeof(DWARFDebugInfoEntry));
+}
+
+TEST(DWARFDebugInfoEntryTest, EmptyChildren)
+{
+    // A DIE whose abbreviation says it has children, but which only
+    // contains a NULL entry, still reports having children. It just
+    // doesn't have a first child.
+    DWARFDebugInfoEntry::collection dies(3);
+    dies[0].SetHasChildren(true);
+    dies[1].SetHasChildren(true);
+    dies[1].SetEmptyChildren(true);
+    AddChild(dies, 0, 0, 1);
+    AddChild(dies, 0, 1, 2);
+
+    EXPECT_EQ(&dies[1], dies[0].GetFirstChild());
+    EXPECT_TRUE(dies[1].HasChildren());
+    EXPECT_TRUE(dies[1].GetEmptyChildren());
+    EXPECT_EQ(nullptr, dies[1].GetFirstChild());
+    EXPECT_EQ(&dies[2], dies[1].GetSibling(nullptr));
+    EXPECT_EQ(&dies[0], dies[2].GetParent());
+    EXPECT_FALSE(dies[2].HasChildren());
+    EXPECT_EQ(nullptr, dies[2].GetFirstChild());
+    EXPECT_EQ(nullptr, dies[2].GetSibling(nullptr));
+}
+
+TEST(DWARFDebugInfoEntryTest, FarSibling)
+{
+    // dies[1] has more descendants than fit in the sibling index. The DIE
+    // can't store the distance to its sibling dies[last], which the
+    // compile unit has to keep instead. Without one it has no sibling, it
+    // is never found by walking the subtree.
+    const uint32_t last = DIE_SIBLING_IDX_FAR + 100;
+    DWARFDebugInfoEntry::collection dies(last + 1);
+    dies[0].SetHasChildren(true);
+    dies[1].SetHasChildren(true);
+    EXPECT_TRUE(AddChild(dies, 0, 0, 1));
+    for (uint32_t i = 2; i < last; ++i)
+        EXPECT_TRUE(AddChild(dies, 1, i > 2 ? i - 1 : 0, i));
+    EXPECT_FALSE(AddChild(dies, 0, 1, last));
+
+    EXPECT_EQ(nullptr, dies[1].GetSibling(nullptr));
+    EXPECT_EQ(&dies[3], dies[2].GetSibling(nullptr));
+    EXPECT_EQ(nullptr, dies[last - 1].GetSibling(nullptr));
+    EXPECT_EQ(&dies[1], dies[last - 1].GetParent());
+    EXPECT_EQ(&dies[0], dies[last].GetParent());
+
+    // The largest distance that fits is still stored in the DIE.
+    EXPECT_TRUE(dies[2].SetSiblingIndex(DIE_SIBLING_IDX_FAR - 1));
+    EXPECT_FALSE(dies[2].SetSiblingIndex(DIE_SIBLING_IDX_FAR));
+}
@@ -0,0 +1,247 @@
+//===-- DWARFGdbIndexTest.cpp -----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <ctype.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataExtractor.h"
+
+#include "Plugins/SymbolFile/DWARF/DWARFGdbIndex.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    // Writes a .gdb_index section with the given compile units and
+    // symbols, laid out the way the linkers lay it out.
+    class GdbIndexBuilder
+    {
+    public:
+        void
+        AddCompileUnit(uint64_t cu_offset)
+        {
+            m_cu_offsets.push_back(cu_offset);
+        }
+
+        void
+        AddSymbol(const char *name, const std::vector<uint32_t> &cu_indexes)
+        {
+            m_symbols.push_back(std::make_pair(std::string(name), cu_indexes));
+        }
+
+        std::vector<uint8_t>
+        Build(uint32_t version, uint32_t num_slots)
+        {
+            m_bytes.clear();
+            const uint32_t cu_list_offset = 6 * 4;
+            const uint32_t types_cu_list_offset = cu_list_offset + m_cu_offsets.size() * 16;
+            const uint32_t symbol_table_offset = types_cu_list_offset;
+            const uint32_t constant_pool_offset = symbol_table_offset + num_slots * 8;
+
+            PutU32(version);
+            PutU32(cu_list_offset);
+            PutU32(types_cu_list_offset);
+            PutU32(types_cu_list_offset); // address area
+            PutU32(symbol_table_offset);
+            PutU32(constant_pool_offset);
+            for (uint64_t cu_offset : m_cu_offsets)
+            {
+                PutU64(cu_offset);
+                PutU64(0x100); // length
+            }
+
+            // The CU vectors go first in the constant pool, then the names.
+            std::vector<uint8_t> pool;
+            std::vector<std::pair<uint32_t, uint32_t>> slots(num_slots, std::make_pair(0u, 0u));
+            std::vector<uint32_t> cu_vector_offsets;
+            for (const auto &symbol : m_symbols)
+            {
+                cu_vector_offsets.push_back(pool.size());
+                PutU32(pool, symbol.second.size());
+                for (uint32_t cu_index : symbol.second)
+                    PutU32(pool, cu_index);
+            }
+            for (size_t i = 0; i < m_symbols.size(); ++i)
+            {
+                const std::string &name = m_symbols[i].first;
+                const uint32_t name_offset = pool.size();
+                pool.insert(pool.end(), name.begin(), name.end());
+                pool.push_back(0);
+
+                const uint32_t hash = Hash(name.c_str());
+                const uint32_t mask = num_slots - 1;
+                const uint32_t step = ((hash * 17) & mask) | 1;
+                uint32_t slot = hash & mask;
+                while (slots[slot].first != 0 || slots[slot].second != 0)
+                    slot = (slot + step) & mask;
+                slots[slot] = std::make_pair(name_offset, cu_vector_offsets[i]);
+            }
+
+            for (const auto &slot : slots)
+            {
+                PutU32(slot.first);
+                PutU32(slot.second);
+            }
+            m_bytes.insert(m_bytes.end(), pool.begin(), pool.end());
+            return m_bytes;
+        }
+
+    private:
+        static uint32_t
+        Hash(const char *name)
+        {
+            uint32_t r = 0;
+            for (const unsigned char *s = (const unsigned char *)name; *s; ++s)
+                r = r * 67 + tolower(*s) - 113;
+            return r;
+        }
+
+        static void
+        PutU32(std::vector<uint8_t> &bytes, uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i)
+                bytes.push_back((value >> (8 * i)) & 0xff);
+        }
+
+        void
+        PutU32(uint32_t value)
+        {
+            PutU32(m_bytes, value);
+        }
+
+        void
+        PutU64(uint64_t value)
+        {
+            PutU32(value & 0xffffffff);
+            PutU32(value >> 32);
+        }
+
+        std::vector<uint64_t> m_cu_offsets;
+        std::vector<std::pair<std::string, std::vector<uint32_t>>> m_symbols;
+        std::vector<uint8_t> m_bytes;
+    };
+
+    std::vector<dw_offset_t>
+    Find(DWARFGdbIndex &index, const char *name)
+    {
+        std::vector<dw_offset_t> cu_offsets;
+        index.FindCompileUnits(ConstString(name), cu_offsets);
+        return cu_offsets;
+    }
+
+    class DWARFGdbIndexTest : public ::testing::Test
+    {
+    public:
+        void
+        SetUp() override
+        {
+            m_builder.AddCompileUnit(0x0);
+            m_builder.AddCompileUnit(0x400);
+            m_builder.AddCompileUnit(0x800);
+            m_builder.AddSymbol("main", {0});
+            m_builder.AddSymbol("ns::Foo", {1});
+            // Version 7 keeps the symbol kind and static flag in the upper bits.
+            m_builder.AddSymbol("ns::bar", {(1u << 31) | (3u << 28) | 1, 2});
+            m_builder.AddSymbol("Global", {2});
+        }
+
+    protected:
+        GdbIndexBuilder m_builder;
+    };
+}
+
+TEST_F(DWARFGdbIndexTest, FindQualifiedNames)
+{
+    std::vector<uint8_t> bytes = m_builder.Build(7, 16);
+    DWARFGdbIndex index(DataExtractor(bytes.data(), bytes.size(), eByteOrderLittle, 8));
+    ASSERT_TRUE(index.IsValid());
+
+    EXPECT_EQ(std::vector<dw_offset_t>({0x0}), Find(index, "main"));
+    EXPECT_EQ(std::vector<dw_offset_t>({0x400}), Find(index, "ns::Foo"));
+    EXPECT_EQ(std::vector<dw_offset_t>({0x400, 0x800}), Find(index, "ns::bar"));
+    EXPECT_EQ(std::vector<dw_offset_t>({0x800}), Find(index, "Global"));
+    EXPECT_TRUE(Find(index, "missing").empty());
+}
+
+TEST_F(DWARFGdbIndexTest, FindBaseNames)
+{
+    std::vector<uint8_t> bytes = m_builder.Build(7, 16);
+    DWARFGdbIndex index(DataExtractor(bytes.data(), bytes.size(), eByteOrderLittle, 8));
+    ASSERT_TRUE(index.IsValid());
+
+    EXPECT_EQ(std::vector<dw_offset_t>({0x400}), Find(index, "Foo"));
+    EXPECT_EQ(std::vector<dw_offset_t>({0x400, 0x800}), Find(index, "bar"));
+    EXPECT_TRUE(Find(index, "ns").empty());
+}
+
+TEST_F(DWARFGdbIndexTest, CollidingSlots)
+{
+    // With two slots every lookup has to probe past the other entry.
+    GdbIndexBuilder builder;
+    builder.AddCompileUnit(0x10);
+    builder.AddCompileUnit(0x20);
+    builder.AddSymbol("first", {0});
+    builder.AddSymbol("second", {1});
+    std::vector<uint8_t> bytes = builder.Build(8, 2);
+    DWARFGdbIndex index(DataExtractor(bytes.data(), bytes.size(), eByteOrderLittle, 8));
+    ASSERT_TRUE(index.IsValid());
+
+    EXPECT_EQ(std::vector<dw_offset_t>({0x10}), Find(index, "first"));
+    EXPECT_EQ(std::vector<dw_offset_t>({0x20}), Find(index, "second"));
+}
+
+TEST_F(DWARFGdbIndexTest, InvalidCompileUnitIndex)
+{
+    GdbIndexBuilder builder;
+    builder.AddCompileUnit(0x10);
+    builder.AddSymbol("type_unit_only", {5});
+    std::vector<uint8_t> bytes = builder.Build(7, 4);
+    DWARFGdbIndex index(DataExtractor(bytes.data(), bytes.size(), eByteOrderLittle, 8));
+    ASSERT_TRUE(index.IsValid());
+
+    EXPECT_TRUE(Find(index, "type_unit_only").empty());
+}
+
+TEST_F(DWARFGdbIndexTest, UnsupportedVersions)
+{
+    std::vector<uint8_t> bytes = m_builder.Build(4, 16);
+    EXPECT_FALSE(DWARFGdbIndex(DataExtractor(bytes.data(), bytes.size(), eByteOrderLittle, 8)).IsValid());
+
+    bytes = m_builder.Build(9, 16);
+    EXPECT_FALSE(DWARFGdbIndex(DataExtractor(bytes.data(), bytes.size(), eByteOrderLittle, 8)).IsValid());
+}
+
+TEST_F(DWARFGdbIndexTest, MalformedHeaders)
+{
+    // Truncated header.
+    std::vector<uint8_t> bytes = m_builder.Build(7, 16);
+    EXPECT_FALSE(DWARFGdbIndex(DataExtractor(bytes.data(), 20, eByteOrderLittle, 8)).IsValid());
+
+    // The symbol table size isn't a power of two.
+    bytes = m_builder.Build(7, 16);
+    const uint32_t constant_pool_offset = 6 * 4 + 3 * 16 + 12 * 8;
+    for (int i = 0; i < 4; ++i)
+        bytes[5 * 4 + i] = (constant_pool_offset >> (8 * i)) & 0xff;
+    EXPECT_FALSE(DWARFGdbIndex(DataExtractor(bytes.data(), bytes.size(), eByteOrderLittle, 8)).IsValid());
+
+    // The constant pool starts past the end of the section.
+    bytes = m_builder.Build(7, 16);
+    bytes.resize(6 * 4 + 3 * 16 + 8 * 8);
+    EXPECT_FALSE(DWARFGdbIndex(DataExtractor(bytes.data(), bytes.size(), eByteOrderLittle, 8)).IsValid());
+
+    DWARFGdbIndex empty_index((DataExtractor()));
+    EXPECT_FALSE(empty_index.IsValid());
+    EXPECT_TRUE(Find(empty_index, "main").empty());
+}
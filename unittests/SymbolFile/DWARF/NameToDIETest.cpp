@@ -0,0 +1,180 @@
+//===-- NameToDIETest.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string.h>
+#include <utility>
+#include <vector>
+
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Host/Endian.h"
+
+#include "Plugins/SymbolFile/DWARF/NameToDIE.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    typedef std::vector<std::pair<dw_offset_t, dw_offset_t>> DIEOffsets;
+
+    const char *g_names[] = {
+        "main",
+        "foo",
+        "std::vector<int, std::allocator<int> >::push_back",
+        "Bar",
+        "operator<<",
+    };
+    const size_t g_num_names = sizeof(g_names) / sizeof(g_names[0]);
+
+    // The DIEs of "g_names[name_idx]": one more for each name, spread over
+    // two compile units.
+    DIEOffsets
+    GetDIEs(size_t name_idx)
+    {
+        DIEOffsets dies;
+        for (size_t i = 0; i <= name_idx; ++i)
+            dies.push_back(std::make_pair(i % 2 ? 0x1000 : 0x0, 0x20 + name_idx * 0x100 + i * 0x10));
+        return dies;
+    }
+
+    void
+    Fill(NameToDIE &map)
+    {
+        // Insert the DIEs of the different names interleaved, the way
+        // indexing several compile units does.
+        for (size_t i = 0; i < g_num_names; ++i)
+        {
+            for (size_t name_idx = 0; name_idx < g_num_names; ++name_idx)
+            {
+                const DIEOffsets dies = GetDIEs(name_idx);
+                if (i < dies.size())
+                    map.Insert(ConstString(g_names[name_idx]), DIERef(dies[i].first, dies[i].second));
+            }
+        }
+        map.Finalize();
+    }
+
+    // The DIEs found for "name", sorted since entries for the same name
+    // have no particular order.
+    DIEOffsets
+    Find(const NameToDIE &map, const char *name)
+    {
+        DIEArray die_refs;
+        map.Find(ConstString(name), die_refs);
+        DIEOffsets dies;
+        for (const DIERef &die_ref : die_refs)
+            dies.push_back(std::make_pair(die_ref.cu_offset, die_ref.die_offset));
+        std::sort(dies.begin(), dies.end());
+        return dies;
+    }
+
+    void
+    ExpectAllNamesFound(const NameToDIE &map)
+    {
+        for (size_t name_idx = 0; name_idx < g_num_names; ++name_idx)
+        {
+            SCOPED_TRACE(g_names[name_idx]);
+            DIEOffsets expected = GetDIEs(name_idx);
+            std::sort(expected.begin(), expected.end());
+            EXPECT_EQ(expected, Find(map, g_names[name_idx]));
+        }
+        EXPECT_TRUE(Find(map, "not_a_name").empty());
+    }
+
+    DataExtractor
+    GetData(const StreamString &strm)
+    {
+        return DataExtractor(strm.GetData(), strm.GetSize(), endian::InlHostByteOrder(), sizeof(void *));
+    }
+}
+
+TEST(NameToDIETest, EncodeDecode)
+{
+    NameToDIE map;
+    Fill(map);
+    ExpectAllNamesFound(map);
+
+    StreamString strm(Stream::eBinary, sizeof(void *), endian::InlHostByteOrder());
+    map.Encode(strm);
+
+    const DataExtractor data = GetData(strm);
+    lldb::offset_t offset = 0;
+    NameToDIE decoded;
+    ASSERT_TRUE(decoded.Decode(data, &offset));
+    EXPECT_EQ(strm.GetSize(), offset);
+    decoded.Finalize();
+    ExpectAllNamesFound(decoded);
+}
+
+TEST(NameToDIETest, DecodeFromOtherSession)
+{
+    // Another session had other string pool pointers, so its entries are
+    // in a different order. Write them in the reverse of this session's
+    // pointer order, in the format of NameToDIE::Encode().
+    std::vector<const char *> names;
+    for (size_t name_idx = 0; name_idx < g_num_names; ++name_idx)
+        names.push_back(ConstString(g_names[name_idx]).GetCString());
+    std::sort(names.begin(), names.end());
+    std::reverse(names.begin(), names.end());
+
+    StreamString strm(Stream::eBinary, sizeof(void *), endian::InlHostByteOrder());
+    strm.PutHex32(names.size());
+    for (const char *name : names)
+    {
+        const size_t name_idx = std::find_if(g_names, g_names + g_num_names,
+                                             [name](const char *n) { return strcmp(n, name) == 0; }) - g_names;
+        const DIEOffsets dies = GetDIEs(name_idx);
+        strm.Write(name, strlen(name) + 1);
+        strm.PutHex32(dies.size());
+        for (auto pos = dies.rbegin(); pos != dies.rend(); ++pos)
+        {
+            strm.PutHex32(pos->first);
+            strm.PutHex32(pos->second);
+        }
+    }
+
+    const DataExtractor data = GetData(strm);
+    lldb::offset_t offset = 0;
+    NameToDIE decoded;
+    ASSERT_TRUE(decoded.Decode(data, &offset));
+    decoded.Finalize();
+    ExpectAllNamesFound(decoded);
+
+    // Encoding the reloaded map and decoding it again gives the same map.
+    StreamString reencoded(Stream::eBinary, sizeof(void *), endian::InlHostByteOrder());
+    decoded.Encode(reencoded);
+    const DataExtractor reencoded_data = GetData(reencoded);
+    offset = 0;
+    NameToDIE redecoded;
+    ASSERT_TRUE(redecoded.Decode(reencoded_data, &offset));
+    redecoded.Finalize();
+    ExpectAllNamesFound(redecoded);
+}
+
+TEST(NameToDIETest, DecodeTruncated)
+{
+    NameToDIE map;
+    Fill(map);
+    StreamString strm(Stream::eBinary, sizeof(void *), endian::InlHostByteOrder());
+    map.Encode(strm);
+
+    // Every proper prefix of the encoded map is malformed
+    for (size_t size = 0; size < strm.GetSize(); ++size)
+    {
+        SCOPED_TRACE(size);
+        const DataExtractor data(strm.GetData(), size, endian::InlHostByteOrder(), sizeof(void *));
+        lldb::offset_t offset = 0;
+        NameToDIE decoded;
+        EXPECT_FALSE(decoded.Decode(data, &offset));
+    }
+}
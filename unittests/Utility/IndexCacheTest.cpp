@@ -0,0 +1,157 @@
+//===-- IndexCacheTest.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/UUID.h"
+#include "lldb/Host/FileSystem.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+
+#include "Utility/IndexCache.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    class IndexCacheTest : public ::testing::Test
+    {
+    public:
+        void
+        SetUp() override
+        {
+            llvm::SmallString<128> root_path;
+            ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("IndexCacheTest", root_path));
+            m_root_spec.SetFile(root_path.c_str(), false);
+            ASSERT_TRUE(m_uuid.SetFromCString("30C94DC6-6A1F-E951-80C3-D68D2B89E576") > 0);
+        }
+
+        void
+        TearDown() override
+        {
+            FileSystem::DeleteDirectory(m_root_spec, true);
+        }
+
+    protected:
+        FileSpec m_root_spec;
+        UUID m_uuid;
+    };
+}
+
+TEST_F(IndexCacheTest, PutAndGet)
+{
+    const char payload[] = "cached index data";
+    ASSERT_TRUE(IndexCache::Put(m_root_spec, m_uuid, "entry", 42, payload, sizeof(payload)).Success());
+
+    DataExtractor data;
+    ASSERT_TRUE(IndexCache::Get(m_root_spec, m_uuid, "entry", 42, data));
+    ASSERT_EQ(sizeof(payload), data.GetByteSize());
+    lldb::offset_t offset = 0;
+    EXPECT_STREQ(payload, data.GetCStr(&offset));
+}
+
+TEST_F(IndexCacheTest, StaleSignature)
+{
+    const uint32_t payload = 0x12345678;
+    ASSERT_TRUE(IndexCache::Put(m_root_spec, m_uuid, "entry", 1, &payload, sizeof(payload)).Success());
+
+    DataExtractor data;
+    EXPECT_FALSE(IndexCache::Get(m_root_spec, m_uuid, "entry", 2, data));
+    EXPECT_FALSE(IndexCache::Get(m_root_spec, m_uuid, "missing", 1, data));
+
+    // A newer entry replaces the stale one.
+    ASSERT_TRUE(IndexCache::Put(m_root_spec, m_uuid, "entry", 2, &payload, sizeof(payload)).Success());
+    ASSERT_TRUE(IndexCache::Get(m_root_spec, m_uuid, "entry", 2, data));
+    lldb::offset_t offset = 0;
+    EXPECT_EQ(payload, data.GetU32(&offset));
+}
+
+TEST_F(IndexCacheTest, EntryForFile)
+{
+    llvm::SmallString<128> file_path(m_root_spec.GetPath().c_str());
+    llvm::sys::path::append(file_path, "libfoo.so");
+    FILE *file = fopen(file_path.c_str(), "w");
+    ASSERT_TRUE(file != nullptr);
+    fclose(file);
+    const FileSpec file_spec(file_path.c_str(), false);
+
+    std::string entry_name;
+    uint64_t signature = 0;
+    ASSERT_TRUE(IndexCache::GetEntryForFile("dwarf-index", file_spec, 0, entry_name, signature));
+    EXPECT_EQ("dwarf-index-libfoo.so", entry_name);
+    EXPECT_EQ(file_spec.GetModificationTime().GetAsNanoSecondsSinceJan1_1970(), signature);
+
+    // Objects inside of an archive get their offset appended.
+    ASSERT_TRUE(IndexCache::GetEntryForFile("demangled-names", file_spec, 0x1000, entry_name, signature));
+    EXPECT_EQ("demangled-names-libfoo.so-0x1000", entry_name);
+
+    const FileSpec missing_spec("/this/file/does/not/exist", false);
+    EXPECT_FALSE(IndexCache::GetEntryForFile("dwarf-index", missing_spec, 0, entry_name, signature));
+}
+
+TEST_F(IndexCacheTest, DemangledNames)
+{
+    IndexCache::DemangledNameList names;
+    names.push_back(std::make_pair(ConstString("_Z3fooi"), ConstString("foo(int)")));
+    names.push_back(std::make_pair(ConstString("_ZN2ns3barEv"), ConstString("ns::bar()")));
+    ASSERT_TRUE(IndexCache::PutDemangledNames(m_root_spec, m_uuid, "demangled-names-a.out", 7, 10, names).Success());
+
+    IndexCache::DemangledNameList cached_names;
+    ASSERT_TRUE(IndexCache::GetDemangledNames(m_root_spec, m_uuid, "demangled-names-a.out", 7, 10, cached_names));
+    EXPECT_EQ(names, cached_names);
+
+    // The symbol table changed size, the names can't be trusted.
+    cached_names.clear();
+    EXPECT_FALSE(IndexCache::GetDemangledNames(m_root_spec, m_uuid, "demangled-names-a.out", 7, 11, cached_names));
+    EXPECT_TRUE(cached_names.empty());
+
+    EXPECT_FALSE(IndexCache::GetDemangledNames(m_root_spec, m_uuid, "demangled-names-a.out", 8, 10, cached_names));
+    EXPECT_TRUE(cached_names.empty());
+}
+
+TEST_F(IndexCacheTest, TruncatedDemangledNames)
+{
+    // Two names are claimed but the second pair is cut short.
+    const uint32_t counts[] = { 10, 2 };
+    std::string payload(reinterpret_cast<const char *>(counts), sizeof(counts));
+    payload.append("_Z3fooi", sizeof("_Z3fooi"));
+    payload.append("foo(int)", sizeof("foo(int)"));
+    payload.append("_ZN2ns3barEv", sizeof("_ZN2ns3barEv"));
+    ASSERT_TRUE(IndexCache::Put(m_root_spec, m_uuid, "demangled-names-a.out", IndexCache::GetDemangledNamesSignature(7),
+                                payload.data(), payload.size()).Success());
+
+    IndexCache::DemangledNameList cached_names;
+    EXPECT_FALSE(IndexCache::GetDemangledNames(m_root_spec, m_uuid, "demangled-names-a.out", 7, 10, cached_names));
+    ASSERT_EQ(1u, cached_names.size());
+    EXPECT_EQ(ConstString("_Z3fooi"), cached_names[0].first);
+    EXPECT_EQ(ConstString("foo(int)"), cached_names[0].second);
+}
+
+TEST_F(IndexCacheTest, DemangledNamesVersion)
+{
+    // An entry written before the demangler or the entry layout changed
+    // has the same file signature, but must not be used.
+    const uint32_t counts[] = { 10, 1 };
+    std::string payload(reinterpret_cast<const char *>(counts), sizeof(counts));
+    payload.append("_Z3fooi", sizeof("_Z3fooi"));
+    payload.append("foo(int)", sizeof("foo(int)"));
+    ASSERT_TRUE(IndexCache::Put(m_root_spec, m_uuid, "demangled-names-a.out", 7, payload.data(), payload.size()).Success());
+
+    EXPECT_NE(7u, IndexCache::GetDemangledNamesSignature(7));
+    EXPECT_NE(IndexCache::GetDemangledNamesSignature(7), IndexCache::GetDemangledNamesSignature(8));
+
+    IndexCache::DemangledNameList cached_names;
+    EXPECT_FALSE(IndexCache::GetDemangledNames(m_root_spec, m_uuid, "demangled-names-a.out", 7, 10, cached_names));
+    EXPECT_TRUE(cached_names.empty());
+}
@@ -60,3 +60,92 @@ TEST (TaskPoolTest, TaskRunner)
 
     ASSERT_EQ(4, count);
 }
+
+TEST (TaskPoolTest, NestedTasks)
+{
+    // Every worker thread waits for subtasks it added itself, which would deadlock if waiting
+    // threads didn't run pending tasks.
+    const size_t num_outer = 4 * TaskPool::GetThreadCount();
+    std::vector<std::future<int>> outer;
+    for (size_t i = 0; i < num_outer; ++i)
+    {
+        outer.push_back(TaskPool::AddTask([]()
+        {
+            std::vector<std::future<int>> inner;
+            for (int j = 1; j <= 4; ++j)
+                inner.push_back(TaskPool::AddTask([j]() { return j; }));
+
+            int sum = 0;
+            for (auto &f : inner)
+            {
+                TaskPool::WaitForFuture(f);
+                sum += f.get();
+            }
+            return sum;
+        }));
+    }
+
+    for (auto &f : outer)
+    {
+        TaskPool::WaitForFuture(f);
+        ASSERT_EQ (10, f.get());
+    }
+}
+
+TEST (TaskPoolTest, TaskMapOverInt)
+{
+    std::vector<int> r(1000);
+    TaskMapOverInt(0, r.size(), [&r](size_t i) { r[i] = i * i + 1; });
+
+    for (size_t i = 0; i < r.size(); ++i)
+        ASSERT_EQ ((int)(i * i + 1), r[i]);
+
+    // An empty range doesn't call the function at all.
+    TaskMapOverInt(5, 5, [](size_t) { FAIL(); });
+}
+
+TEST (TaskPoolTest, WaitersOnlyRunOwnTasks)
+{
+    // Keep every worker busy so the tasks added below stay queued.
+    const uint32_t num_workers = TaskPool::GetThreadCount();
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t num_blocked = 0;
+    bool release = false;
+    std::vector<std::future<void>> blockers;
+    for (uint32_t i = 0; i < num_workers; ++i)
+    {
+        blockers.push_back(TaskPool::AddTask([&]()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ++num_blocked;
+            cv.notify_all();
+            cv.wait(lock, [&release]() { return release; });
+        }));
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return num_blocked == num_workers; });
+    }
+
+    // A task added by another thread must not be run by this thread while it waits.
+    std::thread::id foreign_thread_id;
+    std::future<void> foreign;
+    std::thread([&]() { foreign = TaskPool::AddTask([&]() { foreign_thread_id = std::this_thread::get_id(); }); }).join();
+
+    bool own_ran = false;
+    auto own = TaskPool::AddTask([&own_ran]() { own_ran = true; });
+    ASSERT_TRUE (TaskPool::RunPendingTask());
+    ASSERT_TRUE (own_ran);
+    ASSERT_FALSE (TaskPool::RunPendingTask());
+
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        release = true;
+    }
+    cv.notify_all();
+    for (auto &f : blockers)
+        TaskPool::WaitForFuture(f);
+    TaskPool::WaitForFuture(foreign);
+    ASSERT_NE (std::this_thread::get_id(), foreign_thread_id);
+}